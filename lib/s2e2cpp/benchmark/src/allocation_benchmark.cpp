@@ -0,0 +1,122 @@
+/**
+ * @brief Heap allocations and time per record of batch evaluation building intermediate strings.
+ */
+
+#include <s2e2/evaluator.hpp>
+#include <s2e2/record_batch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    /// @brief Number of calls of the global operator new.
+    std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+
+namespace
+{
+    const std::vector<std::string> VARIABLES = {"Name", "Tier", "City"};
+    const std::vector<std::pair<std::string, std::string>> EXPRESSIONS = {
+        {"concatenation", "Name + \", \" + Tier + \" customer from \" + City"},
+        {"branches", "IF(Tier == gold, Name + \" (gold)\", City + \" / \" + Name)"},
+        {"replace", "REPLACE(Name + \" of \" + City, \"[aeiou]\", _)"},
+        {"template", "\"Dear \" + Name + \", your \" + Tier + \" status in \" + City + \" is confirmed. \" + "
+                     "Name + \" / \" + Tier + \" / \" + City + \" / \" + Name + \" / \" + Tier + \" / \" + City"}};
+    const size_t NUMBER_OF_RECORDS = 64 * 1024;
+
+    /**
+     * @brief Make values of all variables, record by record.
+     */
+    std::vector<std::string> makeValues()
+    {
+        const std::vector<std::string> tiers = {"bronze", "silver", "gold"};
+        const std::vector<std::string> cities = {"Amsterdam", "Berlin", "Copenhagen", "Dublin"};
+
+        std::vector<std::string> values;
+        for (size_t i = 0; i < NUMBER_OF_RECORDS; ++i)
+        {
+            values.push_back("customer number " + std::to_string(i));
+            values.push_back(tiers[i % tiers.size()]);
+            values.push_back(cities[i % cities.size()]);
+        }
+        return values;
+    }
+
+    /**
+     * @brief Evaluate the batch once to warm up buffers, then print allocations and time per record of the second run.
+     */
+    void measure(const s2e2::Evaluator& evaluator,
+                 const std::string& name,
+                 const std::string& expression,
+                 const s2e2::RecordBatch& records,
+                 s2e2::ExecutionMode mode)
+    {
+        const auto compiled = evaluator.compile(expression, VARIABLES);
+        std::vector<std::optional<std::string>> results(NUMBER_OF_RECORDS);
+        std::vector<s2e2::RecordStatus> statuses(NUMBER_OF_RECORDS);
+        evaluator.evaluateBatch(compiled, records, results, statuses, mode);
+
+        const auto allocationsBefore = allocations.load();
+        const auto begin = std::chrono::steady_clock::now();
+        evaluator.evaluateBatch(compiled, records, results, statuses, mode);
+        const auto end = std::chrono::steady_clock::now();
+        const auto allocationsAfter = allocations.load();
+
+        std::printf("%14s %11s %18.2f %14.1f\n",
+                    name.c_str(),
+                    (mode == s2e2::ExecutionMode::SCALAR) ? "scalar" : "vectorized",
+                    static_cast<double>(allocationsAfter - allocationsBefore) / NUMBER_OF_RECORDS,
+                    std::chrono::duration<double, std::nano>(end - begin).count() / NUMBER_OF_RECORDS);
+    }
+}
+
+int main()
+{
+    const auto values = makeValues();
+    const std::vector<s2e2::VariableValue> views(values.begin(), values.end());
+    const auto records = s2e2::RecordBatch::rowMajor(views, NUMBER_OF_RECORDS, VARIABLES.size());
+
+    s2e2::Evaluator evaluator;
+    evaluator.addStandardFunctions();
+    evaluator.addStandardOperators();
+
+    // results are kept in std::string, so every record allocates at least its result
+    std::printf("%14s %11s %18s %14s\n", "expression", "mode", "allocations/record", "ns/record");
+    for (const auto& expression : EXPRESSIONS)
+    {
+        measure(evaluator, expression.first, expression.second, records, s2e2::ExecutionMode::SCALAR);
+        measure(evaluator, expression.first, expression.second, records, s2e2::ExecutionMode::VECTORIZED);
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @brief Throughput of batch and rule set evaluation on the standard functions, by number of threads.
+ */
+
+#include <s2e2/evaluator.hpp>
+#include <s2e2/record_batch.hpp>
+#include <s2e2/rule_set.hpp>
+#include <s2e2/thread_pool.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    const std::vector<std::string> VARIABLES = {"Name", "Tier", "Amount", "Days"};
+    const std::string EXPRESSION = "IF(IN(Tier, gold, platinum) && Amount > A5, "
+                                   "REPLACE(Name + \" VIP\", \"[aeiou]\", _), "
+                                   "Name + FORMAT_DATE(ADD_DAYS(NOW(), Days), \"%Y-%m-%d\"))";
+    const size_t NUMBER_OF_RECORDS = 100000;
+    const size_t NUMBER_OF_RULES = 2000;
+    const size_t NUMBER_OF_RUNS = 3;
+
+    /**
+     * @brief Make random columns, values are kept alive by the returned storage.
+     */
+    std::vector<std::vector<std::string>> makeColumns()
+    {
+        std::mt19937 random(42);
+        const auto pick = [&random](size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(random); };
+        const std::vector<std::string> tiers = {"bronze", "silver", "gold", "platinum"};
+
+        std::vector<std::vector<std::string>> columns(VARIABLES.size());
+        for (size_t i = 0; i < NUMBER_OF_RECORDS; ++i)
+        {
+            columns[0].push_back("customer" + std::to_string(pick(10000)));
+            columns[1].push_back(tiers[pick(tiers.size())]);
+            columns[2].push_back("A" + std::to_string(pick(10)));
+            columns[3].push_back(std::to_string(pick(30)));
+        }
+        return columns;
+    }
+
+    /**
+     * @brief Make rules over the same variables, sharing their conditions.
+     */
+    std::vector<std::string> makeRules()
+    {
+        std::vector<std::string> rules;
+        for (size_t i = 0; i < NUMBER_OF_RULES; ++i)
+        {
+            rules.push_back("IF(Amount > A" + std::to_string(i % 10) + " && Tier != T" + std::to_string(i % 7) +
+                            ", REPLACE(Name, customer, c" + std::to_string(i) + "), NULL)");
+        }
+        return rules;
+    }
+
+    /**
+     * @brief Measure the best time of the action in milliseconds.
+     */
+    template <class Action>
+    double measure(Action action)
+    {
+        double best = 0.0;
+        for (size_t run = 0; run < NUMBER_OF_RUNS; ++run)
+        {
+            const auto begin = std::chrono::steady_clock::now();
+            action();
+            const auto end = std::chrono::steady_clock::now();
+            const auto time = std::chrono::duration<double, std::milli>(end - begin).count();
+            best = (run == 0 || time < best) ? time : best;
+        }
+        return best;
+    }
+}
+
+int main()
+{
+    s2e2::Evaluator evaluator;
+    evaluator.addStandardFunctions();
+    evaluator.addStandardOperators();
+
+    const auto storage = makeColumns();
+    std::vector<std::vector<s2e2::VariableValue>> values;
+    std::vector<s2e2::BatchColumn> columns;
+    for (const auto& column : storage)
+    {
+        values.emplace_back(column.begin(), column.end());
+    }
+    for (const auto& column : values)
+    {
+        columns.emplace_back(column);
+    }
+    const auto records = s2e2::RecordBatch::columnar(columns, NUMBER_OF_RECORDS);
+
+    const auto expression = evaluator.compile(EXPRESSION, VARIABLES);
+    const auto rules = evaluator.compileRuleSet(makeRules(), VARIABLES);
+
+    std::vector<std::optional<std::string>> results(NUMBER_OF_RECORDS);
+    std::vector<s2e2::RecordStatus> statuses(NUMBER_OF_RECORDS);
+    std::vector<std::optional<std::string>> ruleResults(NUMBER_OF_RULES);
+    std::vector<s2e2::RecordStatus> ruleStatuses(NUMBER_OF_RULES);
+
+    std::printf("%8s %14s %14s %14s %10s\n", "threads", "scalar, ms", "vectorized, ms", "rule set, ms", "speedup");
+
+    double baseline = 0.0;
+    for (const size_t numberOfThreads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        s2e2::ThreadPoolOptions options;
+        options.numberOfThreads = numberOfThreads;
+        options.grainSize = 256;
+        evaluator.setThreadPool(std::make_shared<s2e2::ThreadPool>(options));
+
+        const auto scalar = measure([&]()
+        {
+            evaluator.evaluateBatch(expression, records, results, statuses, s2e2::ExecutionMode::SCALAR);
+        });
+
+        const auto vectorized = measure([&]()
+        {
+            evaluator.evaluateBatch(expression, records, results, statuses, s2e2::ExecutionMode::VECTORIZED);
+        });
+
+        // one thousandth of the records is enough to keep rule set runs comparable to batch ones
+        const auto ruleSet = measure([&]()
+        {
+            for (size_t record = 0; record < NUMBER_OF_RECORDS / 1000; ++record)
+            {
+                const std::vector<s2e2::VariableValue> recordValues = {values[0][record], values[1][record],
+                                                                       values[2][record], values[3][record]};
+                evaluator.evaluateRules(rules, recordValues, ruleResults, ruleStatuses);
+            }
+        });
+
+        baseline = (numberOfThreads == 1) ? scalar : baseline;
+        std::printf("%8zu %14.1f %14.1f %14.1f %10.2f\n", numberOfThreads, scalar, vectorized, ruleSet,
+                    baseline / scalar);
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/**
+ * @brief Per-record cost of routing rules evaluated one by one and as a rule set, by number of rules.
+ */
+
+#include <s2e2/evaluator.hpp>
+#include <s2e2/rule_set.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    const std::vector<std::string> VARIABLES = {"Country", "Tier", "Amount"};
+    const size_t NUMBER_OF_COUNTRIES = 50;
+    const size_t NUMBER_OF_TIERS = 5;
+    const size_t NUMBER_OF_THRESHOLDS = 20;
+    const size_t NUMBER_OF_RECORDS = 200;
+
+    /**
+     * @brief Make routing rules, rules with the same country and tier share their conditions.
+     */
+    std::vector<std::string> makeRules(size_t numberOfRules)
+    {
+        std::vector<std::string> rules;
+        for (size_t i = 0; i < numberOfRules; ++i)
+        {
+            rules.push_back("IF(Country == C" + std::to_string(i % NUMBER_OF_COUNTRIES) +
+                            " && Tier == T" + std::to_string(i / NUMBER_OF_COUNTRIES % NUMBER_OF_TIERS) +
+                            " && Amount > A" + std::to_string(i / NUMBER_OF_COUNTRIES / NUMBER_OF_TIERS % NUMBER_OF_THRESHOLDS) +
+                            ", route" + std::to_string(i) + ", NULL)");
+        }
+        return rules;
+    }
+
+    /**
+     * @brief Make random records, values are kept alive by the returned storage.
+     */
+    std::vector<std::vector<std::string>> makeRecords()
+    {
+        std::mt19937 random(42);
+        const auto pick = [&random](size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(random); };
+
+        std::vector<std::vector<std::string>> records;
+        for (size_t i = 0; i < NUMBER_OF_RECORDS; ++i)
+        {
+            records.push_back({"C" + std::to_string(pick(NUMBER_OF_COUNTRIES)),
+                               "T" + std::to_string(pick(NUMBER_OF_TIERS)),
+                               "A" + std::to_string(pick(NUMBER_OF_THRESHOLDS))});
+        }
+        return records;
+    }
+
+    /**
+     * @brief Measure average time of the action per record in nanoseconds.
+     */
+    template <class Action>
+    double measure(const std::vector<std::vector<s2e2::VariableValue>>& records, Action action)
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        for (const auto& values : records)
+        {
+            action(values);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - begin).count() / records.size();
+    }
+}
+
+int main()
+{
+    s2e2::Evaluator evaluator;
+    evaluator.addStandardFunctions();
+    evaluator.addStandardOperators();
+
+    const auto storage = makeRecords();
+    std::vector<std::vector<s2e2::VariableValue>> records;
+    for (const auto& record : storage)
+    {
+        records.emplace_back(record.begin(), record.end());
+    }
+
+    std::printf("%8s %8s %10s %16s %16s %16s\n",
+                "rules", "nodes", "decisions", "separate, ns", "rule set, ns", "first match, ns");
+
+    for (const size_t numberOfRules : {10, 100, 1000, 5000})
+    {
+        const auto rules = makeRules(numberOfRules);
+
+        std::vector<s2e2::CompiledExpression> compiled;
+        for (const auto& rule : rules)
+        {
+            compiled.push_back(evaluator.compile(rule, VARIABLES));
+        }
+        const auto ruleSet = evaluator.compileRuleSet(rules, VARIABLES);
+
+        std::vector<std::optional<std::string>> results(numberOfRules);
+        std::vector<s2e2::RecordStatus> statuses(numberOfRules);
+
+        const auto separate = measure(records, [&](const auto& values)
+        {
+            for (size_t i = 0; i < compiled.size(); ++i)
+            {
+                results[i] = evaluator.evaluate(compiled[i], values);
+            }
+        });
+
+        const auto together = measure(records, [&](const auto& values)
+        {
+            evaluator.evaluateRules(ruleSet, values, results, statuses);
+        });
+
+        const auto firstMatch = measure(records, [&](const auto& values)
+        {
+            evaluator.evaluateFirstMatch(ruleSet, values);
+        });
+
+        std::printf("%8zu %8zu %10zu %16.0f %16.0f %16.0f\n", numberOfRules, ruleSet.numberOfNodes(),
+                    ruleSet.numberOfDecisionNodes(), separate, together, firstMatch);
+    }
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @brief Compile throughput of long quoted literals, plain text and multi-kilobyte expressions, dominated by tokenization.
+ */
+
+#include <s2e2/evaluator.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    const std::vector<std::string> VARIABLES = {"A", "B"};
+    const size_t TOTAL_SIZE = 64 * 1024 * 1024;
+
+    /**
+     * @brief Make a single quoted literal with escaped quotes, commas and blanks inside.
+     */
+    std::string makeLiteral(size_t size)
+    {
+        std::string literal = "\"";
+        for (size_t i = 0; literal.size() < size; ++i)
+        {
+            literal += (i % 10 == 0) ? "\\\"quoted\\\", " : "plain text (with brackets) ";
+        }
+        return literal + "\"";
+    }
+
+    /**
+     * @brief Make plain text with no special symbols but blanks, a literal without quotes.
+     */
+    std::string makePlainText(size_t size)
+    {
+        std::string text;
+        while (text.size() < size)
+        {
+            text += "plain text without operators ";
+        }
+        return text;
+    }
+
+    /**
+     * @brief Make a long expression of variables, literals and calls.
+     */
+    std::string makeExpression(size_t size)
+    {
+        std::string expression = "A";
+        for (size_t i = 0; expression.size() < size; ++i)
+        {
+            expression += (i % 3 == 0) ? " + \"some literal, " + std::to_string(i) + "\""
+                        : (i % 3 == 1) ? " + IF(B == value" + std::to_string(i) + ", yes, no)"
+                                       : " + REPLACE(B, pattern, replacement" + std::to_string(i) + ")";
+        }
+        return expression;
+    }
+
+    /**
+     * @brief Measure compile throughput of the expression in megabytes per second.
+     */
+    double measure(const s2e2::Evaluator& evaluator, const std::string& expression)
+    {
+        const auto repetitions = TOTAL_SIZE / expression.size() + 1;
+
+        const auto begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < repetitions; ++i)
+        {
+            evaluator.compile(expression, VARIABLES);
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        const auto seconds = std::chrono::duration<double>(end - begin).count();
+        return repetitions * expression.size() / seconds / (1024 * 1024);
+    }
+}
+
+int main()
+{
+    s2e2::Evaluator evaluator;
+    evaluator.addStandardFunctions();
+    evaluator.addStandardOperators();
+
+    std::printf("%12s %10s %12s\n", "input", "bytes", "MB/s");
+
+    for (const size_t size : {256, 4096, 65536})
+    {
+        const auto literal = makeLiteral(size);
+        std::printf("%12s %10zu %12.1f\n", "literal", literal.size(), measure(evaluator, literal));
+    }
+
+    for (const size_t size : {256, 4096, 65536})
+    {
+        const auto text = makePlainText(size);
+        std::printf("%12s %10zu %12.1f\n", "plain text", text.size(), measure(evaluator, text));
+    }
+
+    s2e2::Evaluator frozenEvaluator;
+    frozenEvaluator.addStandardFunctions();
+    frozenEvaluator.addStandardOperators();
+    frozenEvaluator.freeze();
+
+    for (const size_t size : {1024, 4096, 16384})
+    {
+        const auto expression = makeExpression(size);
+        std::printf("%12s %10zu %12.1f\n", "expression", expression.size(), measure(evaluator, expression));
+        std::printf("%12s %10zu %12.1f\n", "frozen", expression.size(), measure(frozenEvaluator, expression));
+    }
+
+    return 0;
+}
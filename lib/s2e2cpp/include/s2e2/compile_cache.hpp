@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Options of the cache of compiled expressions, zero capacities disable the cache.
+     */
+    struct CompileCacheOptions
+    {
+        /// @brief Maximal number of compiled expressions, the least recently used ones are evicted first.
+        size_t capacity = 0;
+
+        /// @brief Maximal number of remembered compile failures, the least recently used ones are evicted first.
+        size_t failureCapacity = 0;
+
+        /// @brief Time a compile failure is remembered for.
+        std::chrono::nanoseconds failureTtl = std::chrono::seconds(60);
+    };
+
+    /**
+     * @brief Counters of the cache of compiled expressions.
+     */
+    struct CompileCacheStatistics
+    {
+        /// @brief Number of compilations answered with a cached compiled expression.
+        size_t hits = 0;
+
+        /// @brief Number of compilations answered with a cached failure.
+        size_t failureHits = 0;
+
+        /// @brief Number of compilations which actually compiled the expression.
+        size_t misses = 0;
+
+        /// @brief Number of cached compiled expressions.
+        size_t size = 0;
+
+        /// @brief Number of cached failures, including expired ones not evicted yet.
+        size_t failureSize = 0;
+    };
+
+} // namespace s2e2
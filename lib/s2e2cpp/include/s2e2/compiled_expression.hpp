@@ -0,0 +1,108 @@
+#pragma once
+
+#include <s2e2/expression_cost.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    class Program;
+
+    /**
+     * @brief Statistics of one operand of a chain of && or || collected on sampled evaluations.
+     */
+    struct OperandStatistics
+    {
+        /// @brief Can the operand be moved: it has no side effects and cannot fail.
+        bool reorderable = false;
+
+        /// @brief Number of sampled evaluations of the operand.
+        uint64_t evaluations = 0;
+
+        /// @brief Number of sampled evaluations into true.
+        uint64_t passes = 0;
+
+        /// @brief Average time of one evaluation in nanoseconds.
+        double averageNanoseconds = 0.0;
+    };
+
+    /**
+     * @brief Statistics and current evaluation order of one chain of && or ||, e.g. A && B && C.
+     */
+    struct ChainStatistics
+    {
+        /// @brief Is it a chain of && rather than ||.
+        bool conjunction = true;
+
+        /// @brief Number of evaluations of the chain.
+        uint64_t evaluations = 0;
+
+        /// @brief Statistics of operands in source order.
+        std::vector<OperandStatistics> operands;
+
+        /// @brief Indices of operands in the order they are evaluated now.
+        std::vector<size_t> order;
+    };
+
+    /**
+     * @class CompiledExpression
+     * @brief Expression which is already tokenized, converted and bound to functions and operators of an evaluator.
+     * @details Is cheap to copy. Must not outlive the evaluator which compiled it.
+     */
+    class CompiledExpression final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] program - Compiled program of the expression.
+         */
+        explicit CompiledExpression(std::shared_ptr<const Program> program);
+
+        /**
+         * @brief Get source expression.
+         * @returns Source expression.
+         */
+        const std::string& expression() const;
+
+        /**
+         * @brief Get names of variables the expression is compiled with.
+         * @returns Names of variables in the order of their indices.
+         */
+        const std::vector<std::string>& variables() const;
+
+        /**
+         * @brief Get compiled program of the expression.
+         * @returns Compiled program.
+         */
+        const Program& program() const;
+
+        /**
+         * @brief Get static cost estimate of the expression.
+         * @returns Cost estimate computed on compilation.
+         */
+        const ExpressionCost& cost() const;
+
+        /**
+         * @brief Get statistics of chains of && and || reordered by adaptive reordering.
+         * @details Outer chains go before chains nested into their operands.
+         * @returns Statistics, empty if the expression is compiled without adaptive reordering.
+         */
+        std::vector<ChainStatistics> chainStatistics() const;
+
+        /**
+         * @brief Forget collected statistics and restore source order of all chains.
+         * @details Statistics are shared by all copies of the expression.
+         */
+        void resetStatistics() const;
+
+    private:
+        /// @brief Compiled program of the expression.
+        std::shared_ptr<const Program> program_;
+    };
+
+} // namespace s2e2
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 
@@ -11,7 +12,7 @@ namespace s2e2
      * @brief Error thrown from inside the s2e2 library.
      * @details Is a subsclass of std::runtime_error.
      */
-    class Error final : public std::runtime_error
+    class Error : public std::runtime_error
     {
     public:
         /**
@@ -27,4 +28,60 @@ namespace s2e2
         explicit Error(const char* message);
     };
 
+    /**
+     * @class AbortedError
+     * @brief Error of an evaluation stopped by its cancellation token or deadline.
+     * @details Aborts the whole call of the evaluator rather than failing a single record or rule.
+     */
+    class AbortedError final : public Error
+    {
+    public:
+        /**
+         * @brief Reason of aborting.
+         */
+        enum class Reason
+        {
+            CANCELLED,        ///< Cancellation token is cancelled.
+            DEADLINE_EXCEEDED ///< Timeout or deadline is exceeded.
+        };
+
+        /**
+         * @brief Construct the error object.
+         * @param[in] reason - Reason of aborting.
+         */
+        explicit AbortedError(Reason reason);
+
+        /**
+         * @brief Get reason of aborting.
+         * @returns Reason.
+         */
+        Reason reason() const;
+
+    private:
+        /// @brief Reason of aborting.
+        Reason reason_;
+    };
+
+    /**
+     * @class SizeLimitError
+     * @brief Error of a string value growing over the limit.
+     * @details Fails the record or rule producing the value, like any other evaluation error.
+     */
+    class SizeLimitError final : public Error
+    {
+    public:
+        /**
+         * @brief Construct the error object.
+         * @param[in] size - Size of the value in bytes.
+         * @param[in] limit - Maximal size in bytes.
+         */
+        SizeLimitError(size_t size, size_t limit);
+
+        /**
+         * @brief Construct the error object.
+         * @param[in] message - Exception description as a C++ string.
+         */
+        explicit SizeLimitError(const std::string& message);
+    };
+
 } // namespace s2e2
@@ -1,12 +1,29 @@
 #pragma once
 
+#include <s2e2/compile_cache.hpp>
+#include <s2e2/compiled_expression.hpp>
+#include <s2e2/execution_limits.hpp>
+#include <s2e2/expression_cost.hpp>
+#include <s2e2/expression_graph.hpp>
 #include <s2e2/function.hpp>
 #include <s2e2/operator.hpp>
+#include <s2e2/record_batch.hpp>
+#include <s2e2/registry.hpp>
+#include <s2e2/rule_set.hpp>
+#include <s2e2/session.hpp>
+#include <s2e2/span.hpp>
+#include <s2e2/status.hpp>
+#include <s2e2/thread_pool.hpp>
+#include <s2e2/tracer.hpp>
 
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 namespace s2e2
@@ -23,6 +40,14 @@ namespace s2e2
          */
         Evaluator();
 
+        /**
+         * @brief Construct the evaluator sharing functions and operators of the registry.
+         * @details Nothing is copied, so construction takes the same time whatever the size of the registry.
+         *          Functions and operators added to the evaluator afterwards go to its private copy of the registry.
+         * @param[in] registry - Registry of functions and operators.
+         */
+        explicit Evaluator(const Registry& registry);
+
         /**
          * @brief Destructor.
          */
@@ -32,7 +57,7 @@ namespace s2e2
          * @brief Add function to set of supported functions.
          * @param[in] fn - Pointer to new supported function.
          * @throws std::invalid_argument if pointer is empty.
-         * @throws Error if function or operator with the same name is already added.
+         * @throws Error if function or operator with the same name is already added or the evaluator is frozen.
          */
         void addFunction(std::unique_ptr<Function>&& fn);
 
@@ -40,7 +65,7 @@ namespace s2e2
          * @brief Add operator to set of supported operators.
          * @param[in] op - Pointer to new supported operator.
          * @throws std::invalid_argument if pointer is empty.
-         * @throws Error if function or operator with the same name is already added.
+         * @throws Error if function or operator with the same name is already added or the evaluator is frozen.
          */
         void addOperator(std::unique_ptr<Operator>&& op);
 
@@ -56,6 +81,21 @@ namespace s2e2
          */
         void addStandardOperators();
 
+        /**
+         * @brief Make the set of functions and operators final and build compact lookup tables of their names.
+         * @details Names are looked up by a perfect hash and operators inside words are found by a precomputed
+         *          automaton. Expressions are tokenized the same way as before. Adding functions or operators
+         *          afterwards throws Error. Freezing twice does nothing.
+         *          A registry shared with other evaluators or registries is frozen for all of them.
+         */
+        void freeze();
+
+        /**
+         * @brief Check if functions and operators are frozen.
+         * @returns true if freeze() was called.
+         */
+        bool frozen() const;
+
         /**
          * @brief Get collection of pointers to all supported functions.
          * @returns Collection of pointers to functions.
@@ -68,14 +108,274 @@ namespace s2e2
          */
         std::unordered_set<const Operator*> getOperators() const;
 
+        /**
+         * @brief Get the registry of functions and operators to share it with other evaluators.
+         * @returns Registry sharing the set of functions and operators with the evaluator.
+         */
+        Registry registry() const;
+
+        /**
+         * @brief Set tracer to record compile, evaluate and function invocation spans into.
+         * @details The same tracer can be shared by evaluators working in different threads.
+         * @param[in] tracer - Tracer, can be empty to disable tracing.
+         */
+        void setTracer(std::shared_ptr<Tracer> tracer);
+
+        /**
+         * @brief Set number of threads evaluating independent parts of work in parallel.
+         * @details Starts a new thread pool with default settings owned by the evaluator.
+         *          By default the calling thread does all work.
+         * @param[in] numberOfThreads - Number of threads including the calling one, zero means one per core.
+         */
+        void setNumberOfThreads(size_t numberOfThreads);
+
+        /**
+         * @brief Set thread pool splitting batches, rule sets and graphs between its threads.
+         * @details The same pool can be shared by several evaluators.
+         * @param[in] pool - Thread pool, can be empty to do all work in the calling thread.
+         */
+        void setThreadPool(std::shared_ptr<ThreadPool> pool);
+
+        /**
+         * @brief Set memory resource the evaluation arenas take their memory from.
+         * @details Every thread of the evaluator keeps an arena of intermediate strings of vectorized batches,
+         *          which is reset after every vector and reuses its memory. The resource is called only when an
+         *          arena grows. It must outlive the evaluator and be thread-safe if the evaluator uses several threads.
+         * @param[in] resource - Memory resource, null for std::pmr::get_default_resource().
+         */
+        void setMemoryResource(std::pmr::memory_resource* resource);
+
+        /**
+         * @brief Turn short-circuit evaluation of &&, || and IF on or off for record by record evaluation.
+         * @details When on, the right operand of && and || is evaluated only if the left one does not decide the
+         *          value and IF evaluates only the returned branch, so skipped operands neither fail nor call their
+         *          functions. When off, every argument is evaluated before the call. Vectorized batches, rule sets,
+         *          sessions and expression graphs always short-circuit. Off by default.
+         * @param[in] enabled - Is short-circuit evaluation on.
+         */
+        void setShortCircuit(bool enabled);
+
+        /**
+         * @brief Turn adaptive reordering of chains of && and || on or off for expressions compiled afterwards.
+         * @details Such expressions sample cost and pass rate of every operand of a chain and periodically move
+         *          cheap and decisive operands forward. Only operands which cannot fail and have no side effects are
+         *          moved, so values and errors are the same as in the source order. Applies to record by record
+         *          evaluation with short-circuit evaluation on, vectorized batches keep the source order.
+         *          Off by default.
+         * @param[in] enabled - Is reordering on.
+         */
+        void setAdaptiveReordering(bool enabled);
+
+        /**
+         * @brief Set limits of expressions compiled afterwards, including ones evaluated right from strings.
+         * @details Cost of an expression is estimated on compilation, see CompiledExpression::cost().
+         *          An expression exceeding any limit is rejected before it ever runs.
+         * @param[in] limits - Limits, zero values mean no limit.
+         */
+        void setLimits(const ExpressionLimits& limits);
+
+        /**
+         * @brief Set limits of every following evaluation, including batches, rule sets and expression graphs.
+         * @details Cancellation and deadline are checked between instructions and inside REPLACE after every match.
+         *          An exceeded deadline or a cancelled token aborts the whole call with AbortedError.
+         *          A string growing over the size limit throws SizeLimitError, which fails only the record or
+         *          the rule producing it, like any other evaluation error. Timeout is counted from the start of
+         *          every call. Sessions are not limited.
+         * @param[in] limits - Limits, zero values mean no limit.
+         */
+        void setExecutionLimits(const ExecutionLimits& limits);
+
+        /**
+         * @brief Set options of the cache of compiled expressions, dropping everything cached.
+         * @details compile, tryCompile and evaluation of expressions right from strings look the expression and
+         *          names of variables up in the cache first. Compile failures are cached separately with their own
+         *          capacity and TTL, so a repeated invalid expression fails with the same error, message and
+         *          position without being tokenized again. Identical compilations share one compiled expression,
+         *          including statistics of its adaptive chains. Adding functions or operators, changing limits or
+         *          adaptive reordering drops everything cached. The cache is off by default.
+         * @param[in] options - Options, zero capacities disable the cache.
+         */
+        void setCompileCache(const CompileCacheOptions& options);
+
+        /**
+         * @brief Get counters of the cache of compiled expressions.
+         * @returns Counters of hits, misses and cached entries since the cache was set.
+         */
+        CompileCacheStatistics compileCacheStatistics() const;
+
         /**
          * @brief Evaluate the expression.
          * @param[in] expression - Input expression.
          * @returns Value of expression as a string or empty value if the result is NULL.
          * @throws Error in case of an invalid expression.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
          */
         std::optional<std::string> evaluate(const std::string& expression) const;
 
+        /**
+         * @brief Check without tokenizing the expression if it evaluates to itself as a string literal.
+         * @details The expression is a literal if it has no operators, brackets, commas and quotes,
+         *          and none of its words is a function. Evaluation of such an expression returns it unchanged,
+         *          so the check lets the caller skip evaluation and copying of the string.
+         * @param[in] expression - Input expression.
+         * @returns The same expression if it is a literal within the limits, empty value otherwise.
+         */
+        std::optional<std::string_view> asLiteral(std::string_view expression) const;
+
+        /**
+         * @brief Compile the expression once to evaluate it many times.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled expression. It must not outlive the evaluator.
+         * @throws Error in case of an invalid expression.
+         */
+        CompiledExpression compile(const std::string& expression, const std::vector<std::string>& variables = {}) const;
+
+        /**
+         * @brief Evaluate the compiled expression.
+         * @param[in] expression - Compiled expression.
+         * @param[in] values - Values of the variables in the order they were passed to compile.
+         * @returns Value of expression as a string or empty value if the result is NULL.
+         * @throws std::invalid_argument if number of values does not match number of variables.
+         * @throws Error in case of an invalid expression.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
+         */
+        std::optional<std::string> evaluate(const CompiledExpression& expression,
+                                            const std::vector<VariableValue>& values = {}) const;
+
+        /**
+         * @brief Compile the expression without throwing.
+         * @details The status of an invalid expression has the same message as the exception thrown by compile
+         *          and the offset of the token the error is found at, if it is bound to a token.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled expression or error status.
+         */
+        Result<CompiledExpression> tryCompile(const std::string& expression,
+                                              const std::vector<std::string>& variables = {}) const;
+
+        /**
+         * @brief Evaluate the expression without throwing.
+         * @details Exceptions of custom functions and operators are reported as CALL_FAILED.
+         * @param[in] expression - Input expression.
+         * @returns Value of expression as a string or empty value if the result is NULL, or error status.
+         */
+        Result<std::optional<std::string>> tryEvaluate(const std::string& expression) const;
+
+        /**
+         * @brief Evaluate the compiled expression without throwing.
+         * @details Errors of functions and operators have the offset of their call in the source expression.
+         *          Exceptions of custom functions and operators are reported as CALL_FAILED.
+         * @param[in] expression - Compiled expression.
+         * @param[in] values - Values of the variables in the order they were passed to compile.
+         * @returns Value of expression as a string or empty value if the result is NULL, or error status.
+         */
+        Result<std::optional<std::string>> tryEvaluate(const CompiledExpression& expression,
+                                                       const std::vector<VariableValue>& values = {}) const;
+
+        /**
+         * @brief Evaluate the compiled expression for every record of the batch.
+         * @details Does not throw on invalid records, reports them through statuses instead.
+         * @param[in] expression - Compiled expression.
+         * @param[in] records - Values of the variables for every record.
+         * @param[out] results - Values of expression, one per record (empty value for NULL or failed record).
+         * @param[out] statuses - Outcomes of evaluation, one per record.
+         * @param[in] mode - Execution mode, both modes produce identical results.
+         * @returns Number of records which failed to evaluate.
+         * @throws std::invalid_argument if batch dimensions do not match the expression or outputs.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
+         */
+        size_t evaluateBatch(const CompiledExpression& expression,
+                             const RecordBatch& records,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses,
+                             ExecutionMode mode = ExecutionMode::SCALAR) const;
+
+        /**
+         * @brief Compile many expressions together, sharing their identical sub-expressions.
+         * @param[in] expressions - Input expressions in priority order.
+         * @param[in] variables - Names of variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled rule set, it can be evaluated by any evaluator.
+         * @throws Error in case of an invalid expression.
+         */
+        RuleSet compileRuleSet(const std::vector<std::string>& expressions,
+                               const std::vector<std::string>& variables = {}) const;
+
+        /**
+         * @brief Evaluate all rules of the rule set for one record.
+         * @details Every shared sub-expression is evaluated at most once. Does not throw on invalid rules,
+         *          reports them through statuses instead.
+         * @param[in] rules - Compiled rule set.
+         * @param[in] values - Values of the variables in the order they were passed to compileRuleSet.
+         * @param[out] results - Values of rules, one per rule (empty value for NULL or failed rule).
+         * @param[out] statuses - Outcomes of evaluation, one per rule.
+         * @returns Number of rules which failed to evaluate.
+         * @throws std::invalid_argument if number of values or size of outputs does not match the rule set.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
+         */
+        size_t evaluateRules(const RuleSet& rules,
+                             const std::vector<VariableValue>& values,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses) const;
+
+        /**
+         * @brief Evaluate rules in priority order until the first one evaluating into a not NULL value.
+         * @details Failed rules are skipped.
+         * @param[in] rules - Compiled rule set.
+         * @param[in] values - Values of the variables in the order they were passed to compileRuleSet.
+         * @returns Matched rule or empty value if no rule matched.
+         * @throws std::invalid_argument if number of values does not match number of variables.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
+         */
+        std::optional<RuleMatch> evaluateFirstMatch(const RuleSet& rules,
+                                                    const std::vector<VariableValue>& values = {}) const;
+
+        /**
+         * @brief Compile named expressions, which can refer to values of each other by their names.
+         * @param[in] fields - Names and expressions of fields.
+         * @param[in] variables - Names of input variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled expression graph. It must not outlive the evaluator.
+         * @throws Error in case of an invalid expression, a name used twice or a cycle of references.
+         */
+        ExpressionGraph compileGraph(const std::vector<std::pair<std::string, std::string>>& fields,
+                                     const std::vector<std::string>& variables = {}) const;
+
+        /**
+         * @brief Evaluate all fields of the graph for one record.
+         * @details Every field is evaluated once after all fields it refers to, independent fields are evaluated in
+         *          parallel. A field referring to a failed field fails too. Does not throw on invalid fields,
+         *          reports them through statuses instead.
+         * @param[in] graph - Compiled expression graph.
+         * @param[in] values - Values of the input variables in the order they were passed to compileGraph.
+         * @param[out] results - Values of fields, one per field (empty value for NULL or failed field).
+         * @param[out] statuses - Outcomes of evaluation, one per field.
+         * @returns Number of fields which failed to evaluate.
+         * @throws std::invalid_argument if number of values or size of outputs does not match the graph.
+         * @throws AbortedError if the evaluation is cancelled or its deadline is exceeded.
+         */
+        size_t evaluateGraph(const ExpressionGraph& graph,
+                             const std::vector<VariableValue>& values,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses) const;
+
+        /**
+         * @brief Start a session evaluating all rules of the rule set for one record updated in place.
+         * @param[in] rules - Compiled rule set.
+         * @param[in] values - Initial values of the variables in the order they were passed to compileRuleSet.
+         * @returns Session with all rules evaluated. It must not outlive the evaluator.
+         * @throws std::invalid_argument if number of values does not match number of variables.
+         */
+        Session startSession(const RuleSet& rules, const std::vector<VariableValue>& values = {}) const;
+
+        /**
+         * @brief Start a session evaluating the expression for one record updated in place.
+         * @param[in] expression - Compiled expression.
+         * @param[in] values - Initial values of the variables in the order they were passed to compile.
+         * @returns Session with the expression evaluated as its only rule. It must not outlive the evaluator.
+         * @throws std::invalid_argument if number of values does not match number of variables.
+         */
+        Session startSession(const CompiledExpression& expression, const std::vector<VariableValue>& values = {}) const;
+
     private:
         /// @brief Nested proxy of real evaluator implementation.
         class Impl;
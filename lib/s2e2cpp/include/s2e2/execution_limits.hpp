@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+
+namespace s2e2
+{
+    /**
+     * @class CancellationToken
+     * @brief Flag cancelling evaluations from another thread.
+     * @details Evaluations check the flag between instructions and inside long-running functions,
+     *          a cancelled evaluation throws AbortedError.
+     */
+    class CancellationToken final
+    {
+    public:
+        /**
+         * @brief Cancel all evaluations using the token, including ones started afterwards.
+         */
+        void cancel();
+
+        /**
+         * @brief Check if the token is cancelled.
+         * @returns true if the token is cancelled.
+         */
+        bool isCancelled() const;
+
+        /**
+         * @brief Make the token usable again.
+         */
+        void reset();
+
+    private:
+        /// @brief Is the token cancelled.
+        std::atomic<bool> cancelled_{false};
+    };
+
+    /**
+     * @brief Limits of every evaluation of an evaluator, zero means no limit.
+     */
+    struct ExecutionLimits
+    {
+        /// @brief Maximal duration of one call of the evaluator, counted from its start.
+        std::chrono::nanoseconds timeout{0};
+
+        /// @brief Point in time every evaluation must finish by.
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+        /// @brief Maximal size of any intermediate or final string value in bytes.
+        size_t maxStringSize = 0;
+
+        /// @brief Token cancelling evaluations, can be empty.
+        std::shared_ptr<const CancellationToken> cancellation;
+    };
+
+} // namespace s2e2
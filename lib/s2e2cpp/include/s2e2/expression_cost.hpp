@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Static cost estimate of an expression computed on compilation.
+     */
+    struct ExpressionCost
+    {
+        /// @brief Number of tokens of the expression.
+        size_t numberOfTokens = 0;
+
+        /// @brief Maximal number of values on the stack when all arguments are evaluated eagerly.
+        size_t maxStackDepth = 0;
+
+        /// @brief Number of calls and operands on the longest path from the root of the expression to an operand.
+        /// @details Unlike the stack depth it grows with every link of a chain like A || B || C.
+        size_t nestingDepth = 0;
+
+        /// @brief Number of function calls.
+        size_t numberOfFunctionCalls = 0;
+
+        /// @brief Number of operator calls.
+        size_t numberOfOperatorCalls = 0;
+
+        /// @brief Number of calls of every function and operator by its name.
+        std::map<std::string, size_t> calls;
+
+        /// @brief Number of regular expressions, i.e. calls of REPLACE.
+        size_t numberOfRegexes = 0;
+
+        /// @brief Sum of complexities of all regular expressions.
+        /// @details Complexity of a pattern grows with its length, quantifiers, backreferences and especially
+        ///          quantified groups containing quantifiers, which can backtrack exponentially.
+        ///          A pattern computed on evaluation counts as DYNAMIC_REGEX_COMPLEXITY.
+        size_t regexComplexity = 0;
+
+        /// @brief Complexity of a pattern which is not a literal.
+        static constexpr size_t DYNAMIC_REGEX_COMPLEXITY = 10000;
+    };
+
+    /**
+     * @brief Limits of expressions accepted by an evaluator, zero means no limit.
+     */
+    struct ExpressionLimits
+    {
+        /// @brief Maximal length of an expression in bytes, checked before it is tokenized.
+        size_t maxLength = 0;
+
+        /// @brief Maximal number of tokens, checked before the expression is compiled.
+        size_t maxTokens = 0;
+
+        /// @brief Maximal depth of the stack when all arguments are evaluated eagerly.
+        size_t maxStackDepth = 0;
+
+        /// @brief Maximal nesting depth of calls.
+        size_t maxNestingDepth = 0;
+
+        /// @brief Maximal number of function and operator calls.
+        size_t maxCalls = 0;
+
+        /// @brief Maximal number of regular expressions.
+        size_t maxRegexes = 0;
+
+        /// @brief Maximal sum of complexities of regular expressions.
+        size_t maxRegexComplexity = 0;
+    };
+
+} // namespace s2e2
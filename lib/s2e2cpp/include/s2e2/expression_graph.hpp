@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    class GraphProgram;
+
+    /**
+     * @class ExpressionGraph
+     * @brief Named expressions, called fields, which can refer to values of each other by their names.
+     * @details References between fields must not form cycles. Every field is evaluated once per record after all
+     *          fields it refers to, fields independent of each other can be evaluated in parallel.
+     *          Is cheap to copy. Must not outlive the evaluator which compiled it.
+     */
+    class ExpressionGraph final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] program - Compiled program of all fields.
+         */
+        explicit ExpressionGraph(std::shared_ptr<const GraphProgram> program);
+
+        /**
+         * @brief Get number of fields.
+         * @returns Number of fields.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get names of fields.
+         * @returns Names of fields in the order they were passed to compileGraph.
+         */
+        const std::vector<std::string>& names() const;
+
+        /**
+         * @brief Get names of input variables the fields are compiled with.
+         * @returns Names of variables in the order of their indices.
+         */
+        std::vector<std::string> variables() const;
+
+        /**
+         * @brief Get fields in an order of evaluation, where every field follows all fields it refers to.
+         * @returns Indices of fields in topological order.
+         */
+        std::vector<size_t> order() const;
+
+        /**
+         * @brief Get compiled program of all fields.
+         * @returns Compiled program.
+         */
+        const GraphProgram& program() const;
+
+    private:
+        /// @brief Compiled program of all fields.
+        std::shared_ptr<const GraphProgram> program_;
+    };
+
+} // namespace s2e2
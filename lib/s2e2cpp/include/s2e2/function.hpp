@@ -1,10 +1,12 @@
 #pragma once
 
+#include <s2e2/invocation_arguments.hpp>
+#include <s2e2/status.hpp>
+
 #include <any>
 #include <cstdint>
 #include <stack>
 #include <string>
-#include <vector>
 
 
 namespace s2e2
@@ -28,6 +30,37 @@ namespace s2e2
          */
         void invoke(std::stack<std::any>& stack) const;
 
+        /**
+         * @brief Invoke the function with the given number of arguments.
+         * @param stack[in, out] - Stack with arguments.
+         * @param numberOfArguments[in] - Number of arguments on the stack top, for variadic functions can be more
+         *                                than the minimal one.
+         * @throws Error in case of wrong number or types of arguments.
+         */
+        void invoke(std::stack<std::any>& stack, size_t numberOfArguments) const;
+
+        /**
+         * @brief Invoke the function with the given number of arguments without throwing on invalid arguments.
+         * @details Errors of tryResult() are reported as statuses, exceptions thrown by result() are not caught.
+         * @param stack[in, out] - Stack with arguments.
+         * @param numberOfArguments[in] - Number of arguments on the stack top.
+         * @param status[out] - Error in case of wrong number or types of arguments.
+         * @returns true if the result is pushed onto the stack.
+         */
+        bool tryInvoke(std::stack<std::any>& stack, size_t numberOfArguments, Status& status) const;
+
+        /**
+         * @brief Get number of the function's arguments.
+         * @returns Number of arguments, the minimal one for variadic functions.
+         */
+        size_t numberOfArguments() const;
+
+        /**
+         * @brief Check if the function accepts any number of arguments not less than numberOfArguments().
+         * @returns true if the function is variadic, false otherwise.
+         */
+        bool isVariadic() const;
+
     protected:
         /**
          * @brief Constructor.
@@ -36,6 +69,14 @@ namespace s2e2
          */
         Function(std::string functionName, const uint_fast16_t numberOfArguments);
 
+        /**
+         * @brief Constructor of a function which can be variadic.
+         * @param functionName[in] - Function's name.
+         * @param numberOfArguments[in] - Number of arguments, the minimal one for a variadic function.
+         * @param variadic[in] - Does the function accept more arguments than numberOfArguments.
+         */
+        Function(std::string functionName, const uint_fast16_t numberOfArguments, const bool variadic);
+
         /**
          * @brief Check if arguments are correct.
          * @returns true is arguments are correct, false otherwise.
@@ -48,13 +89,29 @@ namespace s2e2
          */
         virtual std::any result() const = 0;
 
+        /**
+         * @brief Calculate result of the function without throwing on errors it finds itself.
+         * @details The default one just calls result(), built-ins which check limits override it.
+         * @param value[out] - Result.
+         * @param status[out] - Error in case of failure.
+         * @returns true if the result is calculated.
+         */
+        virtual bool tryResult(std::any& value, Status& status) const;
+
     public:
         /// @brief Function's name.
         const std::string name;
 
     protected:
-        /// @brief Vector of arguments.
-        mutable std::vector<std::any> arguments_;
+        /// @brief Arguments of the current invocation, valid only inside checkArguments() and result().
+        static constexpr InvocationArguments arguments_{};
+
+    private:
+        /// @brief Number of arguments, the minimal one for a variadic function.
+        const size_t numberOfArguments_;
+
+        /// @brief Does the function accept more arguments than numberOfArguments_.
+        const bool variadic_;
     };
 
 } // namespace s2e2
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <s2e2/function.hpp>
+
+#include <any>
+
+
+namespace s2e2
+{
+    /**
+     * @class FunctionConcat
+     * @brief Function CONCAT(<string1>, <string2>, ...)
+     * @details Concatenates two or more strings with a single allocation. Returns the same as a chain of + does:
+     *          NULL arguments are skipped and the result is NULL only if all arguments are NULL.
+     */
+    class FunctionConcat final : public Function
+    {
+    public:
+        /**
+         * Default constructor.
+         */
+        FunctionConcat();
+
+    private:
+        /**
+         * @brief Check if arguments are correct.
+         * @returns true is arguments are correct, false otherwise.
+         */
+        bool checkArguments() const override;
+
+        /**
+         * @brief Calculate result of the function.
+         * @return Result.
+         */
+        std::any result() const override;
+
+        /**
+         * @brief Calculate result of the function, checking limits of the evaluation without throwing.
+         * @param value[out] - Result.
+         * @param status[out] - Error in case of exceeded limits.
+         * @returns true if the result is calculated.
+         */
+        bool tryResult(std::any& value, Status& status) const override;
+    };
+
+} // namespace s2e2
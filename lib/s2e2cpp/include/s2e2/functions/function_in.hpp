@@ -0,0 +1,38 @@
+#pragma once
+
+#include <s2e2/function.hpp>
+
+#include <any>
+
+
+namespace s2e2
+{
+    /**
+     * @class FunctionIn
+     * @brief Function IN(<value>, <candidate1>, <candidate2>, ...)
+     * @details Returns true if value is equal to any of candidates, false otherwise.
+     *          Takes one or more candidates, NULL is equal only to NULL.
+     */
+    class FunctionIn final : public Function
+    {
+    public:
+        /**
+         * Default constructor.
+         */
+        FunctionIn();
+
+    private:
+        /**
+         * @brief Check if arguments are correct.
+         * @returns true is arguments are correct, false otherwise.
+         */
+        bool checkArguments() const override;
+
+        /**
+         * @brief Calculate result of the function.
+         * @return Result.
+         */
+        std::any result() const override;
+    };
+
+} // namespace s2e2
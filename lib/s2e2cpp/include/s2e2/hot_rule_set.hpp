@@ -0,0 +1,118 @@
+#pragma once
+
+#include <s2e2/registry.hpp>
+#include <s2e2/rule_set.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Version of a registry together with a rule set compiled with it.
+     */
+    struct RuleSetSnapshot
+    {
+        /// @brief Functions and operators to construct evaluators of the version with.
+        Registry registry;
+
+        /// @brief Compiled rules.
+        RuleSet rules;
+
+        /// @brief Number of the version, the first published one is 1.
+        uint64_t version;
+    };
+
+    /**
+     * @class HotRuleSet
+     * @brief Current snapshot of a registry and a rule set which can be replaced while other threads evaluate it.
+     * @details A new snapshot is published by an atomic exchange of the pointer, evaluations of the previous one
+     *          are not disturbed. Readers load the pointer atomically and never take the lock serializing publications.
+     *          A replaced snapshot is freed as soon as the last pointer returned by acquire() is dropped and every
+     *          Reader which returned it has read again, been released or been destroyed.
+     *          Evaluation threads read it through their own Reader, which costs one atomic load of the version unless
+     *          the snapshot has been replaced since its previous read.
+     */
+    class HotRuleSet final
+    {
+    public:
+        /**
+         * @class Reader
+         * @brief Per-thread access to the current snapshot.
+         * @details A reader holds the snapshot it returned last until its next read, so a reader going idle
+         *          should be released or destroyed to let a replaced snapshot be freed.
+         *          Must not be used by several threads at once.
+         */
+        class Reader final
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param[in] source - Snapshots to read, must outlive the reader.
+             */
+            explicit Reader(const HotRuleSet& source);
+
+            /**
+             * @brief Get the current snapshot.
+             * @details Costs one atomic load unless the snapshot has been replaced.
+             * @returns Snapshot, valid until the next call or destruction of the reader.
+             */
+            const RuleSetSnapshot& current();
+
+            /**
+             * @brief Drop the last returned snapshot, the next call of current() loads the current one again.
+             */
+            void release();
+
+        private:
+            /// @brief Snapshots to read.
+            const HotRuleSet& source_;
+
+            /// @brief The last returned snapshot, empty if released.
+            std::shared_ptr<const RuleSetSnapshot> snapshot_;
+        };
+
+        /**
+         * @brief Constructor, publishes the first snapshot.
+         * @param[in] registry - Functions and operators.
+         * @param[in] rules - Rule set compiled with the registry.
+         */
+        HotRuleSet(const Registry& registry, const RuleSet& rules);
+
+        /**
+         * @brief Replace the current snapshot.
+         * @param[in] registry - Functions and operators.
+         * @param[in] rules - Rule set compiled with the registry.
+         * @returns Version of the new snapshot.
+         */
+        uint64_t publish(const Registry& registry, const RuleSet& rules);
+
+        /**
+         * @brief Get the current snapshot, keeping it alive as long as the pointer.
+         * @details Loads the pointer atomically without the lock serializing publications, a Reader avoids even that
+         *          and the reference counting while the snapshot is not replaced.
+         * @returns Snapshot.
+         */
+        std::shared_ptr<const RuleSetSnapshot> acquire() const;
+
+        /**
+         * @brief Get version of the current snapshot.
+         * @returns Version of the snapshot.
+         */
+        uint64_t version() const;
+
+    private:
+        /// @brief Lock serializing publications, readers never take it.
+        std::mutex mutex_;
+
+        /// @brief Current snapshot, accessed only by atomic operations on shared pointers.
+        std::shared_ptr<const RuleSetSnapshot> snapshot_;
+
+        /// @brief Version of the current snapshot, set after the pointer so readers can check it without the lock.
+        std::atomic<uint64_t> version_{0};
+    };
+
+} // namespace s2e2
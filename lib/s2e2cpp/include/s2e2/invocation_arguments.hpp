@@ -0,0 +1,76 @@
+#pragma once
+
+#include <s2e2/span.hpp>
+
+#include <any>
+#include <cstddef>
+
+
+namespace s2e2
+{
+    class InvocationScope;
+
+    /**
+     * @class InvocationArguments
+     * @brief Arguments of the innermost function or operator invocation in progress on the calling thread.
+     * @details Every invocation keeps its arguments in its own buffer, released as soon as the invocation ends.
+     *          So result() can invoke other functions and operators, and one object can be invoked by several
+     *          threads at once.
+     */
+    class InvocationArguments final
+    {
+    public:
+        /**
+         * @brief Access argument by its index.
+         * @param[in] index - Index of the argument.
+         * @returns Reference to the argument, the callee can move it out.
+         */
+        std::any& operator[](size_t index) const noexcept
+        {
+            return current_[index];
+        }
+
+        /**
+         * @brief Get number of arguments.
+         * @returns Number of arguments.
+         */
+        size_t size() const noexcept
+        {
+            return current_.size();
+        }
+
+        /**
+         * @brief Check if there are no arguments.
+         * @returns true if there are no arguments, false otherwise.
+         */
+        bool empty() const noexcept
+        {
+            return current_.empty();
+        }
+
+        /**
+         * @brief Get iterator to the first argument.
+         * @returns Iterator.
+         */
+        std::any* begin() const noexcept
+        {
+            return current_.begin();
+        }
+
+        /**
+         * @brief Get iterator past the last argument.
+         * @returns Iterator.
+         */
+        std::any* end() const noexcept
+        {
+            return current_.end();
+        }
+
+    private:
+        friend class InvocationScope;
+
+        /// @brief Arguments of the innermost invocation in progress on this thread.
+        static thread_local Span<std::any> current_;
+    };
+
+} // namespace s2e2
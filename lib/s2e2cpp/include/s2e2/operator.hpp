@@ -1,10 +1,12 @@
 #pragma once
 
+#include <s2e2/invocation_arguments.hpp>
+#include <s2e2/status.hpp>
+
 #include <any>
 #include <cstdint>
 #include <stack>
 #include <string>
-#include <vector>
 
 
 namespace s2e2
@@ -28,6 +30,21 @@ namespace s2e2
          */
         void invoke(std::stack<std::any>& stack) const;
 
+        /**
+         * @brief Invoke the operator without throwing on invalid arguments.
+         * @details Errors of tryResult() are reported as statuses, exceptions thrown by result() are not caught.
+         * @param stack[in, out] - Stack with arguments.
+         * @param status[out] - Error in case of wrong number or types of arguments.
+         * @returns true if the result is pushed onto the stack.
+         */
+        bool tryInvoke(std::stack<std::any>& stack, Status& status) const;
+
+        /**
+         * @brief Get number of the operator's arguments.
+         * @returns Number of arguments.
+         */
+        size_t numberOfArguments() const;
+
     protected:
         /**
          * @brief Constructor.
@@ -51,6 +68,15 @@ namespace s2e2
          */
         virtual std::any result() const = 0;
 
+        /**
+         * @brief Calculate result of the operator without throwing on errors it finds itself.
+         * @details The default one just calls result(), built-ins which check limits override it.
+         * @param value[out] - Result.
+         * @param status[out] - Error in case of failure.
+         * @returns true if the result is calculated.
+         */
+        virtual bool tryResult(std::any& value, Status& status) const;
+
     public:
         /// @brief Operator's name.
         const std::string name;
@@ -59,8 +85,12 @@ namespace s2e2
         const uint_fast16_t priority;
 
     protected:
-        /// @brief Vector of arguments.
-        mutable std::vector<std::any> arguments_;
+        /// @brief Arguments of the current invocation, valid only inside checkArguments() and result().
+        static constexpr InvocationArguments arguments_{};
+
+    private:
+        /// @brief Number of arguments.
+        const size_t numberOfArguments_;
     };
 
 } // namespace s2e2
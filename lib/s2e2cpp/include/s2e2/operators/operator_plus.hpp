@@ -32,6 +32,14 @@ namespace s2e2
          * @return Result.
          */
         std::any result() const override;
+
+        /**
+         * @brief Calculate result of the operator, checking limits of the evaluation without throwing.
+         * @param value[out] - Result.
+         * @param status[out] - Error in case of exceeded limits.
+         * @returns true if the result is calculated.
+         */
+        bool tryResult(std::any& value, Status& status) const override;
     };
 
 } // namespace s2e2
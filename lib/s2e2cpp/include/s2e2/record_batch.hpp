@@ -0,0 +1,196 @@
+#pragma once
+
+#include <s2e2/span.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+
+namespace s2e2
+{
+    /// @brief Value of a variable bound to a compiled expression, empty value means NULL.
+    using VariableValue = std::optional<std::string_view>;
+
+    /**
+     * @brief Outcome of evaluation of one record within a batch.
+     */
+    enum class RecordStatus : uint8_t
+    {
+        OK,     ///< Record is evaluated, the result is valid.
+        ERROR   ///< Evaluation failed, the result is empty.
+    };
+
+    /**
+     * @brief How a batch of records is evaluated.
+     */
+    enum class ExecutionMode : uint8_t
+    {
+        SCALAR,     ///< Every record is evaluated separately.
+        VECTORIZED  ///< Every instruction processes a whole vector of records at once.
+    };
+
+    /**
+     * @class BatchColumn
+     * @brief Non-owning view of values of one variable for all records of a columnar batch.
+     * @details Values are either stored one per record or dictionary encoded: every record holds an index (code)
+     *          of its value within the dictionary of distinct values. Dictionary encoding suits variables with
+     *          few distinct values, comparisons of such variables with literals become comparisons of codes.
+     */
+    class BatchColumn final
+    {
+    public:
+        /**
+         * @brief Make column of plain values.
+         * @param[in] values - Value of the variable for every record.
+         */
+        BatchColumn(Span<const VariableValue> values);
+
+        /**
+         * @brief Make column of plain values stored in the contiguous container (std::vector, std::array, etc.).
+         * @tparam Container - Type of the container.
+         * @param[in] values - Value of the variable for every record.
+         */
+        template <class Container>
+        BatchColumn(const Container& values)
+            : BatchColumn(Span<const VariableValue>{values.data(), values.size()})
+        {
+        }
+
+        /**
+         * @brief Make dictionary encoded column.
+         * @param[in] dictionary - Distinct values of the variable, NULL can be one of them.
+         * @param[in] codes - Index of the value within the dictionary for every record.
+         * @returns Column.
+         */
+        static BatchColumn dictionary(Span<const VariableValue> dictionary, Span<const uint32_t> codes);
+
+    private:
+        friend class RecordBatch;
+
+        /**
+         * @brief Constructor.
+         * @param[in] values - Plain values or dictionary.
+         * @param[in] codes - Codes of values, empty for plain values.
+         * @param[in] encoded - Is the column dictionary encoded.
+         */
+        BatchColumn(Span<const VariableValue> values, Span<const uint32_t> codes, bool encoded);
+
+    private:
+        /// @brief Plain values or dictionary.
+        Span<const VariableValue> values_;
+
+        /// @brief Codes of values, empty for plain values.
+        Span<const uint32_t> codes_;
+
+        /// @brief Is the column dictionary encoded.
+        bool encoded_;
+    };
+
+    /**
+     * @class RecordBatch
+     * @brief Non-owning view of values of variables for a batch of records.
+     * @details Values can be laid out either row by row or column by column (one column per variable).
+     *          Variables are indexed in the same order they were passed to Evaluator::compile.
+     */
+    class RecordBatch final
+    {
+    public:
+        /**
+         * @brief Make batch of records laid out row by row.
+         * @param[in] values - Values of all variables of the first record, then of the second one, etc.
+         * @param[in] numberOfRecords - Number of records.
+         * @param[in] numberOfVariables - Number of variables in every record.
+         * @returns Batch of records.
+         * @throws std::invalid_argument if number of values does not match batch dimensions.
+         */
+        static RecordBatch rowMajor(Span<const VariableValue> values, size_t numberOfRecords, size_t numberOfVariables);
+
+        /**
+         * @brief Make batch of records laid out column by column.
+         * @param[in] columns - Values of every variable for all records, plain or dictionary encoded.
+         * @param[in] numberOfRecords - Number of records.
+         * @returns Batch of records.
+         * @throws std::invalid_argument if size of some column differs from number of records, some code is out of
+         *                              its dictionary or some dictionary contains the same value twice.
+         */
+        static RecordBatch columnar(const std::vector<BatchColumn>& columns, size_t numberOfRecords);
+
+        /**
+         * @brief Get number of records.
+         * @returns Number of records.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get number of variables in every record.
+         * @returns Number of variables.
+         */
+        size_t numberOfVariables() const;
+
+        /**
+         * @brief Get value of the variable within the record.
+         * @param[in] record - Index of the record.
+         * @param[in] variable - Index of the variable.
+         * @returns Value of the variable.
+         */
+        const VariableValue& value(size_t record, size_t variable) const
+        {
+            const auto& column = columns_[variable];
+            if (column.codes)
+            {
+                return column.data[column.codes[record]];
+            }
+            return column.data[record * column.stride];
+        }
+
+        /**
+         * @brief Get dictionary of the variable.
+         * @param[in] variable - Index of the variable.
+         * @returns Distinct values of the variable if it is dictionary encoded, empty span otherwise.
+         */
+        Span<const VariableValue> dictionary(size_t variable) const;
+
+        /**
+         * @brief Get codes of values of the variable.
+         * @param[in] variable - Index of the variable.
+         * @returns Code of every record if the variable is dictionary encoded, empty span otherwise.
+         */
+        Span<const uint32_t> codes(size_t variable) const;
+
+    private:
+        /**
+         * @brief Values of one variable for all records.
+         */
+        struct Column
+        {
+            /// @brief Pointer to the value within the first record or to the dictionary.
+            const VariableValue* data;
+
+            /// @brief Distance between values of consecutive records.
+            size_t stride;
+
+            /// @brief Codes of values within data if the variable is dictionary encoded, nullptr otherwise.
+            const uint32_t* codes = nullptr;
+
+            /// @brief Number of values in the dictionary.
+            size_t dictionarySize = 0;
+        };
+
+        /**
+         * @brief Constructor.
+         * @param[in] columns - Values of every variable.
+         * @param[in] numberOfRecords - Number of records.
+         */
+        RecordBatch(std::vector<Column> columns, size_t numberOfRecords);
+
+    private:
+        /// @brief Values of every variable.
+        std::vector<Column> columns_;
+
+        /// @brief Number of records.
+        size_t size_;
+    };
+
+} // namespace s2e2
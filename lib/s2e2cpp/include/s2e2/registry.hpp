@@ -0,0 +1,111 @@
+#pragma once
+
+#include <s2e2/function.hpp>
+#include <s2e2/operator.hpp>
+
+#include <memory>
+#include <unordered_set>
+
+
+namespace s2e2
+{
+    class RegistryImpl;
+
+    /**
+     * @class Registry
+     * @brief Set of functions and operators which many evaluators can share instead of building their own.
+     * @details Copies of a registry and evaluators using it share one immutable set of functions and operators
+     *          together with lookup tables of their names. Adding to a shared registry, through a copy or through
+     *          an evaluator, first makes a private copy, so other owners never see the change. Functions and
+     *          operators themselves are not copied. Compiled expressions keep their registry alive.
+     */
+    class Registry final
+    {
+    public:
+        /**
+         * @brief Construct the empty registry.
+         */
+        Registry();
+
+        /**
+         * @brief Destructor.
+         */
+        ~Registry();
+
+        /**
+         * @brief Copy constructor, shares the set of functions and operators.
+         */
+        Registry(const Registry& other);
+
+        /**
+         * @brief Copy assignment, shares the set of functions and operators.
+         */
+        Registry& operator=(const Registry& other);
+
+        /**
+         * @brief Add function to set of supported functions.
+         * @param[in] fn - Pointer to new supported function.
+         * @throws std::invalid_argument if pointer is empty.
+         * @throws Error if function or operator with the same name is already added or the registry is frozen.
+         */
+        void addFunction(std::unique_ptr<Function>&& fn);
+
+        /**
+         * @brief Add operator to set of supported operators.
+         * @param[in] op - Pointer to new supported operator.
+         * @throws std::invalid_argument if pointer is empty.
+         * @throws Error if function or operator with the same name is already added or the registry is frozen.
+         */
+        void addOperator(std::unique_ptr<Operator>&& op);
+
+        /**
+         * @brief Add standard functions to set of supported functions.
+         * @throws Error if there is a collision between functions names.
+         */
+        void addStandardFunctions();
+
+        /**
+         * @brief Add standard operators to set of supported operators.
+         * @throws Error if there is a collision between operators names.
+         */
+        void addStandardOperators();
+
+        /**
+         * @brief Make the set of functions and operators final and build compact lookup tables of their names.
+         * @details The set is frozen for all owners sharing it, so nothing can be added through any of them.
+         *          Must not be called while other threads compile expressions with the registry.
+         */
+        void freeze();
+
+        /**
+         * @brief Check if functions and operators are frozen.
+         * @returns true if freeze() was called.
+         */
+        bool frozen() const;
+
+        /**
+         * @brief Get collection of pointers to all supported functions.
+         * @returns Collection of pointers to functions.
+         */
+        std::unordered_set<const Function*> getFunctions() const;
+
+        /**
+         * @brief Get collection of pointers to all supported operators.
+         * @returns Collection of pointers to operators.
+         */
+        std::unordered_set<const Operator*> getOperators() const;
+
+    private:
+        friend class Evaluator;
+
+        /**
+         * @brief Construct the registry sharing the set of functions and operators.
+         * @param[in] impl - Real registry.
+         */
+        explicit Registry(std::shared_ptr<RegistryImpl> impl);
+
+        /// @brief Real registry, shared with copies and evaluators using it.
+        std::shared_ptr<RegistryImpl> impl_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    class RuleProgram;
+
+    /**
+     * @brief Rule which matched a record first.
+     */
+    struct RuleMatch
+    {
+        /// @brief Index of the rule in the rule set.
+        size_t rule;
+
+        /// @brief Value of the rule.
+        std::string value;
+    };
+
+    /**
+     * @class RuleSet
+     * @brief Many expressions compiled together so that their identical sub-expressions are shared.
+     * @details Rules are kept in priority order: the first rule has the highest priority.
+     *          Is cheap to copy. Keeps functions and operators of its rules alive, so it can outlive the evaluator
+     *          which compiled it and can be evaluated by any evaluator.
+     */
+    class RuleSet final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] program - Compiled program of all rules.
+         */
+        explicit RuleSet(std::shared_ptr<const RuleProgram> program);
+
+        /**
+         * @brief Get number of rules.
+         * @returns Number of rules.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get source expressions of rules.
+         * @returns Source expressions in priority order.
+         */
+        const std::vector<std::string>& expressions() const;
+
+        /**
+         * @brief Get names of variables the rules are compiled with.
+         * @returns Names of variables in the order of their indices.
+         */
+        const std::vector<std::string>& variables() const;
+
+        /**
+         * @brief Get number of distinct sub-expressions of all rules.
+         * @returns Number of distinct sub-expressions.
+         */
+        size_t numberOfNodes() const;
+
+        /**
+         * @brief Get number of nodes of the decision DAG selecting rules which can match a record.
+         * @returns Number of decision nodes, one if no rule has guards.
+         */
+        size_t numberOfDecisionNodes() const;
+
+        /**
+         * @brief Get compiled program of all rules.
+         * @returns Compiled program.
+         */
+        const RuleProgram& program() const;
+
+    private:
+        /// @brief Compiled program of all rules.
+        std::shared_ptr<const RuleProgram> program_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <s2e2/record_batch.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    class SessionImpl;
+
+    /**
+     * @class Session
+     * @brief Long-lived record evaluated by rules of a rule set or by a compiled expression.
+     * @details Values of all sub-expressions are cached. When one variable changes only the sub-expressions
+     *          depending on it are evaluated again, and only the rules downstream of them.
+     *          Functions are assumed to be pure: their cached values are reused until their arguments change.
+     *          Must not outlive the evaluator which started it.
+     */
+    class Session final
+    {
+    public:
+        /**
+         * @brief Move constructor.
+         */
+        Session(Session&&) noexcept;
+
+        /**
+         * @brief Move assignment.
+         */
+        Session& operator=(Session&&) noexcept;
+
+        /**
+         * @brief Destructor.
+         */
+        ~Session();
+
+        /**
+         * @brief Get number of rules, one for a session of a compiled expression.
+         * @returns Number of rules.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get names of variables.
+         * @returns Names of variables in the order of their indices.
+         */
+        const std::vector<std::string>& variables() const;
+
+        /**
+         * @brief Set new value of the variable and evaluate again the rules depending on it.
+         * @param[in] variable - Index of the variable.
+         * @param[in] value - New value, the session keeps its copy.
+         * @throws std::invalid_argument if there is no such variable.
+         */
+        void update(size_t variable, VariableValue value);
+
+        /**
+         * @brief Set new value of the variable and evaluate again the rules depending on it.
+         * @param[in] variable - Name of the variable.
+         * @param[in] value - New value, the session keeps its copy.
+         * @throws std::invalid_argument if there is no such variable.
+         */
+        void update(const std::string& variable, VariableValue value);
+
+        /**
+         * @brief Get rules whose value or status is changed by the last update.
+         * @returns Indices of rules in priority order.
+         */
+        const std::vector<size_t>& changedRules() const;
+
+        /**
+         * @brief Get current value of the rule.
+         * @param[in] rule - Index of the rule.
+         * @returns Value of the rule, empty value for NULL or failed rule.
+         * @throws std::invalid_argument if there is no such rule.
+         */
+        const std::optional<std::string>& result(size_t rule = 0) const;
+
+        /**
+         * @brief Get current outcome of evaluation of the rule.
+         * @param[in] rule - Index of the rule.
+         * @returns Outcome of evaluation.
+         * @throws std::invalid_argument if there is no such rule.
+         */
+        RecordStatus status(size_t rule = 0) const;
+
+        /**
+         * @brief Get number of sub-expressions evaluated by the last update.
+         * @returns Number of evaluated sub-expressions.
+         */
+        size_t numberOfRecomputedNodes() const;
+
+    private:
+        friend class Evaluator;
+
+        /**
+         * @brief Constructor.
+         * @param[in] impl - Real session.
+         */
+        explicit Session(std::unique_ptr<SessionImpl> impl);
+
+    private:
+        /// @brief Real session.
+        std::unique_ptr<SessionImpl> impl_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+
+
+namespace s2e2
+{
+    /**
+     * @class Span
+     * @brief Non-owning view of a contiguous sequence of objects.
+     * @tparam T - Type of objects.
+     */
+    template <class T>
+    class Span final
+    {
+    public:
+        /**
+         * @brief Construct an empty span.
+         */
+        constexpr Span() noexcept = default;
+
+        /**
+         * @brief Construct the span.
+         * @param[in] data - Pointer to the first object.
+         * @param[in] size - Number of objects.
+         */
+        constexpr Span(T* data, size_t size) noexcept
+            : data_{data}
+            , size_{size}
+        {
+        }
+
+        /**
+         * @brief Construct the span viewing the whole contiguous container (std::vector, std::array, etc.).
+         * @tparam Container - Type of the container.
+         * @param[in] container - Container.
+         */
+        template <class Container>
+        constexpr Span(Container& container) noexcept
+            : data_{container.data()}
+            , size_{container.size()}
+        {
+        }
+
+        /**
+         * @brief Get pointer to the first object.
+         * @returns Pointer to the first object.
+         */
+        constexpr T* data() const noexcept
+        {
+            return data_;
+        }
+
+        /**
+         * @brief Get number of objects.
+         * @returns Number of objects.
+         */
+        constexpr size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Check if the span is empty.
+         * @returns true if there are no objects, false otherwise.
+         */
+        constexpr bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        /**
+         * @brief Access object by its index.
+         * @param[in] index - Index of the object.
+         * @returns Reference to the object.
+         */
+        constexpr T& operator[](size_t index) const noexcept
+        {
+            return data_[index];
+        }
+
+        /**
+         * @brief Get iterator to the first object.
+         * @returns Iterator.
+         */
+        constexpr T* begin() const noexcept
+        {
+            return data_;
+        }
+
+        /**
+         * @brief Get iterator past the last object.
+         * @returns Iterator.
+         */
+        constexpr T* end() const noexcept
+        {
+            return data_ + size_;
+        }
+
+    private:
+        /// @brief Pointer to the first object.
+        T* data_ = nullptr;
+
+        /// @brief Number of objects.
+        size_t size_ = 0;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Code of an error reported without throwing.
+     */
+    enum class ErrorCode
+    {
+        OK,                          ///< No error.
+        UNPAIRED_BRACKET,            ///< Bracket without its pair.
+        UNSUPPORTED_OPERATOR,        ///< Unknown operator.
+        UNSUPPORTED_FUNCTION,        ///< Unknown function.
+        NOT_ENOUGH_ARGUMENTS,        ///< Operator or function lacks arguments.
+        INVALID_NUMBER_OF_ARGUMENTS, ///< Function is called with a wrong number of arguments.
+        INVALID_EXPRESSION,          ///< Expression does not evaluate into exactly one value.
+        DUPLICATE_VARIABLE,          ///< Variable is declared twice.
+        LIMIT_EXCEEDED,              ///< Expression exceeds a limit of the evaluator.
+        INVALID_VARIABLES,           ///< Number of values does not match number of variables.
+        INVALID_ARGUMENTS,           ///< Operator or function is called with arguments of wrong types.
+        NOT_A_STRING,                ///< Value of the expression is neither a string nor NULL.
+        STRING_TOO_LONG,             ///< String grows over the size limit.
+        CANCELLED,                   ///< Evaluation is cancelled.
+        DEADLINE_EXCEEDED,           ///< Evaluation deadline is exceeded.
+        CALL_FAILED                  ///< Custom function or operator throws.
+    };
+
+    /**
+     * @brief Outcome of an operation reported without throwing.
+     */
+    struct Status
+    {
+        /// @brief Position of errors which are not bound to any part of the expression.
+        static constexpr size_t NO_POSITION = std::numeric_limits<size_t>::max();
+
+        /// @brief Error code.
+        ErrorCode code = ErrorCode::OK;
+
+        /// @brief Error message, the same as the one of the exception thrown by the throwing API.
+        std::string message;
+
+        /// @brief Offset in the source expression of the token the error is found at, or NO_POSITION.
+        size_t position = NO_POSITION;
+
+        /**
+         * @brief Check if there is no error.
+         * @returns true if there is no error.
+         */
+        bool ok() const
+        {
+            return code == ErrorCode::OK;
+        }
+    };
+
+    /**
+     * @class Result
+     * @brief Value or error of an operation reported without throwing.
+     * @tparam T - Type of the value.
+     */
+    template <class T>
+    class Result final
+    {
+    public:
+        /**
+         * @brief Construct successful result.
+         * @param[in] value - Value.
+         */
+        Result(T value)
+            : value_{std::move(value)}
+        {
+        }
+
+        /**
+         * @brief Construct failed result.
+         * @param[in] status - Status with an error.
+         */
+        Result(Status status)
+            : status_{std::move(status)}
+        {
+        }
+
+        /**
+         * @brief Check if there is no error.
+         * @returns true if there is no error.
+         */
+        bool ok() const
+        {
+            return status_.ok();
+        }
+
+        /**
+         * @brief Get value of a successful result.
+         * @returns Value.
+         */
+        const T& value() const
+        {
+            return *value_;
+        }
+
+        /**
+         * @brief Get value of a successful result.
+         * @returns Value.
+         */
+        T& value()
+        {
+            return *value_;
+        }
+
+        /**
+         * @brief Get status.
+         * @returns Status, OK for a successful result.
+         */
+        const Status& status() const
+        {
+            return status_;
+        }
+
+    private:
+        /// @brief Value, empty in case of an error.
+        std::optional<T> value_;
+
+        /// @brief Status.
+        Status status_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace s2e2
+{
+    class WorkStealingPool;
+
+    /**
+     * @brief Settings of a thread pool.
+     */
+    struct ThreadPoolOptions
+    {
+        /// @brief Number of threads including the one calling the evaluator, zero means one per core.
+        size_t numberOfThreads = 0;
+
+        /// @brief Number of records of a batch or rules of a rule set evaluated by one task.
+        size_t grainSize = 1024;
+
+        /// @brief CPUs to pin started threads to round robin, empty to leave them to the OS (supported on Linux).
+        std::vector<size_t> affinity;
+    };
+
+    /**
+     * @class ThreadPool
+     * @brief Fixed set of worker threads splitting batch, rule set and graph evaluations across cores.
+     * @details Every worker has its own deque of tasks and steals from others when it runs out of work, so there is
+     *          no global lock on the fast path. The thread calling the evaluator works as one of the workers.
+     *          Outputs are the same and in the same order as with sequential evaluation.
+     *          One pool can be shared by several evaluators, their parallel evaluations are run one at a time.
+     */
+    class ThreadPool final
+    {
+    public:
+        /**
+         * @brief Constructor, starts the threads.
+         * @param[in] options - Settings of the pool.
+         * @throws std::invalid_argument if grain size is zero or some CPU index is out of range.
+         */
+        explicit ThreadPool(const ThreadPoolOptions& options = {});
+
+        /**
+         * @brief Destructor, stops the threads.
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Get number of threads.
+         * @returns Number of threads including the one calling the evaluator.
+         */
+        size_t numberOfThreads() const;
+
+        /**
+         * @brief Get number of records or rules evaluated by one task.
+         * @returns Grain size.
+         */
+        size_t grainSize() const;
+
+    private:
+        friend class Evaluator;
+
+        /// @brief Real pool, shared with evaluators using it.
+        std::shared_ptr<WorkStealingPool> impl_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+
+
+namespace s2e2
+{
+    class TracerImpl;
+
+    /**
+     * @class Tracer
+     * @brief Collects timelines of evaluations and exports them in Chrome trace-event format.
+     * @details Every thread records its spans into its own buffer, so recording does not take any locks.
+     *          One tracer can be shared by several evaluators working in different threads.
+     */
+    class Tracer final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] samplingRate - Share of evaluations to trace, from 0 (none) to 1 (all).
+         * @throws std::invalid_argument if sampling rate is out of range.
+         */
+        explicit Tracer(double samplingRate = 1.0);
+
+        /**
+         * @brief Destructor.
+         */
+        ~Tracer();
+
+        /**
+         * @brief Get share of traced evaluations.
+         * @returns Sampling rate.
+         */
+        double samplingRate() const;
+
+        /**
+         * @brief Write all recorded spans as Chrome trace-event JSON (can be opened in Perfetto).
+         * @details Must not be called while any evaluation using this tracer is in progress.
+         * @param[out] stream - Output stream.
+         */
+        void writeChromeTrace(std::ostream& stream) const;
+
+        /**
+         * @brief Drop all recorded spans.
+         * @details Must not be called while any evaluation using this tracer is in progress.
+         */
+        void clear();
+
+    private:
+        friend class Evaluator;
+
+        /// @brief Real tracer, shared with evaluators using it.
+        std::shared_ptr<TracerImpl> impl_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,343 @@
+#include "adaptive_chains.hpp"
+
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+
+
+namespace // anonymous
+{
+    /// @brief Number of bits of one position of an order.
+    const size_t BITS_PER_POSITION = 4;
+
+    /// @brief Mask of one position of an order.
+    const uint64_t POSITION_MASK = (uint64_t{1} << BITS_PER_POSITION) - 1;
+
+    /**
+     * @brief Values a subtree can evaluate into, if it cannot fail.
+     */
+    enum class Kind : uint8_t
+    {
+        UNKNOWN,        ///< Any value, the subtree can fail or have side effects.
+        STRING_OR_NULL, ///< String or NULL.
+        BOOLEAN         ///< Boolean.
+    };
+
+    /**
+     * @brief Get source order of a chain.
+     * @param[in] numberOfOperands - Number of operands of the chain.
+     * @returns Order of operands.
+     */
+    uint64_t sourceOrder(size_t numberOfOperands)
+    {
+        uint64_t order = 0;
+        for (uint64_t position = 0; position < numberOfOperands; ++position)
+        {
+            order |= position << (position * BITS_PER_POSITION);
+        }
+        return order;
+    }
+
+    /**
+     * @brief Get indices of the last instructions of arguments of the instruction.
+     * @param[in] program - Compiled program.
+     * @param[in] index - Index of the instruction.
+     * @returns Indices in order of arguments.
+     */
+    std::vector<size_t> arguments(const s2e2::Program& program, size_t index)
+    {
+        const auto& instruction = program.instructions[index];
+        std::vector<size_t> result;
+        for (auto end = index; end > instruction.subtreeStart; end = program.instructions[end - 1].subtreeStart)
+        {
+            result.push_back(end - 1);
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     * @brief Find what every instruction's subtree evaluates into.
+     * @details Standard operations fail only on values of unexpected types and on NULLs in ordering comparisons,
+     *          so types of arguments are enough to tell that a subtree cannot fail.
+     * @param[in] program - Compiled program.
+     * @returns Kind of every instruction.
+     */
+    std::vector<Kind> findKinds(const s2e2::Program& program)
+    {
+        static const auto& stringType = typeid(std::string);
+
+        using s2e2::Builtin;
+        std::vector<Kind> kinds(program.instructions.size(), Kind::UNKNOWN);
+        for (size_t index = 0; index < program.instructions.size(); ++index)
+        {
+            const auto& instruction = program.instructions[index];
+            const auto argumentKinds = [&program, &kinds, index]()
+            {
+                std::vector<Kind> result;
+                for (const auto argument : arguments(program, index))
+                {
+                    result.push_back(kinds[argument]);
+                }
+                return result;
+            };
+            const auto all = [](const std::vector<Kind>& values, Kind kind)
+            {
+                return std::all_of(values.begin(), values.end(), [kind](Kind value) { return value == kind; });
+            };
+
+            switch (instruction.type)
+            {
+                case s2e2::InstructionType::CONSTANT:
+                {
+                    const auto& constant = program.constants[instruction.index];
+                    if (!constant.has_value() || constant.type() == stringType)
+                    {
+                        kinds[index] = Kind::STRING_OR_NULL;
+                    }
+                    break;
+                }
+
+                case s2e2::InstructionType::VARIABLE:
+                    kinds[index] = Kind::STRING_OR_NULL;
+                    break;
+
+                case s2e2::InstructionType::MEMBERSHIP:
+                    if (kinds[index - 1] == Kind::STRING_OR_NULL)
+                    {
+                        kinds[index] = Kind::BOOLEAN;
+                    }
+                    break;
+
+                case s2e2::InstructionType::OPERATOR:
+                case s2e2::InstructionType::FUNCTION:
+                {
+                    const auto values = argumentKinds();
+                    switch (instruction.builtin)
+                    {
+                        case Builtin::PLUS:
+                        case Builtin::CONCAT:
+                            kinds[index] = all(values, Kind::STRING_OR_NULL) ? Kind::STRING_OR_NULL : Kind::UNKNOWN;
+                            break;
+                        case Builtin::EQUAL:
+                        case Builtin::NOT_EQUAL:
+                        case Builtin::IN:
+                            kinds[index] = all(values, Kind::STRING_OR_NULL) ? Kind::BOOLEAN : Kind::UNKNOWN;
+                            break;
+                        case Builtin::AND:
+                        case Builtin::OR:
+                        case Builtin::NOT:
+                            kinds[index] = all(values, Kind::BOOLEAN) ? Kind::BOOLEAN : Kind::UNKNOWN;
+                            break;
+                        case Builtin::IF:
+                            if (values.size() == 3 && values[0] == Kind::BOOLEAN && values[1] == values[2])
+                            {
+                                kinds[index] = values[1];
+                            }
+                            break;
+                        default:
+                            // ordering comparisons fail on NULL, custom calls can fail or have side effects
+                            break;
+                    }
+                    break;
+                }
+            }
+        }
+        return kinds;
+    }
+
+} // namespace anonymous
+
+
+s2e2::AdaptiveChains::AdaptiveChains(const Program& program)
+    : chainOf_(program.instructions.size(), NO_CHAIN)
+{
+    const auto& instructions = program.instructions;
+    const auto kinds = findKinds(program);
+    std::vector<uint8_t> absorbed(instructions.size());
+
+    // walk from the end so that outer operators absorb nested left operands before they are visited
+    for (auto root = instructions.size(); root-- > 0;)
+    {
+        const auto& instruction = instructions[root];
+        if (absorbed[root] || instruction.type != InstructionType::OPERATOR ||
+            (instruction.builtin != Builtin::AND && instruction.builtin != Builtin::OR))
+        {
+            continue;
+        }
+
+        std::vector<uint32_t> operands;
+        auto current = root;
+        while (true)
+        {
+            const auto rightOperand = current - 1;
+            const auto leftOperand = instructions[rightOperand].subtreeStart - 1;
+            operands.push_back(static_cast<uint32_t>(rightOperand));
+
+            const auto& left = instructions[leftOperand];
+            if (left.type == InstructionType::OPERATOR && left.builtin == instruction.builtin &&
+                operands.size() + 2 <= MAX_OPERANDS)
+            {
+                absorbed[leftOperand] = true;
+                current = leftOperand;
+                continue;
+            }
+            operands.push_back(static_cast<uint32_t>(leftOperand));
+            break;
+        }
+        std::reverse(operands.begin(), operands.end());
+
+        // a single reorderable operand between the ones which can fail has nowhere to move
+        bool hasRun = false;
+        for (size_t operand = 1; operand < operands.size(); ++operand)
+        {
+            hasRun = hasRun || (kinds[operands[operand - 1]] == Kind::BOOLEAN && kinds[operands[operand]] == Kind::BOOLEAN);
+        }
+        if (!hasRun)
+        {
+            continue;
+        }
+
+        chainOf_[root] = static_cast<uint32_t>(chains_.size());
+        auto& chain = chains_.emplace_back();
+        chain.conjunction = (instruction.builtin == Builtin::AND);
+        for (const auto operand : operands)
+        {
+            auto& added = chain.operands.emplace_back();
+            added.root = operand;
+            added.reorderable = (kinds[operand] == Kind::BOOLEAN);
+        }
+        chain.order = sourceOrder(operands.size());
+    }
+}
+
+bool s2e2::AdaptiveChains::empty() const
+{
+    return chains_.empty();
+}
+
+s2e2::AdaptiveChains::Chain* s2e2::AdaptiveChains::find(size_t instruction)
+{
+    const auto chain = chainOf_[instruction];
+    return (chain == NO_CHAIN) ? nullptr : &chains_[chain];
+}
+
+bool s2e2::AdaptiveChains::startEvaluation(Chain& chain)
+{
+    const auto evaluation = chain.evaluations.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (evaluation % REORDERING_PERIOD == 0)
+    {
+        reorder(chain);
+    }
+    return evaluation % SAMPLING_PERIOD == 0;
+}
+
+void s2e2::AdaptiveChains::sample(Operand& operand, bool value, Clock::time_point start)
+{
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    operand.evaluations.fetch_add(1, std::memory_order_relaxed);
+    operand.passes.fetch_add(value ? 1 : 0, std::memory_order_relaxed);
+    operand.nanoseconds.fetch_add(static_cast<uint64_t>(time), std::memory_order_relaxed);
+}
+
+size_t s2e2::AdaptiveChains::operandAt(uint64_t order, size_t position)
+{
+    return static_cast<size_t>((order >> (position * BITS_PER_POSITION)) & POSITION_MASK);
+}
+
+std::vector<s2e2::ChainStatistics> s2e2::AdaptiveChains::statistics() const
+{
+    std::vector<ChainStatistics> result;
+    for (const auto& chain : chains_)
+    {
+        auto& statistics = result.emplace_back();
+        statistics.conjunction = chain.conjunction;
+        statistics.evaluations = chain.evaluations.load(std::memory_order_relaxed);
+
+        const auto order = chain.order.load(std::memory_order_acquire);
+        for (size_t position = 0; position < chain.operands.size(); ++position)
+        {
+            statistics.order.push_back(operandAt(order, position));
+        }
+
+        for (const auto& operand : chain.operands)
+        {
+            auto& operandStatistics = statistics.operands.emplace_back();
+            operandStatistics.reorderable = operand.reorderable;
+            operandStatistics.evaluations = operand.evaluations.load(std::memory_order_relaxed);
+            operandStatistics.passes = operand.passes.load(std::memory_order_relaxed);
+            if (operandStatistics.evaluations != 0)
+            {
+                operandStatistics.averageNanoseconds = static_cast<double>(operand.nanoseconds.load(std::memory_order_relaxed)) /
+                                                       static_cast<double>(operandStatistics.evaluations);
+            }
+        }
+    }
+    return result;
+}
+
+void s2e2::AdaptiveChains::reset()
+{
+    for (auto& chain : chains_)
+    {
+        for (auto& operand : chain.operands)
+        {
+            operand.evaluations = 0;
+            operand.passes = 0;
+            operand.nanoseconds = 0;
+        }
+        chain.evaluations = 0;
+        chain.order = sourceOrder(chain.operands.size());
+    }
+}
+
+void s2e2::AdaptiveChains::reorder(Chain& chain) const
+{
+    // an operand decides the chain with the probability of being false for && and true for ||,
+    // so the expected cost of a run is minimal when operands go in ascending cost per decision
+    std::vector<double> costs;
+    for (const auto& operand : chain.operands)
+    {
+        const auto evaluations = static_cast<double>(operand.evaluations.load(std::memory_order_relaxed));
+        const auto passes = static_cast<double>(operand.passes.load(std::memory_order_relaxed));
+        const auto decisions = chain.conjunction ? evaluations - passes : passes;
+        if (decisions <= 0.0)
+        {
+            // never measured or never decisive operands go last
+            costs.push_back(std::numeric_limits<double>::infinity());
+            continue;
+        }
+        // a nanosecond is added so that operands too cheap to measure are still ordered by selectivity
+        const auto nanoseconds = static_cast<double>(operand.nanoseconds.load(std::memory_order_relaxed));
+        costs.push_back((nanoseconds + evaluations) / decisions);
+    }
+
+    std::vector<size_t> order(chain.operands.size());
+    for (size_t operand = 0; operand < order.size(); ++operand)
+    {
+        order[operand] = operand;
+    }
+    for (size_t begin = 0; begin < order.size();)
+    {
+        if (!chain.operands[begin].reorderable)
+        {
+            ++begin;
+            continue;
+        }
+        auto end = begin;
+        while (end < order.size() && chain.operands[end].reorderable)
+        {
+            ++end;
+        }
+        std::stable_sort(order.begin() + begin, order.begin() + end,
+                         [&costs](size_t lhs, size_t rhs) { return costs[lhs] < costs[rhs]; });
+        begin = end;
+    }
+
+    uint64_t packed = 0;
+    for (size_t position = 0; position < order.size(); ++position)
+    {
+        packed |= static_cast<uint64_t>(order[position]) << (position * BITS_PER_POSITION);
+    }
+    chain.order.store(packed, std::memory_order_release);
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "program.hpp"
+
+#include <s2e2/compiled_expression.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class AdaptiveChains
+     * @brief Chains of && or || of a program whose operands are reordered by observed cost and selectivity.
+     * @details A chain is a left-nested sequence of one operator, e.g. A && B && C, flattened into its operands.
+     *          Only operands which cannot fail and have no side effects, i.e. boolean subtrees of standard
+     *          operations over strings and NULLs, are moved, and only between operands which can fail.
+     *          So the result and the error of every evaluation are the same as in the source order.
+     *          Statistics are collected on sampled evaluations and are updated concurrently by all threads.
+     */
+    class AdaptiveChains final
+    {
+    public:
+        /// @brief Maximal number of operands of one chain, longer chains are split into nested ones.
+        static constexpr size_t MAX_OPERANDS = 16;
+
+        /// @brief Every this evaluation of a chain is timed and counted.
+        static constexpr uint64_t SAMPLING_PERIOD = 16;
+
+        /// @brief Every this evaluation of a chain reorders its operands.
+        static constexpr uint64_t REORDERING_PERIOD = 1024;
+
+        /// @brief Index of a chain of instructions which are not chain roots.
+        static constexpr uint32_t NO_CHAIN = std::numeric_limits<uint32_t>::max();
+
+        /// @brief Clock timing operands.
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @struct Operand
+         * @brief Operand of a chain and its statistics.
+         */
+        struct Operand
+        {
+            /// @brief Index of the last instruction of the operand's subtree.
+            uint32_t root = 0;
+
+            /// @brief Can the operand be moved.
+            bool reorderable = false;
+
+            /// @brief Number of sampled evaluations.
+            std::atomic<uint64_t> evaluations{0};
+
+            /// @brief Number of sampled evaluations into true.
+            std::atomic<uint64_t> passes{0};
+
+            /// @brief Total time of sampled evaluations in nanoseconds.
+            std::atomic<uint64_t> nanoseconds{0};
+        };
+
+        /**
+         * @struct Chain
+         * @brief Flattened chain of one operator.
+         */
+        struct Chain
+        {
+            /// @brief Is it a chain of && rather than ||.
+            bool conjunction = true;
+
+            /// @brief Operands in source order.
+            std::deque<Operand> operands;
+
+            /// @brief Indices of operands in evaluation order, four bits per position starting from the lowest ones.
+            std::atomic<uint64_t> order{0};
+
+            /// @brief Number of evaluations since the last reset.
+            std::atomic<uint64_t> evaluations{0};
+        };
+
+        /**
+         * @brief Constructor, finds chains with at least two adjacent reorderable operands.
+         * @param[in] program - Compiled program.
+         */
+        explicit AdaptiveChains(const Program& program);
+
+        /**
+         * @brief Check if the program has chains to reorder.
+         * @returns true if there are no chains.
+         */
+        bool empty() const;
+
+        /**
+         * @brief Get chain whose root is the instruction.
+         * @param[in] instruction - Index of && or || instruction.
+         * @returns Chain or nullptr if the instruction is not a chain root.
+         */
+        Chain* find(size_t instruction);
+
+        /**
+         * @brief Account a new evaluation of the chain and reorder it if its period is over.
+         * @param[in, out] chain - Chain.
+         * @returns true if the evaluation is to be sampled.
+         */
+        bool startEvaluation(Chain& chain);
+
+        /**
+         * @brief Account a sampled evaluation of the operand.
+         * @param[in, out] operand - Operand.
+         * @param[in] value - Value of the operand.
+         * @param[in] start - Time the evaluation started at.
+         */
+        static void sample(Operand& operand, bool value, Clock::time_point start);
+
+        /**
+         * @brief Get index of the operand evaluated at the position.
+         * @param[in] order - Evaluation order of a chain.
+         * @param[in] position - Position.
+         * @returns Index of the operand in source order.
+         */
+        static size_t operandAt(uint64_t order, size_t position);
+
+        /**
+         * @brief Get statistics of all chains.
+         * @returns Statistics in order of chain roots.
+         */
+        std::vector<ChainStatistics> statistics() const;
+
+        /**
+         * @brief Forget all statistics and restore source order of all chains.
+         */
+        void reset();
+
+    private:
+        /**
+         * @brief Sort operands of every run of reorderable ones by their expected cost per decision.
+         * @param[in, out] chain - Chain.
+         */
+        void reorder(Chain& chain) const;
+
+    private:
+        /// @brief Index of the chain of every instruction, NO_CHAIN for instructions which are not chain roots.
+        std::vector<uint32_t> chainOf_;
+
+        /// @brief Chains in order of their roots.
+        std::deque<Chain> chains_;
+    };
+
+} // namespace s2e2
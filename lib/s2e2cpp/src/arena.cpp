@@ -0,0 +1,141 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+
+namespace // anonymous
+{
+    /// @brief Alignment of chunks.
+    constexpr size_t CHUNK_ALIGNMENT = alignof(std::max_align_t);
+
+    /**
+     * @brief Get the first offset from the start at which the address is aligned.
+     * @param[in] start - Start of a chunk.
+     * @param[in] offset - Offset to align.
+     * @param[in] alignment - Alignment, a power of two.
+     * @returns Aligned offset.
+     */
+    size_t alignUp(const char* start, size_t offset, size_t alignment)
+    {
+        const auto address = reinterpret_cast<uintptr_t>(start) + offset;
+        return offset + (((address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - address);
+    }
+}
+
+
+s2e2::Arena::Arena(std::pmr::memory_resource* upstream)
+    : upstream_{upstream ? upstream : std::pmr::get_default_resource()}
+{
+}
+
+s2e2::Arena::Arena(Arena&& other) noexcept
+    : upstream_{other.upstream_}
+    , chunks_{std::move(other.chunks_)}
+    , offset_{other.offset_}
+{
+    other.chunks_.clear();
+    other.offset_ = 0;
+}
+
+s2e2::Arena::~Arena()
+{
+    release();
+}
+
+void s2e2::Arena::setUpstream(std::pmr::memory_resource* upstream)
+{
+    release();
+    upstream_ = upstream ? upstream : std::pmr::get_default_resource();
+}
+
+std::pmr::memory_resource* s2e2::Arena::upstream() const
+{
+    return upstream_;
+}
+
+void s2e2::Arena::reset()
+{
+    // the next evaluation fits into one chunk as big as all chunks of this one
+    if (chunks_.size() > 1)
+    {
+        const auto total = capacity();
+        release();
+        chunks_.push_back(Chunk{static_cast<char*>(upstream_->allocate(total, CHUNK_ALIGNMENT)), total, CHUNK_ALIGNMENT});
+    }
+    offset_ = 0;
+}
+
+std::string_view s2e2::Arena::copy(std::string_view string)
+{
+    return concatenate(string, {});
+}
+
+std::string_view s2e2::Arena::concatenate(std::string_view lhs, std::string_view rhs)
+{
+    const auto size = lhs.size() + rhs.size();
+    if (size == 0)
+    {
+        return {};
+    }
+
+    auto* data = static_cast<char*>(allocate(size, 1));
+    std::memcpy(data, lhs.data(), lhs.size());
+    if (!rhs.empty())
+    {
+        std::memcpy(data + lhs.size(), rhs.data(), rhs.size());
+    }
+    return {data, size};
+}
+
+size_t s2e2::Arena::capacity() const
+{
+    size_t total = 0;
+    for (const auto& chunk : chunks_)
+    {
+        total += chunk.size;
+    }
+    return total;
+}
+
+void* s2e2::Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    auto start = chunks_.empty() ? 0 : alignUp(chunks_.back().data, offset_, alignment);
+    if (chunks_.empty() || start + bytes > chunks_.back().size)
+    {
+        grow(bytes, alignment);
+        start = 0;
+    }
+    offset_ = start + bytes;
+    return chunks_.back().data + start;
+}
+
+void s2e2::Arena::do_deallocate(void*, size_t, size_t)
+{
+}
+
+bool s2e2::Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+void s2e2::Arena::grow(size_t bytes, size_t alignment)
+{
+    const auto previous = chunks_.empty() ? FIRST_CHUNK_SIZE / 2 : chunks_.back().size;
+    const auto size = std::max(previous * 2, bytes);
+    const auto chunkAlignment = std::max(alignment, CHUNK_ALIGNMENT);
+    chunks_.push_back(Chunk{static_cast<char*>(upstream_->allocate(size, chunkAlignment)), size, chunkAlignment});
+    offset_ = 0;
+}
+
+void s2e2::Arena::release()
+{
+    for (const auto& chunk : chunks_)
+    {
+        upstream_->deallocate(chunk.data, chunk.size, chunk.alignment);
+    }
+    chunks_.clear();
+    offset_ = 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class Arena
+     * @brief Bump allocator of temporaries which all die together, at the end of an evaluation or a vector.
+     * @details Memory is taken from the upstream resource in chunks and is never freed one allocation at a time.
+     *          reset() makes all memory available again and merges chunks into one, so once the arena has grown to
+     *          the size of the largest evaluation it stops taking memory from the upstream resource at all.
+     *          Must not be shared by threads.
+     */
+    class Arena final : public std::pmr::memory_resource
+    {
+    public:
+        /// @brief Size of the first chunk.
+        static constexpr size_t FIRST_CHUNK_SIZE = 16 * 1024;
+
+        /**
+         * @brief Constructor, takes no memory until the first allocation.
+         * @param[in] upstream - Resource to take chunks from, null for the default resource.
+         */
+        explicit Arena(std::pmr::memory_resource* upstream = nullptr);
+
+        /**
+         * @brief Destructor, returns all chunks to the upstream resource.
+         */
+        ~Arena() override;
+
+        /**
+         * @brief Move constructor, the other arena is left empty.
+         */
+        Arena(Arena&& other) noexcept;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Return all chunks to the current upstream resource and take them from another one afterwards.
+         * @param[in] upstream - Resource to take chunks from, null for the default resource.
+         */
+        void setUpstream(std::pmr::memory_resource* upstream);
+
+        /**
+         * @brief Get the resource chunks are taken from.
+         * @returns Upstream resource.
+         */
+        std::pmr::memory_resource* upstream() const;
+
+        /**
+         * @brief Invalidate all allocations and make their memory available again.
+         */
+        void reset();
+
+        /**
+         * @brief Copy the string into the arena.
+         * @param[in] string - String.
+         * @returns View of the copy.
+         */
+        std::string_view copy(std::string_view string);
+
+        /**
+         * @brief Concatenate two strings into the arena.
+         * @param[in] lhs - First string.
+         * @param[in] rhs - Second string.
+         * @returns View of the concatenation.
+         */
+        std::string_view concatenate(std::string_view lhs, std::string_view rhs);
+
+        /**
+         * @brief Get total size of all chunks.
+         * @returns Number of bytes taken from the upstream resource.
+         */
+        size_t capacity() const;
+
+    private:
+        /**
+         * @brief Chunk of memory taken from the upstream resource.
+         */
+        struct Chunk
+        {
+            /// @brief Start of the chunk.
+            char* data;
+
+            /// @brief Size of the chunk.
+            size_t size;
+
+            /// @brief Alignment the chunk is allocated with.
+            size_t alignment;
+        };
+
+        /**
+         * @brief Allocate memory valid until the next reset.
+         */
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        /**
+         * @brief Do nothing, memory is reclaimed by reset only.
+         */
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+        /**
+         * @brief Check if the resource is this arena.
+         */
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+        /**
+         * @brief Take a new chunk big enough for the allocation from the upstream resource.
+         * @param[in] bytes - Size of the allocation.
+         * @param[in] alignment - Alignment of the allocation.
+         */
+        void grow(size_t bytes, size_t alignment);
+
+        /**
+         * @brief Return all chunks to the upstream resource.
+         */
+        void release();
+
+    private:
+        /// @brief Resource to take chunks from.
+        std::pmr::memory_resource* upstream_;
+
+        /// @brief All chunks, the last one is the current one.
+        std::vector<Chunk> chunks_;
+
+        /// @brief Offset of free memory within the current chunk.
+        size_t offset_ = 0;
+    };
+
+} // namespace s2e2
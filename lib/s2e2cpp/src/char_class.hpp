@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Bit flags of symbol classes, one symbol can belong to several classes.
+     * @details Classes are fixed ASCII sets which do not depend on the locale, all other bytes belong to none of them.
+     */
+    struct CharClass final
+    {
+        /// @brief Space and tab, they separate tokens.
+        static constexpr uint8_t BLANK = 0x01;
+
+        /// @brief Double quote.
+        static constexpr uint8_t QUOTE = 0x02;
+
+        /// @brief Comma and round brackets, each of them is a token of its own.
+        static constexpr uint8_t SEPARATOR = 0x04;
+
+        /// @brief Symbols which end a run of ordinary symbols outside quotes.
+        static constexpr uint8_t SPECIAL = BLANK | QUOTE | SEPARATOR;
+
+        /// @brief Punctuation which is not special, standard operators are made of it.
+        static constexpr uint8_t OPERATOR = 0x08;
+
+        /// @brief Latin letters, digits and underscore.
+        static constexpr uint8_t IDENTIFIER = 0x10;
+    };
+
+    /// @brief Classes of all byte values.
+    using CharClassTable = std::array<uint8_t, 256>;
+
+    /**
+     * @brief Build the table of symbol classes.
+     * @returns Table of classes indexed by unsigned symbol value.
+     */
+    constexpr CharClassTable makeCharClassTable()
+    {
+        CharClassTable table{};
+
+        table[static_cast<unsigned char>(' ')] = CharClass::BLANK;
+        table[static_cast<unsigned char>('\t')] = CharClass::BLANK;
+        table[static_cast<unsigned char>('"')] = CharClass::QUOTE;
+        table[static_cast<unsigned char>(',')] = CharClass::SEPARATOR;
+        table[static_cast<unsigned char>('(')] = CharClass::SEPARATOR;
+        table[static_cast<unsigned char>(')')] = CharClass::SEPARATOR;
+
+        for (unsigned symbol = '!'; symbol <= '~'; ++symbol)
+        {
+            const auto isLetter = (symbol >= 'a' && symbol <= 'z') || (symbol >= 'A' && symbol <= 'Z');
+            const auto isDigit = symbol >= '0' && symbol <= '9';
+            if (isLetter || isDigit || symbol == '_')
+            {
+                table[symbol] = CharClass::IDENTIFIER;
+            }
+            else if (table[symbol] == 0)
+            {
+                table[symbol] = CharClass::OPERATOR;
+            }
+        }
+
+        return table;
+    }
+
+    /// @brief Classes of all byte values.
+    inline constexpr CharClassTable CHAR_CLASSES = makeCharClassTable();
+
+    /**
+     * @brief Check if the symbol belongs to any of the classes.
+     * @param[in] symbol - Symbol, any byte value is allowed.
+     * @param[in] classes - Bit flags of classes.
+     * @returns true if the symbol belongs to at least one of the classes.
+     */
+    constexpr bool hasCharClass(char symbol, uint8_t classes)
+    {
+        return (CHAR_CLASSES[static_cast<unsigned char>(symbol)] & classes) != 0;
+    }
+
+} // namespace s2e2
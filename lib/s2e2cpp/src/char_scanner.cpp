@@ -0,0 +1,258 @@
+#include "char_class.hpp"
+#include "char_scanner.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define S2E2_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// GCC and Clang compile AVX2 code for single functions and check the processor at run time,
+// other compilers use AVX2 only if the whole build targets it
+#if defined(S2E2_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define S2E2_AVX2
+#define S2E2_AVX2_FUNCTION __attribute__((target("avx2")))
+#elif defined(S2E2_X86_SIMD) && defined(__AVX2__)
+#define S2E2_AVX2
+#define S2E2_AVX2_FUNCTION
+#endif
+
+
+namespace // anonymous
+{
+    // Special symbols.
+    constexpr char QUOTE = '"';
+    constexpr char COMMA = ',';
+    constexpr char LEFT_BRACKET = '(';
+    constexpr char RIGHT_BRACKET = ')';
+    constexpr char SPACE = ' ';
+    constexpr char TAB = '\t';
+
+    /**
+     * @brief Find the first quote one symbol at a time.
+     */
+    size_t findQuoteScalar(const char* data, size_t size, size_t from)
+    {
+        while (from < size && data[from] != QUOTE)
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    /**
+     * @brief Find the first special symbol one symbol at a time.
+     */
+    size_t findSpecialScalar(const char* data, size_t size, size_t from)
+    {
+        while (from < size && !s2e2::hasCharClass(data[from], s2e2::CharClass::SPECIAL))
+        {
+            ++from;
+        }
+        return from;
+    }
+
+#if defined(S2E2_X86_SIMD)
+    /**
+     * @brief Get index of the lowest set bit.
+     * @param[in] mask - Not zero mask.
+     * @returns Index of the bit.
+     */
+    inline size_t lowestBit(unsigned mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+    }
+
+    /// @brief Size of an SSE2 chunk.
+    constexpr size_t SSE2_CHUNK = 16;
+
+    /**
+     * @brief Find the first quote 16 symbols at a time.
+     */
+    size_t findQuoteSse2(const char* data, size_t size, size_t from)
+    {
+        const auto quote = _mm_set1_epi8(QUOTE);
+        for (; from + SSE2_CHUNK <= size; from += SSE2_CHUNK)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+            if (mask != 0)
+            {
+                return from + lowestBit(mask);
+            }
+        }
+        return findQuoteScalar(data, size, from);
+    }
+
+    /**
+     * @brief Find the first special symbol 16 symbols at a time.
+     */
+    size_t findSpecialSse2(const char* data, size_t size, size_t from)
+    {
+        const auto quote = _mm_set1_epi8(QUOTE);
+        const auto comma = _mm_set1_epi8(COMMA);
+        const auto leftBracket = _mm_set1_epi8(LEFT_BRACKET);
+        const auto rightBracket = _mm_set1_epi8(RIGHT_BRACKET);
+        const auto space = _mm_set1_epi8(SPACE);
+        const auto tab = _mm_set1_epi8(TAB);
+
+        for (; from + SSE2_CHUNK <= size; from += SSE2_CHUNK)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+            const auto special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, comma)),
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, leftBracket), _mm_cmpeq_epi8(chunk, rightBracket)),
+                             _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab))));
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return from + lowestBit(mask);
+            }
+        }
+        return findSpecialScalar(data, size, from);
+    }
+#endif
+
+#if defined(S2E2_AVX2)
+    /// @brief Size of an AVX2 chunk.
+    constexpr size_t AVX2_CHUNK = 32;
+
+    /**
+     * @brief Find the first quote 32 symbols at a time.
+     */
+    S2E2_AVX2_FUNCTION size_t findQuoteAvx2(const char* data, size_t size, size_t from)
+    {
+        const auto quote = _mm256_set1_epi8(QUOTE);
+        for (; from + AVX2_CHUNK <= size; from += AVX2_CHUNK)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, quote)));
+            if (mask != 0)
+            {
+                return from + lowestBit(mask);
+            }
+        }
+        return findQuoteSse2(data, size, from);
+    }
+
+    /**
+     * @brief Find the first special symbol 32 symbols at a time.
+     */
+    S2E2_AVX2_FUNCTION size_t findSpecialAvx2(const char* data, size_t size, size_t from)
+    {
+        const auto quote = _mm256_set1_epi8(QUOTE);
+        const auto comma = _mm256_set1_epi8(COMMA);
+        const auto leftBracket = _mm256_set1_epi8(LEFT_BRACKET);
+        const auto rightBracket = _mm256_set1_epi8(RIGHT_BRACKET);
+        const auto space = _mm256_set1_epi8(SPACE);
+        const auto tab = _mm256_set1_epi8(TAB);
+
+        for (; from + AVX2_CHUNK <= size; from += AVX2_CHUNK)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+            const auto special = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, comma)),
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, leftBracket), _mm256_cmpeq_epi8(chunk, rightBracket)),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab))));
+            const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(special));
+            if (mask != 0)
+            {
+                return from + lowestBit(mask);
+            }
+        }
+        return findSpecialSse2(data, size, from);
+    }
+#endif
+
+#if defined(S2E2_X86_SIMD)
+    /**
+     * @brief Check if the processor supports AVX2.
+     * @returns true if AVX2 code can run.
+     */
+    bool processorSupportsAvx2()
+    {
+#if defined(S2E2_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#elif defined(S2E2_AVX2)
+        return true;
+#else
+        return false;
+#endif
+    }
+#endif
+
+} // namespace anonymous
+
+
+s2e2::CharScanner::CharScanner()
+    : CharScanner(bestLevel())
+{
+}
+
+s2e2::CharScanner::CharScanner(SimdLevel level)
+    : level_{level}
+{
+}
+
+s2e2::SimdLevel s2e2::CharScanner::bestLevel()
+{
+#if defined(S2E2_X86_SIMD)
+    static const auto level = processorSupportsAvx2() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+s2e2::SimdLevel s2e2::CharScanner::level() const
+{
+    return level_;
+}
+
+size_t s2e2::CharScanner::findQuote(std::string_view text, size_t from) const
+{
+    switch (level_)
+    {
+#if defined(S2E2_AVX2)
+        case SimdLevel::AVX2:
+            return findQuoteAvx2(text.data(), text.size(), from);
+#endif
+
+#if defined(S2E2_X86_SIMD)
+        case SimdLevel::SSE2:
+            return findQuoteSse2(text.data(), text.size(), from);
+#endif
+
+        default:
+            return findQuoteScalar(text.data(), text.size(), from);
+    }
+}
+
+size_t s2e2::CharScanner::findSpecial(std::string_view text, size_t from) const
+{
+    switch (level_)
+    {
+#if defined(S2E2_AVX2)
+        case SimdLevel::AVX2:
+            return findSpecialAvx2(text.data(), text.size(), from);
+#endif
+
+#if defined(S2E2_X86_SIMD)
+        case SimdLevel::SSE2:
+            return findSpecialSse2(text.data(), text.size(), from);
+#endif
+
+        default:
+            return findSpecialScalar(text.data(), text.size(), from);
+    }
+}
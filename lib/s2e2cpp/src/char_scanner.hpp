@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Instruction set used to scan strings.
+     */
+    enum class SimdLevel
+    {
+        SCALAR, ///< One symbol at a time.
+        SSE2,   ///< 16 symbols at a time.
+        AVX2    ///< 32 symbols at a time.
+    };
+
+    /**
+     * @class CharScanner
+     * @brief Finds symbols which are special for the tokenizer, checking whole chunks of a string at once.
+     * @details The best level supported by the compiler and the processor is chosen once at run time.
+     */
+    class CharScanner final
+    {
+    public:
+        /**
+         * @brief Construct the scanner of the best supported level.
+         */
+        CharScanner();
+
+        /**
+         * @brief Construct the scanner of the given level.
+         * @param[in] level - Instruction set, it must be supported.
+         */
+        explicit CharScanner(SimdLevel level);
+
+        /**
+         * @brief Get the best instruction set supported by the build and the processor.
+         * @returns Instruction set.
+         */
+        static SimdLevel bestLevel();
+
+        /**
+         * @brief Get the instruction set of the scanner.
+         * @returns Instruction set.
+         */
+        SimdLevel level() const;
+
+        /**
+         * @brief Find the first quote, the only special symbol inside quotes.
+         * @param[in] text - String.
+         * @param[in] from - Offset to start from.
+         * @returns Offset of the symbol or size of the string if there is none.
+         */
+        size_t findQuote(std::string_view text, size_t from) const;
+
+        /**
+         * @brief Find the first symbol special outside quotes: a quote, a comma, a bracket, a space or a tab.
+         * @param[in] text - String.
+         * @param[in] from - Offset to start from.
+         * @returns Offset of the symbol or size of the string if there is none.
+         */
+        size_t findSpecial(std::string_view text, size_t from) const;
+
+    private:
+        /// @brief Instruction set.
+        SimdLevel level_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,49 @@
+#include "adaptive_chains.hpp"
+#include "program.hpp"
+
+#include <s2e2/compiled_expression.hpp>
+
+#include <stdexcept>
+
+
+s2e2::CompiledExpression::CompiledExpression(std::shared_ptr<const Program> program)
+    : program_{std::move(program)}
+{
+    if (!program_)
+    {
+        throw std::invalid_argument("CompiledExpression: pointer to program is empty");
+    }
+}
+
+const std::string& s2e2::CompiledExpression::expression() const
+{
+    return program_->expression;
+}
+
+const std::vector<std::string>& s2e2::CompiledExpression::variables() const
+{
+    return program_->variables;
+}
+
+const s2e2::Program& s2e2::CompiledExpression::program() const
+{
+    return *program_;
+}
+
+const s2e2::ExpressionCost& s2e2::CompiledExpression::cost() const
+{
+    return program_->cost;
+}
+
+std::vector<s2e2::ChainStatistics> s2e2::CompiledExpression::chainStatistics() const
+{
+    return program_->adaptiveChains ? program_->adaptiveChains->statistics() : std::vector<ChainStatistics>{};
+}
+
+void s2e2::CompiledExpression::resetStatistics() const
+{
+    if (program_->adaptiveChains)
+    {
+        program_->adaptiveChains->reset();
+    }
+}
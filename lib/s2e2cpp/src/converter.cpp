@@ -20,6 +20,11 @@ namespace // anonymous
 } // namespace anonymous 
 
 
+std::unique_ptr<s2e2::IConverter> s2e2::Converter::clone() const
+{
+    return std::make_unique<Converter>(*this);
+}
+
 void s2e2::Converter::addOperator(const std::string& name, const uint_fast16_t priority)
 {
     if (operators_.count(name) != 0)
@@ -31,123 +36,183 @@ void s2e2::Converter::addOperator(const std::string& name, const uint_fast16_t p
 
 std::list<s2e2::Token> s2e2::Converter::convert(const std::list<Token>& infixExpression) const
 {
-    std::list<Token>{}.swap(outputQueue_);
-    std::stack<Token>{}.swap(operatorStack_);
+    std::list<Token> postfixExpression;
+    Status status;
+    if (!tryConvert(infixExpression, postfixExpression, status))
+    {
+        throw Error(status.message);
+    }
+    return postfixExpression;
+}
 
-    processTokens(infixExpression);
-    processOperators();
+bool s2e2::Converter::tryConvert(const std::list<Token>& infixExpression,
+                                 std::list<Token>& postfixExpression,
+                                 Status& status) const
+{
+    State state;
+    if (!processTokens(state, infixExpression, status) || !processOperators(state, status))
+    {
+        return false;
+    }
 
-    return std::move(outputQueue_);
+    postfixExpression = std::move(state.outputQueue);
+    return true;
 }
 
-void s2e2::Converter::processTokens(const std::list<Token>& expression) const
+bool s2e2::Converter::processTokens(State& state, const std::list<Token>& expression, Status& status) const
 {
     for (const auto& token : expression)
     {
         switch (token.type)
         {
         case TokenType::ATOM:
-            processAtom(token);
+            processAtom(state, token);
             break;
 
         case TokenType::COMMA:
-            processComma();
+            processComma(state);
             break;
 
         case TokenType::FUNCTION:
-            processFunction(token);
+            processFunction(state, token);
             break;
 
         case TokenType::OPERATOR:
-            processOperator(token);
+            if (!processOperator(state, token, status))
+            {
+                return false;
+            }
             break;
 
         case TokenType::LEFT_BRACKET:
-            processLeftBracket(token);
+            processLeftBracket(state, token);
             break;
 
         case TokenType::RIGHT_BRACKET:
-            processRightBracket();
+            if (!processRightBracket(state, token, status))
+            {
+                return false;
+            }
             break;
         
         default:
-            throw Error("Converter: unexpected token type " + std::to_string(static_cast<int>(token.type)));
+            status = Status{ErrorCode::INVALID_EXPRESSION,
+                            "Converter: unexpected token type " + std::to_string(static_cast<int>(token.type)),
+                            token.position};
+            return false;
         }
     }
+    return true;
 }
 
-void s2e2::Converter::processAtom(const Token& token) const
+void s2e2::Converter::processAtom(State& state, const Token& token) const
 {
-    outputQueue_.push_back(token);
+    markBracketsNotEmpty(state);
+    state.outputQueue.push_back(token);
 }
 
-void s2e2::Converter::processComma() const
+void s2e2::Converter::processComma(State& state) const
 {
-    while (!operatorStack_.empty() &&
-           operatorStack_.top().type != TokenType::LEFT_BRACKET)
+    if (!state.bracketsStack.empty())
+    {
+        ++state.bracketsStack.top().commas;
+    }
+
+    while (!state.operatorStack.empty() &&
+           state.operatorStack.top().type != TokenType::LEFT_BRACKET)
     {
-        moveTokenFromStackToQueue(operatorStack_, outputQueue_);
+        moveTokenFromStackToQueue(state.operatorStack, state.outputQueue);
     }
 }
 
-void s2e2::Converter::processFunction(const Token& token) const
+void s2e2::Converter::processFunction(State& state, const Token& token) const
 {
-    operatorStack_.push(token);
+    markBracketsNotEmpty(state);
+    state.operatorStack.push(token);
 }
 
-void s2e2::Converter::processOperator(const Token& token) const
+bool s2e2::Converter::processOperator(State& state, const Token& token, Status& status) const
 {
-    const auto it = operators_.find(token.value);
-    if (it == operators_.end())
+    // interned operators carry their priorities, others are looked up by name once
+    auto priority = token.priority;
+    if (token.symbol == NO_SYMBOL)
     {
-        throw Error("Converter: unknown operator " + token.value);
+        const auto it = operators_.find(token.value);
+        if (it == operators_.end())
+        {
+            status = Status{ErrorCode::UNSUPPORTED_OPERATOR, "Converter: unknown operator " + token.value, token.position};
+            return false;
+        }
+        priority = it->second;
     }
-    const auto& priority = it->second;
+    markBracketsNotEmpty(state);
 
-    while (!operatorStack_.empty() &&
-           operatorStack_.top().type == TokenType::OPERATOR &&
-           priority <= operators_.at(operatorStack_.top().value))
+    while (!state.operatorStack.empty() &&
+           state.operatorStack.top().type == TokenType::OPERATOR &&
+           priority <= state.operatorStack.top().priority)
     {
-        moveTokenFromStackToQueue(operatorStack_, outputQueue_);
+        moveTokenFromStackToQueue(state.operatorStack, state.outputQueue);
     }
 
-    operatorStack_.push(token);
+    state.operatorStack.emplace(token.type, token.value, 0, token.position, token.symbol, priority);
+    return true;
 }
 
-void s2e2::Converter::processLeftBracket(const Token& token) const
+void s2e2::Converter::processLeftBracket(State& state, const Token& token) const
 {
-    operatorStack_.push(token);
+    markBracketsNotEmpty(state);
+    state.bracketsStack.emplace();
+    state.operatorStack.push(token);
 }
 
-void s2e2::Converter::processRightBracket() const
+bool s2e2::Converter::processRightBracket(State& state, const Token& token, Status& status) const
 {
-    while (!operatorStack_.empty() &&
-           operatorStack_.top().type != TokenType::LEFT_BRACKET)
+    while (!state.operatorStack.empty() &&
+           state.operatorStack.top().type != TokenType::LEFT_BRACKET)
+    {
+        moveTokenFromStackToQueue(state.operatorStack, state.outputQueue);
+    }
+
+    if (state.operatorStack.empty())
     {
-        moveTokenFromStackToQueue(operatorStack_, outputQueue_);
+        status = Status{ErrorCode::UNPAIRED_BRACKET, "Converter: unpaired bracket", token.position};
+        return false;
     }
+    state.operatorStack.pop();
+
+    const auto brackets = state.bracketsStack.top();
+    state.bracketsStack.pop();
 
-    if (operatorStack_.empty())
+    if (!state.operatorStack.empty() &&
+        state.operatorStack.top().type == TokenType::FUNCTION)
     {
-        throw Error("Converter: unpaired bracket");
+        const auto numberOfArguments = brackets.empty ? 0 : brackets.commas + 1;
+        const auto& function = state.operatorStack.top();
+        state.outputQueue.emplace_back(TokenType::FUNCTION, function.value, numberOfArguments, function.position,
+                                  function.symbol, function.priority);
+        state.operatorStack.pop();
     }
-    operatorStack_.pop();
+    return true;
+}
 
-    if (!operatorStack_.empty() &&
-        operatorStack_.top().type == TokenType::FUNCTION)
+void s2e2::Converter::markBracketsNotEmpty(State& state) const
+{
+    if (!state.bracketsStack.empty())
     {
-        moveTokenFromStackToQueue(operatorStack_, outputQueue_);
+        state.bracketsStack.top().empty = false;
     }
 }
 
-void s2e2::Converter::processOperators() const
+bool s2e2::Converter::processOperators(State& state, Status& status) const
 {
-    while (!operatorStack_.empty())
+    while (!state.operatorStack.empty())
     {
-        if (operatorStack_.top().type == TokenType::LEFT_BRACKET)
+        if (state.operatorStack.top().type == TokenType::LEFT_BRACKET)
         {
-            throw Error("Converter: unpaired bracket");
+            status = Status{ErrorCode::UNPAIRED_BRACKET, "Converter: unpaired bracket", state.operatorStack.top().position};
+            return false;
         }
-        moveTokenFromStackToQueue(operatorStack_, outputQueue_);
+        moveTokenFromStackToQueue(state.operatorStack, state.outputQueue);
     }
+    return true;
 }
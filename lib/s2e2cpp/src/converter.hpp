@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <stack>
 #include <string>
 #include <unordered_map>
@@ -17,10 +18,19 @@ namespace s2e2
      * @class Converter
      * @brief Class converts infix token sequence into postfix one.
      * @details Convertion is done by Shunting Yard algorithm.
+     *          Every FUNCTION token of the result knows the number of arguments it is called with.
+     *          Operators of tokens with interned symbols are compared by priorities the tokens carry.
+     *          Conversions keep their state on the stack, so one converter can be used by many threads.
      */
     class Converter final : public IConverter
     {
     public:
+        /**
+         * @brief Make a copy knowing the same operators.
+         * @returns Copy of the converter.
+         */
+        std::unique_ptr<IConverter> clone() const override;
+
         /**
          * @brief Add operator expected within expression.
          * @param[in] name - Operator's name.
@@ -37,63 +47,114 @@ namespace s2e2
          */
         std::list<Token> convert(const std::list<Token>& infixExpression) const override;
 
+        /**
+         * @brief Convert infix token sequence into postfix one without throwing.
+         * @param[in] infixExpression - Input sequence of tokens.
+         * @param[out] postfixExpression - Postfix sequence of tokens.
+         * @param[out] status - Error in case of failure.
+         * @returns true in case of success.
+         */
+        bool tryConvert(const std::list<Token>& infixExpression,
+                        std::list<Token>& postfixExpression,
+                        Status& status) const override;
+
     private:
+        /**
+         * @brief Content of one pair of brackets seen so far.
+         */
+        struct Brackets
+        {
+            /// @brief Number of commas directly within the brackets.
+            size_t commas = 0;
+
+            /// @brief Are there any tokens within the brackets.
+            bool empty = true;
+        };
+
+        /**
+         * @brief State of one conversion.
+         */
+        struct State
+        {
+            /// @brief Output queue of all tokens.
+            std::list<Token> outputQueue;
+
+            /// @brief Stack of operators and functions.
+            std::stack<Token> operatorStack;
+
+            /// @brief Stack of currently open brackets, used to count arguments of functions.
+            std::stack<Brackets> bracketsStack;
+        };
+
         /**
          * @brief Process all tokens in the input sequence.
+         * @param[in, out] state - State of the conversion.
          * @param[in] expression - Tokens sequence.
-         * @throws Error in case of an error.
+         * @param[out] status - Error in case of failure.
+         * @returns true in case of success.
          */
-        void processTokens(const std::list<Token>& expression) const;
+        bool processTokens(State& state, const std::list<Token>& expression, Status& status) const;
 
         /**
          * @brief Process ATOM token.
+         * @param[in, out] state - State of the conversion.
          * @param[in] token - Input token.
          */
-        void processAtom(const Token& token) const;
+        void processAtom(State& state, const Token& token) const;
 
         /**
          * @brief Process COMMA token.
+         * @param[in, out] state - State of the conversion.
          */
-        void processComma() const;
+        void processComma(State& state) const;
 
         /**
          * @brief Process FUNCTION token.
+         * @param[in, out] state - State of the conversion.
          * @param[in] token - Input token.
          */
-        void processFunction(const Token& token) const;
+        void processFunction(State& state, const Token& token) const;
 
         /**
          * @brief Process OPERATOR token.
+         * @param[in, out] state - State of the conversion.
          * @param[in] token - Input token.
-         * @throws Error in case of an unknown operator.
+         * @param[out] status - Error in case of an unknown operator.
+         * @returns true in case of success.
          */
-        void processOperator(const Token& token) const;
+        bool processOperator(State& state, const Token& token, Status& status) const;
 
         /**
          * @brief Process LEFT BRACKET token.
+         * @param[in, out] state - State of the conversion.
          * @param[in] token - Input token.
          */
-        void processLeftBracket(const Token& token) const;
+        void processLeftBracket(State& state, const Token& token) const;
 
         /**
          * @brief Process RIGHT BRACKET token.
-         * @throws Error in case of an error.
+         * @param[in, out] state - State of the conversion.
+         * @param[in] token - Input token.
+         * @param[out] status - Error in case of an unpaired bracket.
+         * @returns true in case of success.
          */
-        void processRightBracket() const;
+        bool processRightBracket(State& state, const Token& token, Status& status) const;
 
         /**
          * @brief Process all operators left in the operator stack.
-         * @throws Error in case of an error.
+         * @param[in, out] state - State of the conversion.
+         * @param[out] status - Error in case of an unpaired bracket.
+         * @returns true in case of success.
          */
-        void processOperators() const;
-
-    private:
-        /// @brief Output queue of all tokens.
-        mutable std::list<Token> outputQueue_;
+        bool processOperators(State& state, Status& status) const;
 
-        /// @brief Stack of operators and functions.
-        mutable std::stack<Token> operatorStack_;
+        /**
+         * @brief Note that there is a token within the innermost brackets.
+         * @param[in, out] state - State of the conversion.
+         */
+        void markBracketsNotEmpty(State& state) const;
 
+    private:
         /// @brief All expected operators and their priorities (precedences).
         std::unordered_map<std::string, uint_fast16_t> operators_;
     };
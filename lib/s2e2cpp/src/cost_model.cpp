@@ -0,0 +1,210 @@
+#include "cost_model.hpp"
+
+#include <s2e2/functions/function_replace.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace // anonymous
+{
+    /// @brief Complexity added by every quantifier.
+    const size_t QUANTIFIER_COMPLEXITY = 10;
+
+    /// @brief Complexity added by every backreference.
+    const size_t BACKREFERENCE_COMPLEXITY = 100;
+
+    /// @brief Complexity added by every quantified group containing a quantifier, e.g. (a+)+.
+    const size_t NESTED_QUANTIFIER_COMPLEXITY = 1000;
+
+    /**
+     * @brief Check the value against the limit.
+     * @param[in] value - Value.
+     * @param[in] limit - Limit, zero means no limit.
+     * @param[in] what - Name of the value for the error message.
+     * @param[out] status - Error if the value exceeds the limit.
+     * @returns false if the value exceeds the limit.
+     */
+    bool checkLimit(size_t value, size_t limit, const std::string& what, s2e2::Status& status)
+    {
+        if (limit != 0 && value > limit)
+        {
+            status = s2e2::Status{s2e2::ErrorCode::LIMIT_EXCEEDED,
+                                  "Evaluator: " + what + " " + std::to_string(value) + " exceeds limit " + std::to_string(limit)};
+            return false;
+        }
+        return true;
+    }
+
+} // namespace anonymous
+
+
+s2e2::CostModel::CostModel(const ExpressionLimits& limits)
+    : limits_{limits}
+{
+}
+
+s2e2::ExpressionCost s2e2::CostModel::estimate(const Program& program, size_t numberOfTokens) const
+{
+    ExpressionCost cost;
+    cost.numberOfTokens = numberOfTokens;
+
+    size_t depth = 0;
+    // height of every subtree is one more than the height of its highest argument
+    std::vector<size_t> heights(program.instructions.size());
+    for (size_t index = 0; index < program.instructions.size(); ++index)
+    {
+        const auto& instruction = program.instructions[index];
+        switch (instruction.type)
+        {
+            case InstructionType::CONSTANT:
+            case InstructionType::VARIABLE:
+                ++depth;
+                break;
+
+            case InstructionType::OPERATOR:
+                ++cost.numberOfOperatorCalls;
+                ++cost.calls[instruction.op->name];
+                depth = depth - std::min<size_t>(depth, instruction.numberOfArguments) + 1;
+                break;
+
+            case InstructionType::FUNCTION:
+            {
+                ++cost.numberOfFunctionCalls;
+                ++cost.calls[instruction.fn->name];
+
+                if (dynamic_cast<const FunctionReplace*>(instruction.fn))
+                {
+                    // arguments are consecutive subtrees ending right before the call, the pattern is the middle one
+                    const auto replacementEnd = index - 1;
+                    const auto pattern = program.instructions[replacementEnd].subtreeStart - 1;
+                    const auto& patternInstruction = program.instructions[pattern];
+                    const auto* literal = (patternInstruction.type == InstructionType::CONSTANT)
+                                        ? std::any_cast<std::string>(&program.constants[patternInstruction.index])
+                                        : nullptr;
+
+                    ++cost.numberOfRegexes;
+                    cost.regexComplexity += literal ? regexComplexity(*literal) : ExpressionCost::DYNAMIC_REGEX_COMPLEXITY;
+                }
+
+                depth = depth - std::min<size_t>(depth, instruction.numberOfArguments) + 1;
+                break;
+            }
+
+            case InstructionType::MEMBERSHIP:
+                break;
+        }
+        cost.maxStackDepth = std::max(cost.maxStackDepth, depth);
+
+        size_t height = 0;
+        for (auto end = index; end > instruction.subtreeStart; end = program.instructions[end - 1].subtreeStart)
+        {
+            height = std::max(height, heights[end - 1]);
+        }
+        heights[index] = height + 1;
+        cost.nestingDepth = std::max(cost.nestingDepth, heights[index]);
+    }
+
+    return cost;
+}
+
+size_t s2e2::CostModel::regexComplexity(const std::string& pattern) const
+{
+    size_t complexity = pattern.size();
+
+    // every open group remembers if it contains a quantifier
+    std::vector<bool> groups{false};
+    bool quantifiedGroupBefore = false;
+    bool quantifierBefore = false;
+
+    for (size_t i = 0; i < pattern.size(); ++i)
+    {
+        const auto symbol = pattern[i];
+        auto groupClosed = false;
+        auto quantifier = false;
+
+        switch (symbol)
+        {
+            case '\\':
+                if (i + 1 < pattern.size() && pattern[i + 1] >= '1' && pattern[i + 1] <= '9')
+                {
+                    complexity += BACKREFERENCE_COMPLEXITY;
+                }
+                ++i;
+                break;
+
+            case '[':
+                // a class is a single atom, its content is not special
+                for (++i; i < pattern.size() && pattern[i] != ']'; ++i)
+                {
+                    i += (pattern[i] == '\\') ? 1 : 0;
+                }
+                break;
+
+            case '(':
+                groups.push_back(false);
+                break;
+
+            case ')':
+                if (groups.size() > 1)
+                {
+                    quantifiedGroupBefore = groups.back();
+                    groups.pop_back();
+                    groups.back() = groups.back() || quantifiedGroupBefore;
+                    groupClosed = true;
+                }
+                break;
+
+            case '?':
+                // ? right after another quantifier makes it lazy rather than quantifying it again
+                if (quantifierBefore)
+                {
+                    break;
+                }
+                [[fallthrough]];
+            case '*':
+            case '+':
+            case '{':
+                quantifier = true;
+                complexity += QUANTIFIER_COMPLEXITY;
+                if (quantifiedGroupBefore)
+                {
+                    complexity += NESTED_QUANTIFIER_COMPLEXITY;
+                }
+                groups.back() = true;
+                if (symbol == '{')
+                {
+                    i = std::min(pattern.find('}', i), pattern.size());
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        quantifiedGroupBefore = groupClosed && quantifiedGroupBefore;
+        quantifierBefore = quantifier;
+    }
+
+    return complexity;
+}
+
+bool s2e2::CostModel::checkLength(std::string_view expression, Status& status) const
+{
+    return checkLimit(expression.size(), limits_.maxLength, "expression length", status);
+}
+
+bool s2e2::CostModel::checkTokens(size_t numberOfTokens, Status& status) const
+{
+    return checkLimit(numberOfTokens, limits_.maxTokens, "number of tokens", status);
+}
+
+bool s2e2::CostModel::checkCost(const ExpressionCost& cost, Status& status) const
+{
+    return checkLimit(cost.maxStackDepth, limits_.maxStackDepth, "stack depth", status) &&
+           checkLimit(cost.nestingDepth, limits_.maxNestingDepth, "nesting depth", status) &&
+           checkLimit(cost.numberOfFunctionCalls + cost.numberOfOperatorCalls, limits_.maxCalls, "number of calls", status) &&
+           checkLimit(cost.numberOfRegexes, limits_.maxRegexes, "number of regular expressions", status) &&
+           checkLimit(cost.regexComplexity, limits_.maxRegexComplexity, "regular expression complexity", status);
+}
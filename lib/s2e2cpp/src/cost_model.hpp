@@ -0,0 +1,72 @@
+#pragma once
+
+#include "program.hpp"
+
+#include <s2e2/expression_cost.hpp>
+#include <s2e2/status.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace s2e2
+{
+    /**
+     * @class CostModel
+     * @brief Estimates cost of compiled programs and checks it against limits before they ever run.
+     */
+    class CostModel final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] limits - Limits of accepted expressions.
+         */
+        explicit CostModel(const ExpressionLimits& limits);
+
+        /**
+         * @brief Estimate cost of the program.
+         * @param[in] program - Compiled but not optimized program.
+         * @param[in] numberOfTokens - Number of tokens of the expression.
+         * @returns Cost estimate.
+         */
+        ExpressionCost estimate(const Program& program, size_t numberOfTokens) const;
+
+        /**
+         * @brief Estimate complexity of a regular expression.
+         * @param[in] pattern - Pattern of the regular expression.
+         * @returns Complexity.
+         */
+        size_t regexComplexity(const std::string& pattern) const;
+
+        /**
+         * @brief Check length of the expression.
+         * @param[in] expression - Source expression.
+         * @param[out] status - Error if the expression is too long.
+         * @returns false if the expression is too long.
+         */
+        bool checkLength(std::string_view expression, Status& status) const;
+
+        /**
+         * @brief Check number of tokens of the expression.
+         * @param[in] numberOfTokens - Number of tokens.
+         * @param[out] status - Error if there are too many tokens.
+         * @returns false if there are too many tokens.
+         */
+        bool checkTokens(size_t numberOfTokens, Status& status) const;
+
+        /**
+         * @brief Check cost of the expression.
+         * @param[in] cost - Cost estimate.
+         * @param[out] status - Error if any limit is exceeded.
+         * @returns false if any limit is exceeded.
+         */
+        bool checkCost(const ExpressionCost& cost, Status& status) const;
+
+    private:
+        /// @brief Limits of accepted expressions.
+        const ExpressionLimits limits_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,28 @@
+#include "decision_dag.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+
+const std::vector<uint32_t>& s2e2::DecisionDag::select(const RecordBatch& records, size_t record) const
+{
+    const auto* node = &nodes[root];
+
+    while (!node->children.empty())
+    {
+        const auto& value = records.value(record, node->variable);
+
+        size_t child = 0;
+        if (value)
+        {
+            const auto& breakpoints = node->breakpoints;
+            const auto it = std::lower_bound(breakpoints.begin(), breakpoints.end(), *value,
+                                             [](const std::string& a, std::string_view b) { return a < b; });
+            const auto index = static_cast<size_t>(it - breakpoints.begin());
+            child = (it != breakpoints.end() && *it == *value) ? 2 + 2 * index : 1 + 2 * index;
+        }
+        node = &nodes[node->children[child]];
+    }
+
+    return node->rules;
+}
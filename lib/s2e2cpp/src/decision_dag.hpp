@@ -0,0 +1,62 @@
+#pragma once
+
+#include <s2e2/record_batch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Node of a decision DAG: either a switch on value of one variable or a leaf.
+     */
+    struct DecisionNode
+    {
+        /// @brief Index of the switched variable, unused in leaves.
+        uint32_t variable = 0;
+
+        /// @brief Sorted distinct literals the switched variable is tested against.
+        std::vector<std::string> breakpoints;
+
+        /// @brief Next nodes by the variable's value, empty in leaves.
+        /// @details The first child is for NULL, then children for values below breakpoint i and equal to it
+        ///          alternate, the last child is for values above all breakpoints.
+        std::vector<uint32_t> children;
+
+        /// @brief Rules which can match values leading to the leaf, in priority order.
+        std::vector<uint32_t> rules;
+    };
+
+    /**
+     * @class DecisionDag
+     * @brief Selects rules of a rule program which can match a record.
+     * @details A rule of the form IF(Guards && Rest, Value, NULL) evaluates into NULL without failure whenever
+     *          one of its guards - tests of variables against literals - is false. The DAG switches on values of
+     *          guarded variables one by one, so a record reaches a leaf listing only the rules all of whose guards
+     *          can be true. Nodes with the same rules are shared. Unguarded rules are selected for every record.
+     */
+    class DecisionDag final
+    {
+    public:
+        /**
+         * @brief Select guarded rules which can match the record.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @returns Indices of rules in priority order.
+         */
+        const std::vector<uint32_t>& select(const RecordBatch& records, size_t record) const;
+
+    public:
+        /// @brief All nodes, every node is stored after its children.
+        std::vector<DecisionNode> nodes;
+
+        /// @brief Index of the root node.
+        uint32_t root = 0;
+
+        /// @brief Rules without guards in priority order, they are selected for every record.
+        std::vector<uint32_t> unguardedRules;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,361 @@
+#include "decision_dag_builder.hpp"
+
+#include <algorithm>
+#include <typeinfo>
+
+
+namespace // anonymous
+{
+    /// @brief Number of nodes after which new nodes become leaves, bounds memory for adversarial rule sets.
+    const size_t MAX_NUMBER_OF_NODES = 1 << 16;
+
+    /// @brief Number of variables switched on along a path after which nodes become leaves, bounds depth of building.
+    const size_t MAX_NUMBER_OF_LEVELS = 256;
+
+    /**
+     * @brief Check if the comparison is an ordering one.
+     * @param[in] test - Comparison operator.
+     * @returns true for <, <=, > and >=.
+     */
+    bool isOrdering(s2e2::Builtin test)
+    {
+        return test == s2e2::Builtin::LESS || test == s2e2::Builtin::LESS_OR_EQUAL ||
+               test == s2e2::Builtin::GREATER || test == s2e2::Builtin::GREATER_OR_EQUAL;
+    }
+
+    /**
+     * @brief Get the comparison with swapped operands.
+     * @param[in] test - Comparison operator.
+     * @returns Equivalent operator for swapped operands.
+     */
+    s2e2::Builtin swapOperands(s2e2::Builtin test)
+    {
+        switch (test)
+        {
+            case s2e2::Builtin::LESS:
+                return s2e2::Builtin::GREATER;
+            case s2e2::Builtin::LESS_OR_EQUAL:
+                return s2e2::Builtin::GREATER_OR_EQUAL;
+            case s2e2::Builtin::GREATER:
+                return s2e2::Builtin::LESS;
+            case s2e2::Builtin::GREATER_OR_EQUAL:
+                return s2e2::Builtin::LESS_OR_EQUAL;
+            default:
+                return test;
+        }
+    }
+
+    /**
+     * @brief Collect operands of nested && in order of evaluation.
+     * @param[in] program - Rule program.
+     * @param[in] node - Index of the node.
+     * @param[out] operands - Indices of operands which are not && themselves.
+     */
+    void collectConjuncts(const s2e2::RuleProgram& program, uint32_t node, std::vector<uint32_t>& operands)
+    {
+        std::vector<uint32_t> stack = {node};
+        while (!stack.empty())
+        {
+            const auto current = stack.back();
+            stack.pop_back();
+
+            const auto& ruleNode = program.nodes[current];
+            if (ruleNode.builtin != s2e2::Builtin::AND)
+            {
+                operands.push_back(current);
+                continue;
+            }
+
+            // the first argument is popped first
+            stack.insert(stack.end(), ruleNode.arguments.rbegin(), ruleNode.arguments.rend());
+        }
+    }
+
+} // namespace anonymous
+
+
+s2e2::DecisionDagBuilder::DecisionDagBuilder(const RuleProgram& program)
+    : program_(program)
+{
+}
+
+s2e2::DecisionDag s2e2::DecisionDagBuilder::build()
+{
+    std::vector<uint32_t> guardedRules;
+    std::vector<size_t> guardedRulesByVariable(program_.variables.size());
+
+    for (uint32_t rule = 0; rule < program_.roots.size(); ++rule)
+    {
+        auto& guards = guards_.emplace_back(findGuards(program_.roots[rule]));
+        if (guards.empty())
+        {
+            dag_.unguardedRules.push_back(rule);
+            continue;
+        }
+
+        guardedRules.push_back(rule);
+        for (size_t variable = 0; variable < guardedRulesByVariable.size(); ++variable)
+        {
+            if (std::any_of(guards.begin(), guards.end(), [&](const Guard& g) { return g.variable == variable; }))
+            {
+                ++guardedRulesByVariable[variable];
+            }
+        }
+    }
+
+    // variables guarded by more rules split them earlier
+    for (uint32_t variable = 0; variable < guardedRulesByVariable.size(); ++variable)
+    {
+        if (guardedRulesByVariable[variable] != 0)
+        {
+            order_.push_back(variable);
+        }
+    }
+    std::stable_sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b)
+    {
+        return guardedRulesByVariable[a] > guardedRulesByVariable[b];
+    });
+
+    dag_.root = buildNode(0, std::move(guardedRules));
+    return std::move(dag_);
+}
+
+std::vector<s2e2::DecisionDagBuilder::Guard> s2e2::DecisionDagBuilder::findGuards(uint32_t root) const
+{
+    // only IF(Condition, Value, NULL) evaluates into NULL without failure when its condition is false
+    const auto& rootNode = program_.nodes[root];
+    if (rootNode.builtin != Builtin::IF)
+    {
+        return {};
+    }
+    const auto& otherwise = program_.nodes[rootNode.arguments[2]];
+    if (otherwise.type != InstructionType::CONSTANT || program_.constants[otherwise.index].has_value())
+    {
+        return {};
+    }
+
+    std::vector<uint32_t> conjuncts;
+    collectConjuncts(program_, rootNode.arguments[0], conjuncts);
+
+    // a guard can rule the rule out only if no guard before it can fail
+    std::vector<Guard> guards;
+    for (const auto conjunct : conjuncts)
+    {
+        auto guard = makeGuard(conjunct);
+        if (!guard)
+        {
+            break;
+        }
+        guards.push_back(std::move(*guard));
+        if (isOrdering(guards.back().test))
+        {
+            break;
+        }
+    }
+    return guards;
+}
+
+std::optional<s2e2::DecisionDagBuilder::Guard> s2e2::DecisionDagBuilder::makeGuard(uint32_t node) const
+{
+    const auto& ruleNode = program_.nodes[node];
+    const auto isVariable = [this](uint32_t argument)
+    {
+        return program_.nodes[argument].type == InstructionType::VARIABLE;
+    };
+
+    if (ruleNode.type == InstructionType::MEMBERSHIP)
+    {
+        if (!isVariable(ruleNode.arguments[0]))
+        {
+            return {};
+        }
+        return Guard{program_.nodes[ruleNode.arguments[0]].index, Builtin::NONE, {}, &program_.sets[ruleNode.index]};
+    }
+
+    if (ruleNode.builtin != Builtin::EQUAL && ruleNode.builtin != Builtin::NOT_EQUAL && !isOrdering(ruleNode.builtin))
+    {
+        return {};
+    }
+
+    auto variable = ruleNode.arguments[0];
+    auto literal = ruleNode.arguments[1];
+    auto test = ruleNode.builtin;
+    if (!isVariable(variable))
+    {
+        std::swap(variable, literal);
+        test = swapOperands(test);
+    }
+    if (!isVariable(variable) || program_.nodes[literal].type != InstructionType::CONSTANT)
+    {
+        return {};
+    }
+
+    const auto& value = program_.constants[program_.nodes[literal].index];
+    if (!value.has_value())
+    {
+        // ordering comparisons with NULL always fail
+        if (isOrdering(test))
+        {
+            return {};
+        }
+        return Guard{program_.nodes[variable].index, test, {}, nullptr};
+    }
+    if (value.type() != typeid(std::string))
+    {
+        return {};
+    }
+    return Guard{program_.nodes[variable].index, test, std::any_cast<const std::string&>(value), nullptr};
+}
+
+uint32_t s2e2::DecisionDagBuilder::buildNode(size_t level, std::vector<uint32_t> rules)
+{
+    const auto guardsVariable = [this](uint32_t rule, uint32_t variable)
+    {
+        const auto& guards = guards_[rule];
+        return std::any_of(guards.begin(), guards.end(), [&](const Guard& g) { return g.variable == variable; });
+    };
+
+    // variables none of the rules guard do not split them
+    while (level < order_.size() &&
+           std::none_of(rules.begin(), rules.end(), [&](uint32_t rule) { return guardsVariable(rule, order_[level]); }))
+    {
+        ++level;
+    }
+
+    auto key = std::make_pair(level, std::move(rules));
+    const auto it = built_.find(key);
+    if (it != built_.end())
+    {
+        return it->second;
+    }
+    const auto& candidates = key.second;
+
+    DecisionNode node;
+    if (level == order_.size() || level >= MAX_NUMBER_OF_LEVELS || dag_.nodes.size() >= MAX_NUMBER_OF_NODES)
+    {
+        node.rules = candidates;
+    }
+    else
+    {
+        node.variable = order_[level];
+
+        for (const auto rule : candidates)
+        {
+            for (const auto& guard : guards_[rule])
+            {
+                if (guard.variable != node.variable)
+                {
+                    continue;
+                }
+                if (guard.literal)
+                {
+                    node.breakpoints.push_back(*guard.literal);
+                }
+                if (guard.set)
+                {
+                    node.breakpoints.insert(node.breakpoints.end(), guard.set->values().begin(), guard.set->values().end());
+                }
+            }
+        }
+        std::sort(node.breakpoints.begin(), node.breakpoints.end());
+        node.breakpoints.erase(std::unique(node.breakpoints.begin(), node.breakpoints.end()), node.breakpoints.end());
+
+        std::vector<Position> positions = {Position{true, false, 0}};
+        for (size_t index = 0; index <= node.breakpoints.size(); ++index)
+        {
+            positions.push_back(Position{false, false, index});
+            if (index < node.breakpoints.size())
+            {
+                positions.push_back(Position{false, true, index});
+            }
+        }
+
+        for (const auto& position : positions)
+        {
+            std::vector<uint32_t> matching;
+            for (const auto rule : candidates)
+            {
+                const auto& guards = guards_[rule];
+                if (std::all_of(guards.begin(), guards.end(), [&](const Guard& g)
+                {
+                    return g.variable != node.variable || accepts(g, node.breakpoints, position);
+                }))
+                {
+                    matching.push_back(rule);
+                }
+            }
+            node.children.push_back(buildNode(level + 1, std::move(matching)));
+        }
+    }
+
+    const auto index = static_cast<uint32_t>(dag_.nodes.size());
+    dag_.nodes.push_back(std::move(node));
+    built_.emplace(std::move(key), index);
+    return index;
+}
+
+bool s2e2::DecisionDagBuilder::accepts(const Guard& guard,
+                                       const std::vector<std::string>& breakpoints,
+                                       const Position& position) const
+{
+    if (position.null)
+    {
+        switch (guard.test)
+        {
+            case Builtin::NONE:
+                return guard.set->testNull();
+            case Builtin::EQUAL:
+                return !guard.literal;
+            case Builtin::NOT_EQUAL:
+                return guard.literal.has_value();
+            default:
+                // ordering comparisons fail for NULL, the rule has to be evaluated to report it
+                return true;
+        }
+    }
+
+    if (position.exact)
+    {
+        const auto& value = breakpoints[position.index];
+        switch (guard.test)
+        {
+            case Builtin::NONE:
+                return guard.set->test(value);
+            case Builtin::EQUAL:
+                return guard.literal && value == *guard.literal;
+            case Builtin::NOT_EQUAL:
+                return !guard.literal || value != *guard.literal;
+            case Builtin::LESS:
+                return value < *guard.literal;
+            case Builtin::LESS_OR_EQUAL:
+                return value <= *guard.literal;
+            case Builtin::GREATER:
+                return value > *guard.literal;
+            case Builtin::GREATER_OR_EQUAL:
+                return value >= *guard.literal;
+            default:
+                return true;
+        }
+    }
+
+    // values strictly between breakpoints index - 1 and index, no literal is among them
+    switch (guard.test)
+    {
+        case Builtin::NONE:
+            return guard.set->testMissing();
+        case Builtin::EQUAL:
+            return false;
+        case Builtin::NOT_EQUAL:
+            return true;
+        default:
+            break;
+    }
+
+    const auto rank = static_cast<size_t>(std::lower_bound(breakpoints.begin(), breakpoints.end(), *guard.literal) -
+                                          breakpoints.begin());
+    if (guard.test == Builtin::LESS || guard.test == Builtin::LESS_OR_EQUAL)
+    {
+        return position.index <= rank;
+    }
+    return position.index > rank;
+}
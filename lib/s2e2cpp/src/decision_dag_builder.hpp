@@ -0,0 +1,123 @@
+#pragma once
+
+#include "decision_dag.hpp"
+#include "rule_program.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class DecisionDagBuilder
+     * @brief Builds decision DAG selecting rules of a rule program.
+     * @details Guards of a rule are the leading operands of && in its condition which compare a variable with a
+     *          literal: ==, != and membership tests, which never fail, and at most one ordering comparison after
+     *          them. Variables are switched on in order of the number of rules guarding them. Every switch splits
+     *          values of its variable at the literals of the guards, so each guard has the same outcome for all
+     *          values of a branch.
+     */
+    class DecisionDagBuilder final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] program - Rule program with all rules already added.
+         */
+        explicit DecisionDagBuilder(const RuleProgram& program);
+
+        /**
+         * @brief Build the DAG.
+         * @returns Decision DAG.
+         */
+        DecisionDag build();
+
+    private:
+        /**
+         * @brief Test of a variable against a literal.
+         */
+        struct Guard
+        {
+            /// @brief Index of the variable.
+            uint32_t variable;
+
+            /// @brief Comparison operator, Builtin::NONE for a membership test.
+            Builtin test;
+
+            /// @brief Literal the variable is compared with.
+            std::optional<std::string> literal;
+
+            /// @brief Set of a membership test.
+            const ValueSet* set;
+        };
+
+        /**
+         * @brief Position of a value relative to breakpoints of a switch.
+         */
+        struct Position
+        {
+            /// @brief Is the value NULL.
+            bool null;
+
+            /// @brief Is the value equal to the breakpoint or below it.
+            bool exact;
+
+            /// @brief Index of the breakpoint.
+            size_t index;
+        };
+
+        /**
+         * @brief Find guards of the rule.
+         * @param[in] root - Root node of the rule.
+         * @returns Guards in order of evaluation, empty if the rule has none.
+         */
+        std::vector<Guard> findGuards(uint32_t root) const;
+
+        /**
+         * @brief Make guard of the node if it tests a variable against a literal.
+         * @param[in] node - Index of the node.
+         * @returns Guard or empty value.
+         */
+        std::optional<Guard> makeGuard(uint32_t node) const;
+
+        /**
+         * @brief Get node for the rules, building it if it is new.
+         * @param[in] level - Index of the first variable not switched on yet.
+         * @param[in] rules - Rules which can still match.
+         * @returns Index of the node.
+         */
+        uint32_t buildNode(size_t level, std::vector<uint32_t> rules);
+
+        /**
+         * @brief Check if the guard can be true or fail for values at the position.
+         * @param[in] guard - Guard.
+         * @param[in] breakpoints - Breakpoints of the switch.
+         * @param[in] position - Position of values.
+         * @returns false if the guard is false for all values at the position.
+         */
+        bool accepts(const Guard& guard, const std::vector<std::string>& breakpoints, const Position& position) const;
+
+    private:
+        /// @brief Rule program.
+        const RuleProgram& program_;
+
+        /// @brief Guards of every rule.
+        std::vector<std::vector<Guard>> guards_;
+
+        /// @brief Guarded variables in switching order.
+        std::vector<uint32_t> order_;
+
+        /// @brief Indices of already built nodes.
+        std::map<std::pair<size_t, std::vector<uint32_t>>, uint32_t> built_;
+
+        /// @brief DAG being built.
+        DecisionDag dag_;
+    };
+
+} // namespace s2e2
@@ -1,3 +1,5 @@
+#include "error_status.hpp"
+
 #include <s2e2/error.hpp>
 
 
@@ -10,3 +12,24 @@ s2e2::Error::Error(const char* message)
     : std::runtime_error(message)
 {
 }
+
+s2e2::AbortedError::AbortedError(Reason reason)
+    : Error(reason == Reason::CANCELLED ? cancelledStatus().message : deadlineExceededStatus().message)
+    , reason_{reason}
+{
+}
+
+s2e2::AbortedError::Reason s2e2::AbortedError::reason() const
+{
+    return reason_;
+}
+
+s2e2::SizeLimitError::SizeLimitError(size_t size, size_t limit)
+    : Error(stringTooLongStatus(size, limit).message)
+{
+}
+
+s2e2::SizeLimitError::SizeLimitError(const std::string& message)
+    : Error(message)
+{
+}
@@ -0,0 +1,59 @@
+#include "error_status.hpp"
+
+#include <s2e2/error.hpp>
+
+#include <stdexcept>
+#include <string>
+
+
+void s2e2::throwError(const Status& status)
+{
+    switch (status.code)
+    {
+        case ErrorCode::CANCELLED:
+            throw AbortedError(AbortedError::Reason::CANCELLED);
+
+        case ErrorCode::DEADLINE_EXCEEDED:
+            throw AbortedError(AbortedError::Reason::DEADLINE_EXCEEDED);
+
+        case ErrorCode::STRING_TOO_LONG:
+            throw SizeLimitError(status.message);
+
+        case ErrorCode::INVALID_VARIABLES:
+            throw std::invalid_argument(status.message);
+
+        default:
+            throw Error(status.message);
+    }
+}
+
+s2e2::Status s2e2::cancelledStatus()
+{
+    return Status{ErrorCode::CANCELLED, "Evaluator: evaluation is cancelled"};
+}
+
+s2e2::Status s2e2::deadlineExceededStatus()
+{
+    return Status{ErrorCode::DEADLINE_EXCEEDED, "Evaluator: evaluation deadline is exceeded"};
+}
+
+s2e2::Status s2e2::stringTooLongStatus(size_t size, size_t limit)
+{
+    return Status{ErrorCode::STRING_TOO_LONG,
+                  "Evaluator: string size " + std::to_string(size) + " exceeds limit " + std::to_string(limit)};
+}
+
+s2e2::Status s2e2::statusOf(const std::exception& exception)
+{
+    if (const auto* aborted = dynamic_cast<const AbortedError*>(&exception))
+    {
+        const auto code = (aborted->reason() == AbortedError::Reason::CANCELLED) ? ErrorCode::CANCELLED
+                                                                                  : ErrorCode::DEADLINE_EXCEEDED;
+        return Status{code, aborted->what()};
+    }
+    if (dynamic_cast<const SizeLimitError*>(&exception))
+    {
+        return Status{ErrorCode::STRING_TOO_LONG, exception.what()};
+    }
+    return Status{ErrorCode::CALL_FAILED, exception.what()};
+}
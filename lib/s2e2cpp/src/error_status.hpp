@@ -0,0 +1,46 @@
+#pragma once
+
+#include <s2e2/status.hpp>
+
+#include <cstddef>
+#include <exception>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Throw the exception the throwing API reports the error with.
+     * @param[in] status - Status with an error.
+     * @throws AbortedError for CANCELLED and DEADLINE_EXCEEDED, SizeLimitError for STRING_TOO_LONG,
+     *         std::invalid_argument for INVALID_VARIABLES and Error for all other codes.
+     */
+    [[noreturn]] void throwError(const Status& status);
+
+    /**
+     * @brief Get status of an evaluation stopped by its cancellation token.
+     * @returns CANCELLED error with the message of AbortedError.
+     */
+    Status cancelledStatus();
+
+    /**
+     * @brief Get status of an evaluation stopped by its deadline.
+     * @returns DEADLINE_EXCEEDED error with the message of AbortedError.
+     */
+    Status deadlineExceededStatus();
+
+    /**
+     * @brief Get status of a string growing over the limit.
+     * @param[in] size - Size of the string in bytes.
+     * @param[in] limit - Maximal size in bytes.
+     * @returns STRING_TOO_LONG error with the message of SizeLimitError.
+     */
+    Status stringTooLongStatus(size_t size, size_t limit);
+
+    /**
+     * @brief Get status of an exception thrown by a function, an operator or a limit check.
+     * @param[in] exception - Exception.
+     * @returns Status with an error.
+     */
+    Status statusOf(const std::exception& exception);
+
+} // namespace s2e2
@@ -1,4 +1,5 @@
 #include "evaluator_impl.hpp"
+#include "session_impl.hpp"
 
 #include <s2e2/evaluator.hpp>
 
@@ -9,6 +10,13 @@
 class s2e2::Evaluator::Impl
 {
 public:
+    Impl() = default;
+
+    explicit Impl(std::shared_ptr<RegistryImpl> registry)
+        : evaluator{std::move(registry)}
+    {
+    }
+
     /// @brief Real evaluator.
     EvaluatorImpl evaluator;
 };
@@ -18,6 +26,11 @@ s2e2::Evaluator::Evaluator()
 {
 }
 
+s2e2::Evaluator::Evaluator(const Registry& registry)
+    : pimpl_{std::make_unique<Impl>(registry.impl_)}
+{
+}
+
 s2e2::Evaluator::~Evaluator() = default;
 
 void s2e2::Evaluator::addFunction(std::unique_ptr<Function>&& fn)
@@ -40,6 +53,16 @@ void s2e2::Evaluator::addStandardOperators()
     pimpl_->evaluator.addStandardOperators();
 }
 
+void s2e2::Evaluator::freeze()
+{
+    pimpl_->evaluator.freeze();
+}
+
+bool s2e2::Evaluator::frozen() const
+{
+    return pimpl_->evaluator.frozen();
+}
+
 std::unordered_set<const s2e2::Function*> s2e2::Evaluator::getFunctions() const
 {
     return pimpl_->evaluator.getFunctions();
@@ -50,7 +73,176 @@ std::unordered_set<const s2e2::Operator*> s2e2::Evaluator::getOperators() const
     return pimpl_->evaluator.getOperators();
 }
 
+s2e2::Registry s2e2::Evaluator::registry() const
+{
+    return Registry(pimpl_->evaluator.registry());
+}
+
+void s2e2::Evaluator::setTracer(std::shared_ptr<Tracer> tracer)
+{
+    pimpl_->evaluator.setTracer(tracer ? tracer->impl_ : nullptr);
+}
+
+void s2e2::Evaluator::setNumberOfThreads(size_t numberOfThreads)
+{
+    ThreadPoolOptions options;
+    options.numberOfThreads = numberOfThreads;
+    setThreadPool(std::make_shared<ThreadPool>(options));
+}
+
+void s2e2::Evaluator::setThreadPool(std::shared_ptr<ThreadPool> pool)
+{
+    pimpl_->evaluator.setThreadPool(pool ? pool->impl_ : nullptr);
+}
+
+void s2e2::Evaluator::setMemoryResource(std::pmr::memory_resource* resource)
+{
+    pimpl_->evaluator.setMemoryResource(resource);
+}
+
+void s2e2::Evaluator::setShortCircuit(bool enabled)
+{
+    pimpl_->evaluator.setShortCircuit(enabled);
+}
+
+void s2e2::Evaluator::setAdaptiveReordering(bool enabled)
+{
+    pimpl_->evaluator.setAdaptiveReordering(enabled);
+}
+
+void s2e2::Evaluator::setLimits(const ExpressionLimits& limits)
+{
+    pimpl_->evaluator.setLimits(limits);
+}
+
+void s2e2::Evaluator::setExecutionLimits(const ExecutionLimits& limits)
+{
+    pimpl_->evaluator.setExecutionLimits(limits);
+}
+
+void s2e2::Evaluator::setCompileCache(const CompileCacheOptions& options)
+{
+    pimpl_->evaluator.setCompileCache(options);
+}
+
+s2e2::CompileCacheStatistics s2e2::Evaluator::compileCacheStatistics() const
+{
+    return pimpl_->evaluator.compileCacheStatistics();
+}
+
 std::optional<std::string> s2e2::Evaluator::evaluate(const std::string& expression) const
 {
     return pimpl_->evaluator.evaluate(expression);
 }
+
+std::optional<std::string_view> s2e2::Evaluator::asLiteral(std::string_view expression) const
+{
+    return pimpl_->evaluator.asLiteral(expression);
+}
+
+s2e2::CompiledExpression s2e2::Evaluator::compile(const std::string& expression,
+                                                  const std::vector<std::string>& variables) const
+{
+    return CompiledExpression(pimpl_->evaluator.compile(expression, variables));
+}
+
+std::optional<std::string> s2e2::Evaluator::evaluate(const CompiledExpression& expression,
+                                                     const std::vector<VariableValue>& values) const
+{
+    const auto records = RecordBatch::rowMajor(values, 1, values.size());
+    return pimpl_->evaluator.evaluate(expression.program(), records, 0);
+}
+
+s2e2::Result<s2e2::CompiledExpression> s2e2::Evaluator::tryCompile(const std::string& expression,
+                                                                  const std::vector<std::string>& variables) const
+{
+    Status status;
+    auto program = pimpl_->evaluator.tryCompile(expression, variables, status);
+    if (!program)
+    {
+        return status;
+    }
+    return CompiledExpression(std::move(program));
+}
+
+s2e2::Result<std::optional<std::string>> s2e2::Evaluator::tryEvaluate(const std::string& expression) const
+{
+    std::optional<std::string> result;
+    Status status;
+    if (!pimpl_->evaluator.tryEvaluate(expression, result, status))
+    {
+        return status;
+    }
+    return result;
+}
+
+s2e2::Result<std::optional<std::string>> s2e2::Evaluator::tryEvaluate(const CompiledExpression& expression,
+                                                                     const std::vector<VariableValue>& values) const
+{
+    const auto records = RecordBatch::rowMajor(values, 1, values.size());
+    std::optional<std::string> result;
+    Status status;
+    if (!pimpl_->evaluator.tryEvaluate(expression.program(), records, 0, result, status))
+    {
+        return status;
+    }
+    return result;
+}
+
+size_t s2e2::Evaluator::evaluateBatch(const CompiledExpression& expression,
+                                      const RecordBatch& records,
+                                      Span<std::optional<std::string>> results,
+                                      Span<RecordStatus> statuses,
+                                      ExecutionMode mode) const
+{
+    return pimpl_->evaluator.evaluateBatch(expression.program(), records, results, statuses, mode);
+}
+
+s2e2::RuleSet s2e2::Evaluator::compileRuleSet(const std::vector<std::string>& expressions,
+                                              const std::vector<std::string>& variables) const
+{
+    return RuleSet(pimpl_->evaluator.compileRuleSet(expressions, variables));
+}
+
+size_t s2e2::Evaluator::evaluateRules(const RuleSet& rules,
+                                      const std::vector<VariableValue>& values,
+                                      Span<std::optional<std::string>> results,
+                                      Span<RecordStatus> statuses) const
+{
+    const auto records = RecordBatch::rowMajor(values, 1, values.size());
+    return pimpl_->evaluator.evaluateRules(rules.program(), records, 0, results, statuses);
+}
+
+std::optional<s2e2::RuleMatch> s2e2::Evaluator::evaluateFirstMatch(const RuleSet& rules,
+                                                                  const std::vector<VariableValue>& values) const
+{
+    const auto records = RecordBatch::rowMajor(values, 1, values.size());
+    return pimpl_->evaluator.evaluateFirstMatch(rules.program(), records, 0);
+}
+
+s2e2::ExpressionGraph s2e2::Evaluator::compileGraph(const std::vector<std::pair<std::string, std::string>>& fields,
+                                                    const std::vector<std::string>& variables) const
+{
+    return ExpressionGraph(pimpl_->evaluator.compileGraph(fields, variables));
+}
+
+size_t s2e2::Evaluator::evaluateGraph(const ExpressionGraph& graph,
+                                      const std::vector<VariableValue>& values,
+                                      Span<std::optional<std::string>> results,
+                                      Span<RecordStatus> statuses) const
+{
+    const auto records = RecordBatch::rowMajor(values, 1, values.size());
+    return pimpl_->evaluator.evaluateGraph(graph.program(), records, 0, results, statuses);
+}
+
+s2e2::Session s2e2::Evaluator::startSession(const RuleSet& rules, const std::vector<VariableValue>& values) const
+{
+    return Session(std::make_unique<SessionImpl>(rules, values));
+}
+
+s2e2::Session s2e2::Evaluator::startSession(const CompiledExpression& expression,
+                                            const std::vector<VariableValue>& values) const
+{
+    const RuleSet rules(pimpl_->evaluator.toRuleProgram(expression.program()));
+    return Session(std::make_unique<SessionImpl>(rules, values));
+}
@@ -1,16 +1,17 @@
-#include "converter.hpp"
+#include "adaptive_chains.hpp"
+#include "cost_model.hpp"
+#include "error_status.hpp"
 #include "evaluator_impl.hpp"
+#include "optimizer.hpp"
+#include "rule_program_builder.hpp"
 #include "token_type.hpp"
 #include "token.hpp"
-#include "tokenizer.hpp"
 
 #include <s2e2/error.hpp>
 
-#include <s2e2/functions/function_add_days.hpp>
-#include <s2e2/functions/function_format_date.hpp>
+#include <s2e2/functions/function_concat.hpp>
 #include <s2e2/functions/function_if.hpp>
-#include <s2e2/functions/function_now.hpp>
-#include <s2e2/functions/function_replace.hpp>
+#include <s2e2/functions/function_in.hpp>
 
 #include <s2e2/operators/operator_and.hpp>
 #include <s2e2/operators/operator_equal.hpp>
@@ -24,6 +25,7 @@
 #include <s2e2/operators/operator_plus.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 
 
@@ -34,203 +36,887 @@ namespace
 
     /// @brief Expected stack size after processing all tokens.
     const size_t FINAL_STACK_SIZE = 1;
+
+    /// @brief Name of the span covering tokenization and conversion of an expression.
+    const std::string COMPILE_SPAN = "compile";
+
+    /// @brief Name of the span covering the whole evaluation.
+    const std::string EVALUATE_SPAN = "evaluate";
+
+    /// @brief Name of the span covering evaluation of a batch of records.
+    const std::string EVALUATE_BATCH_SPAN = "evaluate_batch";
+
+    /// @brief Name of the span covering evaluation of a rule set.
+    const std::string EVALUATE_RULES_SPAN = "evaluate_rules";
+
+    /// @brief Name of spans of graph evaluations.
+    const std::string EVALUATE_GRAPH_SPAN = "evaluate_graph";
+
+    /**
+     * @brief Find out which standard operator the operator is.
+     * @param[in] op - Operator.
+     * @returns Standard operator or Builtin::NONE for a custom one.
+     */
+    s2e2::Builtin builtinOperator(const s2e2::Operator* op)
+    {
+        if (dynamic_cast<const s2e2::OperatorAnd*>(op))
+        {
+            return s2e2::Builtin::AND;
+        }
+        if (dynamic_cast<const s2e2::OperatorEqual*>(op))
+        {
+            return s2e2::Builtin::EQUAL;
+        }
+        if (dynamic_cast<const s2e2::OperatorGreater*>(op))
+        {
+            return s2e2::Builtin::GREATER;
+        }
+        if (dynamic_cast<const s2e2::OperatorGreaterOrEqual*>(op))
+        {
+            return s2e2::Builtin::GREATER_OR_EQUAL;
+        }
+        if (dynamic_cast<const s2e2::OperatorLess*>(op))
+        {
+            return s2e2::Builtin::LESS;
+        }
+        if (dynamic_cast<const s2e2::OperatorLessOrEqual*>(op))
+        {
+            return s2e2::Builtin::LESS_OR_EQUAL;
+        }
+        if (dynamic_cast<const s2e2::OperatorNot*>(op))
+        {
+            return s2e2::Builtin::NOT;
+        }
+        if (dynamic_cast<const s2e2::OperatorNotEqual*>(op))
+        {
+            return s2e2::Builtin::NOT_EQUAL;
+        }
+        if (dynamic_cast<const s2e2::OperatorOr*>(op))
+        {
+            return s2e2::Builtin::OR;
+        }
+        if (dynamic_cast<const s2e2::OperatorPlus*>(op))
+        {
+            return s2e2::Builtin::PLUS;
+        }
+        return s2e2::Builtin::NONE;
+    }
+
+    /**
+     * @brief Find out which standard function the function is.
+     * @param[in] fn - Function.
+     * @returns Standard function or Builtin::NONE for a custom one.
+     */
+    s2e2::Builtin builtinFunction(const s2e2::Function* fn)
+    {
+        if (dynamic_cast<const s2e2::FunctionIf*>(fn))
+        {
+            return s2e2::Builtin::IF;
+        }
+        if (dynamic_cast<const s2e2::FunctionIn*>(fn))
+        {
+            return s2e2::Builtin::IN;
+        }
+        if (dynamic_cast<const s2e2::FunctionConcat*>(fn))
+        {
+            return s2e2::Builtin::CONCAT;
+        }
+        return s2e2::Builtin::NONE;
+    }
 }
 
 s2e2::EvaluatorImpl::EvaluatorImpl()
-    : EvaluatorImpl(std::make_unique<Converter>(), std::make_unique<Tokenizer>())
+    : EvaluatorImpl(std::make_shared<RegistryImpl>())
 {
 }
 
 s2e2::EvaluatorImpl::EvaluatorImpl(std::unique_ptr<IConverter>&& converter, std::unique_ptr<ITokenizer>&& tokenizer)
-    : converter_(std::move(converter))
-    , tokenizer_(std::move(tokenizer))
+    : EvaluatorImpl(std::make_shared<RegistryImpl>(std::move(converter), std::move(tokenizer)))
+{
+}
+
+s2e2::EvaluatorImpl::EvaluatorImpl(std::shared_ptr<RegistryImpl> registry)
+    : registry_(std::move(registry))
+{
+    setThreadPool(nullptr);
+}
+
+void s2e2::EvaluatorImpl::addFunction(std::unique_ptr<Function>&& fn)
+{
+    writableRegistry().addFunction(std::move(fn));
+}
+
+void s2e2::EvaluatorImpl::addOperator(std::unique_ptr<Operator>&& op)
+{
+    writableRegistry().addOperator(std::move(op));
+}
+
+void s2e2::EvaluatorImpl::addStandardFunctions()
+{
+    writableRegistry().addStandardFunctions();
+}
+
+void s2e2::EvaluatorImpl::addStandardOperators()
+{
+    writableRegistry().addStandardOperators();
+}
+
+void s2e2::EvaluatorImpl::freeze()
+{
+    registry_->freeze();
+}
+
+bool s2e2::EvaluatorImpl::frozen() const
+{
+    return registry_->frozen();
+}
+
+std::unordered_set<const s2e2::Function*> s2e2::EvaluatorImpl::getFunctions() const
+{
+    return registry_->getFunctions();
+}
+
+std::unordered_set<const s2e2::Operator*> s2e2::EvaluatorImpl::getOperators() const
+{
+    return registry_->getOperators();
+}
+
+std::shared_ptr<s2e2::RegistryImpl> s2e2::EvaluatorImpl::registry() const
+{
+    return registry_;
+}
+
+void s2e2::EvaluatorImpl::setTracer(std::shared_ptr<TracerImpl> tracer)
+{
+    tracer_ = std::move(tracer);
+}
+
+void s2e2::EvaluatorImpl::setThreadPool(std::shared_ptr<WorkStealingPool> pool)
 {
-    if (!converter_)
+    if (!pool)
     {
-        throw std::invalid_argument("Evaluator: pointer to converter is empty");
+        ThreadPoolOptions options;
+        options.numberOfThreads = 1;
+        pool = std::make_shared<WorkStealingPool>(options);
     }
-    if (!tokenizer_)
+    pool_ = std::move(pool);
+
+    const auto previousSize = executors_.size();
+    executors_.resize(pool_->numberOfWorkers());
+    for (auto worker = previousSize; worker < executors_.size(); ++worker)
     {
-        throw std::invalid_argument("Evaluator: pointer to tokenizer is empty");
+        executors_[worker].vectorized.setMemoryResource(memoryResource_);
+        executors_[worker].scalar.setShortCircuit(shortCircuit_);
     }
 }
 
-void s2e2::EvaluatorImpl::addFunction(std::unique_ptr<Function>&& fn)
+void s2e2::EvaluatorImpl::setMemoryResource(std::pmr::memory_resource* resource)
 {
-    if (!fn)
+    memoryResource_ = resource;
+    for (auto& executors : executors_)
     {
-        throw std::invalid_argument("Evaluator: pointer to adding function is empty");
+        executors.vectorized.setMemoryResource(memoryResource_);
     }
-    checkUniqueness(fn->name);
-
-    tokenizer_->addFunction(fn->name);
-    functions_.emplace(fn->name, std::move(fn));
 }
 
-void s2e2::EvaluatorImpl::addOperator(std::unique_ptr<Operator>&& op)
+void s2e2::EvaluatorImpl::setShortCircuit(bool enabled)
 {
-    if (!op)
+    shortCircuit_ = enabled;
+    for (auto& executors : executors_)
     {
-        throw std::invalid_argument("Evaluator: pointer to adding operator is empty");
+        executors.scalar.setShortCircuit(shortCircuit_);
     }
-    checkUniqueness(op->name);
+}
 
-    converter_->addOperator(op->name, op->priority);
-    tokenizer_->addOperator(op->name);
-    operators_.emplace(op->name, std::move(op));
+void s2e2::EvaluatorImpl::setAdaptiveReordering(bool enabled)
+{
+    adaptiveReordering_ = enabled;
+    cache_.clear();
 }
 
-void s2e2::EvaluatorImpl::addStandardFunctions()
+void s2e2::EvaluatorImpl::setLimits(const ExpressionLimits& limits)
 {
-    addFunction(std::make_unique<FunctionAddDays>());
-    addFunction(std::make_unique<FunctionFormatDate>());
-    addFunction(std::make_unique<FunctionIf>());
-    addFunction(std::make_unique<FunctionNow>());
-    addFunction(std::make_unique<FunctionReplace>());
+    limits_ = limits;
+    cache_.clear();
 }
 
-void s2e2::EvaluatorImpl::addStandardOperators()
+void s2e2::EvaluatorImpl::setExecutionLimits(const ExecutionLimits& limits)
 {
-    addOperator(std::make_unique<OperatorAnd>());
-    addOperator(std::make_unique<OperatorEqual>());
-    addOperator(std::make_unique<OperatorGreaterOrEqual>());
-    addOperator(std::make_unique<OperatorGreater>());
-    addOperator(std::make_unique<OperatorLessOrEqual>());
-    addOperator(std::make_unique<OperatorLess>());
-    addOperator(std::make_unique<OperatorNotEqual>());
-    addOperator(std::make_unique<OperatorNot>());
-    addOperator(std::make_unique<OperatorOr>());
-    addOperator(std::make_unique<OperatorPlus>());
+    executionLimits_ = limits;
 }
 
-std::unordered_set<const s2e2::Function*> s2e2::EvaluatorImpl::getFunctions() const
+void s2e2::EvaluatorImpl::setCompileCache(const CompileCacheOptions& options)
+{
+    cache_.configure(options);
+}
+
+s2e2::CompileCacheStatistics s2e2::EvaluatorImpl::compileCacheStatistics() const
 {
-    std::unordered_set<const Function*> result(functions_.bucket_count());
-    for (const auto& pair : functions_)
+    return cache_.statistics();
+}
+
+std::shared_ptr<const s2e2::Program> s2e2::EvaluatorImpl::compile(const std::string& expression,
+                                                                  const std::vector<std::string>& variables) const
+{
+    Status status;
+    auto program = tryCompile(expression, variables, status);
+    if (!program)
+    {
+        throwError(status);
+    }
+    return program;
+}
+
+std::shared_ptr<const s2e2::Program> s2e2::EvaluatorImpl::tryCompile(const std::string& expression,
+                                                                     const std::vector<std::string>& variables,
+                                                                     Status& status) const
+{
+    activeTracer_ = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    return compileCached(expression, variables, status);
+}
+
+std::optional<std::string> s2e2::EvaluatorImpl::evaluate(const std::string& expression) const
+{
+    std::optional<std::string> result;
+    Status status;
+    if (!evaluateExpression(expression, result, status))
     {
-        result.insert(pair.second.get());
+        throwError(status);
     }
     return result;
 }
 
-std::unordered_set<const s2e2::Operator*> s2e2::EvaluatorImpl::getOperators() const
+bool s2e2::EvaluatorImpl::tryEvaluate(const std::string& expression,
+                                      std::optional<std::string>& result,
+                                      Status& status) const
+{
+    return evaluateExpression(expression, result, status);
+}
+
+std::optional<std::string_view> s2e2::EvaluatorImpl::asLiteral(std::string_view expression) const
+{
+    const CostModel costModel(limits_);
+    Status status;
+    size_t numberOfTokens = 0;
+    if (costModel.checkLength(expression, status) &&
+        registry_->tokenizer().isLiteral(expression, {}, numberOfTokens) &&
+        costModel.checkTokens(numberOfTokens, status))
+    {
+        return expression;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> s2e2::EvaluatorImpl::evaluate(const Program& program,
+                                                         const RecordBatch& records,
+                                                         size_t record) const
 {
-    std::unordered_set<const Operator*> result(operators_.bucket_count());
-    for (const auto& pair : operators_)
+    std::optional<std::string> result;
+    Status status;
+    if (!evaluateProgram(program, records, record, result, status))
     {
-        result.insert(pair.second.get());
+        throwError(status);
     }
     return result;
 }
 
-std::optional<std::string> s2e2::EvaluatorImpl::evaluate(const std::string& expression) const
+bool s2e2::EvaluatorImpl::tryEvaluate(const Program& program,
+                                      const RecordBatch& records,
+                                      size_t record,
+                                      std::optional<std::string>& result,
+                                      Status& status) const
 {
-    const auto infixExpression = tokenizer_->tokenize(expression);
+    return evaluateProgram(program, records, record, result, status);
+}
 
-    // a bit of syntax sugar: if expression contains only atoms
-    // consider it as just a string literal
-    if (std::all_of(infixExpression.begin(), infixExpression.end(), [](const auto& e){ return e.type == TokenType::ATOM; }))
+size_t s2e2::EvaluatorImpl::evaluateBatch(const Program& program,
+                                          const RecordBatch& records,
+                                          Span<std::optional<std::string>> results,
+                                          Span<RecordStatus> statuses,
+                                          ExecutionMode mode) const
+{
+    checkVariables(program.variables, records);
+    if (results.size() != records.size() || statuses.size() != records.size())
     {
-        return {expression};
+        throw std::invalid_argument("Evaluator: size of outputs does not match number of records");
     }
 
-    const auto postfixExpression = converter_->convert(infixExpression);
-    return evaluateExpression(postfixExpression);
+    // function spans of every record would flood the trace, so only the whole batch is traced
+    auto* batchTracer = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan batchSpan(batchTracer, EVALUATE_BATCH_SPAN);
+    activeTracer_ = nullptr;
+
+    // every worker counts calls of its own copy of the context
+    const auto context = startExecution();
+
+    // every record is written by exactly one range, so the output order does not depend on scheduling
+    std::atomic<size_t> failures{0};
+    if (mode == ExecutionMode::VECTORIZED)
+    {
+        // ranges are whole vectors, so splitting between workers does not shorten vectors
+        const auto vectorSize = VectorizedExecutor::VECTOR_SIZE;
+        const auto grain = (pool_->grainSize() + vectorSize - 1) / vectorSize * vectorSize;
+        pool_->forEachRange(records.size(), grain, [&](size_t first, size_t last, size_t worker)
+        {
+            auto local = context;
+            ExecutionContext::Scope scope(local ? &*local : nullptr);
+            if (local)
+            {
+                local->checkNow();
+            }
+            failures += executors_[worker].vectorized.execute(program, records, first, last, results, statuses);
+        });
+        return failures;
+    }
+
+    pool_->forEachRange(records.size(), pool_->grainSize(), [&](size_t first, size_t last, size_t worker)
+    {
+        auto local = context;
+        ExecutionContext::Scope scope(local ? &*local : nullptr);
+        if (local)
+        {
+            local->checkNow();
+        }
+        auto& executor = executors_[worker].scalar;
+        Status status;
+        for (size_t record = first; record < last; ++record)
+        {
+            if (executor.tryExecute(program, records, record, nullptr, results[record], status))
+            {
+                statuses[record] = RecordStatus::OK;
+                continue;
+            }
+            if (status.code == ErrorCode::CANCELLED || status.code == ErrorCode::DEADLINE_EXCEEDED)
+            {
+                throwError(status);
+            }
+            results[record].reset();
+            statuses[record] = RecordStatus::ERROR;
+            ++failures;
+        }
+    });
+    return failures;
 }
 
-void s2e2::EvaluatorImpl::checkUniqueness(const std::string& entityName) const
+std::shared_ptr<const s2e2::RuleProgram> s2e2::EvaluatorImpl::compileRuleSet(const std::vector<std::string>& expressions,
+                                                                             const std::vector<std::string>& variables) const
 {
-    if (functions_.count(entityName) != 0)
+    activeTracer_ = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+
+    RuleProgramBuilder builder(variables);
+    for (const auto& expression : expressions)
     {
-        throw Error("Evaluator: function " + entityName + " is already added");
+        builder.addRule(*compileProgram(expression, variables));
     }
-    if (operators_.count(entityName) != 0)
+    return builder.build();
+}
+
+std::shared_ptr<const s2e2::RuleProgram> s2e2::EvaluatorImpl::toRuleProgram(const Program& program) const
+{
+    RuleProgramBuilder builder(program.variables);
+    builder.addRule(program);
+    return builder.build();
+}
+
+size_t s2e2::EvaluatorImpl::evaluateRules(const RuleProgram& program,
+                                          const RecordBatch& records,
+                                          size_t record,
+                                          Span<std::optional<std::string>> results,
+                                          Span<RecordStatus> statuses) const
+{
+    checkVariables(program.variables, records);
+    if (results.size() != program.roots.size() || statuses.size() != program.roots.size())
     {
-        throw Error("Evaluator: operator " + entityName + " is already added");
+        throw std::invalid_argument("Evaluator: size of outputs does not match number of rules");
     }
+
+    auto* rulesTracer = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan rulesSpan(rulesTracer, EVALUATE_RULES_SPAN);
+
+    // shared sub-expressions are memoized per worker, so a range of rules recomputes only what it needs itself
+    const auto context = startExecution();
+    std::atomic<size_t> failures{0};
+    pool_->forEachRange(program.roots.size(), pool_->grainSize(), [&](size_t first, size_t last, size_t worker)
+    {
+        auto local = context;
+        ExecutionContext::Scope scope(local ? &*local : nullptr);
+        failures += executors_[worker].rules.execute(program, records, record, first, last, results, statuses);
+    });
+    return failures;
 }
 
-std::optional<std::string> s2e2::EvaluatorImpl::evaluateExpression(const std::list<Token>& postfixExpression) const
+std::optional<s2e2::RuleMatch> s2e2::EvaluatorImpl::evaluateFirstMatch(const RuleProgram& program,
+                                                                      const RecordBatch& records,
+                                                                      size_t record) const
 {
-    std::stack<std::any>{}.swap(stack_);
+    checkVariables(program.variables, records);
+
+    auto* rulesTracer = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan rulesSpan(rulesTracer, EVALUATE_RULES_SPAN);
+    auto context = startExecution();
+    ExecutionContext::Scope scope(context ? &*context : nullptr);
+
+    return executors_[0].rules.executeFirstMatch(program, records, record);
+}
+
+std::shared_ptr<const s2e2::GraphProgram> s2e2::EvaluatorImpl::compileGraph(
+    const std::vector<std::pair<std::string, std::string>>& fields,
+    const std::vector<std::string>& variables) const
+{
+    activeTracer_ = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+
+    // references to fields are compiled as variables following the input ones
+    auto names = variables;
+    for (const auto& field : fields)
+    {
+        if (std::find(names.begin(), names.end(), field.first) != names.end())
+        {
+            throw Error("ExpressionGraph: name " + field.first + " is used twice");
+        }
+        names.push_back(field.first);
+    }
+
+    RuleProgramBuilder builder(names);
+    for (const auto& field : fields)
+    {
+        builder.addRule(*compileProgram(field.second, names));
+    }
+
+    names.erase(names.begin(), names.begin() + variables.size());
+    return std::make_shared<GraphProgram>(std::move(names), variables.size(), builder.build());
+}
+
+size_t s2e2::EvaluatorImpl::evaluateGraph(const GraphProgram& program,
+                                          const RecordBatch& records,
+                                          size_t record,
+                                          Span<std::optional<std::string>> results,
+                                          Span<RecordStatus> statuses) const
+{
+    if (records.numberOfVariables() != program.numberOfVariables)
+    {
+        throw std::invalid_argument("Evaluator: number of variables does not match the expression");
+    }
+    const auto numberOfFields = program.names.size();
+    if (results.size() != numberOfFields || statuses.size() != numberOfFields)
+    {
+        throw std::invalid_argument("Evaluator: size of outputs does not match number of fields");
+    }
+
+    auto* graphTracer = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan graphSpan(graphTracer, EVALUATE_GRAPH_SPAN);
+
+    // values of fields are bound as soon as they are evaluated, before any field referring to them starts
+    std::vector<VariableValue> values(program.numberOfVariables + numberOfFields);
+    for (size_t variable = 0; variable < program.numberOfVariables; ++variable)
+    {
+        values[variable] = records.value(record, variable);
+    }
+    const auto bound = RecordBatch::rowMajor(values, 1, values.size());
+
+    const auto& fields = *program.fields;
+    for (auto& executors : executors_)
+    {
+        executors.rules.startRecord(fields);
+    }
+
+    const auto remaining = std::make_unique<std::atomic<size_t>[]>(numberOfFields);
+    for (size_t field = 0; field < numberOfFields; ++field)
+    {
+        remaining[field] = program.dependencies[field].size();
+    }
+    std::atomic<size_t> failures{0};
+
+    const auto context = startExecution();
+    pool_->run(program.sources, [&](WorkStealingPool& pool, size_t field, size_t worker)
+    {
+        auto local = context;
+        ExecutionContext::Scope scope(local ? &*local : nullptr);
+
+        const auto& dependencies = program.dependencies[field];
+        const auto dependencyFailed = std::any_of(dependencies.begin(), dependencies.end(),
+                                                  [&statuses](uint32_t dependency)
+                                                  { return statuses[dependency] == RecordStatus::ERROR; });
+
+        auto& result = results[field];
+        if (!dependencyFailed && executors_[worker].rules.executeRule(fields, bound, 0, field, result))
+        {
+            statuses[field] = RecordStatus::OK;
+        }
+        else
+        {
+            result.reset();
+            statuses[field] = RecordStatus::ERROR;
+            ++failures;
+        }
+        values[program.numberOfVariables + field] = result ? VariableValue{*result} : VariableValue{};
+
+        for (const auto dependent : program.dependents[field])
+        {
+            if (--remaining[dependent] == 0)
+            {
+                pool.spawn(dependent, worker);
+            }
+        }
+    });
+
+    return failures;
+}
+
+std::optional<s2e2::ExecutionContext> s2e2::EvaluatorImpl::startExecution() const
+{
+    std::optional<ExecutionContext> context;
+    Status status;
+    if (!tryStartExecution(context, status))
+    {
+        throwError(status);
+    }
+    return context;
+}
+
+bool s2e2::EvaluatorImpl::tryStartExecution(std::optional<ExecutionContext>& context, Status& status) const
+{
+    if (!ExecutionContext::isLimited(executionLimits_))
+    {
+        context.reset();
+        return true;
+    }
+
+    // a call started already cancelled or past its deadline does not run at all
+    context.emplace(executionLimits_);
+    return context->tryCheckNow(status);
+}
+
+bool s2e2::EvaluatorImpl::evaluateExpression(const std::string& expression,
+                                             std::optional<std::string>& result,
+                                             Status& status) const
+{
+    activeTracer_ = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan evaluateSpan(activeTracer_, EVALUATE_SPAN);
+    std::optional<ExecutionContext> context;
+    if (!tryStartExecution(context, status))
+    {
+        return false;
+    }
+    ExecutionContext::Scope scope(context ? &*context : nullptr);
+
+    // string literals evaluate to themselves, so there is nothing to tokenize and compile
+    if (const auto literal = asLiteral(expression))
+    {
+        result.emplace(*literal);
+        return true;
+    }
+
+    // expressions evaluated once need no adaptive chains, so the cache is bypassed unless it is on
+    const auto program = cache_.enabled() ? compileCached(expression, {}, status)
+                                          : std::shared_ptr<const Program>{compileProgram(expression, {}, status)};
+    return program && executors_[0].scalar.tryExecute(*program, RecordBatch::rowMajor({}, 1, 0), 0, activeTracer_,
+                                                      result, status);
+}
+
+bool s2e2::EvaluatorImpl::evaluateProgram(const Program& program,
+                                          const RecordBatch& records,
+                                          size_t record,
+                                          std::optional<std::string>& result,
+                                          Status& status) const
+{
+    if (records.numberOfVariables() != program.variables.size())
+    {
+        status = Status{ErrorCode::INVALID_VARIABLES, "Evaluator: number of variables does not match the expression"};
+        return false;
+    }
+
+    activeTracer_ = (tracer_ && tracer_->sample()) ? tracer_.get() : nullptr;
+    TraceSpan evaluateSpan(activeTracer_, EVALUATE_SPAN);
+    std::optional<ExecutionContext> context;
+    if (!tryStartExecution(context, status))
+    {
+        return false;
+    }
+    ExecutionContext::Scope scope(context ? &*context : nullptr);
+
+    return executors_[0].scalar.tryExecute(program, records, record, activeTracer_, result, status);
+}
+
+std::shared_ptr<const s2e2::Program> s2e2::EvaluatorImpl::compileCached(const std::string& expression,
+                                                                        const std::vector<std::string>& variables,
+                                                                        Status& status) const
+{
+    std::shared_ptr<const Program> cached;
+    switch (cache_.find(expression, variables, cached, status))
+    {
+        case ProgramCache::Lookup::PROGRAM:
+            return cached;
+
+        case ProgramCache::Lookup::FAILURE:
+            return nullptr;
+
+        case ProgramCache::Lookup::MISS:
+            break;
+    }
+
+    auto program = compileProgram(expression, variables, status);
+    if (!program)
+    {
+        cache_.insertFailure(expression, variables, status);
+        return nullptr;
+    }
+
+    if (adaptiveReordering_)
+    {
+        auto chains = std::make_shared<AdaptiveChains>(*program);
+        if (!chains->empty())
+        {
+            program->adaptiveChains = std::move(chains);
+        }
+    }
+    cache_.insert(expression, variables, program);
+    return program;
+}
+
+std::shared_ptr<s2e2::Program> s2e2::EvaluatorImpl::compileProgram(const std::string& expression,
+                                                                   const std::vector<std::string>& variables) const
+{
+    Status status;
+    auto program = compileProgram(expression, variables, status);
+    if (!program)
+    {
+        throwError(status);
+    }
+    return program;
+}
+
+std::shared_ptr<s2e2::Program> s2e2::EvaluatorImpl::compileProgram(const std::string& expression,
+                                                                   const std::vector<std::string>& variables,
+                                                                   Status& status) const
+{
+    TraceSpan compileSpan(activeTracer_, COMPILE_SPAN);
+
+    auto program = std::make_shared<Program>();
+    program->expression = expression;
+    program->variables = variables;
+    program->registry = registry_;
+
+    for (size_t i = 0; i < variables.size(); ++i)
+    {
+        if (std::find(variables.begin(), variables.begin() + i, variables[i]) != variables.begin() + i)
+        {
+            status = Status{ErrorCode::DUPLICATE_VARIABLE, "Evaluator: variable " + variables[i] + " is declared twice"};
+            return nullptr;
+        }
+    }
+
+    // expressions over the budget are rejected as early as possible, before they cost much to compile
+    const CostModel costModel(limits_);
+    if (!costModel.checkLength(expression, status))
+    {
+        return nullptr;
+    }
+
+    const auto compileLiteral = [&program, &costModel](size_t numberOfTokens)
+    {
+        program->constants.emplace_back(program->expression);
+        program->instructions.push_back(Instruction{InstructionType::CONSTANT, 0});
+        program->cost = costModel.estimate(*program, numberOfTokens);
+        return program;
+    };
+
+    // literals are recognized without building tokens
+    size_t numberOfTokens = 0;
+    if (registry_->tokenizer().isLiteral(expression, variables, numberOfTokens))
+    {
+        return costModel.checkTokens(numberOfTokens, status) ? compileLiteral(numberOfTokens) : nullptr;
+    }
+
+    std::list<Token> infixExpression;
+    if (!registry_->tokenizer().tryTokenize(expression, infixExpression, status))
+    {
+        return nullptr;
+    }
+    if (!costModel.checkTokens(infixExpression.size(), status))
+    {
+        return nullptr;
+    }
+
+    const auto isVariable = [&variables](const Token& token)
+    {
+        return std::find(variables.begin(), variables.end(), token.value) != variables.end();
+    };
+
+    // a bit of syntax sugar: if expression contains only atoms
+    // and none of them is a variable consider it as just a string literal
+    if (std::all_of(infixExpression.begin(), infixExpression.end(), [](const auto& e){ return e.type == TokenType::ATOM; }) &&
+        std::none_of(infixExpression.begin(), infixExpression.end(), isVariable))
+    {
+        return compileLiteral(infixExpression.size());
+    }
+
+    std::list<Token> postfixExpression;
+    if (!registry_->converter().tryConvert(infixExpression, postfixExpression, status) ||
+        !compileExpression(postfixExpression, *program, status))
+    {
+        return nullptr;
+    }
+    program->cost = costModel.estimate(*program, infixExpression.size());
+    if (!costModel.checkCost(program->cost, status))
+    {
+        return nullptr;
+    }
+    Optimizer().optimize(*program);
+    return program;
+}
+
+bool s2e2::EvaluatorImpl::compileExpression(const std::list<Token>& postfixExpression,
+                                            Program& program,
+                                            Status& status) const
+{
+    // starts of subtrees whose values are on the stack at the moment
+    std::vector<uint32_t> subtreeStarts;
 
     for (const auto& token : postfixExpression)
     {
         switch (token.type)
         {
             case TokenType::ATOM:
-                processAtom(token);
+                compileAtom(token, program);
                 break;
 
             case TokenType::OPERATOR:
-                processOperator(token);
+                if (!compileOperator(token, program, status))
+                {
+                    return false;
+                }
                 break;
 
             case TokenType::FUNCTION:
-                processFunction(token);
+                if (!compileFunction(token, program, status))
+                {
+                    return false;
+                }
                 break;
 
             default:
-                throw Error("Evaluator: unexpected token type " + std::to_string(static_cast<int>(token.type)));
+                status = Status{ErrorCode::INVALID_EXPRESSION,
+                                "Evaluator: unexpected token type " + std::to_string(static_cast<int>(token.type)),
+                                token.position};
+                return false;
         }
-    }
 
-    auto result = getResultValueFromStack();
-    std::stack<std::any>{}.swap(stack_);
-    return result;
-}
+        // check stack balance in advance so the program never underflows the stack on execution
+        auto& instruction = program.instructions.back();
+        instruction.subtreeStart = static_cast<uint32_t>(program.instructions.size() - 1);
 
-void s2e2::EvaluatorImpl::processAtom(const Token& token) const
-{
-    auto value = (token.value == NULL_VALUE) ? std::any{} : std::any{token.value};
-    stack_.push(std::move(value));
+        const size_t numberOfArguments = instruction.numberOfArguments;
+        if (subtreeStarts.size() < numberOfArguments)
+        {
+            status = Status{ErrorCode::NOT_ENOUGH_ARGUMENTS,
+                            instruction.op ? "Not enough arguments for operator " + instruction.op->name
+                                           : "Not enough arguments for function " + instruction.fn->name,
+                            token.position};
+            return false;
+        }
+
+        if (numberOfArguments != 0)
+        {
+            instruction.subtreeStart = subtreeStarts[subtreeStarts.size() - numberOfArguments];
+            subtreeStarts.resize(subtreeStarts.size() - numberOfArguments);
+        }
+        subtreeStarts.push_back(instruction.subtreeStart);
+    }
+
+    if (subtreeStarts.size() != FINAL_STACK_SIZE)
+    {
+        status = Status{ErrorCode::INVALID_EXPRESSION, "Evaluator: invalid expression"};
+        if (subtreeStarts.size() > FINAL_STACK_SIZE && program.variables.empty())
+        {
+            findCallError(program, status);
+        }
+        return false;
+    }
+    return true;
 }
 
-void s2e2::EvaluatorImpl::processOperator(const Token& token) const
+void s2e2::EvaluatorImpl::findCallError(const Program& program, Status& status) const
 {
-    try
+    const CostModel costModel(limits_);
+    Status costStatus;
+    if (!costModel.checkCost(costModel.estimate(program, 0), costStatus))
     {
-        const auto& op = operators_.at(token.value);
-        op->invoke(stack_);
+        return;
     }
-    catch (const std::out_of_range&)
+
+    ScalarExecutor executor;
+    std::optional<std::string> result;
+    Status executionStatus;
+    if (!executor.tryExecute(program, RecordBatch::rowMajor({}, 1, 0), 0, nullptr, result, executionStatus))
     {
-        throw Error("Evaluator: unsupported operator " + token.value);
+        status = std::move(executionStatus);
     }
 }
 
-void s2e2::EvaluatorImpl::processFunction(const Token& token) const
+void s2e2::EvaluatorImpl::compileAtom(const Token& token, Program& program) const
 {
-    try
+    const auto variable = std::find(program.variables.begin(), program.variables.end(), token.value);
+    if (variable != program.variables.end())
     {
-        const auto& fn = functions_.at(token.value);
-        fn->invoke(stack_);
+        const auto index = static_cast<uint32_t>(variable - program.variables.begin());
+        program.instructions.push_back(Instruction{InstructionType::VARIABLE, index, 0, nullptr, nullptr, Builtin::NONE, 0,
+                                                   token.position});
+        return;
     }
-    catch (const std::out_of_range&)
+
+    const auto index = static_cast<uint32_t>(program.constants.size());
+    program.constants.push_back((token.value == NULL_VALUE) ? std::any{} : std::any{token.value});
+    program.instructions.push_back(Instruction{InstructionType::CONSTANT, index, 0, nullptr, nullptr, Builtin::NONE, 0,
+                                               token.position});
+}
+
+bool s2e2::EvaluatorImpl::compileOperator(const Token& token, Program& program, Status& status) const
+{
+    const auto* op = registry_->findOperator(token);
+    if (!op)
     {
-        throw Error("Evaluator: unsupported function " + token.value);
+        status = Status{ErrorCode::UNSUPPORTED_OPERATOR, "Evaluator: unsupported operator " + token.value, token.position};
+        return false;
     }
+    const auto numberOfArguments = static_cast<uint32_t>(op->numberOfArguments());
+    program.instructions.push_back(Instruction{InstructionType::OPERATOR, 0, 0, op, nullptr, builtinOperator(op), numberOfArguments,
+                                               token.position});
+    return true;
 }
 
-std::optional<std::string> s2e2::EvaluatorImpl::getResultValueFromStack() const
+bool s2e2::EvaluatorImpl::compileFunction(const Token& token, Program& program, Status& status) const
 {
-    if (stack_.size() != FINAL_STACK_SIZE)
+    const auto* fn = registry_->findFunction(token);
+    if (!fn)
     {
-        throw Error("Evaluator: invalid expression");
+        status = Status{ErrorCode::UNSUPPORTED_FUNCTION, "Evaluator: unsupported function " + token.value, token.position};
+        return false;
     }
 
-    const auto& result = stack_.top();
-
-    if (!result.has_value())
+    // only variadic functions rely on the number of arguments counted by the converter
+    const auto numberOfArguments = static_cast<uint32_t>(fn->isVariadic() ? token.numberOfArguments : fn->numberOfArguments());
+    if (numberOfArguments < fn->numberOfArguments())
     {
-        return {};
+        status = Status{ErrorCode::INVALID_NUMBER_OF_ARGUMENTS, "Invalid number of arguments for function " + fn->name,
+                        token.position};
+        return false;
     }
+    program.instructions.push_back(Instruction{InstructionType::FUNCTION, 0, 0, nullptr, fn, builtinFunction(fn), numberOfArguments,
+                                               token.position});
+    return true;
+}
 
-    static const auto& stringType = typeid(std::string);
-    if (result.type() != stringType)
+s2e2::RegistryImpl& s2e2::EvaluatorImpl::writableRegistry()
+{
+    // compiled programs of the cache share the registry too, they are dropped anyway
+    cache_.clear();
+    return RegistryImpl::writable(registry_);
+}
+
+void s2e2::EvaluatorImpl::checkVariables(const std::vector<std::string>& variables, const RecordBatch& records) const
+{
+    if (records.numberOfVariables() != variables.size())
     {
-        throw Error("Evaluator: expression value is not a string");
+        throw std::invalid_argument("Evaluator: number of variables does not match the expression");
     }
-
-    return {std::any_cast<std::string>(std::move(result))};
 }
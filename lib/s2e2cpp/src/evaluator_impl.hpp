@@ -1,19 +1,38 @@
 #pragma once
 
+#include "execution_context.hpp"
+#include "graph_program.hpp"
 #include "interface_converter.hpp"
 #include "interface_tokenizer.hpp"
+#include "program.hpp"
+#include "program_cache.hpp"
+#include "registry_impl.hpp"
+#include "rule_program.hpp"
+#include "rule_set_executor.hpp"
+#include "scalar_executor.hpp"
 #include "token.hpp"
+#include "tracer_impl.hpp"
+#include "vectorized_executor.hpp"
+#include "work_stealing_pool.hpp"
 
+#include <s2e2/compile_cache.hpp>
+#include <s2e2/execution_limits.hpp>
 #include <s2e2/function.hpp>
 #include <s2e2/operator.hpp>
+#include <s2e2/record_batch.hpp>
+#include <s2e2/rule_set.hpp>
+#include <s2e2/span.hpp>
+#include <s2e2/status.hpp>
 
-#include <any>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <optional>
-#include <stack>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 namespace s2e2
@@ -38,11 +57,17 @@ namespace s2e2
          */
         EvaluatorImpl(std::unique_ptr<IConverter>&& converter, std::unique_ptr<ITokenizer>&& tokenizer);
 
+        /**
+         * @brief Construct the evaluator sharing the registry with its other owners.
+         * @param[in] registry - Registry of functions and operators, not empty.
+         */
+        explicit EvaluatorImpl(std::shared_ptr<RegistryImpl> registry);
+
         /**
          * @brief Add function to set of supported functions.
          * @param[in] fn - Pointer to new supported function.
          * @throws std::invalid_argument if pointer is empty.
-         * @throws Error if function or operator with the same name is already added.
+         * @throws Error if function or operator with the same name is already added or the evaluator is frozen.
          */
         void addFunction(std::unique_ptr<Function>&& fn);
 
@@ -50,7 +75,7 @@ namespace s2e2
          * @brief Add operator to set of supported operators.
          * @param[in] op - Pointer to new supported operator.
          * @throws std::invalid_argument if pointer is empty.
-         * @throws Error if function or operator with the same name is already added.
+         * @throws Error if function or operator with the same name is already added or the evaluator is frozen.
          */
         void addOperator(std::unique_ptr<Operator>&& op);
 
@@ -66,6 +91,20 @@ namespace s2e2
          */
         void addStandardOperators();
 
+        /**
+         * @brief Make the set of functions and operators final and build compact lookup tables of their names.
+         * @details Names are looked up by a perfect hash and operators inside words are found by a precomputed
+         *          automaton. Expressions are tokenized the same way as before. Adding functions or operators
+         *          afterwards throws Error. Freezing twice does nothing.
+         */
+        void freeze();
+
+        /**
+         * @brief Check if functions and operators are frozen.
+         * @returns true if freeze() was called.
+         */
+        bool frozen() const;
+
         /**
          * @brief Get collection of pointers to all supported functions.
          * @returns Collection of pointers to functions.
@@ -78,6 +117,87 @@ namespace s2e2
          */
         std::unordered_set<const Operator*> getOperators() const;
 
+        /**
+         * @brief Get the registry to share it with other owners.
+         * @returns Registry of functions and operators.
+         */
+        std::shared_ptr<RegistryImpl> registry() const;
+
+        /**
+         * @brief Set tracer to record evaluation timelines into.
+         * @param[in] tracer - Tracer, can be empty to disable tracing.
+         */
+        void setTracer(std::shared_ptr<TracerImpl> tracer);
+
+        /**
+         * @brief Set pool of threads to split evaluations between.
+         * @param[in] pool - Thread pool, can be empty to evaluate in the calling thread only.
+         */
+        void setThreadPool(std::shared_ptr<WorkStealingPool> pool);
+
+        /**
+         * @brief Set the resource arenas of intermediate values take their memory from.
+         * @param[in] resource - Memory resource, null for the default one.
+         */
+        void setMemoryResource(std::pmr::memory_resource* resource);
+
+        /**
+         * @brief Turn short-circuit evaluation of &&, || and IF record by record on or off.
+         * @param[in] enabled - Is short-circuit evaluation on.
+         */
+        void setShortCircuit(bool enabled);
+
+        /**
+         * @brief Turn adaptive reordering of chains of && and || in expressions compiled afterwards on or off.
+         * @param[in] enabled - Is reordering on.
+         */
+        void setAdaptiveReordering(bool enabled);
+
+        /**
+         * @brief Set limits of expressions compiled afterwards.
+         * @param[in] limits - Limits, zero values mean no limit.
+         */
+        void setLimits(const ExpressionLimits& limits);
+
+        /**
+         * @brief Set limits of every evaluation.
+         * @param[in] limits - Limits, zero values mean no limit.
+         */
+        void setExecutionLimits(const ExecutionLimits& limits);
+
+        /**
+         * @brief Set options of the cache of compiled expressions and compile failures, dropping everything cached.
+         * @param[in] options - Options, zero capacities disable the cache.
+         */
+        void setCompileCache(const CompileCacheOptions& options);
+
+        /**
+         * @brief Get counters of the cache of compiled expressions.
+         * @returns Counters.
+         */
+        CompileCacheStatistics compileCacheStatistics() const;
+
+        /**
+         * @brief Compile the expression.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled program.
+         * @throws Error in case of an invalid expression.
+         */
+        std::shared_ptr<const Program> compile(const std::string& expression,
+                                               const std::vector<std::string>& variables) const;
+
+        /**
+         * @brief Compile the expression without throwing on errors of the expression.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] status - Error with the position of the failed token.
+         * @returns Compiled program or null in case of an error.
+         */
+        std::shared_ptr<const Program> tryCompile(const std::string& expression,
+                                                  const std::vector<std::string>& variables,
+                                                  Status& status) const;
+
         /**
          * @brief Evaluate the expression.
          * @param[in] expression - Input expression.
@@ -86,64 +206,314 @@ namespace s2e2
          */
         std::optional<std::string> evaluate(const std::string& expression) const;
 
+        /**
+         * @brief Evaluate the expression without throwing.
+         * @param[in] expression - Input expression.
+         * @param[out] result - Value of expression as a string or empty value if the result is NULL.
+         * @param[out] status - Error, exceptions of custom functions and operators are turned into CALL_FAILED.
+         * @returns true on success, false in case of an error.
+         */
+        bool tryEvaluate(const std::string& expression, std::optional<std::string>& result, Status& status) const;
+
+        /**
+         * @brief Check without tokenizing the expression if it is a string literal.
+         * @param[in] expression - Input expression.
+         * @returns The same expression if it is a literal within the limits, empty value otherwise.
+         */
+        std::optional<std::string_view> asLiteral(std::string_view expression) const;
+
+        /**
+         * @brief Evaluate the compiled program for one record.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @returns Value of expression as a string or empty value if the result is NULL.
+         * @throws std::invalid_argument if number of variables does not match the program.
+         * @throws Error in case of an invalid expression.
+         */
+        std::optional<std::string> evaluate(const Program& program, const RecordBatch& records, size_t record) const;
+
+        /**
+         * @brief Evaluate the compiled program for one record without throwing.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @param[out] result - Value of expression as a string or empty value if the result is NULL.
+         * @param[out] status - Error, exceptions of custom functions and operators are turned into CALL_FAILED.
+         * @returns true on success, false in case of an error.
+         */
+        bool tryEvaluate(const Program& program,
+                         const RecordBatch& records,
+                         size_t record,
+                         std::optional<std::string>& result,
+                         Status& status) const;
+
+        /**
+         * @brief Evaluate the compiled program for every record of the batch.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[out] results - Values of expression, one per record.
+         * @param[out] statuses - Outcomes of evaluation, one per record.
+         * @param[in] mode - Execution mode, both modes produce identical results.
+         * @returns Number of records which failed to evaluate.
+         * @throws std::invalid_argument if batch dimensions do not match the program or outputs.
+         */
+        size_t evaluateBatch(const Program& program,
+                             const RecordBatch& records,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses,
+                             ExecutionMode mode) const;
+
+        /**
+         * @brief Compile the expressions into one rule program sharing their identical sub-expressions.
+         * @param[in] expressions - Input expressions in priority order.
+         * @param[in] variables - Names of variables, atoms with these names are bound to values on evaluation.
+         * @returns Compiled rule program.
+         * @throws Error in case of an invalid expression.
+         */
+        std::shared_ptr<const RuleProgram> compileRuleSet(const std::vector<std::string>& expressions,
+                                                          const std::vector<std::string>& variables) const;
+
+        /**
+         * @brief Convert the compiled expression into a rule program of one rule.
+         * @param[in] program - Compiled expression.
+         * @returns Rule program.
+         */
+        std::shared_ptr<const RuleProgram> toRuleProgram(const Program& program) const;
+
+        /**
+         * @brief Evaluate all rules of the rule program for one record.
+         * @param[in] program - Compiled rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @param[out] results - Values of rules, one per rule.
+         * @param[out] statuses - Outcomes of evaluation, one per rule.
+         * @returns Number of rules which failed to evaluate.
+         * @throws std::invalid_argument if number of variables or size of outputs does not match the program.
+         */
+        size_t evaluateRules(const RuleProgram& program,
+                             const RecordBatch& records,
+                             size_t record,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses) const;
+
+        /**
+         * @brief Find the first rule of the rule program evaluating into a not NULL value for one record.
+         * @param[in] program - Compiled rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @returns Matched rule or empty value if no rule matched.
+         * @throws std::invalid_argument if number of variables does not match the program.
+         */
+        std::optional<RuleMatch> evaluateFirstMatch(const RuleProgram& program,
+                                                    const RecordBatch& records,
+                                                    size_t record) const;
+
+        /**
+         * @brief Compile named expressions referring to each other into one graph program.
+         * @param[in] fields - Names and expressions of fields.
+         * @param[in] variables - Names of input variables.
+         * @returns Compiled graph program.
+         * @throws Error in case of an invalid expression, a repeated name or a cycle of references.
+         */
+        std::shared_ptr<const GraphProgram> compileGraph(const std::vector<std::pair<std::string, std::string>>& fields,
+                                                         const std::vector<std::string>& variables) const;
+
+        /**
+         * @brief Evaluate all fields of the graph program for one record, independent fields in parallel.
+         * @details A field referring to a failed field fails too.
+         * @param[in] program - Compiled graph program.
+         * @param[in] records - Values of input variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @param[out] results - Values of fields, one per field.
+         * @param[out] statuses - Outcomes of evaluation, one per field.
+         * @returns Number of fields which failed to evaluate.
+         * @throws std::invalid_argument if number of variables or size of outputs does not match the program.
+         */
+        size_t evaluateGraph(const GraphProgram& program,
+                             const RecordBatch& records,
+                             size_t record,
+                             Span<std::optional<std::string>> results,
+                             Span<RecordStatus> statuses) const;
+
     private:
         /**
-         * @brief Check is function's or operator's name is unique.
-         * @param[in] entityName - Function's or operator's name.
-         * @throws Error if the name is not unique.
+         * @brief Executors of one worker.
+         */
+        struct Executors
+        {
+            /// @brief Executor of programs record by record.
+            ScalarExecutor scalar;
+
+            /// @brief Executor of programs vector by vector.
+            VectorizedExecutor vectorized;
+
+            /// @brief Executor of rule and graph programs.
+            RuleSetExecutor rules;
+        };
+
+        /**
+         * @brief Start counting limits of a call of the evaluator.
+         * @returns Execution context or empty value if evaluations are not limited.
          */
-        void checkUniqueness(const std::string& entityName) const;
+        std::optional<ExecutionContext> startExecution() const;
 
         /**
-         * @brief Get value of the postfix sequence of tokens.
-         * @param[in] postfixExpression - Sequence of tokens.
-         * @return String value or empty value.
+         * @brief Start counting limits of a call of the evaluator without throwing.
+         * @param[out] context - Execution context or empty value if evaluations are not limited.
+         * @param[out] status - CANCELLED or DEADLINE_EXCEEDED error if the call is cancelled or late already.
+         * @returns true if the call can run.
+         */
+        bool tryStartExecution(std::optional<ExecutionContext>& context, Status& status) const;
+
+        /**
+         * @brief Compile and evaluate the expression reporting its errors as a status.
+         * @param[in] expression - Input expression.
+         * @param[out] result - Value of expression as a string or empty value if the result is NULL.
+         * @param[out] status - Error of the expression.
+         * @returns true on success, false in case of an error.
+         * @throws AbortedError if the call starts cancelled or past its deadline.
+         */
+        bool evaluateExpression(const std::string& expression, std::optional<std::string>& result, Status& status) const;
+
+        /**
+         * @brief Evaluate the compiled program for one record reporting its errors as a status.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record to evaluate.
+         * @param[out] result - Value of expression as a string or empty value if the result is NULL.
+         * @param[out] status - Error of the expression, INVALID_VARIABLES if number of variables does not match.
+         * @returns true on success, false in case of an error.
+         * @throws AbortedError if the call starts cancelled or past its deadline.
+         */
+        bool evaluateProgram(const Program& program,
+                             const RecordBatch& records,
+                             size_t record,
+                             std::optional<std::string>& result,
+                             Status& status) const;
+
+        /**
+         * @brief Find the compiled program or the compile failure in the cache, compile and cache it otherwise.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] status - Error with the position of the failed token.
+         * @returns Compiled program with adaptive chains if they are on, or null in case of an error.
+         */
+        std::shared_ptr<const Program> compileCached(const std::string& expression,
+                                                     const std::vector<std::string>& variables,
+                                                     Status& status) const;
+
+        /**
+         * @brief Compile the expression within the current trace.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @returns Compiled program.
          * @throws Error in case of an invalid expression.
          */
-        std::optional<std::string> evaluateExpression(const std::list<Token>& postfixExpression) const;
+        std::shared_ptr<Program> compileProgram(const std::string& expression,
+                                                const std::vector<std::string>& variables) const;
+
+        /**
+         * @brief Compile the expression within the current trace without throwing on errors of the expression.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] status - Error with the position of the failed token.
+         * @returns Compiled program or null in case of an error.
+         */
+        std::shared_ptr<Program> compileProgram(const std::string& expression,
+                                                const std::vector<std::string>& variables,
+                                                Status& status) const;
+
+        /**
+         * @brief Turn the postfix sequence of tokens into the program.
+         * @param[in] postfixExpression - Sequence of tokens.
+         * @param[in, out] program - Program with already set expression and variables.
+         * @param[out] status - Error with the position of the failed token.
+         * @returns false in case of an invalid expression.
+         */
+        bool compileExpression(const std::list<Token>& postfixExpression, Program& program, Status& status) const;
+
+        /**
+         * @brief Find the error of a program leaving more than one value, which has no variables.
+         * @details Such programs used to run and fail in the call given too many arguments rather than as invalid
+         *          expressions, so the program runs once within the cost limits to report the same error.
+         * @param[in] program - Compiled program.
+         * @param[out] status - Error of the call, left untouched if the program does not run.
+         */
+        void findCallError(const Program& program, Status& status) const;
 
         /**
-         * @brief Process ATOM token.
+         * @brief Compile ATOM token.
          * @param[in] token - ATOM token.
+         * @param[in, out] program - Program being compiled.
          */
-        void processAtom(const Token& token) const;
+        void compileAtom(const Token& token, Program& program) const;
 
         /**
-         * @brief Process OPERATOR token.
+         * @brief Compile OPERATOR token.
          * @param[in] token - OPERATOR token.
-         * @throws Error in case of unsupported operator.
+         * @param[in, out] program - Program being compiled.
+         * @param[out] status - Error in case of unsupported operator.
+         * @returns false in case of unsupported operator.
          */
-        void processOperator(const Token& token) const;
+        bool compileOperator(const Token& token, Program& program, Status& status) const;
 
         /**
-         * @brief Process FUNCTION token.
+         * @brief Compile FUNCTION token.
          * @param[in] token - FUNCTION token.
-         * @throws Error in case of unsupported function.
+         * @param[in, out] program - Program being compiled.
+         * @param[out] status - Error in case of unsupported function or invalid number of arguments.
+         * @returns false in case of an error.
          */
-        void processFunction(const Token& token) const;
+        bool compileFunction(const Token& token, Program& program, Status& status) const;
 
         /**
-         * @brief Get result value from the stack of intermediate values.
-         * @return String value or empty value.
-         * @throws Error in case of an invalid expression.
+         * @brief Get the registry to add functions or operators to, copying it first if it is shared and not frozen.
+         * @returns Registry owned by the evaluator only unless it is frozen.
+         */
+        RegistryImpl& writableRegistry();
+
+        /**
+         * @brief Check that the program values match the variables.
+         * @param[in] variables - Names of variables of the program.
+         * @param[in] records - Values of variables.
+         * @throws std::invalid_argument if number of variables does not match the program.
          */
-        std::optional<std::string> getResultValueFromStack() const;
+        void checkVariables(const std::vector<std::string>& variables, const RecordBatch& records) const;
 
     private:
-        /// @brief Converter of infix token sequence into postfix one.
-        const std::unique_ptr<IConverter> converter_;
+        /// @brief Functions and operators, can be shared with other evaluators and compiled programs.
+        std::shared_ptr<RegistryImpl> registry_;
+
+        /// @brief Workers evaluating parts of work in parallel, can be shared with other evaluators.
+        std::shared_ptr<WorkStealingPool> pool_;
+
+        /// @brief Resource arenas of executors take their memory from, null for the default one.
+        std::pmr::memory_resource* memoryResource_ = nullptr;
+
+        /// @brief Executors of every worker, kept to reuse their buffers. The first ones serve sequential calls.
+        mutable std::vector<Executors> executors_;
+
+        /// @brief Tracer to record evaluation timelines into.
+        std::shared_ptr<TracerImpl> tracer_;
+
+        /// @brief Limits of compiled expressions.
+        ExpressionLimits limits_;
+
+        /// @brief Limits of evaluations.
+        ExecutionLimits executionLimits_;
 
-        /// @brief Tokenizer of expression onto list of tokens.
-        const std::unique_ptr<ITokenizer> tokenizer_;
+        /// @brief Do compiled expressions reorder their chains of && and ||.
+        bool adaptiveReordering_ = false;
 
-        /// @brief Set of all supported functions.
-        std::unordered_map<std::string, std::unique_ptr<Function>> functions_;
+        /// @brief Do &&, || and IF evaluated record by record execute only the subtrees deciding their value.
+        bool shortCircuit_ = false;
 
-        /// @brief Set of all supported operators.
-        std::unordered_map<std::string, std::unique_ptr<Operator>> operators_;
+        /// @brief Compiled expressions and compile failures, dropped whenever anything affecting compilation changes.
+        mutable ProgramCache cache_;
 
-        /// @brief Stack of intermediate values.
-        mutable std::stack<std::any> stack_;
+        /// @brief Tracer of the current evaluation if it is sampled, null otherwise.
+        mutable TracerImpl* activeTracer_ = nullptr;
     };
 
 } // namespace s2e2
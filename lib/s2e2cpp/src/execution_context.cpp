@@ -0,0 +1,148 @@
+#include "error_status.hpp"
+#include "execution_context.hpp"
+
+#include <string>
+#include <typeinfo>
+
+
+namespace // anonymous
+{
+    /// @brief Context of the current thread.
+    thread_local s2e2::ExecutionContext* currentContext = nullptr;
+
+} // namespace anonymous
+
+
+s2e2::ExecutionContext::Scope::Scope(ExecutionContext* context)
+    : previous_{currentContext}
+{
+    currentContext = context;
+}
+
+s2e2::ExecutionContext::Scope::~Scope()
+{
+    currentContext = previous_;
+}
+
+s2e2::ExecutionContext::ExecutionContext(const ExecutionLimits& limits)
+    : cancellation_{limits.cancellation}
+    , deadline_{limits.deadline}
+    , maxStringSize_{limits.maxStringSize}
+{
+    if (limits.timeout.count() > 0)
+    {
+        const auto now = Clock::now();
+        // a timeout past the end of the clock means no timeout
+        if (limits.timeout < deadline_ - now)
+        {
+            deadline_ = now + std::chrono::duration_cast<Clock::duration>(limits.timeout);
+        }
+    }
+}
+
+bool s2e2::ExecutionContext::isLimited(const ExecutionLimits& limits)
+{
+    return limits.timeout.count() > 0 || limits.deadline != Clock::time_point::max() ||
+           limits.maxStringSize != 0 || limits.cancellation;
+}
+
+s2e2::ExecutionContext* s2e2::ExecutionContext::current()
+{
+    return currentContext;
+}
+
+void s2e2::ExecutionContext::check()
+{
+    Status status;
+    if (!tryCheck(status))
+    {
+        throwError(status);
+    }
+}
+
+bool s2e2::ExecutionContext::tryCheck(Status& status)
+{
+    if (cancellation_ && cancellation_->isCancelled())
+    {
+        status = cancelledStatus();
+        return false;
+    }
+    if (--countdown_ == 0)
+    {
+        countdown_ = CHECK_PERIOD;
+        return tryCheckNow(status);
+    }
+    return true;
+}
+
+void s2e2::ExecutionContext::checkNow()
+{
+    Status status;
+    if (!tryCheckNow(status))
+    {
+        throwError(status);
+    }
+}
+
+bool s2e2::ExecutionContext::tryCheckNow(Status& status)
+{
+    if (cancellation_ && cancellation_->isCancelled())
+    {
+        status = cancelledStatus();
+        return false;
+    }
+    if (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_)
+    {
+        status = deadlineExceededStatus();
+        return false;
+    }
+    return true;
+}
+
+bool s2e2::ExecutionContext::fits(size_t size) const
+{
+    return maxStringSize_ == 0 || size <= maxStringSize_;
+}
+
+void s2e2::ExecutionContext::checkSize(size_t size) const
+{
+    Status status;
+    if (!tryCheckSize(size, status))
+    {
+        throwError(status);
+    }
+}
+
+bool s2e2::ExecutionContext::tryCheckSize(size_t size, Status& status) const
+{
+    if (!fits(size))
+    {
+        status = stringTooLongStatus(size, maxStringSize_);
+        return false;
+    }
+    return true;
+}
+
+void s2e2::ExecutionContext::checkValue(const std::any& value) const
+{
+    Status status;
+    if (!tryCheckValue(value, status))
+    {
+        throwError(status);
+    }
+}
+
+bool s2e2::ExecutionContext::tryCheckValue(const std::any& value, Status& status) const
+{
+    if (maxStringSize_ == 0)
+    {
+        return true;
+    }
+    const auto* string = std::any_cast<std::string>(&value);
+    if (string && !fits(string->size()))
+    {
+        status = stringTooLongStatus(string->size(), maxStringSize_);
+        return false;
+    }
+    return true;
+}
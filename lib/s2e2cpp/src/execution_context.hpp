@@ -0,0 +1,152 @@
+#pragma once
+
+#include <s2e2/execution_limits.hpp>
+#include <s2e2/status.hpp>
+
+#include <any>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+namespace s2e2
+{
+    /**
+     * @class ExecutionContext
+     * @brief Limits of one call of the evaluator checked while it runs.
+     * @details Every thread working on the call installs its own copy as the current context of the thread,
+     *          so built-in functions check it without it being passed through the generic call interface.
+     */
+    class ExecutionContext final
+    {
+    public:
+        /// @brief Clock of deadlines.
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Every this call of check() reads the clock.
+        static constexpr uint32_t CHECK_PERIOD = 64;
+
+        /**
+         * @class Scope
+         * @brief Makes the context current for the thread until the end of the scope.
+         */
+        class Scope final
+        {
+        public:
+            /**
+             * @brief Constructor.
+             * @param[in] context - Context, can be null to run without limits.
+             */
+            explicit Scope(ExecutionContext* context);
+
+            /**
+             * @brief Destructor, restores the previous context.
+             */
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            /// @brief Context current before the scope.
+            ExecutionContext* previous_;
+        };
+
+        /**
+         * @brief Constructor, starts counting the timeout.
+         * @param[in] limits - Limits.
+         */
+        explicit ExecutionContext(const ExecutionLimits& limits);
+
+        /**
+         * @brief Check if the limits need checking at all.
+         * @param[in] limits - Limits.
+         * @returns true if any limit is set.
+         */
+        static bool isLimited(const ExecutionLimits& limits);
+
+        /**
+         * @brief Get context of the current thread.
+         * @returns Context or null if the thread runs without limits.
+         */
+        static ExecutionContext* current();
+
+        /**
+         * @brief Check the cancellation token, and the deadline once in CHECK_PERIOD calls.
+         * @throws AbortedError if the evaluation is cancelled or the deadline is exceeded.
+         */
+        void check();
+
+        /**
+         * @brief Check the cancellation token, and the deadline once in CHECK_PERIOD calls, without throwing.
+         * @param[out] status - CANCELLED or DEADLINE_EXCEEDED error in case of failure.
+         * @returns true if the evaluation can go on.
+         */
+        bool tryCheck(Status& status);
+
+        /**
+         * @brief Check both the cancellation token and the deadline.
+         * @throws AbortedError if the evaluation is cancelled or the deadline is exceeded.
+         */
+        void checkNow();
+
+        /**
+         * @brief Check both the cancellation token and the deadline without throwing.
+         * @param[out] status - CANCELLED or DEADLINE_EXCEEDED error in case of failure.
+         * @returns true if the evaluation can go on.
+         */
+        bool tryCheckNow(Status& status);
+
+        /**
+         * @brief Check if a string of the size fits the limit.
+         * @param[in] size - Size in bytes.
+         * @returns true if the size does not exceed the limit.
+         */
+        bool fits(size_t size) const;
+
+        /**
+         * @brief Check size of a string being produced.
+         * @param[in] size - Size in bytes.
+         * @throws SizeLimitError if the size exceeds the limit.
+         */
+        void checkSize(size_t size) const;
+
+        /**
+         * @brief Check size of a string being produced without throwing.
+         * @param[in] size - Size in bytes.
+         * @param[out] status - STRING_TOO_LONG error in case of failure.
+         * @returns true if the size does not exceed the limit.
+         */
+        bool tryCheckSize(size_t size, Status& status) const;
+
+        /**
+         * @brief Check size of the value if it is a string.
+         * @param[in] value - Value.
+         * @throws SizeLimitError if the size exceeds the limit.
+         */
+        void checkValue(const std::any& value) const;
+
+        /**
+         * @brief Check size of the value if it is a string without throwing.
+         * @param[in] value - Value.
+         * @param[out] status - STRING_TOO_LONG error in case of failure.
+         * @returns true if the value fits the limit.
+         */
+        bool tryCheckValue(const std::any& value, Status& status) const;
+
+    private:
+        /// @brief Token cancelling the evaluation, can be empty.
+        std::shared_ptr<const CancellationToken> cancellation_;
+
+        /// @brief Point in time the evaluation must finish by.
+        Clock::time_point deadline_;
+
+        /// @brief Maximal size of a string, zero means no limit.
+        size_t maxStringSize_;
+
+        /// @brief Number of calls of check() left before the next reading of the clock.
+        uint32_t countdown_ = CHECK_PERIOD;
+    };
+
+} // namespace s2e2
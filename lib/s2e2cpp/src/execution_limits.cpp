@@ -0,0 +1,17 @@
+#include <s2e2/execution_limits.hpp>
+
+
+void s2e2::CancellationToken::cancel()
+{
+    cancelled_.store(true, std::memory_order_release);
+}
+
+bool s2e2::CancellationToken::isCancelled() const
+{
+    return cancelled_.load(std::memory_order_acquire);
+}
+
+void s2e2::CancellationToken::reset()
+{
+    cancelled_.store(false, std::memory_order_release);
+}
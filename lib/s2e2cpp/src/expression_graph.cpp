@@ -0,0 +1,40 @@
+#include "graph_program.hpp"
+
+#include <s2e2/expression_graph.hpp>
+
+#include <stdexcept>
+
+
+s2e2::ExpressionGraph::ExpressionGraph(std::shared_ptr<const GraphProgram> program)
+    : program_{std::move(program)}
+{
+    if (!program_)
+    {
+        throw std::invalid_argument("ExpressionGraph: pointer to program is empty");
+    }
+}
+
+size_t s2e2::ExpressionGraph::size() const
+{
+    return program_->names.size();
+}
+
+const std::vector<std::string>& s2e2::ExpressionGraph::names() const
+{
+    return program_->names;
+}
+
+std::vector<std::string> s2e2::ExpressionGraph::variables() const
+{
+    return program_->variables();
+}
+
+std::vector<size_t> s2e2::ExpressionGraph::order() const
+{
+    return {program_->order.begin(), program_->order.end()};
+}
+
+const s2e2::GraphProgram& s2e2::ExpressionGraph::program() const
+{
+    return *program_;
+}
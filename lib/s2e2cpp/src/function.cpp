@@ -1,29 +1,83 @@
-#include <s2e2/error.hpp>
+#include "error_status.hpp"
+#include "invocation_scope.hpp"
+
 #include <s2e2/function.hpp>
 
 
 void s2e2::Function::invoke(std::stack<std::any>& stack) const
 {
-    if (stack.size() < arguments_.size())
+    invoke(stack, numberOfArguments_);
+}
+
+void s2e2::Function::invoke(std::stack<std::any>& stack, size_t numberOfArguments) const
+{
+    Status status;
+    if (!tryInvoke(stack, numberOfArguments, status))
     {
-        throw Error("Not enough arguments for function " + name);
+        throwError(status);
     }
+}
 
-    for (int i = static_cast<int>(arguments_.size() - 1); i >= 0; --i)
+bool s2e2::Function::tryInvoke(std::stack<std::any>& stack, size_t numberOfArguments, Status& status) const
+{
+    if (numberOfArguments != numberOfArguments_ && (!variadic_ || numberOfArguments < numberOfArguments_))
     {
-        arguments_[i] = std::move(stack.top());
+        status = Status{ErrorCode::INVALID_NUMBER_OF_ARGUMENTS, "Invalid number of arguments for function " + name};
+        return false;
+    }
+
+    if (stack.size() < numberOfArguments)
+    {
+        status = Status{ErrorCode::NOT_ENOUGH_ARGUMENTS, "Not enough arguments for function " + name};
+        return false;
+    }
+
+    InvocationScope scope(numberOfArguments);
+    const auto arguments = scope.arguments();
+    for (auto i = numberOfArguments; i-- > 0;)
+    {
+        arguments[i] = std::move(stack.top());
         stack.pop();
     }
 
     if (!checkArguments())
     {
-        throw Error("Invalid arguments for function " + name);
+        status = Status{ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for function " + name};
+        return false;
+    }
+    std::any value;
+    if (!tryResult(value, status))
+    {
+        return false;
     }
-    stack.push(result());
+    stack.push(std::move(value));
+    return true;
+}
+
+bool s2e2::Function::tryResult(std::any& value, Status& /*status*/) const
+{
+    value = result();
+    return true;
+}
+
+size_t s2e2::Function::numberOfArguments() const
+{
+    return numberOfArguments_;
+}
+
+bool s2e2::Function::isVariadic() const
+{
+    return variadic_;
 }
 
 s2e2::Function::Function(std::string functionName, const uint_fast16_t numberOfArguments)
+    : Function(std::move(functionName), numberOfArguments, false)
+{
+}
+
+s2e2::Function::Function(std::string functionName, const uint_fast16_t numberOfArguments, const bool variadic)
     : name(std::move(functionName))
-    , arguments_(numberOfArguments)
+    , numberOfArguments_(numberOfArguments)
+    , variadic_(variadic)
 {
 }
@@ -50,7 +50,7 @@ std::any s2e2::FunctionAddDays::result() const
 
     datetime.tm_mday += days;
     const auto newTs = utcTs(&datetime);
-    datetime = *std::gmtime(&newTs);
+    datetime = utcTm(newTs);
 
     return std::any{std::move(datetime)};
 }
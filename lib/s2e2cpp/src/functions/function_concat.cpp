@@ -0,0 +1,77 @@
+#include "../error_status.hpp"
+#include "../execution_context.hpp"
+
+#include <s2e2/functions/function_concat.hpp>
+
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+
+
+s2e2::FunctionConcat::FunctionConcat()
+    : Function("CONCAT", 2, true)
+{
+}
+
+bool s2e2::FunctionConcat::checkArguments() const
+{
+    static const auto& stringType = typeid(std::string);
+
+    return std::all_of(arguments_.begin(), arguments_.end(), [](const std::any& argument)
+    {
+        return !argument.has_value() || argument.type() == stringType;
+    });
+}
+
+std::any s2e2::FunctionConcat::result() const
+{
+    std::any value;
+    Status status;
+    if (!tryResult(value, status))
+    {
+        throwError(status);
+    }
+    return value;
+}
+
+bool s2e2::FunctionConcat::tryResult(std::any& value, Status& status) const
+{
+    const auto* context = ExecutionContext::current();
+
+    // sizes are checked after every argument as a chain of + does, so the same size is reported over the limit
+    std::string* first = nullptr;
+    size_t size = 0;
+    for (size_t i = 0; i < arguments_.size(); ++i)
+    {
+        auto* argument = std::any_cast<std::string>(&arguments_[i]);
+        if (argument)
+        {
+            first = first ? first : argument;
+            size += argument->size();
+        }
+        if (context && i > 0 && !context->tryCheckSize(size, status))
+        {
+            return false;
+        }
+    }
+
+    if (!first)
+    {
+        value.reset();
+        return true;
+    }
+
+    // arguments are owned by the invocation, so the result takes over the buffer of the first string
+    auto result = std::move(*first);
+    result.reserve(size);
+    for (auto& argument : arguments_)
+    {
+        const auto* string = std::any_cast<std::string>(&argument);
+        if (string && string != first)
+        {
+            result.append(*string);
+        }
+    }
+    value = std::move(result);
+    return true;
+}
@@ -0,0 +1,35 @@
+#include <s2e2/functions/function_in.hpp>
+
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+
+
+s2e2::FunctionIn::FunctionIn()
+    : Function("IN", 2, true)
+{
+}
+
+bool s2e2::FunctionIn::checkArguments() const
+{
+    static const auto& stringType = typeid(std::string);
+
+    return std::all_of(arguments_.begin(), arguments_.end(), [](const std::any& argument)
+    {
+        return !argument.has_value() || argument.type() == stringType;
+    });
+}
+
+std::any s2e2::FunctionIn::result() const
+{
+    const auto& value = arguments_[0];
+
+    return {std::any_of(arguments_.begin() + 1, arguments_.end(), [&value](const std::any& candidate)
+    {
+        if (!value.has_value() || !candidate.has_value())
+        {
+            return value.has_value() == candidate.has_value();
+        }
+        return *std::any_cast<std::string>(&value) == *std::any_cast<std::string>(&candidate);
+    })};
+}
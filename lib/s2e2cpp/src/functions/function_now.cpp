@@ -1,3 +1,5 @@
+#include "../utils.hpp"
+
 #include <s2e2/functions/function_now.hpp>
 
 #include <ctime>
@@ -16,7 +18,5 @@ bool s2e2::FunctionNow::checkArguments() const
 std::any s2e2::FunctionNow::result() const
 {
     const auto now = std::time(nullptr);
-    const auto* tm = std::gmtime(&now);
-
-    return std::any{*tm};
+    return std::any{utcTm(now)};
 }
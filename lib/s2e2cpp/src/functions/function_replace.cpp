@@ -1,10 +1,40 @@
+#include "../error_status.hpp"
+#include "../execution_context.hpp"
+
 #include <s2e2/functions/function_replace.hpp>
 
+#include <iterator>
 #include <regex>
 #include <string>
 #include <typeinfo>
 
 
+namespace // anonymous
+{
+    /**
+     * @brief Get the compiled regular expression, compiling it only if it differs from the previous one of the thread.
+     * @param[in] pattern - Regular expression.
+     * @returns Compiled regular expression, valid until the next call in the same thread.
+     * @throws std::regex_error if the pattern is invalid.
+     */
+    const std::regex& compile(const std::string& pattern)
+    {
+        thread_local std::string lastPattern;
+        thread_local std::regex lastRegex;
+        thread_local bool compiled = false;
+
+        if (!compiled || pattern != lastPattern)
+        {
+            compiled = false;
+            lastRegex.assign(pattern);
+            lastPattern = pattern;
+            compiled = true;
+        }
+        return lastRegex;
+    }
+}
+
+
 s2e2::FunctionReplace::FunctionReplace()
     : Function("REPLACE", 3)
 {
@@ -40,16 +70,58 @@ bool s2e2::FunctionReplace::checkArguments() const
 }
 
 std::any s2e2::FunctionReplace::result() const
+{
+    std::any value;
+    Status status;
+    if (!tryResult(value, status))
+    {
+        throwError(status);
+    }
+    return value;
+}
+
+bool s2e2::FunctionReplace::tryResult(std::any& value, Status& status) const
 {
     if (!arguments_[0].has_value())
     {
-        return std::any{};
+        value.reset();
+        return true;
     }
 
     const auto* source = std::any_cast<std::string>(&arguments_[0]);
-    const auto regex = std::regex(*std::any_cast<std::string>(&arguments_[1]));
+    const auto& regex = compile(*std::any_cast<std::string>(&arguments_[1]));
     const auto* replacement = std::any_cast<std::string>(&arguments_[2]);
 
-    auto result = std::regex_replace(*source, regex, *replacement);
-    return std::any{std::move(result)};
+    auto* context = ExecutionContext::current();
+    if (!context)
+    {
+        value = std::regex_replace(*source, regex, *replacement);
+        return true;
+    }
+
+    // the same as std::regex_replace, but checks limits after every match instead of once at the end
+    std::string result;
+    result.reserve(source->size());
+    auto rest = source->cbegin();
+    for (std::sregex_iterator match(source->cbegin(), source->cend(), regex), end; match != end; ++match)
+    {
+        if (!context->tryCheck(status))
+        {
+            return false;
+        }
+        result.append(match->prefix().first, match->prefix().second);
+        match->format(std::back_inserter(result), *replacement);
+        if (!context->tryCheckSize(result.size(), status))
+        {
+            return false;
+        }
+        rest = match->suffix().first;
+    }
+    if (!context->tryCheckSize(result.size() + static_cast<size_t>(source->cend() - rest), status))
+    {
+        return false;
+    }
+    result.append(rest, source->cend());
+    value = std::move(result);
+    return true;
 }
@@ -0,0 +1,130 @@
+#include "graph_program.hpp"
+
+#include <s2e2/error.hpp>
+
+#include <algorithm>
+#include <utility>
+
+
+namespace // anonymous
+{
+    /**
+     * @brief State of a field during depth-first search.
+     */
+    enum class Visit : uint8_t
+    {
+        NOT_VISITED,
+        IN_PROGRESS,
+        DONE
+    };
+
+} // namespace anonymous
+
+
+s2e2::GraphProgram::GraphProgram(std::vector<std::string> fieldNames,
+                                 size_t numberOfInputs,
+                                 std::shared_ptr<const RuleProgram> rules)
+    : names{std::move(fieldNames)}
+    , numberOfVariables{numberOfInputs}
+    , fields{std::move(rules)}
+{
+    dependents.resize(names.size());
+    for (uint32_t field = 0; field < names.size(); ++field)
+    {
+        dependencies.push_back(findDependencies(field));
+        for (const auto dependency : dependencies.back())
+        {
+            dependents[dependency].push_back(field);
+        }
+        if (dependencies.back().empty())
+        {
+            sources.push_back(field);
+        }
+    }
+
+    sortFields();
+}
+
+std::vector<std::string> s2e2::GraphProgram::variables() const
+{
+    const auto& all = fields->variables;
+    return {all.begin(), all.begin() + numberOfVariables};
+}
+
+std::vector<uint32_t> s2e2::GraphProgram::findDependencies(uint32_t field) const
+{
+    const auto& nodes = fields->nodes;
+    std::vector<uint8_t> reachable(nodes.size());
+    reachable[fields->roots[field]] = true;
+
+    // arguments always precede their nodes, so one backward pass finds all reachable nodes
+    std::vector<uint32_t> result;
+    for (auto node = nodes.size(); node-- > 0;)
+    {
+        if (!reachable[node])
+        {
+            continue;
+        }
+
+        const auto& ruleNode = nodes[node];
+        if (ruleNode.type == InstructionType::VARIABLE && ruleNode.index >= numberOfVariables)
+        {
+            result.push_back(static_cast<uint32_t>(ruleNode.index - numberOfVariables));
+        }
+        for (const auto argument : ruleNode.arguments)
+        {
+            reachable[argument] = true;
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void s2e2::GraphProgram::sortFields()
+{
+    std::vector<Visit> visits(names.size(), Visit::NOT_VISITED);
+    // path of the search: field and index of its next dependency to visit
+    std::vector<std::pair<uint32_t, size_t>> path;
+
+    for (uint32_t start = 0; start < names.size(); ++start)
+    {
+        if (visits[start] != Visit::NOT_VISITED)
+        {
+            continue;
+        }
+
+        visits[start] = Visit::IN_PROGRESS;
+        path.emplace_back(start, 0);
+
+        while (!path.empty())
+        {
+            auto& [field, next] = path.back();
+            if (next == dependencies[field].size())
+            {
+                visits[field] = Visit::DONE;
+                order.push_back(field);
+                path.pop_back();
+                continue;
+            }
+
+            const auto dependency = dependencies[field][next++];
+            if (visits[dependency] == Visit::NOT_VISITED)
+            {
+                visits[dependency] = Visit::IN_PROGRESS;
+                path.emplace_back(dependency, 0);
+            }
+            else if (visits[dependency] == Visit::IN_PROGRESS)
+            {
+                const auto it = std::find_if(path.begin(), path.end(),
+                                             [dependency](const auto& step) { return step.first == dependency; });
+                std::string cycle;
+                for (auto step = it; step != path.end(); ++step)
+                {
+                    cycle += names[step->first] + " -> ";
+                }
+                throw Error("ExpressionGraph: cycle of fields " + cycle + names[dependency]);
+            }
+        }
+    }
+}
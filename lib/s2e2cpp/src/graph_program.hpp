@@ -0,0 +1,75 @@
+#pragma once
+
+#include "rule_program.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class GraphProgram
+     * @brief Named expressions referring to values of each other.
+     * @details Every field is a rule of one rule program whose variables are the input variables followed by names
+     *          of all fields, so a reference to a field compiles into a variable bound to its value.
+     *          References between fields form a DAG, which is checked on construction.
+     */
+    class GraphProgram final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] fieldNames - Names of fields.
+         * @param[in] numberOfInputs - Number of input variables.
+         * @param[in] rules - Rule program with one rule per field.
+         * @throws Error if fields refer to each other in a cycle.
+         */
+        GraphProgram(std::vector<std::string> fieldNames, size_t numberOfInputs, std::shared_ptr<const RuleProgram> rules);
+
+        /**
+         * @brief Get names of input variables.
+         * @returns Names of input variables in the order of their indices.
+         */
+        std::vector<std::string> variables() const;
+
+    private:
+        /**
+         * @brief Find fields the field refers to.
+         * @param[in] field - Index of the field.
+         * @returns Indices of fields in ascending order.
+         */
+        std::vector<uint32_t> findDependencies(uint32_t field) const;
+
+        /**
+         * @brief Sort fields so that every field follows all fields it refers to.
+         * @throws Error if fields refer to each other in a cycle.
+         */
+        void sortFields();
+
+    public:
+        /// @brief Names of fields.
+        const std::vector<std::string> names;
+
+        /// @brief Number of input variables.
+        const size_t numberOfVariables;
+
+        /// @brief Rule program with one rule per field.
+        const std::shared_ptr<const RuleProgram> fields;
+
+        /// @brief Indices of fields every field refers to.
+        std::vector<std::vector<uint32_t>> dependencies;
+
+        /// @brief Indices of fields referring to every field.
+        std::vector<std::vector<uint32_t>> dependents;
+
+        /// @brief Indices of fields which do not refer to other fields.
+        std::vector<size_t> sources;
+
+        /// @brief Indices of all fields in topological order.
+        std::vector<uint32_t> order;
+    };
+
+} // namespace s2e2
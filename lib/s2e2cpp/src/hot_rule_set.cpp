@@ -0,0 +1,53 @@
+#include <s2e2/hot_rule_set.hpp>
+
+#include <memory>
+#include <utility>
+
+
+s2e2::HotRuleSet::Reader::Reader(const HotRuleSet& source)
+    : source_{source}
+    , snapshot_{source.acquire()}
+{
+}
+
+const s2e2::RuleSetSnapshot& s2e2::HotRuleSet::Reader::current()
+{
+    if (!snapshot_ || snapshot_->version != source_.version_.load(std::memory_order_acquire))
+    {
+        snapshot_ = source_.acquire();
+    }
+    return *snapshot_;
+}
+
+void s2e2::HotRuleSet::Reader::release()
+{
+    snapshot_.reset();
+}
+
+s2e2::HotRuleSet::HotRuleSet(const Registry& registry, const RuleSet& rules)
+{
+    publish(registry, rules);
+}
+
+uint64_t s2e2::HotRuleSet::publish(const Registry& registry, const RuleSet& rules)
+{
+    // declared before the lock, so the replaced snapshot is freed, if it is the last reference, after unlocking
+    std::shared_ptr<const RuleSetSnapshot> previous;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto version = version_.load(std::memory_order_relaxed) + 1;
+    auto next = std::make_shared<const RuleSetSnapshot>(RuleSetSnapshot{registry, rules, version});
+    previous = std::atomic_exchange(&snapshot_, std::move(next));
+    version_.store(version, std::memory_order_release);
+    return version;
+}
+
+std::shared_ptr<const s2e2::RuleSetSnapshot> s2e2::HotRuleSet::acquire() const
+{
+    return std::atomic_load(&snapshot_);
+}
+
+uint64_t s2e2::HotRuleSet::version() const
+{
+    return version_.load(std::memory_order_acquire);
+}
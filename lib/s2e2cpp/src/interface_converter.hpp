@@ -2,8 +2,12 @@
 
 #include "token.hpp"
 
+#include <s2e2/error.hpp>
+#include <s2e2/status.hpp>
+
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 
@@ -21,6 +25,12 @@ namespace s2e2
          */
         virtual ~IConverter() = default;
 
+        /**
+         * @brief Make a copy knowing the same operators, used when a shared registry is extended.
+         * @returns Copy of the converter.
+         */
+        virtual std::unique_ptr<IConverter> clone() const = 0;
+
         /**
          * @brief Add operator expected within expression.
          * @param[in] name - Operator's name.
@@ -36,6 +46,31 @@ namespace s2e2
          * @throws Error in case of an error.
          */
         virtual std::list<Token> convert(const std::list<Token>& infixExpression) const = 0;
+
+        /**
+         * @brief Convert infix token sequence into postfix one without throwing.
+         * @details The default implementation relies on convert(), converters able to report errors without
+         *          exceptions override it.
+         * @param[in] infixExpression - Input sequence of tokens.
+         * @param[out] postfixExpression - Postfix sequence of tokens.
+         * @param[out] status - Error in case of failure.
+         * @returns true in case of success.
+         */
+        virtual bool tryConvert(const std::list<Token>& infixExpression,
+                                std::list<Token>& postfixExpression,
+                                Status& status) const
+        {
+            try
+            {
+                postfixExpression = convert(infixExpression);
+                return true;
+            }
+            catch (const Error& error)
+            {
+                status = Status{ErrorCode::INVALID_EXPRESSION, error.what()};
+                return false;
+            }
+        }
     };
 
 } // namespace s2e2
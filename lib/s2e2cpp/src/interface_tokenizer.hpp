@@ -1,9 +1,18 @@
 #pragma once
 
+#include "symbol_table.hpp"
 #include "token.hpp"
 
+#include <s2e2/error.hpp>
+#include <s2e2/status.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 namespace s2e2
@@ -20,19 +29,36 @@ namespace s2e2
          */
         virtual ~ITokenizer() = default;
 
+        /**
+         * @brief Make a copy knowing the same names under the same ids, used when a shared registry is extended.
+         * @returns Copy of the tokenizer.
+         */
+        virtual std::unique_ptr<ITokenizer> clone() const = 0;
+
         /**
          * @brief Add function expected within expression.
          * @param[in] functionName - Function's name.
+         * @returns Id of the symbol FUNCTION tokens of the function carry, or NO_SYMBOL if tokens carry none.
          * @throws Error if functons's name is not unique.
          */
-        virtual void addFunction(const std::string& functionName) = 0;
+        virtual SymbolId addFunction(const std::string& functionName) = 0;
 
         /**
          * @brief Add operator expected within expression.
          * @param[in] operatorName - Operator's name.
+         * @param[in] priority - Operator's priority OPERATOR tokens of the operator carry.
+         * @returns Id of the symbol OPERATOR tokens of the operator carry, or NO_SYMBOL if tokens carry none.
          * @throws Error if operator's name is not unique.
          */
-        virtual void addOperator(const std::string& operatorName) = 0;
+        virtual SymbolId addOperator(const std::string& operatorName, const uint_fast16_t priority) = 0;
+
+        /**
+         * @brief Build lookup tables of all added functions and operators, no more can be added after that.
+         * @details Default implementation keeps the tokenizer as is.
+         */
+        virtual void freeze()
+        {
+        }
 
         /**
          * @brief Split expression into tokens.
@@ -41,6 +67,45 @@ namespace s2e2
          * @throws Error if expression contains unknown symbol.
          */
         virtual std::list<Token> tokenize(const std::string& expression) const = 0;
+
+        /**
+         * @brief Split expression into tokens without throwing.
+         * @details The default implementation relies on tokenize(), tokenizers able to report errors without
+         *          exceptions override it.
+         * @param[in] expression - Input expression.
+         * @param[out] tokens - List of tokens.
+         * @param[out] status - Error in case of failure.
+         * @returns true in case of success.
+         */
+        virtual bool tryTokenize(const std::string& expression, std::list<Token>& tokens, Status& status) const
+        {
+            try
+            {
+                tokens = tokenize(expression);
+                return true;
+            }
+            catch (const Error& error)
+            {
+                status = Status{ErrorCode::INVALID_EXPRESSION, error.what()};
+                return false;
+            }
+        }
+
+        /**
+         * @brief Check without building any tokens if the expression is just a string literal,
+         *        i.e. it would be split into atoms none of which is a variable.
+         * @details Default implementation never recognizes literals, so the expression is always tokenized.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] numberOfTokens - Number of atoms of a literal expression.
+         * @returns true if the expression is a string literal.
+         */
+        virtual bool isLiteral(std::string_view /*expression*/,
+                               const std::vector<std::string>& /*variables*/,
+                               size_t& /*numberOfTokens*/) const
+        {
+            return false;
+        }
     };
 
 } // namespace s2e2
@@ -0,0 +1,29 @@
+#include "invocation_scope.hpp"
+
+
+thread_local s2e2::Span<std::any> s2e2::InvocationArguments::current_;
+
+s2e2::InvocationScope::InvocationScope(size_t numberOfArguments)
+    : previous_{InvocationArguments::current_}
+{
+    if (numberOfArguments <= INLINE_CAPACITY)
+    {
+        arguments_ = Span<std::any>(inline_.data(), numberOfArguments);
+    }
+    else
+    {
+        spilled_.resize(numberOfArguments);
+        arguments_ = Span<std::any>(spilled_);
+    }
+    InvocationArguments::current_ = arguments_;
+}
+
+s2e2::InvocationScope::~InvocationScope()
+{
+    InvocationArguments::current_ = previous_;
+}
+
+s2e2::Span<std::any> s2e2::InvocationScope::arguments() const
+{
+    return arguments_;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <s2e2/invocation_arguments.hpp>
+#include <s2e2/span.hpp>
+
+#include <any>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class InvocationScope
+     * @brief Buffer of arguments of one invocation, current on the calling thread while the scope lives.
+     * @details Arguments of the enclosing invocation become current again when the scope ends,
+     *          so invocations can be nested.
+     */
+    class InvocationScope final
+    {
+    public:
+        /**
+         * @brief Make a buffer of empty arguments current.
+         * @param[in] numberOfArguments - Number of arguments.
+         */
+        explicit InvocationScope(size_t numberOfArguments);
+
+        /**
+         * @brief Release the arguments and restore the ones of the enclosing invocation.
+         */
+        ~InvocationScope();
+
+        InvocationScope(const InvocationScope&) = delete;
+        InvocationScope& operator=(const InvocationScope&) = delete;
+
+        /**
+         * @brief Get the arguments to fill.
+         * @returns Arguments.
+         */
+        Span<std::any> arguments() const;
+
+    private:
+        /// @brief Number of arguments kept without allocation.
+        static constexpr size_t INLINE_CAPACITY = 4;
+
+        /// @brief Storage of up to INLINE_CAPACITY arguments.
+        std::array<std::any, INLINE_CAPACITY> inline_;
+
+        /// @brief Storage of more arguments.
+        std::vector<std::any> spilled_;
+
+        /// @brief Arguments of this invocation.
+        Span<std::any> arguments_;
+
+        /// @brief Arguments of the enclosing invocation.
+        Span<std::any> previous_;
+    };
+
+} // namespace s2e2
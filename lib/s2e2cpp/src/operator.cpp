@@ -1,25 +1,57 @@
-#include <s2e2/error.hpp>
+#include "error_status.hpp"
+#include "invocation_scope.hpp"
+
 #include <s2e2/operator.hpp>
 
 
 void s2e2::Operator::invoke(std::stack<std::any>& stack) const
 {
-    if (stack.size() < arguments_.size())
+    Status status;
+    if (!tryInvoke(stack, status))
     {
-        throw Error("Not enough arguments for operator " + name);
+        throwError(status);
     }
+}
 
-    for (int i = static_cast<int>(arguments_.size() - 1); i >= 0; --i)
+bool s2e2::Operator::tryInvoke(std::stack<std::any>& stack, Status& status) const
+{
+    if (stack.size() < numberOfArguments_)
     {
-        arguments_[i] = std::move(stack.top());
+        status = Status{ErrorCode::NOT_ENOUGH_ARGUMENTS, "Not enough arguments for operator " + name};
+        return false;
+    }
+
+    InvocationScope scope(numberOfArguments_);
+    const auto arguments = scope.arguments();
+    for (auto i = numberOfArguments_; i-- > 0;)
+    {
+        arguments[i] = std::move(stack.top());
         stack.pop();
     }
 
     if (!checkArguments())
     {
-        throw Error("Invalid arguments for operator " + name);
+        status = Status{ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for operator " + name};
+        return false;
+    }
+    std::any value;
+    if (!tryResult(value, status))
+    {
+        return false;
     }
-    stack.push(result());
+    stack.push(std::move(value));
+    return true;
+}
+
+bool s2e2::Operator::tryResult(std::any& value, Status& /*status*/) const
+{
+    value = result();
+    return true;
+}
+
+size_t s2e2::Operator::numberOfArguments() const
+{
+    return numberOfArguments_;
 }
 
 s2e2::Operator::Operator(std::string operatorName,
@@ -27,6 +59,6 @@ s2e2::Operator::Operator(std::string operatorName,
                          const uint_fast16_t numberOfArguments)
     : name(std::move(operatorName))
     , priority(operatorPriority)
-    , arguments_(numberOfArguments)
+    , numberOfArguments_(numberOfArguments)
 {
 }
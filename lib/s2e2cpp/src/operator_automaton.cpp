@@ -0,0 +1,82 @@
+#include "operator_automaton.hpp"
+
+
+void s2e2::OperatorAutomaton::build(const SymbolTable& symbols)
+{
+    states_.assign(1, State{});
+    numberOfSymbols_ = symbols.size();
+
+    for (SymbolId id = 0; id < symbols.size(); ++id)
+    {
+        if (symbols[id].type != TokenType::OPERATOR)
+        {
+            continue;
+        }
+
+        uint32_t state = 0;
+        for (const auto symbol : symbols[id].name)
+        {
+            auto& next = states_[state].next[static_cast<unsigned char>(symbol)];
+            if (next == 0)
+            {
+                next = static_cast<uint32_t>(states_.size());
+                states_.emplace_back();
+            }
+            state = states_[state].next[static_cast<unsigned char>(symbol)];
+        }
+        states_[state].symbol = id;
+    }
+}
+
+bool s2e2::OperatorAutomaton::containsAny(std::string_view text) const
+{
+    for (size_t from = 0; from < text.size(); ++from)
+    {
+        if (walk(text, from, [](SymbolId) { return true; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool s2e2::OperatorAutomaton::findAll(std::string_view text, std::vector<bool>& found) const
+{
+    found.assign(numberOfSymbols_, false);
+
+    bool any = false;
+    for (size_t from = 0; from < text.size(); ++from)
+    {
+        walk(text, from, [&found, &any](SymbolId symbol)
+        {
+            found[symbol] = true;
+            any = true;
+            return false;
+        });
+    }
+    return any;
+}
+
+template <class Callback>
+bool s2e2::OperatorAutomaton::walk(std::string_view text, size_t from, Callback callback) const
+{
+    if (states_.empty())
+    {
+        return false;
+    }
+
+    uint32_t state = 0;
+    for (size_t i = from; i < text.size(); ++i)
+    {
+        state = states_[state].next[static_cast<unsigned char>(text[i])];
+        if (state == 0)
+        {
+            return false;
+        }
+        if (states_[state].symbol != NO_SYMBOL && callback(states_[state].symbol))
+        {
+            return true;
+        }
+    }
+    return false;
+}
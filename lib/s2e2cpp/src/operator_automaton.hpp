@@ -0,0 +1,75 @@
+#pragma once
+
+#include "symbol_table.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class OperatorAutomaton
+     * @brief Trie of all operator names, finds every operator occurring in a string in one pass.
+     * @details Every state has a full table of transitions, so a step costs one lookup.
+     *          Built once when the tokenizer is frozen.
+     */
+    class OperatorAutomaton final
+    {
+    public:
+        /**
+         * @brief Build the automaton of all operators of the table.
+         * @param[in] symbols - Interned functions and operators.
+         */
+        void build(const SymbolTable& symbols);
+
+        /**
+         * @brief Check if the string contains any operator.
+         * @param[in] text - String.
+         * @returns true if at least one operator occurs in the string.
+         */
+        bool containsAny(std::string_view text) const;
+
+        /**
+         * @brief Mark all operators occurring in the string.
+         * @param[in] text - String.
+         * @param[out] found - Flags by symbol id, resized to the number of symbols.
+         * @returns true if at least one operator occurs in the string.
+         */
+        bool findAll(std::string_view text, std::vector<bool>& found) const;
+
+    private:
+        /**
+         * @brief State of the automaton.
+         */
+        struct State
+        {
+            /// @brief Next states by symbol, 0 means no transition (the root is never a target).
+            std::array<uint32_t, 256> next{};
+
+            /// @brief Operator whose name ends in this state or NO_SYMBOL.
+            SymbolId symbol = NO_SYMBOL;
+        };
+
+        /**
+         * @brief Walk from the root along the string starting at the offset, reporting every operator passed.
+         * @tparam Callback - Callable taking SymbolId, returns true to stop the walk.
+         * @param[in] text - String.
+         * @param[in] from - Offset to start at.
+         * @param[in] callback - Callback.
+         * @returns true if the callback stopped the walk.
+         */
+        template <class Callback>
+        bool walk(std::string_view text, size_t from, Callback callback) const;
+
+    private:
+        /// @brief States, the first one is the root.
+        std::vector<State> states_;
+
+        /// @brief Number of symbols of the table the automaton is built from.
+        size_t numberOfSymbols_ = 0;
+    };
+
+} // namespace s2e2
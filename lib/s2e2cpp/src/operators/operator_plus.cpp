@@ -1,3 +1,5 @@
+#include "../error_status.hpp"
+#include "../execution_context.hpp"
 #include "priorities.hpp"
 
 #include <s2e2/operators/operator_plus.hpp>
@@ -19,20 +21,46 @@ bool s2e2::OperatorPlus::checkArguments() const
 }
 
 std::any s2e2::OperatorPlus::result() const
+{
+    std::any value;
+    Status status;
+    if (!tryResult(value, status))
+    {
+        throwError(status);
+    }
+    return value;
+}
+
+bool s2e2::OperatorPlus::tryResult(std::any& value, Status& status) const
 {
     if (!arguments_[0].has_value() && !arguments_[1].has_value())
     {
-        return {};
+        value.reset();
+        return true;
+    }
+
+    auto* lhs = std::any_cast<std::string>(&arguments_[0]);
+    auto* rhs = std::any_cast<std::string>(&arguments_[1]);
+
+    // the size is checked before the concatenation so that the limit also bounds memory
+    const auto* context = ExecutionContext::current();
+    if (context && !context->tryCheckSize((lhs ? lhs->size() : 0) + (rhs ? rhs->size() : 0), status))
+    {
+        return false;
     }
 
-    std::string result;
-    if (arguments_[0].has_value())
+    // arguments are owned by the invocation, so the result takes over the buffer of one of them
+    if (!rhs)
     {
-        result += *std::any_cast<std::string>(&arguments_[0]);
+        value = std::move(*lhs);
+        return true;
     }
-    if (arguments_[1].has_value())
+    if (!lhs)
     {
-        result += *std::any_cast<std::string>(&arguments_[1]);
+        value = std::move(*rhs);
+        return true;
     }
-    return result;
+    lhs->append(*rhs);
+    value = std::move(*lhs);
+    return true;
 }
@@ -0,0 +1,344 @@
+#include "optimizer.hpp"
+
+#include <s2e2/functions/function_concat.hpp>
+
+#include <algorithm>
+#include <typeinfo>
+
+
+namespace // anonymous
+{
+    /// @brief Minimal number of comparisons in a chain worth replacing with a membership test.
+    const size_t MIN_CHAIN_LENGTH = 3;
+
+    /// @brief Minimal number of operands of a chain of + worth replacing with a CONCAT call.
+    const size_t MIN_CONCATENATION_LENGTH = 3;
+
+    /// @brief Function CONCAT which chains of + are replaced with, the same for all programs.
+    const s2e2::FunctionConcat CONCATENATION;
+
+    /**
+     * @brief Get arguments of the call.
+     * @param[in] instructions - Instructions of the program.
+     * @param[in] index - Index of the call instruction.
+     * @returns Indices of the last instructions of arguments in order.
+     */
+    std::vector<size_t> argumentsOf(const std::vector<s2e2::Instruction>& instructions, size_t index)
+    {
+        std::vector<size_t> arguments;
+        for (auto end = index; end > instructions[index].subtreeStart; end = instructions[end - 1].subtreeStart)
+        {
+            arguments.push_back(end - 1);
+        }
+        std::reverse(arguments.begin(), arguments.end());
+        return arguments;
+    }
+
+    /**
+     * @brief Collect operands of nested applications of the same operator.
+     * @param[in] instructions - Instructions of the program.
+     * @param[in] index - Index of the operator's instruction.
+     * @param[out] leaves - Indices of operands which are not applications of the operator, in order.
+     * @param[out] inner - Indices of nested applications of the operator.
+     */
+    void collectLeaves(const std::vector<s2e2::Instruction>& instructions,
+                       size_t index,
+                       std::vector<size_t>& leaves,
+                       std::vector<size_t>& inner)
+    {
+        // operands are taken from the stack in order, nested applications are replaced with their own operands
+        std::vector<size_t> stack{index};
+        while (!stack.empty())
+        {
+            const auto node = stack.back();
+            stack.pop_back();
+
+            if (node != index && instructions[node].builtin != instructions[index].builtin)
+            {
+                leaves.push_back(node);
+                continue;
+            }
+            if (node != index)
+            {
+                inner.push_back(node);
+            }
+
+            const auto arguments = argumentsOf(instructions, node);
+            stack.insert(stack.end(), arguments.rbegin(), arguments.rend());
+        }
+    }
+
+} // namespace anonymous
+
+
+void s2e2::Optimizer::optimize(Program& program) const
+{
+    Program output;
+    emitSubtree(program, program.instructions.size() - 1, output);
+
+    program.sets = std::move(output.sets);
+    program.instructions = std::move(output.instructions);
+}
+
+void s2e2::Optimizer::emitSubtree(const Program& program, size_t index, Program& output) const
+{
+    std::vector<bool> analysed(program.instructions.size(), false);
+
+    // rewrites whose operands are being emitted, they are finished in reverse order
+    std::vector<Rewrite> pending;
+
+    // subtrees to emit, an empty item finishes the last pending rewrite
+    std::vector<std::optional<size_t>> work{index};
+
+    while (!work.empty())
+    {
+        const auto item = work.back();
+        work.pop_back();
+
+        if (!item)
+        {
+            auto& finished = pending.back();
+            if (finished.set)
+            {
+                finished.instruction.index = static_cast<uint32_t>(output.sets.size());
+                output.sets.push_back(std::move(*finished.set));
+            }
+            finished.instruction.subtreeStart = finished.start;
+            output.instructions.push_back(finished.instruction);
+            pending.pop_back();
+            continue;
+        }
+
+        auto& started = pending.emplace_back(rewrite(program, *item, analysed));
+        started.start = static_cast<uint32_t>(output.instructions.size());
+        work.emplace_back();
+        work.insert(work.end(), started.operands.rbegin(), started.operands.rend());
+    }
+}
+
+s2e2::Optimizer::Rewrite s2e2::Optimizer::rewrite(const Program& program, size_t index, std::vector<bool>& analysed) const
+{
+    Rewrite result;
+    if (!analysed[index] &&
+        (rewriteMembership(program, index, analysed, result) || rewriteConcatenation(program, index, analysed, result)))
+    {
+        return result;
+    }
+
+    result.operands = argumentsOf(program.instructions, index);
+    result.instruction = program.instructions[index];
+    return result;
+}
+
+bool s2e2::Optimizer::rewriteMembership(const Program& program,
+                                        size_t index,
+                                        std::vector<bool>& analysed,
+                                        Rewrite& result) const
+{
+    const auto& instruction = program.instructions[index];
+
+    std::optional<size_t> operand;
+    std::vector<std::optional<std::string>> values;
+    std::string callee;
+
+    if (instruction.builtin == Builtin::IN)
+    {
+        const auto arguments = argumentsOf(program.instructions, index);
+        for (size_t i = 1; i < arguments.size(); ++i)
+        {
+            auto value = constantValue(program, arguments[i]);
+            if (!value)
+            {
+                return false;
+            }
+            values.push_back(std::move(*value));
+        }
+        operand = arguments[0];
+        callee = "function " + instruction.fn->name;
+    }
+    else if (instruction.builtin == Builtin::OR || instruction.builtin == Builtin::AND)
+    {
+        // x == a || x == b || ... and x != a && x != b && ...
+        const auto comparison = (instruction.builtin == Builtin::OR) ? Builtin::EQUAL : Builtin::NOT_EQUAL;
+
+        // the chain is analysed once at its root, nested parts of it are never rewritten on their own
+        std::vector<size_t> leaves;
+        std::vector<size_t> inner;
+        collectLeaves(program.instructions, index, leaves, inner);
+        for (const auto node : inner)
+        {
+            analysed[node] = true;
+        }
+
+        if (leaves.size() < MIN_CHAIN_LENGTH)
+        {
+            return false;
+        }
+
+        for (const auto leaf : leaves)
+        {
+            if (program.instructions[leaf].builtin != comparison)
+            {
+                return false;
+            }
+
+            const auto arguments = argumentsOf(program.instructions, leaf);
+            auto side = arguments[0];
+            auto value = constantValue(program, arguments[1]);
+            if (!value)
+            {
+                side = arguments[1];
+                value = constantValue(program, arguments[0]);
+            }
+
+            if (!value || (operand && !isSameSubtree(program, *operand, side)))
+            {
+                return false;
+            }
+            operand = side;
+            values.push_back(std::move(*value));
+        }
+        callee = "operator " + program.instructions[leaves.front()].op->name;
+
+        // the operand is executed once instead of once per comparison, so it must be free of side effects
+        if (!isSameSubtree(program, *operand, *operand))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    const auto negated = (instruction.builtin == Builtin::AND);
+    result.operands = {*operand};
+    result.set.emplace(values, negated, std::move(callee));
+    result.instruction = Instruction{InstructionType::MEMBERSHIP, 0, 0, nullptr, nullptr, Builtin::NONE, 1, instruction.position};
+    return true;
+}
+
+bool s2e2::Optimizer::rewriteConcatenation(const Program& program,
+                                           size_t index,
+                                           std::vector<bool>& analysed,
+                                           Rewrite& result) const
+{
+    // ((a + b) + c) + d appends c and d to a + b, which becomes the first operand unless it is a chain itself
+    std::vector<size_t> operands;
+    auto first = index;
+    while (program.instructions[first].builtin == Builtin::PLUS)
+    {
+        const auto arguments = argumentsOf(program.instructions, first);
+        if (!isStringOperand(program, arguments[1]))
+        {
+            break;
+        }
+        operands.push_back(arguments[1]);
+        // nested applications share the first operand, so they are rewritable only as a part of this chain
+        if (first != index)
+        {
+            analysed[first] = true;
+        }
+        first = arguments[0];
+    }
+
+    // the first operand is executed before all others in both programs, so it may be anything giving a string
+    const auto& firstInstruction = program.instructions[first];
+    if (firstInstruction.builtin != Builtin::PLUS && firstInstruction.builtin != Builtin::CONCAT &&
+        !isStringOperand(program, first))
+    {
+        return false;
+    }
+    operands.push_back(first);
+    if (operands.size() < MIN_CONCATENATION_LENGTH)
+    {
+        return false;
+    }
+
+    const auto numberOfArguments = static_cast<uint32_t>(operands.size());
+    result.operands.assign(operands.rbegin(), operands.rend());
+    result.instruction = Instruction{InstructionType::FUNCTION, 0, 0, nullptr, &CONCATENATION, Builtin::CONCAT,
+                                     numberOfArguments, program.instructions[index].position};
+    return true;
+}
+
+std::optional<std::optional<std::string>> s2e2::Optimizer::constantValue(const Program& program, size_t index) const
+{
+    const auto& instruction = program.instructions[index];
+    if (instruction.type != InstructionType::CONSTANT)
+    {
+        return {};
+    }
+
+    const auto& value = program.constants[instruction.index];
+    if (!value.has_value())
+    {
+        return std::optional<std::string>{};
+    }
+    if (value.type() != typeid(std::string))
+    {
+        return {};
+    }
+    return std::optional<std::string>{std::any_cast<const std::string&>(value)};
+}
+
+bool s2e2::Optimizer::isSameSubtree(const Program& program, size_t lhs, size_t rhs) const
+{
+    const auto& instructions = program.instructions;
+    const auto lhsStart = instructions[lhs].subtreeStart;
+    const auto rhsStart = instructions[rhs].subtreeStart;
+    if (lhs - lhsStart != rhs - rhsStart)
+    {
+        return false;
+    }
+
+    for (size_t offset = 0; offset <= lhs - lhsStart; ++offset)
+    {
+        const auto& a = instructions[lhsStart + offset];
+        const auto& b = instructions[rhsStart + offset];
+
+        if (a.type != b.type || a.op != b.op || a.fn != b.fn || a.numberOfArguments != b.numberOfArguments ||
+            a.subtreeStart - lhsStart != b.subtreeStart - rhsStart)
+        {
+            return false;
+        }
+
+        switch (a.type)
+        {
+            case InstructionType::CONSTANT:
+            {
+                const auto aValue = constantValue(program, lhsStart + offset);
+                if (!aValue || aValue != constantValue(program, rhsStart + offset))
+                {
+                    return false;
+                }
+                break;
+            }
+
+            case InstructionType::VARIABLE:
+                if (a.index != b.index)
+                {
+                    return false;
+                }
+                break;
+
+            case InstructionType::OPERATOR:
+            case InstructionType::FUNCTION:
+                // custom operators and functions may have side effects or depend on time
+                if (a.builtin == Builtin::NONE)
+                {
+                    return false;
+                }
+                break;
+
+            case InstructionType::MEMBERSHIP:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool s2e2::Optimizer::isStringOperand(const Program& program, size_t index) const
+{
+    return program.instructions[index].type == InstructionType::VARIABLE || constantValue(program, index).has_value();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "program.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class Optimizer
+     * @brief Rewrites compiled programs into equivalent cheaper ones.
+     * @details Disjunctions of == and conjunctions of != comparing one operand with several constants, and IN
+     *          with only constant candidates, become single MEMBERSHIP instructions testing the operand against a
+     *          sorted set. The operand is executed once instead of once per comparison.
+     *          Chains of + appending variables and constant strings become single CONCAT calls, which allocate
+     *          the result once instead of copying everything accumulated so far on every +.
+     *          Results, including failures and their messages, are identical to the ones of the source program.
+     *          Every chain is analysed once at its root, so the time is linear in the size of the program.
+     */
+    class Optimizer final
+    {
+    public:
+        /**
+         * @brief Optimize the program in place.
+         * @param[in, out] program - Compiled program.
+         */
+        void optimize(Program& program) const;
+
+    private:
+        /**
+         * @brief Instruction of the optimized program together with subtrees of the source one computing its operands.
+         */
+        struct Rewrite
+        {
+            /// @brief Indices of the last instructions of operands' subtrees in the source program, in order.
+            std::vector<size_t> operands;
+
+            /// @brief Instruction emitted after its operands.
+            Instruction instruction{};
+
+            /// @brief Set of a MEMBERSHIP instruction, added to the optimized program together with it.
+            std::optional<ValueSet> set;
+
+            /// @brief Index of the first instruction of the emitted subtree in the optimized program.
+            uint32_t start = 0;
+        };
+
+        /**
+         * @brief Emit optimized subtree ending with the instruction.
+         * @details Subtrees are walked with an explicit stack, so the depth of the expression is not bounded
+         *          by the stack of the thread.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the last instruction of the subtree.
+         * @param[in, out] output - Optimized program.
+         */
+        void emitSubtree(const Program& program, size_t index, Program& output) const;
+
+        /**
+         * @brief Get the instruction to emit instead of the source one together with its operands.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the source instruction.
+         * @param[in, out] analysed - Inner nodes of already analysed chains, they are not analysed again.
+         * @returns Membership test, CONCAT call or the source instruction with its own arguments.
+         */
+        Rewrite rewrite(const Program& program, size_t index, std::vector<bool>& analysed) const;
+
+        /**
+         * @brief Rewrite the subtree as a membership test if it is a chain of equalities or IN with constants.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the last instruction of the subtree.
+         * @param[in, out] analysed - Inner nodes of the chain are marked as analysed.
+         * @param[out] result - Membership test.
+         * @returns true if the subtree is rewritten, false if it is not rewritable.
+         */
+        bool rewriteMembership(const Program& program, size_t index, std::vector<bool>& analysed, Rewrite& result) const;
+
+        /**
+         * @brief Rewrite the subtree as a CONCAT call if it is a chain of + appending variables and constants.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the last instruction of the subtree.
+         * @param[in, out] analysed - Inner nodes of the chain are marked as analysed.
+         * @param[out] result - CONCAT call.
+         * @returns true if the subtree is rewritten, false if it is not rewritable.
+         */
+        bool rewriteConcatenation(const Program& program, size_t index, std::vector<bool>& analysed, Rewrite& result) const;
+
+        /**
+         * @brief Get value of the instruction if it is a constant string or NULL.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the instruction.
+         * @returns Value or empty value if the instruction is not such a constant.
+         */
+        std::optional<std::optional<std::string>> constantValue(const Program& program, size_t index) const;
+
+        /**
+         * @brief Check if two subtrees compute the same value.
+         * @param[in] program - Source program.
+         * @param[in] lhs - Index of the last instruction of the first subtree.
+         * @param[in] rhs - Index of the last instruction of the second subtree.
+         * @returns true if subtrees are identical and consist of standard operations only.
+         */
+        bool isSameSubtree(const Program& program, size_t lhs, size_t rhs) const;
+
+        /**
+         * @brief Check if the instruction pushes a string or NULL and can neither fail nor have side effects.
+         * @param[in] program - Source program.
+         * @param[in] index - Index of the instruction.
+         * @returns true for variables and constant strings and NULL.
+         */
+        bool isStringOperand(const Program& program, size_t index) const;
+    };
+
+} // namespace s2e2
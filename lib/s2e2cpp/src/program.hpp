@@ -0,0 +1,125 @@
+#pragma once
+
+#include "value_set.hpp"
+
+#include <s2e2/expression_cost.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/operator.hpp>
+#include <s2e2/status.hpp>
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    class AdaptiveChains;
+    class RegistryImpl;
+
+    /**
+     * @brief All instruction types.
+     */
+    enum class InstructionType : uint8_t
+    {
+        CONSTANT,   ///< Push constant value onto the stack.
+        VARIABLE,   ///< Push value of a bound variable onto the stack.
+        OPERATOR,   ///< Invoke operator.
+        FUNCTION,   ///< Invoke function.
+        MEMBERSHIP  ///< Test value of the only argument against a constant set.
+    };
+
+    /**
+     * @brief Standard operators and functions recognized by the compiler.
+     * @details Lets executors run specialized code for them instead of a generic invocation.
+     */
+    enum class Builtin : uint8_t
+    {
+        NONE,               ///< Custom operator or function, or not a call at all.
+        AND,                ///< Operator &&.
+        EQUAL,              ///< Operator ==.
+        GREATER,            ///< Operator >.
+        GREATER_OR_EQUAL,   ///< Operator >=.
+        LESS,               ///< Operator <.
+        LESS_OR_EQUAL,      ///< Operator <=.
+        NOT,                ///< Operator !.
+        NOT_EQUAL,          ///< Operator !=.
+        OR,                 ///< Operator ||.
+        PLUS,               ///< Operator +.
+        IF,                 ///< Function IF.
+        IN,                 ///< Function IN.
+        CONCAT              ///< Function CONCAT.
+    };
+
+    /**
+     * @brief Single instruction of a compiled program.
+     */
+    struct Instruction
+    {
+        /// @brief Instruction's type.
+        InstructionType type;
+
+        /// @brief Index of a constant, a variable or a set.
+        uint32_t index = 0;
+
+        /// @brief Index of the first instruction of the subtree which computes this instruction's value.
+        /// @details Arguments of a call are consecutive subtrees between it and the call itself.
+        uint32_t subtreeStart = 0;
+
+        /// @brief Operator to invoke.
+        const Operator* op = nullptr;
+
+        /// @brief Function to invoke.
+        const Function* fn = nullptr;
+
+        /// @brief Standard operator or function the instruction invokes.
+        Builtin builtin = Builtin::NONE;
+
+        /// @brief Number of arguments of a call, can exceed the minimal one for variadic functions.
+        uint32_t numberOfArguments = 0;
+
+        /// @brief Offset of the instruction's token in the source expression, reported with errors.
+        size_t position = Status::NO_POSITION;
+    };
+
+    /**
+     * @class Program
+     * @brief Postfix sequence of instructions with all functions and operators already resolved.
+     * @details Operators && and || and function IF can be executed lazily: the right operand of && or || is executed
+     *          only if the left one does not decide the result, and IF executes only the selected branch.
+     *          Chains of equality comparisons of one operand with constants and IN with constant candidates are
+     *          replaced with single MEMBERSHIP instructions, chains of + appending variables and constants are replaced
+     *          with single calls of CONCAT.
+     *          With adaptive reordering chains of && and || are executed in the order kept by adaptiveChains.
+     */
+    class Program final
+    {
+    public:
+        /// @brief Source expression.
+        std::string expression;
+
+        /// @brief Names of bound variables.
+        std::vector<std::string> variables;
+
+        /// @brief Constant values used by instructions.
+        std::vector<std::any> constants;
+
+        /// @brief Constant sets used by MEMBERSHIP instructions.
+        std::vector<ValueSet> sets;
+
+        /// @brief Instructions in postfix order.
+        std::vector<Instruction> instructions;
+
+        /// @brief Static cost estimate of the source expression.
+        ExpressionCost cost;
+
+        /// @brief Chains of && and || reordered by observed statistics, empty unless adaptive reordering is on.
+        std::shared_ptr<AdaptiveChains> adaptiveChains;
+
+        /// @brief Registry of resolved functions and operators, keeps them alive as long as the program.
+        std::shared_ptr<const RegistryImpl> registry;
+    };
+
+} // namespace s2e2
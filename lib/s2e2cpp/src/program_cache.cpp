@@ -0,0 +1,166 @@
+#include "program_cache.hpp"
+
+#include <functional>
+
+
+bool s2e2::ProgramCache::KeyView::operator==(const KeyView& other) const
+{
+    return expression == other.expression && *variables == *other.variables;
+}
+
+size_t s2e2::ProgramCache::KeyHash::operator()(const KeyView& key) const
+{
+    const std::hash<std::string_view> hash;
+    auto result = hash(key.expression);
+    for (const auto& variable : *key.variables)
+    {
+        result ^= hash(variable) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+    }
+    return result;
+}
+
+s2e2::ProgramCache::KeyView s2e2::ProgramCache::viewOf(const std::string& expression,
+                                                       const std::vector<std::string>& variables)
+{
+    return KeyView{expression, &variables};
+}
+
+template <class Value>
+Value* s2e2::ProgramCache::Lru<Value>::find(const KeyView& key)
+{
+    const auto it = index_.find(key);
+    if (it == index_.end())
+    {
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->second;
+}
+
+template <class Value>
+void s2e2::ProgramCache::Lru<Value>::insert(Key key, Value value)
+{
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    erase(viewOf(key.expression, key.variables));
+    while (entries_.size() >= capacity)
+    {
+        const auto& last = entries_.back().first;
+        index_.erase(viewOf(last.expression, last.variables));
+        entries_.pop_back();
+    }
+
+    entries_.emplace_front(std::move(key), std::move(value));
+    const auto& first = entries_.front().first;
+    index_.emplace(viewOf(first.expression, first.variables), entries_.begin());
+}
+
+template <class Value>
+void s2e2::ProgramCache::Lru<Value>::erase(const KeyView& key)
+{
+    const auto it = index_.find(key);
+    if (it != index_.end())
+    {
+        entries_.erase(it->second);
+        index_.erase(it);
+    }
+}
+
+template <class Value>
+void s2e2::ProgramCache::Lru<Value>::clear()
+{
+    index_.clear();
+    entries_.clear();
+}
+
+template <class Value>
+size_t s2e2::ProgramCache::Lru<Value>::size() const
+{
+    return entries_.size();
+}
+
+void s2e2::ProgramCache::configure(const CompileCacheOptions& options)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    programs_.clear();
+    failures_.clear();
+    programs_.capacity = options.capacity;
+    failures_.capacity = options.failureCapacity;
+    failureTtl_ = std::chrono::duration_cast<Clock::duration>(options.failureTtl);
+    statistics_ = CompileCacheStatistics{};
+}
+
+bool s2e2::ProgramCache::enabled() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return programs_.capacity != 0 || failures_.capacity != 0;
+}
+
+void s2e2::ProgramCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    programs_.clear();
+    failures_.clear();
+}
+
+s2e2::ProgramCache::Lookup s2e2::ProgramCache::find(const std::string& expression,
+                                                    const std::vector<std::string>& variables,
+                                                    std::shared_ptr<const Program>& program,
+                                                    Status& status)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (programs_.capacity == 0 && failures_.capacity == 0)
+    {
+        return Lookup::MISS;
+    }
+
+    const auto key = viewOf(expression, variables);
+    if (const auto* cached = programs_.find(key))
+    {
+        ++statistics_.hits;
+        program = *cached;
+        return Lookup::PROGRAM;
+    }
+
+    if (const auto* failure = failures_.find(key))
+    {
+        if (Clock::now() < failure->expiration)
+        {
+            ++statistics_.failureHits;
+            status = failure->status;
+            return Lookup::FAILURE;
+        }
+        failures_.erase(key);
+    }
+
+    ++statistics_.misses;
+    return Lookup::MISS;
+}
+
+void s2e2::ProgramCache::insert(const std::string& expression,
+                                const std::vector<std::string>& variables,
+                                std::shared_ptr<const Program> program)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    programs_.insert(Key{expression, variables}, std::move(program));
+}
+
+void s2e2::ProgramCache::insertFailure(const std::string& expression,
+                                       const std::vector<std::string>& variables,
+                                       const Status& status)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    failures_.insert(Key{expression, variables}, Failure{status, Clock::now() + failureTtl_});
+}
+
+s2e2::CompileCacheStatistics s2e2::ProgramCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto statistics = statistics_;
+    statistics.size = programs_.size();
+    statistics.failureSize = failures_.size();
+    return statistics;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "program.hpp"
+
+#include <s2e2/compile_cache.hpp>
+#include <s2e2/status.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class ProgramCache
+     * @brief Remembers compiled programs and compile failures by expression and names of variables.
+     * @details Programs and failures are kept in separate LRU lists with their own capacities,
+     *          so a flood of invalid expressions never evicts valid ones. Failures expire after their TTL.
+     *          Thread safe.
+     */
+    class ProgramCache final
+    {
+    public:
+        /**
+         * @brief Result of a lookup.
+         */
+        enum class Lookup
+        {
+            MISS,    ///< Expression is not cached.
+            PROGRAM, ///< Compiled program is cached.
+            FAILURE  ///< Compile failure is cached.
+        };
+
+        /**
+         * @brief Set options and drop everything cached.
+         * @param[in] options - Options.
+         */
+        void configure(const CompileCacheOptions& options);
+
+        /**
+         * @brief Check if either programs or failures are cached.
+         * @returns true if the cache is enabled.
+         */
+        bool enabled() const;
+
+        /**
+         * @brief Drop everything cached, e.g. after functions or limits change.
+         */
+        void clear();
+
+        /**
+         * @brief Look the expression up.
+         * @param[in] expression - Source expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] program - Cached program if it is found.
+         * @param[out] status - Cached failure if it is found.
+         * @returns Kind of the found entry.
+         */
+        Lookup find(const std::string& expression,
+                    const std::vector<std::string>& variables,
+                    std::shared_ptr<const Program>& program,
+                    Status& status);
+
+        /**
+         * @brief Remember the compiled program.
+         * @param[in] expression - Source expression.
+         * @param[in] variables - Names of variables.
+         * @param[in] program - Compiled program.
+         */
+        void insert(const std::string& expression,
+                    const std::vector<std::string>& variables,
+                    std::shared_ptr<const Program> program);
+
+        /**
+         * @brief Remember the compile failure.
+         * @param[in] expression - Source expression.
+         * @param[in] variables - Names of variables.
+         * @param[in] status - Compile failure.
+         */
+        void insertFailure(const std::string& expression, const std::vector<std::string>& variables, const Status& status);
+
+        /**
+         * @brief Get counters.
+         * @returns Counters of lookups and sizes.
+         */
+        CompileCacheStatistics statistics() const;
+
+    private:
+        /// @brief Clock of failure expiration.
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Key of an entry owned by the entry.
+         */
+        struct Key
+        {
+            /// @brief Source expression.
+            std::string expression;
+
+            /// @brief Names of variables.
+            std::vector<std::string> variables;
+        };
+
+        /**
+         * @brief Key of a lookup referring to strings owned by the caller or by an entry, so lookups copy nothing.
+         */
+        struct KeyView
+        {
+            /// @brief Source expression.
+            std::string_view expression;
+
+            /// @brief Names of variables.
+            const std::vector<std::string>* variables;
+
+            bool operator==(const KeyView& other) const;
+        };
+
+        /**
+         * @brief Hash of a key.
+         */
+        struct KeyHash
+        {
+            size_t operator()(const KeyView& key) const;
+        };
+
+        /**
+         * @brief Get view of a key.
+         * @param[in] expression - Source expression.
+         * @param[in] variables - Names of variables.
+         * @returns View referring to the arguments.
+         */
+        static KeyView viewOf(const std::string& expression, const std::vector<std::string>& variables);
+
+        /**
+         * @brief Remembered compile failure.
+         */
+        struct Failure
+        {
+            /// @brief Compile failure.
+            Status status;
+
+            /// @brief Time the failure expires at.
+            Clock::time_point expiration;
+        };
+
+        /**
+         * @brief List of entries ordered from the most to the least recently used with an index by key.
+         * @tparam Value - Type of entries' values.
+         */
+        template <class Value>
+        class Lru final
+        {
+        public:
+            /// @brief Maximal number of entries.
+            size_t capacity = 0;
+
+            /**
+             * @brief Find the entry and make it the most recently used one.
+             * @param[in] key - Key.
+             * @returns Pointer to the value or null if it is not found.
+             */
+            Value* find(const KeyView& key);
+
+            /**
+             * @brief Add or replace the entry evicting the least recently used one over the capacity.
+             * @param[in] key - Key.
+             * @param[in] value - Value.
+             */
+            void insert(Key key, Value value);
+
+            /**
+             * @brief Remove the entry.
+             * @param[in] key - Key.
+             */
+            void erase(const KeyView& key);
+
+            /**
+             * @brief Remove all entries.
+             */
+            void clear();
+
+            /**
+             * @brief Get number of entries.
+             * @returns Number of entries.
+             */
+            size_t size() const;
+
+        private:
+            /// @brief Entries from the most to the least recently used.
+            std::list<std::pair<Key, Value>> entries_;
+
+            /// @brief Entries by views of their own keys, which stay valid as list nodes never move.
+            std::unordered_map<KeyView, typename std::list<std::pair<Key, Value>>::iterator, KeyHash> index_;
+        };
+
+    private:
+        /// @brief Lock of all members.
+        mutable std::mutex mutex_;
+
+        /// @brief Compiled programs.
+        Lru<std::shared_ptr<const Program>> programs_;
+
+        /// @brief Compile failures.
+        Lru<Failure> failures_;
+
+        /// @brief Time a failure is remembered for.
+        Clock::duration failureTtl_{};
+
+        /// @brief Counters of lookups.
+        CompileCacheStatistics statistics_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,112 @@
+#include <s2e2/record_batch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+
+s2e2::BatchColumn::BatchColumn(Span<const VariableValue> values)
+    : BatchColumn(values, {}, false)
+{
+}
+
+s2e2::BatchColumn s2e2::BatchColumn::dictionary(Span<const VariableValue> dictionary, Span<const uint32_t> codes)
+{
+    return BatchColumn(dictionary, codes, true);
+}
+
+s2e2::BatchColumn::BatchColumn(Span<const VariableValue> values, Span<const uint32_t> codes, bool encoded)
+    : values_{values}
+    , codes_{codes}
+    , encoded_{encoded}
+{
+}
+
+
+s2e2::RecordBatch s2e2::RecordBatch::rowMajor(Span<const VariableValue> values,
+                                              size_t numberOfRecords,
+                                              size_t numberOfVariables)
+{
+    if (values.size() != numberOfRecords * numberOfVariables)
+    {
+        throw std::invalid_argument("RecordBatch: number of values does not match batch dimensions");
+    }
+
+    std::vector<Column> columns;
+    columns.reserve(numberOfVariables);
+
+    for (size_t variable = 0; variable < numberOfVariables; ++variable)
+    {
+        columns.push_back(Column{values.data() + variable, numberOfVariables});
+    }
+    return RecordBatch(std::move(columns), numberOfRecords);
+}
+
+s2e2::RecordBatch s2e2::RecordBatch::columnar(const std::vector<BatchColumn>& columns, size_t numberOfRecords)
+{
+    std::vector<Column> batchColumns;
+    batchColumns.reserve(columns.size());
+
+    for (const auto& column : columns)
+    {
+        if (!column.encoded_)
+        {
+            if (column.values_.size() != numberOfRecords)
+            {
+                throw std::invalid_argument("RecordBatch: column size does not match number of records");
+            }
+            batchColumns.push_back(Column{column.values_.data(), 1});
+            continue;
+        }
+
+        if (column.codes_.size() != numberOfRecords)
+        {
+            throw std::invalid_argument("RecordBatch: column size does not match number of records");
+        }
+
+        const auto& dictionary = column.values_;
+        const std::unordered_set<VariableValue> distinctValues(dictionary.begin(), dictionary.end());
+        if (distinctValues.size() != dictionary.size())
+        {
+            throw std::invalid_argument("RecordBatch: dictionary contains the same value twice");
+        }
+
+        const auto outOfRange = std::any_of(column.codes_.begin(), column.codes_.end(),
+                                            [&dictionary](uint32_t code) { return code >= dictionary.size(); });
+        if (outOfRange)
+        {
+            throw std::invalid_argument("RecordBatch: dictionary code is out of range");
+        }
+
+        batchColumns.push_back(Column{dictionary.data(), 1, column.codes_.data(), dictionary.size()});
+    }
+    return RecordBatch(std::move(batchColumns), numberOfRecords);
+}
+
+size_t s2e2::RecordBatch::size() const
+{
+    return size_;
+}
+
+size_t s2e2::RecordBatch::numberOfVariables() const
+{
+    return columns_.size();
+}
+
+s2e2::Span<const s2e2::VariableValue> s2e2::RecordBatch::dictionary(size_t variable) const
+{
+    const auto& column = columns_[variable];
+    return column.codes ? Span<const VariableValue>{column.data, column.dictionarySize} : Span<const VariableValue>{};
+}
+
+s2e2::Span<const uint32_t> s2e2::RecordBatch::codes(size_t variable) const
+{
+    const auto& column = columns_[variable];
+    return column.codes ? Span<const uint32_t>{column.codes, size_} : Span<const uint32_t>{};
+}
+
+s2e2::RecordBatch::RecordBatch(std::vector<Column> columns, size_t numberOfRecords)
+    : columns_{std::move(columns)}
+    , size_{numberOfRecords}
+{
+}
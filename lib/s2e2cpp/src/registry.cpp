@@ -0,0 +1,60 @@
+#include "registry_impl.hpp"
+
+#include <s2e2/registry.hpp>
+
+
+s2e2::Registry::Registry()
+    : impl_{std::make_shared<RegistryImpl>()}
+{
+}
+
+s2e2::Registry::Registry(std::shared_ptr<RegistryImpl> impl)
+    : impl_{std::move(impl)}
+{
+}
+
+s2e2::Registry::~Registry() = default;
+
+s2e2::Registry::Registry(const Registry& other) = default;
+
+s2e2::Registry& s2e2::Registry::operator=(const Registry& other) = default;
+
+void s2e2::Registry::addFunction(std::unique_ptr<Function>&& fn)
+{
+    RegistryImpl::writable(impl_).addFunction(std::move(fn));
+}
+
+void s2e2::Registry::addOperator(std::unique_ptr<Operator>&& op)
+{
+    RegistryImpl::writable(impl_).addOperator(std::move(op));
+}
+
+void s2e2::Registry::addStandardFunctions()
+{
+    RegistryImpl::writable(impl_).addStandardFunctions();
+}
+
+void s2e2::Registry::addStandardOperators()
+{
+    RegistryImpl::writable(impl_).addStandardOperators();
+}
+
+void s2e2::Registry::freeze()
+{
+    impl_->freeze();
+}
+
+bool s2e2::Registry::frozen() const
+{
+    return impl_->frozen();
+}
+
+std::unordered_set<const s2e2::Function*> s2e2::Registry::getFunctions() const
+{
+    return impl_->getFunctions();
+}
+
+std::unordered_set<const s2e2::Operator*> s2e2::Registry::getOperators() const
+{
+    return impl_->getOperators();
+}
@@ -0,0 +1,215 @@
+#include "converter.hpp"
+#include "registry_impl.hpp"
+#include "tokenizer.hpp"
+
+#include <s2e2/error.hpp>
+
+#include <s2e2/functions/function_add_days.hpp>
+#include <s2e2/functions/function_concat.hpp>
+#include <s2e2/functions/function_format_date.hpp>
+#include <s2e2/functions/function_if.hpp>
+#include <s2e2/functions/function_in.hpp>
+#include <s2e2/functions/function_now.hpp>
+#include <s2e2/functions/function_replace.hpp>
+
+#include <s2e2/operators/operator_and.hpp>
+#include <s2e2/operators/operator_equal.hpp>
+#include <s2e2/operators/operator_greater_or_equal.hpp>
+#include <s2e2/operators/operator_greater.hpp>
+#include <s2e2/operators/operator_less_or_equal.hpp>
+#include <s2e2/operators/operator_less.hpp>
+#include <s2e2/operators/operator_not_equal.hpp>
+#include <s2e2/operators/operator_not.hpp>
+#include <s2e2/operators/operator_or.hpp>
+#include <s2e2/operators/operator_plus.hpp>
+
+#include <stdexcept>
+
+
+s2e2::RegistryImpl::RegistryImpl()
+    : RegistryImpl(std::make_unique<Converter>(), std::make_unique<Tokenizer>())
+{
+}
+
+s2e2::RegistryImpl::RegistryImpl(std::unique_ptr<IConverter>&& converter, std::unique_ptr<ITokenizer>&& tokenizer)
+    : converter_(std::move(converter))
+    , tokenizer_(std::move(tokenizer))
+{
+    if (!converter_)
+    {
+        throw std::invalid_argument("Evaluator: pointer to converter is empty");
+    }
+    if (!tokenizer_)
+    {
+        throw std::invalid_argument("Evaluator: pointer to tokenizer is empty");
+    }
+}
+
+std::shared_ptr<s2e2::RegistryImpl> s2e2::RegistryImpl::copy() const
+{
+    auto result = std::make_shared<RegistryImpl>(converter_->clone(), tokenizer_->clone());
+    result->functions_ = functions_;
+    result->operators_ = operators_;
+    result->order_ = order_;
+    result->callees_ = callees_;
+    result->frozen_ = frozen_;
+    return result;
+}
+
+s2e2::RegistryImpl& s2e2::RegistryImpl::writable(std::shared_ptr<RegistryImpl>& registry)
+{
+    if (registry.use_count() > 1 && !registry->frozen_)
+    {
+        registry = registry->copy();
+    }
+    return *registry;
+}
+
+void s2e2::RegistryImpl::addFunction(std::shared_ptr<const Function> fn)
+{
+    if (!fn)
+    {
+        throw std::invalid_argument("Evaluator: pointer to adding function is empty");
+    }
+    checkUniqueness(fn->name);
+
+    const auto symbol = tokenizer_->addFunction(fn->name);
+    if (symbol != NO_SYMBOL)
+    {
+        calleeOf(symbol).function = fn.get();
+    }
+    order_.emplace_back(fn, nullptr);
+    functions_.emplace(fn->name, std::move(fn));
+}
+
+void s2e2::RegistryImpl::addOperator(std::shared_ptr<const Operator> op)
+{
+    if (!op)
+    {
+        throw std::invalid_argument("Evaluator: pointer to adding operator is empty");
+    }
+    checkUniqueness(op->name);
+
+    converter_->addOperator(op->name, op->priority);
+    const auto symbol = tokenizer_->addOperator(op->name, op->priority);
+    if (symbol != NO_SYMBOL)
+    {
+        calleeOf(symbol).op = op.get();
+    }
+    order_.emplace_back(nullptr, op);
+    operators_.emplace(op->name, std::move(op));
+}
+
+void s2e2::RegistryImpl::addStandardFunctions()
+{
+    addFunction(std::make_shared<FunctionAddDays>());
+    addFunction(std::make_shared<FunctionConcat>());
+    addFunction(std::make_shared<FunctionFormatDate>());
+    addFunction(std::make_shared<FunctionIf>());
+    addFunction(std::make_shared<FunctionIn>());
+    addFunction(std::make_shared<FunctionNow>());
+    addFunction(std::make_shared<FunctionReplace>());
+}
+
+void s2e2::RegistryImpl::addStandardOperators()
+{
+    addOperator(std::make_shared<OperatorAnd>());
+    addOperator(std::make_shared<OperatorEqual>());
+    addOperator(std::make_shared<OperatorGreaterOrEqual>());
+    addOperator(std::make_shared<OperatorGreater>());
+    addOperator(std::make_shared<OperatorLessOrEqual>());
+    addOperator(std::make_shared<OperatorLess>());
+    addOperator(std::make_shared<OperatorNotEqual>());
+    addOperator(std::make_shared<OperatorNot>());
+    addOperator(std::make_shared<OperatorOr>());
+    addOperator(std::make_shared<OperatorPlus>());
+}
+
+void s2e2::RegistryImpl::freeze()
+{
+    if (!frozen_)
+    {
+        tokenizer_->freeze();
+        frozen_ = true;
+    }
+}
+
+bool s2e2::RegistryImpl::frozen() const
+{
+    return frozen_;
+}
+
+std::unordered_set<const s2e2::Function*> s2e2::RegistryImpl::getFunctions() const
+{
+    std::unordered_set<const Function*> result(functions_.bucket_count());
+    for (const auto& pair : functions_)
+    {
+        result.insert(pair.second.get());
+    }
+    return result;
+}
+
+std::unordered_set<const s2e2::Operator*> s2e2::RegistryImpl::getOperators() const
+{
+    std::unordered_set<const Operator*> result(operators_.bucket_count());
+    for (const auto& pair : operators_)
+    {
+        result.insert(pair.second.get());
+    }
+    return result;
+}
+
+const s2e2::Operator* s2e2::RegistryImpl::findOperator(const Token& token) const
+{
+    if (token.symbol != NO_SYMBOL)
+    {
+        return (token.symbol < callees_.size()) ? callees_[token.symbol].op : nullptr;
+    }
+    const auto it = operators_.find(token.value);
+    return (it != operators_.end()) ? it->second.get() : nullptr;
+}
+
+const s2e2::Function* s2e2::RegistryImpl::findFunction(const Token& token) const
+{
+    if (token.symbol != NO_SYMBOL)
+    {
+        return (token.symbol < callees_.size()) ? callees_[token.symbol].function : nullptr;
+    }
+    const auto it = functions_.find(token.value);
+    return (it != functions_.end()) ? it->second.get() : nullptr;
+}
+
+const s2e2::ITokenizer& s2e2::RegistryImpl::tokenizer() const
+{
+    return *tokenizer_;
+}
+
+const s2e2::IConverter& s2e2::RegistryImpl::converter() const
+{
+    return *converter_;
+}
+
+void s2e2::RegistryImpl::checkUniqueness(const std::string& entityName) const
+{
+    if (frozen_)
+    {
+        throw Error("Evaluator: functions and operators are frozen, " + entityName + " can not be added");
+    }
+    if (functions_.count(entityName) != 0)
+    {
+        throw Error("Evaluator: function " + entityName + " is already added");
+    }
+    if (operators_.count(entityName) != 0)
+    {
+        throw Error("Evaluator: operator " + entityName + " is already added");
+    }
+}
+
+s2e2::RegistryImpl::Callee& s2e2::RegistryImpl::calleeOf(SymbolId symbol)
+{
+    if (symbol >= callees_.size())
+    {
+        callees_.resize(symbol + 1);
+    }
+    return callees_[symbol];
+}
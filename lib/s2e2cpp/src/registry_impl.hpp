@@ -0,0 +1,188 @@
+#pragma once
+
+#include "interface_converter.hpp"
+#include "interface_tokenizer.hpp"
+#include "symbol_table.hpp"
+#include "token.hpp"
+
+#include <s2e2/function.hpp>
+#include <s2e2/operator.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class RegistryImpl
+     * @brief Functions and operators together with the tokenizer and the converter knowing their names.
+     * @details Once shared by several evaluators or compiled expressions a registry is never changed,
+     *          owners extend their own copy instead. Functions and operators themselves are shared by copies.
+     *          All const methods can be called from many threads.
+     */
+    class RegistryImpl final
+    {
+    public:
+        /**
+         * @brief Construct the empty registry with the default tokenizer and converter.
+         */
+        RegistryImpl();
+
+        /**
+         * @brief Constructor for unit testing.
+         * @param[in] converter - External IConverter object.
+         * @param[in] tokenizer - External ITokenizer object.
+         * @throws std::invalid_argument if any of input params in empty.
+         */
+        RegistryImpl(std::unique_ptr<IConverter>&& converter, std::unique_ptr<ITokenizer>&& tokenizer);
+
+        /**
+         * @brief Make a copy with clones of the tokenizer and the converter and the same functions and operators.
+         * @details Clones know the same names under the same ids, so expressions are tokenized the same way.
+         * @returns Copy of the registry.
+         */
+        std::shared_ptr<RegistryImpl> copy() const;
+
+        /**
+         * @brief Get the registry to add functions or operators to, replacing it with a copy if it is shared.
+         * @details Frozen registries are never copied, adding to them throws anyway.
+         * @param[in, out] registry - Registry owned by the caller, not empty.
+         * @returns Registry with no other owners unless it is frozen.
+         */
+        static RegistryImpl& writable(std::shared_ptr<RegistryImpl>& registry);
+
+        /**
+         * @brief Add function.
+         * @param[in] fn - Pointer to new supported function.
+         * @throws std::invalid_argument if pointer is empty.
+         * @throws Error if function or operator with the same name is already added or the registry is frozen.
+         */
+        void addFunction(std::shared_ptr<const Function> fn);
+
+        /**
+         * @brief Add operator.
+         * @param[in] op - Pointer to new supported operator.
+         * @throws std::invalid_argument if pointer is empty.
+         * @throws Error if function or operator with the same name is already added or the registry is frozen.
+         */
+        void addOperator(std::shared_ptr<const Operator> op);
+
+        /**
+         * @brief Add standard functions.
+         * @throws Error if there is a collision between functions names.
+         */
+        void addStandardFunctions();
+
+        /**
+         * @brief Add standard operators.
+         * @throws Error if there is a collision between operators names.
+         */
+        void addStandardOperators();
+
+        /**
+         * @brief Build lookup tables of the tokenizer, no more functions and operators can be added after that.
+         * @details A frozen registry is immutable, so it is frozen in place and stays shared by all its owners.
+         *          Freezing must not run concurrently with compilations using the registry.
+         */
+        void freeze();
+
+        /**
+         * @brief Check if functions and operators are frozen.
+         * @returns true if freeze() was called.
+         */
+        bool frozen() const;
+
+        /**
+         * @brief Get collection of pointers to all supported functions.
+         * @returns Collection of pointers to functions.
+         */
+        std::unordered_set<const Function*> getFunctions() const;
+
+        /**
+         * @brief Get collection of pointers to all supported operators.
+         * @returns Collection of pointers to operators.
+         */
+        std::unordered_set<const Operator*> getOperators() const;
+
+        /**
+         * @brief Find operator of the token by its symbol, or by its name if the token carries no symbol.
+         * @param[in] token - OPERATOR token.
+         * @returns Operator or null if it is not supported.
+         */
+        const Operator* findOperator(const Token& token) const;
+
+        /**
+         * @brief Find function of the token by its symbol, or by its name if the token carries no symbol.
+         * @param[in] token - FUNCTION token.
+         * @returns Function or null if it is not supported.
+         */
+        const Function* findFunction(const Token& token) const;
+
+        /**
+         * @brief Get the tokenizer of all added names.
+         * @returns Tokenizer.
+         */
+        const ITokenizer& tokenizer() const;
+
+        /**
+         * @brief Get the converter of all added operators.
+         * @returns Converter.
+         */
+        const IConverter& converter() const;
+
+    private:
+        /**
+         * @brief Function or operator of an interned symbol.
+         */
+        struct Callee
+        {
+            /// @brief Function or null.
+            const Function* function = nullptr;
+
+            /// @brief Operator or null.
+            const Operator* op = nullptr;
+        };
+
+        /**
+         * @brief Check is function's or operator's name is unique and can be added.
+         * @param[in] entityName - Function's or operator's name.
+         * @throws Error if the name is not unique or the registry is frozen.
+         */
+        void checkUniqueness(const std::string& entityName) const;
+
+        /**
+         * @brief Get callee of the symbol the tokenizer assigned to a function or an operator.
+         * @param[in] symbol - Id of the symbol, not NO_SYMBOL.
+         * @returns Callee to set.
+         */
+        Callee& calleeOf(SymbolId symbol);
+
+    private:
+        /// @brief Converter of infix token sequence into postfix one.
+        const std::unique_ptr<IConverter> converter_;
+
+        /// @brief Tokenizer of expression onto list of tokens.
+        const std::unique_ptr<ITokenizer> tokenizer_;
+
+        /// @brief Set of all supported functions.
+        std::unordered_map<std::string, std::shared_ptr<const Function>> functions_;
+
+        /// @brief Set of all supported operators.
+        std::unordered_map<std::string, std::shared_ptr<const Operator>> operators_;
+
+        /// @brief Functions and operators in order of registration, exactly one of the pair is set.
+        std::vector<std::pair<std::shared_ptr<const Function>, std::shared_ptr<const Operator>>> order_;
+
+        /// @brief Functions and operators by ids of their symbols, tokens of the tokenizer are compiled with no hashing.
+        std::vector<Callee> callees_;
+
+        /// @brief Are functions and operators frozen.
+        bool frozen_ = false;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "decision_dag.hpp"
+#include "program.hpp"
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @brief Single distinct sub-expression of a rule set.
+     */
+    struct RuleNode
+    {
+        /// @brief Node's type.
+        InstructionType type;
+
+        /// @brief Index of a constant, a variable or a set.
+        uint32_t index = 0;
+
+        /// @brief Operator to invoke.
+        const Operator* op = nullptr;
+
+        /// @brief Function to invoke.
+        const Function* fn = nullptr;
+
+        /// @brief Standard operator or function the node invokes.
+        Builtin builtin = Builtin::NONE;
+
+        /// @brief Indices of argument nodes, all of them are less than the index of this node.
+        std::vector<uint32_t> arguments;
+    };
+
+    /**
+     * @class RuleProgram
+     * @brief Several compiled expressions sharing their identical sub-expressions.
+     * @details Nodes form a DAG sorted topologically: every node is stored after all its arguments.
+     *          Operators && and || and function IF are executed lazily, the same way as in Program.
+     *          Rules which cannot match a record are skipped according to the decision DAG.
+     */
+    class RuleProgram final
+    {
+    public:
+        /// @brief Source expressions in priority order.
+        std::vector<std::string> expressions;
+
+        /// @brief Names of bound variables.
+        std::vector<std::string> variables;
+
+        /// @brief Distinct constant values used by nodes.
+        std::vector<std::any> constants;
+
+        /// @brief Distinct constant sets used by MEMBERSHIP nodes.
+        std::vector<ValueSet> sets;
+
+        /// @brief Distinct sub-expressions of all rules.
+        std::vector<RuleNode> nodes;
+
+        /// @brief Index of the root node of every rule.
+        std::vector<uint32_t> roots;
+
+        /// @brief Selector of rules which can match a record.
+        DecisionDag decisions;
+
+        /// @brief Registry of resolved functions and operators, keeps them alive as long as the program.
+        std::shared_ptr<const RegistryImpl> registry;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,137 @@
+#include "decision_dag_builder.hpp"
+#include "rule_program_builder.hpp"
+
+#include <functional>
+
+
+namespace // anonymous
+{
+    /**
+     * @brief Mix the hash of one more value into the combined hash.
+     * @param[in] seed - Combined hash so far.
+     * @param[in] value - Hash of the value.
+     * @returns New combined hash.
+     */
+    size_t combineHash(size_t seed, size_t value)
+    {
+        return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+} // namespace anonymous
+
+
+size_t s2e2::RuleProgramBuilder::NodeKeyHash::operator()(const NodeKey& key) const
+{
+    auto hash = std::hash<uint32_t>{}(static_cast<uint32_t>(std::get<0>(key)));
+    hash = combineHash(hash, std::hash<uint32_t>{}(std::get<1>(key)));
+    hash = combineHash(hash, std::hash<const Operator*>{}(std::get<2>(key)));
+    hash = combineHash(hash, std::hash<const Function*>{}(std::get<3>(key)));
+    for (const auto argument : std::get<4>(key))
+    {
+        hash = combineHash(hash, std::hash<uint32_t>{}(argument));
+    }
+    return hash;
+}
+
+s2e2::RuleProgramBuilder::RuleProgramBuilder(std::vector<std::string> variables)
+    : program_{std::make_shared<RuleProgram>()}
+{
+    program_->variables = std::move(variables);
+}
+
+void s2e2::RuleProgramBuilder::addRule(const Program& program)
+{
+    if (!program_->registry)
+    {
+        program_->registry = program.registry;
+    }
+
+    // compiled programs are well-formed, so the stack never underflows
+    std::vector<uint32_t> stack;
+
+    for (const auto& instruction : program.instructions)
+    {
+        RuleNode node{instruction.type, instruction.index, instruction.op, instruction.fn, instruction.builtin, {}};
+
+        switch (instruction.type)
+        {
+            case InstructionType::CONSTANT:
+                node.index = internConstant(program.constants[instruction.index]);
+                break;
+
+            case InstructionType::VARIABLE:
+                break;
+
+            case InstructionType::MEMBERSHIP:
+                node.index = internSet(program.sets[instruction.index]);
+                [[fallthrough]];
+
+            case InstructionType::OPERATOR:
+            case InstructionType::FUNCTION:
+            {
+                const auto numberOfArguments = instruction.numberOfArguments;
+                node.arguments.assign(stack.end() - numberOfArguments, stack.end());
+                stack.resize(stack.size() - numberOfArguments);
+                break;
+            }
+        }
+
+        stack.push_back(internNode(std::move(node)));
+    }
+
+    program_->expressions.push_back(program.expression);
+    program_->roots.push_back(stack.back());
+}
+
+std::shared_ptr<const s2e2::RuleProgram> s2e2::RuleProgramBuilder::build()
+{
+    program_->decisions = DecisionDagBuilder(*program_).build();
+    return program_;
+}
+
+uint32_t s2e2::RuleProgramBuilder::internConstant(const std::any& value)
+{
+    const auto* string = std::any_cast<std::string>(&value);
+    const auto key = string ? std::optional<std::string>{*string} : std::optional<std::string>{};
+
+    const auto it = constants_.find(key);
+    if (it != constants_.end())
+    {
+        return it->second;
+    }
+
+    const auto index = static_cast<uint32_t>(program_->constants.size());
+    program_->constants.push_back(value);
+    constants_.emplace(key, index);
+    return index;
+}
+
+uint32_t s2e2::RuleProgramBuilder::internSet(const ValueSet& set)
+{
+    const auto it = sets_.find(set);
+    if (it != sets_.end())
+    {
+        return it->second;
+    }
+
+    const auto index = static_cast<uint32_t>(program_->sets.size());
+    program_->sets.push_back(set);
+    sets_.emplace(set, index);
+    return index;
+}
+
+uint32_t s2e2::RuleProgramBuilder::internNode(RuleNode node)
+{
+    auto key = NodeKey{node.type, node.index, node.op, node.fn, node.arguments};
+
+    const auto it = nodes_.find(key);
+    if (it != nodes_.end())
+    {
+        return it->second;
+    }
+
+    const auto index = static_cast<uint32_t>(program_->nodes.size());
+    program_->nodes.push_back(std::move(node));
+    nodes_.emplace(std::move(key), index);
+    return index;
+}
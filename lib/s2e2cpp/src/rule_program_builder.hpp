@@ -0,0 +1,94 @@
+#pragma once
+
+#include "program.hpp"
+#include "rule_program.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class RuleProgramBuilder
+     * @brief Merges compiled programs into one rule program, storing every distinct sub-expression once.
+     * @details Nodes are hash-consed: a node is identified by its type, constant, variable, operator or function
+     *          and the identities of its arguments, so structurally identical sub-expressions get the same node.
+     */
+    class RuleProgramBuilder final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] variables - Names of variables all programs are compiled with.
+         */
+        explicit RuleProgramBuilder(std::vector<std::string> variables);
+
+        /**
+         * @brief Add the program as the next rule.
+         * @param[in] program - Compiled program.
+         */
+        void addRule(const Program& program);
+
+        /**
+         * @brief Get the rule program built so far.
+         * @returns Rule program.
+         */
+        std::shared_ptr<const RuleProgram> build();
+
+    private:
+        /**
+         * @brief Identity of a node.
+         */
+        using NodeKey = std::tuple<InstructionType, uint32_t, const Operator*, const Function*, std::vector<uint32_t>>;
+
+        /**
+         * @brief Hash of a node's identity.
+         */
+        struct NodeKeyHash
+        {
+            size_t operator()(const NodeKey& key) const;
+        };
+
+        /**
+         * @brief Get index of the constant, add it if it is new.
+         * @param[in] value - Constant value, string or NULL.
+         * @returns Index of the constant.
+         */
+        uint32_t internConstant(const std::any& value);
+
+        /**
+         * @brief Get index of the set, add it if it is new.
+         * @param[in] set - Constant set.
+         * @returns Index of the set.
+         */
+        uint32_t internSet(const ValueSet& set);
+
+        /**
+         * @brief Get index of the node, add it if it is new.
+         * @param[in] node - Node.
+         * @returns Index of the node.
+         */
+        uint32_t internNode(RuleNode node);
+
+    private:
+        /// @brief Rule program being built.
+        std::shared_ptr<RuleProgram> program_;
+
+        /// @brief Indices of known constants, NULL is the empty key.
+        std::unordered_map<std::optional<std::string>, uint32_t> constants_;
+
+        /// @brief Indices of known sets.
+        std::map<ValueSet, uint32_t> sets_;
+
+        /// @brief Indices of known nodes.
+        std::unordered_map<NodeKey, uint32_t, NodeKeyHash> nodes_;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,45 @@
+#include "rule_program.hpp"
+
+#include <s2e2/rule_set.hpp>
+
+#include <stdexcept>
+
+
+s2e2::RuleSet::RuleSet(std::shared_ptr<const RuleProgram> program)
+    : program_{std::move(program)}
+{
+    if (!program_)
+    {
+        throw std::invalid_argument("RuleSet: pointer to program is empty");
+    }
+}
+
+size_t s2e2::RuleSet::size() const
+{
+    return program_->roots.size();
+}
+
+const std::vector<std::string>& s2e2::RuleSet::expressions() const
+{
+    return program_->expressions;
+}
+
+const std::vector<std::string>& s2e2::RuleSet::variables() const
+{
+    return program_->variables;
+}
+
+size_t s2e2::RuleSet::numberOfNodes() const
+{
+    return program_->nodes.size();
+}
+
+size_t s2e2::RuleSet::numberOfDecisionNodes() const
+{
+    return program_->decisions.nodes.size();
+}
+
+const s2e2::RuleProgram& s2e2::RuleSet::program() const
+{
+    return *program_;
+}
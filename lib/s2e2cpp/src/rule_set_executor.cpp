@@ -0,0 +1,420 @@
+#include "rule_set_executor.hpp"
+
+#include <s2e2/error.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <typeinfo>
+
+
+size_t s2e2::RuleSetExecutor::execute(const RuleProgram& program,
+                                      const RecordBatch& records,
+                                      size_t record,
+                                      Span<std::optional<std::string>> results,
+                                      Span<RecordStatus> statuses)
+{
+    return execute(program, records, record, 0, program.roots.size(), results, statuses);
+}
+
+size_t s2e2::RuleSetExecutor::execute(const RuleProgram& program,
+                                      const RecordBatch& records,
+                                      size_t record,
+                                      size_t firstRule,
+                                      size_t lastRule,
+                                      Span<std::optional<std::string>> results,
+                                      Span<RecordStatus> statuses)
+{
+    startRecord(program);
+
+    const auto& guarded = program.decisions.select(records, record);
+    const auto& unguarded = program.decisions.unguardedRules;
+    auto nextGuarded = std::lower_bound(guarded.begin(), guarded.end(), firstRule);
+    auto nextUnguarded = std::lower_bound(unguarded.begin(), unguarded.end(), firstRule);
+
+    size_t failures = 0;
+    for (auto rule = firstRule; rule < lastRule; ++rule)
+    {
+        if (nextGuarded != guarded.end() && *nextGuarded == rule)
+        {
+            ++nextGuarded;
+        }
+        else if (nextUnguarded != unguarded.end() && *nextUnguarded == rule)
+        {
+            ++nextUnguarded;
+        }
+        else
+        {
+            // one of the rule's guards is false, so it is NULL
+            results[rule].reset();
+            statuses[rule] = RecordStatus::OK;
+            continue;
+        }
+
+        if (executeRule(program, records, record, rule, results[rule]))
+        {
+            statuses[rule] = RecordStatus::OK;
+        }
+        else
+        {
+            results[rule].reset();
+            statuses[rule] = RecordStatus::ERROR;
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+std::optional<s2e2::RuleMatch> s2e2::RuleSetExecutor::executeFirstMatch(const RuleProgram& program,
+                                                                       const RecordBatch& records,
+                                                                       size_t record)
+{
+    startRecord(program);
+
+    const auto& guarded = program.decisions.select(records, record);
+    const auto& unguarded = program.decisions.unguardedRules;
+    auto nextGuarded = guarded.begin();
+    auto nextUnguarded = unguarded.begin();
+
+    std::optional<std::string> result;
+    while (nextGuarded != guarded.end() || nextUnguarded != unguarded.end())
+    {
+        const auto rule = (nextUnguarded == unguarded.end() ||
+                           (nextGuarded != guarded.end() && *nextGuarded < *nextUnguarded)) ? *nextGuarded++
+                                                                                              : *nextUnguarded++;
+        if (executeRule(program, records, record, rule, result) && result)
+        {
+            return RuleMatch{rule, std::move(*result)};
+        }
+    }
+    return {};
+}
+
+void s2e2::RuleSetExecutor::startRecord(const RuleProgram& program)
+{
+    // generations only grow, so marks left by other programs or records never match
+    ++generation_;
+    executedIn_.resize(program.nodes.size());
+    succeeded_.resize(program.nodes.size());
+    values_.resize(program.nodes.size());
+}
+
+bool s2e2::RuleSetExecutor::executeRule(const RuleProgram& program,
+                                        const RecordBatch& records,
+                                        size_t record,
+                                        size_t rule,
+                                        std::optional<std::string>& result)
+{
+    context_ = ExecutionContext::current();
+
+    const auto root = program.roots[rule];
+    if (!executeNode(program, records, record, root))
+    {
+        return false;
+    }
+
+    const auto& value = valueOf(program, root);
+    if (!value.has_value())
+    {
+        result.reset();
+        return true;
+    }
+
+    static const auto& stringType = typeid(std::string);
+    if (value.type() != stringType)
+    {
+        return false;
+    }
+
+    result = std::any_cast<const std::string&>(value);
+    return true;
+}
+
+void s2e2::RuleSetExecutor::invalidate(const std::vector<uint32_t>& nodes)
+{
+    // generations start from one, so zero never matches the current one
+    for (const auto node : nodes)
+    {
+        executedIn_[node] = 0;
+    }
+}
+
+size_t s2e2::RuleSetExecutor::numberOfComputedNodes() const
+{
+    return computedNodes_;
+}
+
+bool s2e2::RuleSetExecutor::executeNode(const RuleProgram& program,
+                                        const RecordBatch& records,
+                                        size_t record,
+                                        uint32_t node)
+{
+    records_ = &records;
+    record_ = record;
+    frames_.clear();
+    if (isReady(program, node))
+    {
+        return succeeded_[node];
+    }
+
+    while (true)
+    {
+        const auto current = frames_.back().node;
+        const auto outcome = computeNode(program, frames_.back());
+        if (!outcome)
+        {
+            continue;
+        }
+
+        succeeded_[current] = *outcome;
+        executedIn_[current] = generation_;
+        ++computedNodes_;
+
+        frames_.pop_back();
+        if (frames_.empty())
+        {
+            return *outcome;
+        }
+    }
+}
+
+bool s2e2::RuleSetExecutor::isReady(const RuleProgram& program, uint32_t node)
+{
+    if (executedIn_[node] == generation_)
+    {
+        return true;
+    }
+
+    const auto type = program.nodes[node].type;
+    if (type == InstructionType::CONSTANT || type == InstructionType::VARIABLE)
+    {
+        executeLeaf(program, node);
+        return true;
+    }
+
+    frames_.push_back(Frame{node, 0});
+    return false;
+}
+
+void s2e2::RuleSetExecutor::executeLeaf(const RuleProgram& program, uint32_t node)
+{
+    if (context_)
+    {
+        context_->check();
+    }
+
+    const auto& ruleNode = program.nodes[node];
+    if (ruleNode.type == InstructionType::VARIABLE)
+    {
+        const auto& value = records_->value(record_, ruleNode.index);
+        values_[node] = value ? std::any{std::string{*value}} : std::any{};
+    }
+
+    succeeded_[node] = true;
+    executedIn_[node] = generation_;
+    ++computedNodes_;
+}
+
+std::optional<bool> s2e2::RuleSetExecutor::computeNode(const RuleProgram& program, Frame& frame)
+{
+    const auto& ruleNode = program.nodes[frame.node];
+
+    if (frame.step == 0)
+    {
+        if (context_)
+        {
+            context_->check();
+        }
+        frame.step = 1;
+    }
+
+    if (ruleNode.type == InstructionType::MEMBERSHIP)
+    {
+        return computeMembership(program, frame);
+    }
+    if (ruleNode.builtin == Builtin::AND || ruleNode.builtin == Builtin::OR)
+    {
+        return computeShortCircuit(program, frame);
+    }
+    if (ruleNode.builtin == Builtin::IF)
+    {
+        return computeIf(program, frame);
+    }
+
+    // step is one past the index of the next argument to execute
+    for (; frame.step <= ruleNode.arguments.size(); ++frame.step)
+    {
+        const auto argument = ruleNode.arguments[frame.step - 1];
+        if (!isReady(program, argument))
+        {
+            return {};
+        }
+        if (!succeeded_[argument])
+        {
+            return false;
+        }
+    }
+
+    for (const auto argument : ruleNode.arguments)
+    {
+        stack_.push(valueOf(program, argument));
+    }
+
+    Status status;
+    auto succeeded = false;
+    try
+    {
+        succeeded = ruleNode.op ? ruleNode.op->tryInvoke(stack_, status)
+                                : ruleNode.fn->tryInvoke(stack_, ruleNode.arguments.size(), status);
+        if (succeeded && (!context_ || context_->tryCheckValue(stack_.top(), status)))
+        {
+            values_[frame.node] = std::move(stack_.top());
+        }
+        else
+        {
+            succeeded = false;
+        }
+    }
+    catch (const AbortedError&)
+    {
+        while (!stack_.empty())
+        {
+            stack_.pop();
+        }
+        throw;
+    }
+    catch (const std::exception&)
+    {
+    }
+
+    while (!stack_.empty())
+    {
+        stack_.pop();
+    }
+    return succeeded;
+}
+
+std::optional<bool> s2e2::RuleSetExecutor::computeShortCircuit(const RuleProgram& program, Frame& frame)
+{
+    const auto& ruleNode = program.nodes[frame.node];
+    const auto decisiveValue = (ruleNode.builtin == Builtin::OR);
+
+    if (frame.step == 1)
+    {
+        const auto leftNode = ruleNode.arguments[0];
+        if (!isReady(program, leftNode))
+        {
+            return {};
+        }
+        if (!succeeded_[leftNode])
+        {
+            return false;
+        }
+
+        const auto* left = std::any_cast<bool>(&valueOf(program, leftNode));
+        if (!left)
+        {
+            return false;
+        }
+        if (*left == decisiveValue)
+        {
+            values_[frame.node] = *left;
+            return true;
+        }
+        frame.step = 2;
+    }
+
+    const auto rightNode = ruleNode.arguments[1];
+    if (!isReady(program, rightNode))
+    {
+        return {};
+    }
+    if (!succeeded_[rightNode])
+    {
+        return false;
+    }
+
+    const auto* right = std::any_cast<bool>(&valueOf(program, rightNode));
+    if (!right)
+    {
+        return false;
+    }
+
+    values_[frame.node] = *right;
+    return true;
+}
+
+std::optional<bool> s2e2::RuleSetExecutor::computeIf(const RuleProgram& program, Frame& frame)
+{
+    const auto& arguments = program.nodes[frame.node].arguments;
+
+    if (frame.step == 1)
+    {
+        if (!isReady(program, arguments[0]))
+        {
+            return {};
+        }
+        if (!succeeded_[arguments[0]])
+        {
+            return false;
+        }
+
+        const auto* condition = std::any_cast<bool>(&valueOf(program, arguments[0]));
+        if (!condition)
+        {
+            return false;
+        }
+        // step 2 executes the first branch, step 3 the second one
+        frame.step = *condition ? 2 : 3;
+    }
+
+    const auto branch = arguments[frame.step - 1];
+    if (!isReady(program, branch))
+    {
+        return {};
+    }
+    if (!succeeded_[branch])
+    {
+        return false;
+    }
+
+    values_[frame.node] = valueOf(program, branch);
+    return true;
+}
+
+std::optional<bool> s2e2::RuleSetExecutor::computeMembership(const RuleProgram& program, Frame& frame)
+{
+    const auto& ruleNode = program.nodes[frame.node];
+    const auto& set = program.sets[ruleNode.index];
+
+    const auto argument = ruleNode.arguments[0];
+    if (!isReady(program, argument))
+    {
+        return {};
+    }
+    if (!succeeded_[argument])
+    {
+        return false;
+    }
+
+    const auto& value = valueOf(program, argument);
+    if (!value.has_value())
+    {
+        values_[frame.node] = set.testNull();
+        return true;
+    }
+
+    const auto* string = std::any_cast<std::string>(&value);
+    if (!string)
+    {
+        return false;
+    }
+
+    values_[frame.node] = set.test(*string);
+    return true;
+}
+
+const std::any& s2e2::RuleSetExecutor::valueOf(const RuleProgram& program, uint32_t node) const
+{
+    const auto& ruleNode = program.nodes[node];
+    return (ruleNode.type == InstructionType::CONSTANT) ? program.constants[ruleNode.index] : values_[node];
+}
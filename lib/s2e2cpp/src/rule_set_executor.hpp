@@ -0,0 +1,223 @@
+#pragma once
+
+#include "execution_context.hpp"
+#include "rule_program.hpp"
+
+#include <s2e2/record_batch.hpp>
+#include <s2e2/rule_set.hpp>
+#include <s2e2/span.hpp>
+
+#include <any>
+#include <cstdint>
+#include <optional>
+#include <stack>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class RuleSetExecutor
+     * @brief Executes all rules of a rule program for one record.
+     * @details Only rules selected by the decision DAG are executed, all others are NULL.
+     *          Nodes are executed on demand and their values are memoized for the current record, so a
+     *          sub-expression shared by several rules is executed at most once per record.
+     *          Pending nodes are kept on an explicit stack, so deeply nested rules cannot exhaust the thread's stack.
+     *          Results are identical to the ones of executing every rule separately.
+     *          Limits of the execution context current when a rule starts are checked on every node.
+     */
+    class RuleSetExecutor final
+    {
+    public:
+        /**
+         * @brief Execute all rules for the record.
+         * @param[in] program - Rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[out] results - Values of rules, one per rule.
+         * @param[out] statuses - Outcomes of evaluation, one per rule.
+         * @returns Number of rules which failed to evaluate.
+         */
+        size_t execute(const RuleProgram& program,
+                       const RecordBatch& records,
+                       size_t record,
+                       Span<std::optional<std::string>> results,
+                       Span<RecordStatus> statuses);
+
+        /**
+         * @brief Execute a range of rules for the record.
+         * @param[in] program - Rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[in] firstRule - Index of the first rule of the range.
+         * @param[in] lastRule - Index past the last rule of the range.
+         * @param[out] results - Values of rules, one per rule of the program.
+         * @param[out] statuses - Outcomes of evaluation, one per rule of the program.
+         * @returns Number of rules of the range which failed to evaluate.
+         */
+        size_t execute(const RuleProgram& program,
+                       const RecordBatch& records,
+                       size_t record,
+                       size_t firstRule,
+                       size_t lastRule,
+                       Span<std::optional<std::string>> results,
+                       Span<RecordStatus> statuses);
+
+        /**
+         * @brief Execute rules in priority order until the first one evaluating into a not NULL value.
+         * @param[in] program - Rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @returns Matched rule or empty value if no rule matched.
+         */
+        std::optional<RuleMatch> executeFirstMatch(const RuleProgram& program, const RecordBatch& records, size_t record);
+
+        /**
+         * @brief Forget all memoized values and prepare for a new record.
+         * @param[in] program - Rule program.
+         */
+        void startRecord(const RuleProgram& program);
+
+        /**
+         * @brief Execute one rule reusing values memoized since the last startRecord().
+         * @details Lets a caller keep one record across calls, forgetting only values of invalidated nodes.
+         * @param[in] program - Rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[in] rule - Index of the rule.
+         * @param[out] result - Value of the rule.
+         * @returns true if the rule is evaluated, false if it failed.
+         */
+        bool executeRule(const RuleProgram& program,
+                         const RecordBatch& records,
+                         size_t record,
+                         size_t rule,
+                         std::optional<std::string>& result);
+
+        /**
+         * @brief Forget memoized values of the nodes, so they are computed again when needed.
+         * @param[in] nodes - Indices of nodes.
+         */
+        void invalidate(const std::vector<uint32_t>& nodes);
+
+        /**
+         * @brief Get number of nodes computed since construction.
+         * @returns Number of computed nodes.
+         */
+        size_t numberOfComputedNodes() const;
+
+    private:
+        /**
+         * @brief Node being executed, waiting for its arguments.
+         */
+        struct Frame
+        {
+            /// @brief Index of the node.
+            uint32_t node;
+
+            /// @brief Progress of the node's execution, zero if it is not started yet.
+            uint32_t step;
+        };
+
+    private:
+
+        /**
+         * @brief Execute the node and its arguments unless they are already executed for the current record.
+         * @param[in] program - Rule program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[in] node - Index of the node.
+         * @returns true if the node is evaluated, false if it failed.
+         */
+        bool executeNode(const RuleProgram& program, const RecordBatch& records, size_t record, uint32_t node);
+
+        /**
+         * @brief Check if the node is executed for the current record, execute or schedule it if it is not.
+         * @details Constants and variables are executed at once, other nodes are pushed on the stack of frames.
+         * @param[in] program - Rule program.
+         * @param[in] node - Index of the node.
+         * @returns true if the node is executed, false if it is pushed on the stack of frames.
+         */
+        bool isReady(const RuleProgram& program, uint32_t node);
+
+        /**
+         * @brief Execute the constant or the variable node.
+         * @param[in] program - Rule program.
+         * @param[in] node - Index of the node.
+         */
+        void executeLeaf(const RuleProgram& program, uint32_t node);
+
+        /**
+         * @brief Continue computing value of the operator, function or membership test.
+         * @param[in] program - Rule program.
+         * @param[in, out] frame - Frame of the node.
+         * @returns true if the node is evaluated, false if it failed, empty value if an argument is scheduled.
+         */
+        std::optional<bool> computeNode(const RuleProgram& program, Frame& frame);
+
+        /**
+         * @brief Continue computing operator && or ||, the right operand only if the left one does not decide the result.
+         * @param[in] program - Rule program.
+         * @param[in, out] frame - Frame of the node.
+         * @returns true if the node is evaluated, false if it failed, empty value if an argument is scheduled.
+         */
+        std::optional<bool> computeShortCircuit(const RuleProgram& program, Frame& frame);
+
+        /**
+         * @brief Continue computing function IF executing only the selected branch.
+         * @param[in] program - Rule program.
+         * @param[in, out] frame - Frame of the node.
+         * @returns true if the node is evaluated, false if it failed, empty value if an argument is scheduled.
+         */
+        std::optional<bool> computeIf(const RuleProgram& program, Frame& frame);
+
+        /**
+         * @brief Continue computing membership test of the value of the only argument.
+         * @param[in] program - Rule program.
+         * @param[in, out] frame - Frame of the node.
+         * @returns true if the node is evaluated, false if it failed, empty value if an argument is scheduled.
+         */
+        std::optional<bool> computeMembership(const RuleProgram& program, Frame& frame);
+
+        /**
+         * @brief Get memoized value of the evaluated node.
+         * @param[in] program - Rule program.
+         * @param[in] node - Index of the node.
+         * @returns Value of the node.
+         */
+        const std::any& valueOf(const RuleProgram& program, uint32_t node) const;
+
+    private:
+        /// @brief Sequential number of the current record, never zero.
+        uint64_t generation_ = 0;
+
+        /// @brief Generation in which every node was executed.
+        std::vector<uint64_t> executedIn_;
+
+        /// @brief Outcome of the last execution of every node.
+        std::vector<uint8_t> succeeded_;
+
+        /// @brief Memoized values of nodes, constants are not copied here.
+        std::vector<std::any> values_;
+
+        /// @brief Number of nodes computed since construction.
+        size_t computedNodes_ = 0;
+
+        /// @brief Scratch stack for invocations.
+        std::stack<std::any> stack_;
+
+        /// @brief Nodes being executed, the innermost one is on top.
+        std::vector<Frame> frames_;
+
+        /// @brief Values of variables of the current record.
+        const RecordBatch* records_ = nullptr;
+
+        /// @brief Index of the current record.
+        size_t record_ = 0;
+
+        /// @brief Execution context of the current rule, null if it is not limited.
+        ExecutionContext* context_ = nullptr;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,449 @@
+#include "error_status.hpp"
+#include "scalar_executor.hpp"
+
+#include <algorithm>
+#include <typeinfo>
+#include <utility>
+
+
+namespace // anonymous
+{
+    /// @brief Expected stack size after executing the whole program.
+    const size_t FINAL_STACK_SIZE = 1;
+
+} // namespace anonymous
+
+
+void s2e2::ScalarExecutor::setShortCircuit(bool enabled)
+{
+    shortCircuit_ = enabled;
+}
+
+std::optional<std::string> s2e2::ScalarExecutor::execute(const Program& program,
+                                                         const RecordBatch& records,
+                                                         size_t record,
+                                                         TracerImpl* tracer)
+{
+    std::optional<std::string> result;
+    Status status;
+    if (!tryExecute(program, records, record, tracer, result, status))
+    {
+        if (callError_)
+        {
+            std::rethrow_exception(std::exchange(callError_, nullptr));
+        }
+        throwError(status);
+    }
+    return result;
+}
+
+bool s2e2::ScalarExecutor::tryExecute(const Program& program,
+                                      const RecordBatch& records,
+                                      size_t record,
+                                      TracerImpl* tracer,
+                                      std::optional<std::string>& result,
+                                      Status& status)
+{
+    tracer_ = tracer;
+    context_ = ExecutionContext::current();
+    status_ = &status;
+    records_ = &records;
+    record_ = record;
+    callError_ = nullptr;
+    while (!stack_.empty())
+    {
+        stack_.pop();
+    }
+
+    return executeProgram(program) && getResultValueFromStack(result);
+}
+
+bool s2e2::ScalarExecutor::executeProgram(const Program& program)
+{
+    frames_.clear();
+    chains_.clear();
+    spanBegins_.clear();
+
+    // a program left with several values runs all of them in order, as calls given too many arguments fail
+    // only when they run
+    const auto root = program.instructions.size() - 1;
+    auto succeeded = true;
+    if (program.instructions[root].subtreeStart == 0)
+    {
+        succeeded = startSubtree(program, root);
+    }
+    else
+    {
+        for (auto end = program.instructions.size(); end > 0; end = program.instructions[end - 1].subtreeStart)
+        {
+            pushFrame(end - 1);
+        }
+    }
+    while (succeeded && !frames_.empty())
+    {
+        succeeded = step(program);
+    }
+    if (!succeeded)
+    {
+        abandonFrames(program);
+    }
+    return succeeded;
+}
+
+bool s2e2::ScalarExecutor::step(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto& instruction = program.instructions[frame.index];
+
+    if (instruction.type == InstructionType::CONSTANT || instruction.type == InstructionType::VARIABLE)
+    {
+        frames_.pop_back();
+        return executeLeaf(program, instruction);
+    }
+
+    if (frame.step == 0)
+    {
+        if (context_ && !context_->tryCheck(*status_))
+        {
+            return false;
+        }
+        if (tracer_ && instruction.type == InstructionType::FUNCTION)
+        {
+            frame.traced = true;
+            spanBegins_.push_back(tracer_->now());
+        }
+    }
+
+    switch (instruction.type)
+    {
+        case InstructionType::OPERATOR:
+            if (shortCircuit_ && (instruction.builtin == Builtin::AND || instruction.builtin == Builtin::OR))
+            {
+                return stepShortCircuit(program);
+            }
+            return stepCall(program);
+
+        case InstructionType::FUNCTION:
+            if (shortCircuit_ && instruction.builtin == Builtin::IF)
+            {
+                return stepIf(program);
+            }
+            return stepCall(program);
+
+        case InstructionType::MEMBERSHIP:
+            return stepMembership(program);
+
+        default:
+            return true;
+    }
+}
+
+bool s2e2::ScalarExecutor::stepCall(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto index = frame.index;
+    const auto& instruction = program.instructions[index];
+
+    if (frame.step == 0)
+    {
+        frame.step = 1;
+
+        // if every argument is a single instruction, they are the ones preceding the call
+        const auto begin = program.instructions.begin() + instruction.subtreeStart;
+        const auto end = program.instructions.begin() + index;
+        const auto onlyLeaves = (index - instruction.subtreeStart == instruction.numberOfArguments) &&
+            std::all_of(begin, end, [](const Instruction& argument)
+            {
+                return argument.type == InstructionType::CONSTANT || argument.type == InstructionType::VARIABLE;
+            });
+
+        if (!onlyLeaves)
+        {
+            // arguments are pushed from the last one, so the first one is executed first
+            for (auto last = index; last > instruction.subtreeStart; last = program.instructions[last - 1].subtreeStart)
+            {
+                pushFrame(last - 1);
+            }
+            return true;
+        }
+
+        for (auto argument = begin; argument != end; ++argument)
+        {
+            if (!executeLeaf(program, *argument))
+            {
+                return false;
+            }
+        }
+    }
+
+    return checkCall(instruction, invoke(instruction)) && popFrame(program);
+}
+
+bool s2e2::ScalarExecutor::stepShortCircuit(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto& instruction = program.instructions[frame.index];
+
+    if (frame.step == 0 && program.adaptiveChains)
+    {
+        if (auto* chain = program.adaptiveChains->find(frame.index))
+        {
+            frame.chained = true;
+            chains_.push_back(ChainState{chain, 0, false, {}});
+        }
+    }
+    if (frame.chained)
+    {
+        return stepChain(program);
+    }
+
+    const auto rightOperand = frame.index - 1;
+    const auto leftOperand = program.instructions[rightOperand].subtreeStart - 1;
+    const auto decisiveValue = (instruction.builtin == Builtin::OR);
+
+    switch (frame.step++)
+    {
+        case 0:
+            return startSubtree(program, leftOperand);
+
+        case 1:
+        {
+            const auto* left = std::any_cast<bool>(&stack_.top());
+            if (!left)
+            {
+                return fail(ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for operator " + instruction.op->name, instruction);
+            }
+            if (*left == decisiveValue)
+            {
+                return popFrame(program);
+            }
+
+            stack_.pop();
+            return startSubtree(program, rightOperand);
+        }
+
+        default:
+            if (!std::any_cast<bool>(&stack_.top()))
+            {
+                return fail(ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for operator " + instruction.op->name, instruction);
+            }
+            return popFrame(program);
+    }
+}
+
+bool s2e2::ScalarExecutor::stepChain(const Program& program)
+{
+    auto& frame = frames_.back();
+    auto& state = chains_.back();
+    const auto& instruction = program.instructions[frame.index];
+    auto& chain = *state.chain;
+    const auto decisiveValue = !chain.conjunction;
+    const auto numberOfOperands = chain.operands.size();
+
+    if (frame.step == 0)
+    {
+        state.sampled = program.adaptiveChains->startEvaluation(chain);
+        state.order = chain.order.load(std::memory_order_acquire);
+    }
+    else
+    {
+        auto& operand = chain.operands[AdaptiveChains::operandAt(state.order, frame.step - 1)];
+
+        const auto* value = std::any_cast<bool>(&stack_.top());
+        if (!value)
+        {
+            return fail(ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for operator " + instruction.op->name, instruction);
+        }
+        if (state.sampled)
+        {
+            AdaptiveChains::sample(operand, *value, state.start);
+        }
+        // the value of the last executed operand is the value of the chain
+        if (*value == decisiveValue || frame.step == numberOfOperands)
+        {
+            return popFrame(program);
+        }
+        stack_.pop();
+    }
+
+    const auto& operand = chain.operands[AdaptiveChains::operandAt(state.order, frame.step)];
+    state.start = state.sampled ? AdaptiveChains::Clock::now() : AdaptiveChains::Clock::time_point{};
+    ++frame.step;
+    return startSubtree(program, operand.root);
+}
+
+bool s2e2::ScalarExecutor::stepIf(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto& instruction = program.instructions[frame.index];
+    const auto whenFalse = frame.index - 1;
+    const auto whenTrue = program.instructions[whenFalse].subtreeStart - 1;
+    const auto condition = program.instructions[whenTrue].subtreeStart - 1;
+
+    switch (frame.step++)
+    {
+        case 0:
+            return startSubtree(program, condition);
+
+        case 1:
+        {
+            const auto* value = std::any_cast<bool>(&stack_.top());
+            if (!value)
+            {
+                return fail(ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for function " + instruction.fn->name, instruction);
+            }
+            const auto branch = *value ? whenTrue : whenFalse;
+
+            stack_.pop();
+            return startSubtree(program, branch);
+        }
+
+        default:
+            return popFrame(program);
+    }
+}
+
+bool s2e2::ScalarExecutor::stepMembership(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto& instruction = program.instructions[frame.index];
+    const auto& set = program.sets[instruction.index];
+
+    if (frame.step++ == 0)
+    {
+        return startSubtree(program, frame.index - 1);
+    }
+
+    auto& value = stack_.top();
+    if (!value.has_value())
+    {
+        value = set.testNull();
+        return popFrame(program);
+    }
+
+    const auto* string = std::any_cast<std::string>(&value);
+    if (!string)
+    {
+        return fail(ErrorCode::INVALID_ARGUMENTS, "Invalid arguments for " + set.callee(), instruction);
+    }
+    value = set.test(*string);
+    return popFrame(program);
+}
+
+bool s2e2::ScalarExecutor::startSubtree(const Program& program, size_t index)
+{
+    const auto& instruction = program.instructions[index];
+    if (instruction.type == InstructionType::CONSTANT || instruction.type == InstructionType::VARIABLE)
+    {
+        return executeLeaf(program, instruction);
+    }
+    pushFrame(index);
+    return true;
+}
+
+void s2e2::ScalarExecutor::pushFrame(size_t index)
+{
+    frames_.push_back(Frame{static_cast<uint32_t>(index), 0, false, false});
+}
+
+bool s2e2::ScalarExecutor::executeLeaf(const Program& program, const Instruction& instruction)
+{
+    if (context_ && !context_->tryCheck(*status_))
+    {
+        return false;
+    }
+
+    if (instruction.type == InstructionType::CONSTANT)
+    {
+        stack_.push(program.constants[instruction.index]);
+    }
+    else
+    {
+        const auto& value = records_->value(record_, instruction.index);
+        stack_.push(value ? std::any{std::string{*value}} : std::any{});
+    }
+    return true;
+}
+
+bool s2e2::ScalarExecutor::popFrame(const Program& program)
+{
+    const auto& frame = frames_.back();
+    if (frame.traced)
+    {
+        tracer_->addSpan(program.instructions[frame.index].fn->name, spanBegins_.back(), tracer_->now());
+        spanBegins_.pop_back();
+    }
+    if (frame.chained)
+    {
+        chains_.pop_back();
+    }
+    frames_.pop_back();
+    return true;
+}
+
+void s2e2::ScalarExecutor::abandonFrames(const Program& program)
+{
+    while (!frames_.empty())
+    {
+        popFrame(program);
+    }
+}
+
+bool s2e2::ScalarExecutor::invoke(const Instruction& instruction)
+{
+    // built-ins report their errors as statuses, so only exceptions of custom code get here
+    try
+    {
+        return instruction.op ? instruction.op->tryInvoke(stack_, *status_)
+                              : instruction.fn->tryInvoke(stack_, instruction.numberOfArguments, *status_);
+    }
+    catch (const std::exception& exception)
+    {
+        callError_ = std::current_exception();
+        *status_ = statusOf(exception);
+        return false;
+    }
+}
+
+bool s2e2::ScalarExecutor::checkCall(const Instruction& instruction, bool succeeded)
+{
+    if (!succeeded)
+    {
+        status_->position = instruction.position;
+        return false;
+    }
+    return !context_ || context_->tryCheckValue(stack_.top(), *status_);
+}
+
+bool s2e2::ScalarExecutor::fail(ErrorCode code, std::string message, const Instruction& instruction)
+{
+    *status_ = Status{code, std::move(message), instruction.position};
+    return false;
+}
+
+bool s2e2::ScalarExecutor::getResultValueFromStack(std::optional<std::string>& result)
+{
+    if (stack_.size() != FINAL_STACK_SIZE)
+    {
+        *status_ = Status{ErrorCode::INVALID_EXPRESSION, "Evaluator: invalid expression"};
+        return false;
+    }
+
+    auto& value = stack_.top();
+
+    if (!value.has_value())
+    {
+        result.reset();
+        return true;
+    }
+
+    static const auto& stringType = typeid(std::string);
+    if (value.type() != stringType)
+    {
+        *status_ = Status{ErrorCode::NOT_A_STRING, "Evaluator: expression value is not a string"};
+        return false;
+    }
+
+    result = std::any_cast<std::string>(std::move(value));
+    return true;
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "adaptive_chains.hpp"
+#include "execution_context.hpp"
+#include "program.hpp"
+#include "tracer_impl.hpp"
+
+#include <s2e2/record_batch.hpp>
+#include <s2e2/status.hpp>
+
+#include <any>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <stack>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class ScalarExecutor
+     * @brief Executes compiled programs record by record on a stack of values.
+     * @details With short-circuit evaluation operators && and || and function IF execute only the subtrees deciding
+     *          their value, otherwise every argument is executed before the call as in the baseline stack machine.
+     *          Keeps its stack between records to reuse its memory, so one executor must not be shared by threads.
+     *          Checks limits of the current execution context between instructions and after every call.
+     *          Reports errors of the expression as statuses, execute() turns them into exceptions.
+     *          Exceptions of custom functions and operators are caught at the call and reported as CALL_FAILED,
+     *          execute() rethrows them as they are.
+     */
+    class ScalarExecutor final
+    {
+    public:
+        /**
+         * @brief Turn short-circuit evaluation of &&, || and IF on or off.
+         * @param[in] enabled - Is short-circuit evaluation on.
+         */
+        void setShortCircuit(bool enabled);
+
+        /**
+         * @brief Execute the program for one record.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[in] tracer - Tracer to record function invocations into, can be null.
+         * @return String value or empty value.
+         * @throws Error in case of an invalid expression.
+         * @throws AbortedError if the execution context is cancelled or its deadline is exceeded.
+         */
+        std::optional<std::string> execute(const Program& program,
+                                           const RecordBatch& records,
+                                           size_t record,
+                                           TracerImpl* tracer);
+
+        /**
+         * @brief Execute the program for one record without throwing on errors of the expression.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] record - Index of the record.
+         * @param[in] tracer - Tracer to record function invocations into, can be null.
+         * @param[out] result - String value or empty value.
+         * @param[out] status - Error with the position of the failed instruction.
+         * @return true on success, false in case of an error.
+         * @details Exceptions of custom functions and operators are reported as CALL_FAILED.
+         */
+        bool tryExecute(const Program& program,
+                        const RecordBatch& records,
+                        size_t record,
+                        TracerImpl* tracer,
+                        std::optional<std::string>& result,
+                        Status& status);
+
+    private:
+        /**
+         * @brief Execution of one instruction's subtree in progress.
+         */
+        struct Frame
+        {
+            /// @brief Index of the instruction.
+            uint32_t index = 0;
+
+            /// @brief Number of operands whose execution has already started.
+            uint32_t step = 0;
+
+            /// @brief Whether the trace span of the function is started.
+            bool traced = false;
+
+            /// @brief Whether the instruction is the root of an adaptive chain.
+            bool chained = false;
+        };
+
+        /**
+         * @brief Progress of an adaptive chain of && or || being executed.
+         */
+        struct ChainState
+        {
+            /// @brief Chain.
+            AdaptiveChains::Chain* chain = nullptr;
+
+            /// @brief Evaluation order of the chain.
+            uint64_t order = 0;
+
+            /// @brief Whether operands of the chain are sampled.
+            bool sampled = false;
+
+            /// @brief Start of the sampled operand.
+            AdaptiveChains::Clock::time_point start;
+        };
+
+        /**
+         * @brief Execute the whole program and push its value onto the stack.
+         * @details Subtrees are executed with an explicit stack of frames, so the depth of the expression is not
+         *          bounded by the stack of the thread. A program leaving several values pushes all of them.
+         * @param[in] program - Compiled program.
+         * @return false in case of an error.
+         */
+        bool executeProgram(const Program& program);
+
+        /**
+         * @brief Make the next step of the frame on the top: start an operand or finish the instruction.
+         * @param[in] program - Compiled program.
+         * @return false in case of an error.
+         */
+        bool step(const Program& program);
+
+        /**
+         * @brief Make the next step of a generic call: execute all arguments, then invoke the callee.
+         * @param[in] program - Compiled program.
+         * @return false in case of an error.
+         */
+        bool stepCall(const Program& program);
+
+        /**
+         * @brief Make the next step of operator && or || skipping its right operand if the left one decides the result.
+         * @param[in] program - Compiled program.
+         * @return false in case of non boolean operands.
+         */
+        bool stepShortCircuit(const Program& program);
+
+        /**
+         * @brief Make the next step of chain of && or || in its adaptive order, sampling statistics of its operands.
+         * @param[in] program - Compiled program.
+         * @return false in case of non boolean operands.
+         */
+        bool stepChain(const Program& program);
+
+        /**
+         * @brief Make the next step of function IF executing only the selected branch.
+         * @param[in] program - Compiled program.
+         * @return false in case of non boolean condition.
+         */
+        bool stepIf(const Program& program);
+
+        /**
+         * @brief Make the next step of membership test of the value of its only argument.
+         * @param[in] program - Compiled program.
+         * @return false in case of not a string argument.
+         */
+        bool stepMembership(const Program& program);
+
+        /**
+         * @brief Start execution of the subtree ending with the instruction.
+         * @details A constant or a variable is executed at once without a frame.
+         * @param[in] program - Compiled program.
+         * @param[in] index - Index of the last instruction of the subtree.
+         * @return false if the limits of the execution context are exceeded.
+         */
+        bool startSubtree(const Program& program, size_t index);
+
+        /**
+         * @brief Schedule execution of the subtree ending with the instruction.
+         * @param[in] index - Index of the last instruction of the subtree.
+         */
+        void pushFrame(size_t index);
+
+        /**
+         * @brief Push value of the constant or the variable onto the stack.
+         * @param[in] program - Compiled program.
+         * @param[in] instruction - Instruction of a constant or a variable.
+         * @return false if the limits of the execution context are exceeded.
+         */
+        bool executeLeaf(const Program& program, const Instruction& instruction);
+
+        /**
+         * @brief Finish execution of the frame on the top, its value is on the top of the stack.
+         * @param[in] program - Compiled program.
+         * @return Always true.
+         */
+        bool popFrame(const Program& program);
+
+        /**
+         * @brief Finish trace spans of all unfinished functions after an error.
+         * @param[in] program - Compiled program.
+         */
+        void abandonFrames(const Program& program);
+
+        /**
+         * @brief Invoke the operator or the function of the instruction with the arguments on the stack.
+         * @param[in] instruction - Instruction of the call.
+         * @return false if the call failed, an exception of custom code is kept to be rethrown by execute().
+         */
+        bool invoke(const Instruction& instruction);
+
+        /**
+         * @brief Finish call of the instruction: bind its error to its position or check size of its value.
+         * @param[in] instruction - Instruction of the call.
+         * @param[in] succeeded - Whether the call succeeded.
+         * @return false if the call failed or its value is a string over the limit of the execution context.
+         */
+        bool checkCall(const Instruction& instruction, bool succeeded);
+
+        /**
+         * @brief Record an error of the instruction.
+         * @param[in] code - Error code.
+         * @param[in] message - Error message.
+         * @param[in] instruction - Failed instruction.
+         * @return Always false.
+         */
+        bool fail(ErrorCode code, std::string message, const Instruction& instruction);
+
+        /**
+         * @brief Get result value from the stack of intermediate values.
+         * @param[out] result - String value or empty value.
+         * @return false in case of an invalid expression.
+         */
+        bool getResultValueFromStack(std::optional<std::string>& result);
+
+    private:
+        /// @brief Stack of intermediate values.
+        std::stack<std::any> stack_;
+
+        /// @brief Stack of subtrees being executed.
+        std::vector<Frame> frames_;
+
+        /// @brief Adaptive chains being executed, the innermost one is on top.
+        std::vector<ChainState> chains_;
+
+        /// @brief Beginnings of trace spans of functions being executed, the innermost one is on top.
+        std::vector<uint64_t> spanBegins_;
+
+        /// @brief Values of variables of the current execution.
+        const RecordBatch* records_ = nullptr;
+
+        /// @brief Index of the record of the current execution.
+        size_t record_ = 0;
+
+        /// @brief Tracer of the current execution, null if it is not traced.
+        TracerImpl* tracer_ = nullptr;
+
+        /// @brief Execution context of the current execution, null if it is not limited.
+        ExecutionContext* context_ = nullptr;
+
+        /// @brief Status of the current execution.
+        Status* status_ = nullptr;
+
+        /// @brief Exception of a custom function or operator failing the current execution.
+        std::exception_ptr callError_;
+
+        /// @brief Do &&, || and IF execute only the subtrees deciding their value.
+        bool shortCircuit_ = false;
+    };
+
+} // namespace s2e2
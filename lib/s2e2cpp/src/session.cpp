@@ -0,0 +1,55 @@
+#include "session_impl.hpp"
+
+#include <s2e2/session.hpp>
+
+
+s2e2::Session::Session(std::unique_ptr<SessionImpl> impl)
+    : impl_{std::move(impl)}
+{
+}
+
+s2e2::Session::Session(Session&&) noexcept = default;
+
+s2e2::Session& s2e2::Session::operator=(Session&&) noexcept = default;
+
+s2e2::Session::~Session() = default;
+
+size_t s2e2::Session::size() const
+{
+    return impl_->rules().size();
+}
+
+const std::vector<std::string>& s2e2::Session::variables() const
+{
+    return impl_->rules().variables();
+}
+
+void s2e2::Session::update(size_t variable, VariableValue value)
+{
+    impl_->update(variable, value);
+}
+
+void s2e2::Session::update(const std::string& variable, VariableValue value)
+{
+    impl_->update(impl_->indexOf(variable), value);
+}
+
+const std::vector<size_t>& s2e2::Session::changedRules() const
+{
+    return impl_->changedRules();
+}
+
+const std::optional<std::string>& s2e2::Session::result(size_t rule) const
+{
+    return impl_->result(rule);
+}
+
+s2e2::RecordStatus s2e2::Session::status(size_t rule) const
+{
+    return impl_->status(rule);
+}
+
+size_t s2e2::Session::numberOfRecomputedNodes() const
+{
+    return impl_->numberOfRecomputedNodes();
+}
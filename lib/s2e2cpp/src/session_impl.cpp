@@ -0,0 +1,154 @@
+#include "session_impl.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+s2e2::SessionImpl::SessionImpl(RuleSet rules, const std::vector<VariableValue>& values)
+    : rules_{std::move(rules)}
+{
+    const auto& program = rules_.program();
+    if (values.size() != program.variables.size())
+    {
+        throw std::invalid_argument("Session: number of values does not match number of variables");
+    }
+
+    for (const auto& value : values)
+    {
+        values_.emplace_back(value ? std::optional<std::string>{*value} : std::optional<std::string>{});
+    }
+    for (const auto& value : values_)
+    {
+        views_.emplace_back(value ? VariableValue{*value} : VariableValue{});
+    }
+
+    findDependents();
+
+    results_.resize(program.roots.size());
+    statuses_.resize(program.roots.size());
+
+    const auto records = RecordBatch::rowMajor(views_, 1, views_.size());
+    executor_.execute(program, records, 0, results_, statuses_);
+}
+
+const s2e2::RuleSet& s2e2::SessionImpl::rules() const
+{
+    return rules_;
+}
+
+void s2e2::SessionImpl::update(size_t variable, VariableValue value)
+{
+    if (variable >= values_.size())
+    {
+        throw std::invalid_argument("Session: variable index is out of range");
+    }
+
+    changedRules_.clear();
+    recomputedNodes_ = 0;
+
+    auto& stored = values_[variable];
+    if (value.has_value() == stored.has_value() && (!value || *value == *stored))
+    {
+        return;
+    }
+    stored = value ? std::optional<std::string>{*value} : std::optional<std::string>{};
+    views_[variable] = stored ? VariableValue{*stored} : VariableValue{};
+
+    const auto& program = rules_.program();
+    const auto records = RecordBatch::rowMajor(views_, 1, views_.size());
+    const auto computedBefore = executor_.numberOfComputedNodes();
+
+    executor_.invalidate(dependentNodes_[variable]);
+
+    std::optional<std::string> result;
+    for (const auto rule : dependentRules_[variable])
+    {
+        const auto succeeded = executor_.executeRule(program, records, 0, rule, result);
+        if (!succeeded)
+        {
+            result.reset();
+        }
+        const auto status = succeeded ? RecordStatus::OK : RecordStatus::ERROR;
+
+        if (status != statuses_[rule] || result != results_[rule])
+        {
+            statuses_[rule] = status;
+            results_[rule] = std::move(result);
+            changedRules_.push_back(rule);
+        }
+    }
+
+    recomputedNodes_ = executor_.numberOfComputedNodes() - computedBefore;
+}
+
+size_t s2e2::SessionImpl::indexOf(const std::string& variable) const
+{
+    const auto& variables = rules_.variables();
+    const auto it = std::find(variables.begin(), variables.end(), variable);
+    if (it == variables.end())
+    {
+        throw std::invalid_argument("Session: unknown variable " + variable);
+    }
+    return static_cast<size_t>(it - variables.begin());
+}
+
+const std::vector<size_t>& s2e2::SessionImpl::changedRules() const
+{
+    return changedRules_;
+}
+
+const std::optional<std::string>& s2e2::SessionImpl::result(size_t rule) const
+{
+    checkRule(rule);
+    return results_[rule];
+}
+
+s2e2::RecordStatus s2e2::SessionImpl::status(size_t rule) const
+{
+    checkRule(rule);
+    return statuses_[rule];
+}
+
+size_t s2e2::SessionImpl::numberOfRecomputedNodes() const
+{
+    return recomputedNodes_;
+}
+
+void s2e2::SessionImpl::findDependents()
+{
+    const auto& program = rules_.program();
+    std::vector<uint8_t> depends(program.nodes.size());
+
+    for (uint32_t variable = 0; variable < program.variables.size(); ++variable)
+    {
+        auto& nodes = dependentNodes_.emplace_back();
+        for (uint32_t node = 0; node < program.nodes.size(); ++node)
+        {
+            const auto& ruleNode = program.nodes[node];
+            depends[node] = (ruleNode.type == InstructionType::VARIABLE && ruleNode.index == variable) ||
+                            std::any_of(ruleNode.arguments.begin(), ruleNode.arguments.end(),
+                                        [&depends](uint32_t argument) { return depends[argument]; });
+            if (depends[node])
+            {
+                nodes.push_back(node);
+            }
+        }
+
+        auto& rules = dependentRules_.emplace_back();
+        for (uint32_t rule = 0; rule < program.roots.size(); ++rule)
+        {
+            if (depends[program.roots[rule]])
+            {
+                rules.push_back(rule);
+            }
+        }
+    }
+}
+
+void s2e2::SessionImpl::checkRule(size_t rule) const
+{
+    if (rule >= results_.size())
+    {
+        throw std::invalid_argument("Session: rule index is out of range");
+    }
+}
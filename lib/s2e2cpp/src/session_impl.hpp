@@ -0,0 +1,130 @@
+#pragma once
+
+#include "rule_program.hpp"
+#include "rule_set_executor.hpp"
+
+#include <s2e2/record_batch.hpp>
+#include <s2e2/rule_set.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class SessionImpl
+     * @brief Real implementation of Session class.
+     * @details Memoized node values of the executor survive updates, an update forgets only the values of the
+     *          nodes depending on the changed variable. Nodes are sorted topologically, so dependents are found in
+     *          one forward pass per variable.
+     */
+    class SessionImpl final
+    {
+    public:
+        /**
+         * @brief Constructor, evaluates all rules.
+         * @param[in] rules - Compiled rule set.
+         * @param[in] values - Initial values of variables.
+         * @throws std::invalid_argument if number of values does not match the rule set.
+         */
+        SessionImpl(RuleSet rules, const std::vector<VariableValue>& values);
+
+        /**
+         * @brief Get compiled rule set.
+         * @returns Rule set.
+         */
+        const RuleSet& rules() const;
+
+        /**
+         * @brief Set new value of the variable and evaluate again the rules depending on it.
+         * @param[in] variable - Index of the variable.
+         * @param[in] value - New value.
+         * @throws std::invalid_argument if there is no such variable.
+         */
+        void update(size_t variable, VariableValue value);
+
+        /**
+         * @brief Get index of the variable.
+         * @param[in] variable - Name of the variable.
+         * @returns Index of the variable.
+         * @throws std::invalid_argument if there is no such variable.
+         */
+        size_t indexOf(const std::string& variable) const;
+
+        /**
+         * @brief Get rules changed by the last update.
+         * @returns Indices of rules in priority order.
+         */
+        const std::vector<size_t>& changedRules() const;
+
+        /**
+         * @brief Get current value of the rule.
+         * @param[in] rule - Index of the rule.
+         * @returns Value of the rule.
+         * @throws std::invalid_argument if there is no such rule.
+         */
+        const std::optional<std::string>& result(size_t rule) const;
+
+        /**
+         * @brief Get current outcome of evaluation of the rule.
+         * @param[in] rule - Index of the rule.
+         * @returns Outcome of evaluation.
+         * @throws std::invalid_argument if there is no such rule.
+         */
+        RecordStatus status(size_t rule) const;
+
+        /**
+         * @brief Get number of nodes computed by the last update.
+         * @returns Number of nodes.
+         */
+        size_t numberOfRecomputedNodes() const;
+
+    private:
+        /**
+         * @brief Find nodes and rules depending on every variable.
+         */
+        void findDependents();
+
+        /**
+         * @brief Check that the rule exists.
+         * @param[in] rule - Index of the rule.
+         * @throws std::invalid_argument if there is no such rule.
+         */
+        void checkRule(size_t rule) const;
+
+    private:
+        /// @brief Compiled rule set.
+        const RuleSet rules_;
+
+        /// @brief Own copies of values of variables.
+        std::vector<std::optional<std::string>> values_;
+
+        /// @brief Views of values_ to read them as a record.
+        std::vector<VariableValue> views_;
+
+        /// @brief Nodes depending on every variable in topological order.
+        std::vector<std::vector<uint32_t>> dependentNodes_;
+
+        /// @brief Rules depending on every variable in priority order.
+        std::vector<std::vector<uint32_t>> dependentRules_;
+
+        /// @brief Executor keeping memoized values of nodes.
+        RuleSetExecutor executor_;
+
+        /// @brief Current values of rules.
+        std::vector<std::optional<std::string>> results_;
+
+        /// @brief Current outcomes of evaluation of rules.
+        std::vector<RecordStatus> statuses_;
+
+        /// @brief Rules changed by the last update.
+        std::vector<size_t> changedRules_;
+
+        /// @brief Number of nodes computed by the last update.
+        size_t recomputedNodes_ = 0;
+    };
+
+} // namespace s2e2
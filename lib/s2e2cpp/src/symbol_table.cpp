@@ -0,0 +1,213 @@
+#include "symbol_table.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+
+namespace // anonymous
+{
+    /// @brief Average number of names in a bucket sharing one displacement.
+    constexpr size_t NAMES_PER_BUCKET = 4;
+
+    /// @brief Number of displacements to try for a bucket before another seed is tried.
+    constexpr uint32_t MAX_DISPLACEMENT = 1U << 16;
+
+    /// @brief Number of seeds to try before the perfect hash gets more slots.
+    constexpr uint64_t SEEDS_PER_SIZE = 8;
+
+    /**
+     * @brief Mix all bits of the value into all bits of the result by the finalizer of SplitMix64.
+     * @param[in] value - Value.
+     * @returns Mixed value.
+     */
+    uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * @brief Seeded FNV-1a hash of the name.
+     * @param[in] name - Name.
+     * @param[in] seed - Seed.
+     * @returns Hash value.
+     */
+    uint64_t hashName(std::string_view name, uint64_t seed)
+    {
+        auto hash = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+        for (const auto symbol : name)
+        {
+            hash ^= static_cast<unsigned char>(symbol);
+            hash *= 0x100000001b3ULL;
+        }
+
+        // high bits of FNV-1a barely differ for similar names, and buckets are chosen by them
+        return mix(hash);
+    }
+
+    /**
+     * @brief Displace the hash of a name, different displacements scatter names of a bucket independently.
+     * @param[in] hash - Hash of the name.
+     * @param[in] displacement - Displacement of the name's bucket.
+     * @returns Displaced hash value.
+     */
+    uint64_t displace(uint64_t hash, uint32_t displacement)
+    {
+        return mix(hash + displacement * 0x9e3779b97f4a7c15ULL);
+    }
+
+    /**
+     * @brief Map the hash onto a range by multiplication instead of division.
+     * @param[in] hash - Hash value.
+     * @param[in] range - Size of the range, less than 2^32.
+     * @returns Value in [0, range).
+     */
+    size_t reduce(uint64_t hash, size_t range)
+    {
+        return static_cast<size_t>(((hash >> 32) * range) >> 32);
+    }
+
+} // namespace anonymous
+
+
+s2e2::SymbolId s2e2::SymbolTable::add(const std::string& name, TokenType type, uint_fast16_t priority)
+{
+    const auto id = static_cast<SymbolId>(symbols_.size());
+    symbols_.push_back(Symbol{name, type, priority});
+    ids_.emplace(name, id);
+    return id;
+}
+
+void s2e2::SymbolTable::freeze()
+{
+    if (frozen() || symbols_.empty())
+    {
+        return;
+    }
+
+    const auto [shortest, longest] = std::minmax_element(symbols_.begin(), symbols_.end(),
+        [](const Symbol& left, const Symbol& right) { return left.name.size() < right.name.size(); });
+    minLength_ = shortest->name.size();
+    maxLength_ = longest->name.size();
+
+    // a quarter of free slots keeps the search for displacements of the last buckets short
+    auto numberOfSlots = symbols_.size() + symbols_.size() / 4 + 1;
+    for (uint64_t seed = 0;; ++seed)
+    {
+        if (seed != 0 && seed % SEEDS_PER_SIZE == 0)
+        {
+            numberOfSlots += numberOfSlots / 8;
+        }
+        if (tryPlaceSymbols(numberOfSlots, seed))
+        {
+            seed_ = seed;
+            return;
+        }
+    }
+}
+
+bool s2e2::SymbolTable::frozen() const
+{
+    return !slots_.empty();
+}
+
+s2e2::SymbolId s2e2::SymbolTable::find(std::string_view name) const
+{
+    if (!frozen())
+    {
+        const auto it = ids_.find(std::string{name});
+        return (it != ids_.end()) ? it->second : NO_SYMBOL;
+    }
+
+    if (name.size() < minLength_ || name.size() > maxLength_)
+    {
+        return NO_SYMBOL;
+    }
+    const auto hash = hashName(name, seed_);
+    const auto displacement = displacements_[reduce(hash, displacements_.size())];
+    const auto id = slots_[reduce(displace(hash, displacement), slots_.size())];
+    return (id != NO_SYMBOL && symbols_[id].name == name) ? id : NO_SYMBOL;
+}
+
+const s2e2::Symbol& s2e2::SymbolTable::operator[](SymbolId id) const
+{
+    return symbols_[id];
+}
+
+size_t s2e2::SymbolTable::size() const
+{
+    return symbols_.size();
+}
+
+size_t s2e2::SymbolTable::numberOfSlots() const
+{
+    return slots_.size();
+}
+
+bool s2e2::SymbolTable::tryPlaceSymbols(size_t numberOfSlots, uint64_t seed)
+{
+    const auto numberOfBuckets = (symbols_.size() + NAMES_PER_BUCKET - 1) / NAMES_PER_BUCKET;
+    std::vector<uint64_t> hashes(symbols_.size());
+    std::vector<std::vector<SymbolId>> buckets(numberOfBuckets);
+    for (SymbolId id = 0; id < symbols_.size(); ++id)
+    {
+        hashes[id] = hashName(symbols_[id].name, seed);
+        buckets[reduce(hashes[id], numberOfBuckets)].push_back(id);
+    }
+
+    // the largest buckets are placed first, while most slots are still free
+    std::vector<size_t> order(numberOfBuckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t left, size_t right)
+    {
+        return buckets[left].size() > buckets[right].size();
+    });
+
+    slots_.assign(numberOfSlots, NO_SYMBOL);
+    displacements_.assign(numberOfBuckets, 0);
+    std::vector<size_t> taken;
+    for (const auto bucket : order)
+    {
+        const auto& ids = buckets[bucket];
+        if (ids.empty())
+        {
+            break;
+        }
+
+        auto placed = false;
+        for (uint32_t displacement = 0; !placed && displacement < MAX_DISPLACEMENT; ++displacement)
+        {
+            taken.clear();
+            for (const auto id : ids)
+            {
+                const auto slot = reduce(displace(hashes[id], displacement), numberOfSlots);
+                if (slots_[slot] != NO_SYMBOL)
+                {
+                    break;
+                }
+                slots_[slot] = id;
+                taken.push_back(slot);
+            }
+
+            placed = (taken.size() == ids.size());
+            if (placed)
+            {
+                displacements_[bucket] = displacement;
+                continue;
+            }
+            for (const auto slot : taken)
+            {
+                slots_[slot] = NO_SYMBOL;
+            }
+        }
+
+        if (!placed)
+        {
+            slots_.clear();
+            displacements_.clear();
+            return false;
+        }
+    }
+    return true;
+}
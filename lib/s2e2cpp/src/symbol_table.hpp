@@ -0,0 +1,128 @@
+#pragma once
+
+#include "token_type.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace s2e2
+{
+    /// @brief Small integer identifying a function or an operator name.
+    using SymbolId = uint32_t;
+
+    /// @brief Id of tokens which are not functions or operators, or were not interned.
+    constexpr SymbolId NO_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+    /**
+     * @brief Interned function or operator name.
+     */
+    struct Symbol
+    {
+        /// @brief Name of the function or the operator.
+        std::string name;
+
+        /// @brief Either FUNCTION or OPERATOR.
+        TokenType type;
+
+        /// @brief Priority of an operator, 0 for a function.
+        uint_fast16_t priority;
+    };
+
+    /**
+     * @class SymbolTable
+     * @brief Interns names of functions and operators once at registration.
+     * @details Ids are assigned in order of registration starting from 0, so later stages can compare
+     *          and index by them without hashing the names again. Once all names are added the table
+     *          can be frozen: it builds a perfect hash by hash and displace (CHD), so a lookup costs one hash
+     *          of the name, one displacement of the hash and one comparison. Names are hashed into buckets of
+     *          a few names, and every bucket gets a displacement placing all its names into free slots,
+     *          so the number of slots stays proportional to the number of names.
+     */
+    class SymbolTable final
+    {
+    public:
+        /**
+         * @brief Intern a new name.
+         * @param[in] name - Function's or operator's name, must not be interned yet.
+         * @param[in] type - Either FUNCTION or OPERATOR.
+         * @param[in] priority - Operator's priority.
+         * @returns Id of the symbol.
+         */
+        SymbolId add(const std::string& name, TokenType type, uint_fast16_t priority);
+
+        /**
+         * @brief Build the perfect hash of all names, no names can be added after that.
+         */
+        void freeze();
+
+        /**
+         * @brief Check if the table is frozen.
+         * @returns true if the perfect hash is built.
+         */
+        bool frozen() const;
+
+        /**
+         * @brief Find the symbol by name.
+         * @param[in] name - Function's or operator's name.
+         * @returns Id of the symbol or NO_SYMBOL if the name is not interned.
+         */
+        SymbolId find(std::string_view name) const;
+
+        /**
+         * @brief Get the symbol by id.
+         * @param[in] id - Id of an interned symbol.
+         * @returns Symbol.
+         */
+        const Symbol& operator[](SymbolId id) const;
+
+        /**
+         * @brief Get number of interned symbols.
+         * @returns Number of symbols.
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get number of slots of the perfect hash.
+         * @returns Number of slots, 0 until the table is frozen.
+         */
+        size_t numberOfSlots() const;
+
+    private:
+        /**
+         * @brief Try to find a displacement for every bucket placing every symbol into its own slot.
+         * @param[in] numberOfSlots - Number of slots, not less than number of symbols.
+         * @param[in] seed - Seed of the hash.
+         * @returns true if no two symbols share a slot.
+         */
+        bool tryPlaceSymbols(size_t numberOfSlots, uint64_t seed);
+
+    private:
+        /// @brief Symbols by id.
+        std::vector<Symbol> symbols_;
+
+        /// @brief Ids by name, used until the table is frozen.
+        std::unordered_map<std::string, SymbolId> ids_;
+
+        /// @brief Ids by slot of the perfect hash or NO_SYMBOL for empty slots, empty until the table is frozen.
+        std::vector<SymbolId> slots_;
+
+        /// @brief Displacements of hashes by bucket, empty until the table is frozen.
+        std::vector<uint32_t> displacements_;
+
+        /// @brief Seed of the perfect hash.
+        uint64_t seed_ = 0;
+
+        /// @brief Length of the shortest name, shorter ones are rejected without hashing.
+        size_t minLength_ = 0;
+
+        /// @brief Length of the longest name, longer ones are rejected without hashing.
+        size_t maxLength_ = 0;
+    };
+
+} // namespace s2e2
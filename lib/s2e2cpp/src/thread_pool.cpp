@@ -0,0 +1,21 @@
+#include "work_stealing_pool.hpp"
+
+#include <s2e2/thread_pool.hpp>
+
+
+s2e2::ThreadPool::ThreadPool(const ThreadPoolOptions& options)
+    : impl_{std::make_shared<WorkStealingPool>(options)}
+{
+}
+
+s2e2::ThreadPool::~ThreadPool() = default;
+
+size_t s2e2::ThreadPool::numberOfThreads() const
+{
+    return impl_->numberOfWorkers();
+}
+
+size_t s2e2::ThreadPool::grainSize() const
+{
+    return impl_->grainSize();
+}
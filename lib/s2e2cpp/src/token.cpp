@@ -2,8 +2,35 @@
 
 
 s2e2::Token::Token(const TokenType tokenType, std::string tokenValue)
+    : Token(tokenType, std::move(tokenValue), 0)
+{
+}
+
+s2e2::Token::Token(const TokenType tokenType, std::string tokenValue, const size_t tokenNumberOfArguments)
+    : Token(tokenType, std::move(tokenValue), tokenNumberOfArguments, Status::NO_POSITION)
+{
+}
+
+s2e2::Token::Token(const TokenType tokenType,
+                   std::string tokenValue,
+                   const size_t tokenNumberOfArguments,
+                   const size_t tokenPosition)
+    : Token(tokenType, std::move(tokenValue), tokenNumberOfArguments, tokenPosition, NO_SYMBOL, 0)
+{
+}
+
+s2e2::Token::Token(const TokenType tokenType,
+                   std::string tokenValue,
+                   const size_t tokenNumberOfArguments,
+                   const size_t tokenPosition,
+                   const SymbolId tokenSymbol,
+                   const uint_fast16_t tokenPriority)
     : type{tokenType}
     , value{std::move(tokenValue)}
+    , numberOfArguments{tokenNumberOfArguments}
+    , position{tokenPosition}
+    , symbol{tokenSymbol}
+    , priority{tokenPriority}
 {
 }
 
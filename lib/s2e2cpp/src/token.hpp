@@ -1,7 +1,12 @@
 #pragma once
 
+#include "symbol_table.hpp"
 #include "token_type.hpp"
 
+#include <s2e2/status.hpp>
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 
@@ -21,6 +26,42 @@ namespace s2e2
          */
         Token(const TokenType tokenType, std::string tokenValue);
 
+        /**
+         * @brief Construct the FUNCTION token with known number of arguments.
+         * @param[in] tokenType - Type of the token.
+         * @param[in] tokenValue - String value of the token.
+         * @param[in] tokenNumberOfArguments - Number of arguments the function is called with.
+         */
+        Token(const TokenType tokenType, std::string tokenValue, const size_t tokenNumberOfArguments);
+
+        /**
+         * @brief Construct the token found at the position of the source expression.
+         * @param[in] tokenType - Type of the token.
+         * @param[in] tokenValue - String value of the token.
+         * @param[in] tokenNumberOfArguments - Number of arguments the function is called with.
+         * @param[in] tokenPosition - Offset of the token in the source expression.
+         */
+        Token(const TokenType tokenType,
+              std::string tokenValue,
+              const size_t tokenNumberOfArguments,
+              const size_t tokenPosition);
+
+        /**
+         * @brief Construct the FUNCTION or OPERATOR token of the interned symbol.
+         * @param[in] tokenType - Type of the token.
+         * @param[in] tokenValue - String value of the token.
+         * @param[in] tokenNumberOfArguments - Number of arguments the function is called with.
+         * @param[in] tokenPosition - Offset of the token in the source expression.
+         * @param[in] tokenSymbol - Id of the symbol.
+         * @param[in] tokenPriority - Priority of the operator.
+         */
+        Token(const TokenType tokenType,
+              std::string tokenValue,
+              const size_t tokenNumberOfArguments,
+              const size_t tokenPosition,
+              const SymbolId tokenSymbol,
+              const uint_fast16_t tokenPriority);
+
         /**
          * @brief Compare token with another token.
          * @param[in] another - Another token.
@@ -34,6 +75,18 @@ namespace s2e2
 
         /// @brief Token's string value.
         const std::string value;
+
+        /// @brief Number of arguments of a FUNCTION token in postfix sequence, not compared by operator==.
+        const size_t numberOfArguments;
+
+        /// @brief Offset of the token in the source expression or Status::NO_POSITION, not compared by operator==.
+        const size_t position;
+
+        /// @brief Id of the interned function or operator or NO_SYMBOL, not compared by operator==.
+        const SymbolId symbol;
+
+        /// @brief Priority of an interned operator, not compared by operator==.
+        const uint_fast16_t priority;
     };
 
 } // namespace s2e2
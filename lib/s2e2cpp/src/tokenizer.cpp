@@ -1,9 +1,13 @@
+#include "char_class.hpp"
+#include "char_scanner.hpp"
 #include "tokenizer.hpp"
 
 #include <s2e2/error.hpp>
 
-#include <algorithm> 
-#include <cctype>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string>
 
 
 namespace // anonymous
@@ -23,7 +27,7 @@ namespace // anonymous
     {
         str.erase(
             str.begin(),
-            std::find_if(str.begin(), str.end(), [](int c) { return !std::isblank(c); })
+            std::find_if(str.begin(), str.end(), [](char c) { return !s2e2::hasCharClass(c, s2e2::CharClass::BLANK); })
         );
     }
 
@@ -34,7 +38,7 @@ namespace // anonymous
     void rightTrim(std::string& str)
     {
         str.erase(
-            std::find_if(str.rbegin(), str.rend(), [](int c) { return !std::isblank(c); }).base(),
+            std::find_if(str.rbegin(), str.rend(), [](char c) { return !s2e2::hasCharClass(c, s2e2::CharClass::BLANK); }).base(),
             str.end()
         );
     }
@@ -64,12 +68,34 @@ namespace // anonymous
 
             auto itCopy = it;
             auto tokenValue = it->value;
-            it = tokens.emplace(it, s2e2::TokenType::ATOM, tokenValue);
+            it = tokens.emplace(it, s2e2::TokenType::ATOM, tokenValue, 0, it->position);
 
             tokens.erase(itCopy);
         }
     }
 
+    /**
+     * @brief Add token of the value, a FUNCTION or OPERATOR token carries its interned symbol.
+     * @param[out] tokens - List of tokens.
+     * @param[in] symbols - Interned functions and operators.
+     * @param[in] value - Token's value.
+     * @param[in] position - Offset of the token in the expression.
+     */
+    void addTokenOfValue(std::list<s2e2::Token>& tokens,
+                         const s2e2::SymbolTable& symbols,
+                         std::string value,
+                         size_t position)
+    {
+        const auto id = symbols.find(value);
+        if (id == s2e2::NO_SYMBOL)
+        {
+            tokens.emplace_back(s2e2::TokenType::EXPRESSION, std::move(value), 0, position);
+            return;
+        }
+        const auto& symbol = symbols[id];
+        tokens.emplace_back(symbol.type, std::move(value), 0, position, id, symbol.priority);
+    }
+
     /**
      * @class ExpressionSplitter
      * @brief Class splits expression into raw tokens.
@@ -81,23 +107,48 @@ namespace // anonymous
          * @brief Construct the splitter object.
          * @param[in] typeByValue - External function to get token's type by its value.
          */
-        ExpressionSplitter(std::function<s2e2::TokenType(const std::string&)> typeByValue)
-            : typeByValue_{typeByValue}
+        ExpressionSplitter(const s2e2::SymbolTable& symbols)
+            : symbols_{symbols}
         {
         }
 
         /**
          * @brief Split expression into tokens by spaces and brackets.
          * @param[in] expression - Input expression.
-         * @throws Error if expression contains unknown symbol.
+         * @param[out] status - Error if expression contains unknown symbol.
+         * @returns true in case of success.
          */
-        const std::list<s2e2::Token>& splitIntoTokens(const std::string& expression)
+        bool splitIntoTokens(const std::string& expression, s2e2::Status& status)
         {
-            for (char symbol : expression)
+            position_ = 0;
+            while (position_ < expression.size())
             {
-                processSymbol(symbol);
+                // only quotes are special inside quotes, all other runs of ordinary symbols are copied at once
+                const auto special = insideQuotes_ ? scanner_.findQuote(expression, position_)
+                                                   : scanner_.findSpecial(expression, position_);
+                if (special != position_)
+                {
+                    addRunToToken(expression, special);
+                }
+                if (position_ < expression.size())
+                {
+                    if (!processSymbol(expression[position_], status))
+                    {
+                        return false;
+                    }
+                    ++position_;
+                }
             }
             flushToken();
+            return true;
+        }
+
+        /**
+         * @brief Get tokens the expression is split into.
+         * @returns List of tokens.
+         */
+        std::list<s2e2::Token>& tokens()
+        {
             return tokens_;
         }
 
@@ -105,39 +156,40 @@ namespace // anonymous
         /**
          * @brief Process one symbol of the input expression.
          * @param[in] symbol - Symbol of the expression.
-         * @throws Error if expression contains unknown symbol.
+         * @param[out] status - Error if expression contains unknown symbol.
+         * @returns true in case of success.
          */
-        void processSymbol(const char symbol)
+        bool processSymbol(const char symbol, s2e2::Status& status)
         {
             switch (symbol)
             {
             case COMMA:
             case LEFT_BRACKET:
             case RIGHT_BRACKET:
-                processSpecialSymbol(symbol);
-                break;
+                return processSpecialSymbol(symbol, status);
 
             case QUOTE:
                 processQuoteSymbol(symbol);
-                break;
+                return true;
 
             default:
                 processCommonSymbol(symbol);
-                break;
+                return true;
             }
         }
 
         /**
          * @brief Process one special symbol of the input expression.
          * @param[in] symbol - Special symbol of expression.
-         * @throws Error if expression contains unknown symbol.
+         * @param[out] status - Error if expression contains unknown symbol.
+         * @returns true in case of success.
          */
-        void processSpecialSymbol(const char symbol)
+        bool processSpecialSymbol(const char symbol, s2e2::Status& status)
         {
             if (insideQuotes_)
             {
                 addSymbolToToken(symbol);
-                return;
+                return true;
             }
             
             flushToken();
@@ -145,20 +197,24 @@ namespace // anonymous
             switch (symbol)
             {
             case COMMA:
-                addFoundToken(s2e2::TokenType::COMMA, COMMA);
+                addFoundToken(s2e2::TokenType::COMMA, COMMA, position_);
                 break;
 
             case LEFT_BRACKET:
-                addFoundToken(s2e2::TokenType::LEFT_BRACKET, LEFT_BRACKET);
+                addFoundToken(s2e2::TokenType::LEFT_BRACKET, LEFT_BRACKET, position_);
                 break;
 
             case RIGHT_BRACKET:
-                addFoundToken(s2e2::TokenType::RIGHT_BRACKET, RIGHT_BRACKET);
+                addFoundToken(s2e2::TokenType::RIGHT_BRACKET, RIGHT_BRACKET, position_);
                 break;
 
             default:
-                throw s2e2::Error(std::string{"Tokenizer: unexpected special symbol "} + symbol);
+                status = s2e2::Status{s2e2::ErrorCode::INVALID_EXPRESSION,
+                                      std::string{"Tokenizer: unexpected special symbol "} + symbol,
+                                      position_};
+                return false;
             }
+            return true;
         }
 
         /**
@@ -175,6 +231,7 @@ namespace // anonymous
             
             flushToken();
             insideQuotes_ = !insideQuotes_;
+            tokenStart_ = position_;
         }
 
         /**
@@ -183,7 +240,7 @@ namespace // anonymous
          */
         void processCommonSymbol(const char symbol)
         {
-            if (insideQuotes_ || std::isblank(symbol) == 0)
+            if (insideQuotes_ || !s2e2::hasCharClass(symbol, s2e2::CharClass::BLANK))
             {
                 addSymbolToToken(symbol);
                 return;
@@ -197,6 +254,11 @@ namespace // anonymous
          */
         void addSymbolToToken(const char symbol)
         {
+            if (currentToken_.empty() && !insideQuotes_)
+            {
+                tokenStart_ = position_;
+            }
+
             if (symbol == QUOTE)
             {
                 currentToken_.back() = symbol;
@@ -207,6 +269,21 @@ namespace // anonymous
             }
         }
 
+        /**
+         * @brief Add run of ordinary symbols starting at the current one to currently parsed token.
+         * @param[in] expression - Input expression.
+         * @param[in] end - Offset past the last symbol of the run.
+         */
+        void addRunToToken(const std::string& expression, size_t end)
+        {
+            if (currentToken_.empty() && !insideQuotes_)
+            {
+                tokenStart_ = position_;
+            }
+            currentToken_.append(expression, position_, end - position_);
+            position_ = end;
+        }
+
         /**
          * @brief Add current token if there is such to the list of found tokens.
          */
@@ -217,9 +294,13 @@ namespace // anonymous
                 trim(currentToken_);
             }
 
-            if (!currentToken_.empty() || insideQuotes_)
+            if (insideQuotes_)
+            {
+                addFoundToken(s2e2::TokenType::ATOM, currentToken_, tokenStart_);
+            }
+            else if (!currentToken_.empty())
             {
-                addFoundToken(tokenTypeByValue(currentToken_), currentToken_);
+                addTokenOfValue(tokens_, symbols_, currentToken_, tokenStart_);
             }
             currentToken_.clear();
         }
@@ -229,14 +310,15 @@ namespace // anonymous
          * @tparam T - Type of token's value.
          * @param[in] type - Token's type.
          * @param[in] value - Token's value.
+         * @param[in] position - Offset of the token in the expression.
          */
         template <class T>
-        void addFoundToken(s2e2::TokenType type, const T& value)
+        void addFoundToken(s2e2::TokenType type, const T& value, size_t position)
         {
             std::string valueCopy;
             valueCopy += value;
 
-            tokens_.emplace_back(type, std::move(valueCopy));
+            tokens_.emplace_back(type, std::move(valueCopy), 0, position);
         }
 
         /**
@@ -249,20 +331,6 @@ namespace // anonymous
                    currentToken_.back() == BACKSLASH;
         }
 
-        /**
-         * @brief Get token type by its value and current state of the splitter.
-         * @param[in] value - Token's value.
-         * @returns Token's type.
-         */
-        s2e2::TokenType tokenTypeByValue(const std::string& value)
-        {
-            if (insideQuotes_)
-            {
-                return s2e2::TokenType::ATOM;
-            }
-            return typeByValue_(value);
-        }
-
     private:
         /// @brief Flag of "inside quotes" state. If set it means that current symbol belongs to an ATOM.
         bool insideQuotes_ = false;
@@ -270,71 +338,211 @@ namespace // anonymous
         /// @brief Currently parsed token value.
         std::string currentToken_;
 
+        /// @brief Offset of the current symbol in the expression.
+        size_t position_ = 0;
+
+        /// @brief Offset of the first symbol of the current token, or of its opening quote.
+        size_t tokenStart_ = 0;
+
         /// @brief List of found tokens.
         std::list<s2e2::Token> tokens_;
 
-        /// @brief External function to get token's type by its value.
-        std::function<s2e2::TokenType(const std::string&)> typeByValue_;
+        /// @brief Scanner of special symbols.
+        const s2e2::CharScanner scanner_;
+
+        /// @brief Interned functions and operators.
+        const s2e2::SymbolTable& symbols_;
     };
 
 } // namespace anonymous 
 
-void s2e2::Tokenizer::addFunction(const std::string& functionName)
+std::unique_ptr<s2e2::ITokenizer> s2e2::Tokenizer::clone() const
+{
+    return std::make_unique<Tokenizer>(*this);
+}
+
+s2e2::SymbolId s2e2::Tokenizer::addFunction(const std::string& functionName)
 {
     checkUniqueness(functionName);
 
-    functions_.insert(functionName);
+    const auto symbol = symbols_.add(functionName, TokenType::FUNCTION, 0);
+    if (!functionName.empty())
+    {
+        functionFirstSymbols_[static_cast<unsigned char>(functionName.front())] = true;
+    }
+    return symbol;
 }
 
-void s2e2::Tokenizer::addOperator(const std::string& operatorName)
+s2e2::SymbolId s2e2::Tokenizer::addOperator(const std::string& operatorName, const uint_fast16_t priority)
 {
     checkUniqueness(operatorName);
 
-    operators_.insert(operatorName);
+    const auto symbol = symbols_.add(operatorName, TokenType::OPERATOR, priority);
+    operatorsByLength_[operatorName.size()].push_back(symbol);
 
-    const auto emplaceResult = operatorsByLength_.try_emplace(operatorName.size(), std::unordered_set<std::string>{});
-    emplaceResult.first->second.insert(operatorName);
+    if (!operatorName.empty())
+    {
+        operatorsByFirstSymbol_[static_cast<unsigned char>(operatorName.front())].push_back(operatorName);
+    }
+    return symbol;
+}
+
+void s2e2::Tokenizer::freeze()
+{
+    symbols_.freeze();
+    automaton_.build(symbols_);
+    frozen_ = true;
 }
 
 std::list<s2e2::Token> s2e2::Tokenizer::tokenize(const std::string& expression) const
 {
-    ExpressionSplitter splitter(std::bind(&Tokenizer::tokenTypeByValue, this, std::placeholders::_1));
-    const auto& rawTokens = splitter.splitIntoTokens(expression);
+    std::list<Token> tokens;
+    Status status;
+    if (!tryTokenize(expression, tokens, status))
+    {
+        throw Error(status.message);
+    }
+    return tokens;
+}
+
+bool s2e2::Tokenizer::tryTokenize(const std::string& expression, std::list<Token>& tokens, Status& status) const
+{
+    ExpressionSplitter splitter(symbols_);
+    if (!splitter.splitIntoTokens(expression, status))
+    {
+        return false;
+    }
+
+    tokens = splitTokensByOperators(splitter.tokens());
+    convertExpressionsIntoAtoms(tokens);
+    return true;
+}
+
+bool s2e2::Tokenizer::isLiteral(std::string_view expression,
+                                const std::vector<std::string>& variables,
+                                size_t& numberOfTokens) const
+{
+    numberOfTokens = 0;
+    size_t wordStart = 0;
+    while (wordStart <= expression.size())
+    {
+        const auto wordEnd = scanner_.findSpecial(expression, wordStart);
+        if (wordEnd != wordStart)
+        {
+            if (!isAtom(expression.substr(wordStart, wordEnd - wordStart), variables))
+            {
+                return false;
+            }
+            ++numberOfTokens;
+        }
+
+        // quotes, commas and brackets make tokens of their own, only blanks separate atoms
+        if (wordEnd < expression.size() && !hasCharClass(expression[wordEnd], CharClass::BLANK))
+        {
+            return false;
+        }
+        wordStart = wordEnd + 1;
+    }
+    return numberOfTokens != 0;
+}
+
+bool s2e2::Tokenizer::isAtom(std::string_view word, const std::vector<std::string>& variables) const
+{
+    if (frozen_)
+    {
+        return !automaton_.containsAny(word) &&
+               symbols_.find(word) == NO_SYMBOL &&
+               std::find(variables.begin(), variables.end(), word) == variables.end();
+    }
 
-    auto refinedTokens = splitTokensByOperators(rawTokens);
-    convertExpressionsIntoAtoms(refinedTokens);
-    return refinedTokens;
+    for (size_t i = 0; i < word.size(); ++i)
+    {
+        for (const auto& operatorName : operatorsByFirstSymbol_[static_cast<unsigned char>(word[i])])
+        {
+            if (word.compare(i, operatorName.size(), operatorName) == 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    if (functionFirstSymbols_[static_cast<unsigned char>(word.front())] && symbols_.find(word) != NO_SYMBOL)
+    {
+        return false;
+    }
+    return std::find(variables.begin(), variables.end(), word) == variables.end();
 }
 
 void s2e2::Tokenizer::checkUniqueness(const std::string& entityName) const
 {
-    if (functions_.count(entityName) != 0)
+    if (frozen_)
     {
-        throw Error("Tokenizer: function " + entityName + " is already added");
+        throw Error("Tokenizer: functions and operators are frozen, " + entityName + " can not be added");
     }
-    if (operators_.count(entityName) != 0)
+
+    const auto symbol = symbols_.find(entityName);
+    if (symbol == NO_SYMBOL)
     {
-        throw Error("Tokenizer: operator " + entityName + " is already added");
+        return;
     }
+    if (symbols_[symbol].type == TokenType::FUNCTION)
+    {
+        throw Error("Tokenizer: function " + entityName + " is already added");
+    }
+    throw Error("Tokenizer: operator " + entityName + " is already added");
 }
 
 std::list<s2e2::Token> s2e2::Tokenizer::splitTokensByOperators(const std::list<Token>& tokens) const
 {
     auto result = tokens;
 
-    for (const auto& pair : operatorsByLength_)
+    // a frozen tokenizer splits every token only by operators the automaton found in it,
+    // parts of a token are its substrings so no other operator can occur in them
+    if (frozen_)
     {
-        const auto& operatorsOfTheSameLength = pair.second;
-        for (const auto& operatorName : operatorsOfTheSameLength)
+        std::vector<bool> operators;
+        for (auto it = result.begin(); it != result.end(); ++it)
         {
-            splitTokensBySingleOperator(result, operatorName);
+            if (it->type == TokenType::EXPRESSION && automaton_.findAll(it->value, operators))
+            {
+                splitSingleTokenByOperators(result, it, operators);
+            }
         }
+        return result;
+    }
+
+    for (const auto& pair : operatorsByLength_)
+    {
+        splitTokensByOperatorsOfLength(result, pair.first);
     }
 
     return result;
 }
 
-void s2e2::Tokenizer::splitTokensBySingleOperator(std::list<Token>& tokens, const std::string& operatorName) const
+void s2e2::Tokenizer::splitSingleTokenByOperators(std::list<Token>& tokens,
+                                                  std::list<Token>::iterator& tokenIterator,
+                                                  const std::vector<bool>& operators) const
+{
+    std::list<Token> parts;
+    parts.splice(parts.end(), tokens, tokenIterator++);
+
+    for (const auto& pair : operatorsByLength_)
+    {
+        const auto found = std::any_of(pair.second.begin(), pair.second.end(), [&operators](SymbolId operatorSymbol)
+        {
+            return operators[operatorSymbol];
+        });
+        if (found)
+        {
+            splitTokensByOperatorsOfLength(parts, pair.first);
+        }
+    }
+
+    tokens.splice(tokenIterator, parts);
+    --tokenIterator;
+}
+
+void s2e2::Tokenizer::splitTokensByOperatorsOfLength(std::list<Token>& tokens, size_t length) const
 {
     for (auto it = tokens.begin(); it != tokens.end(); ++it)
     {
@@ -342,59 +550,62 @@ void s2e2::Tokenizer::splitTokensBySingleOperator(std::list<Token>& tokens, cons
         {
             continue;
         }
-        splitSingleTokenBySingleOperator(tokens, it, operatorName);
+        splitSingleTokenByOperatorsOfLength(tokens, it, length);
     }
 }
 
-void s2e2::Tokenizer::splitSingleTokenBySingleOperator(std::list<Token>& tokens,
-                                                       std::list<Token>::iterator& tokenIterator,
-                                                       const std::string& operatorName) const
+void s2e2::Tokenizer::splitSingleTokenByOperatorsOfLength(std::list<Token>& tokens,
+                                                          std::list<Token>::iterator& tokenIterator,
+                                                          size_t length) const
 {
     std::list<Token> newTokens;
     const auto& token = tokenIterator->value;
+    const auto tokenPosition = tokenIterator->position;
     size_t start = 0;
 
-    while (start < token.size())
+    // operators of the same length can not start at the same position, so overlapping ones are resolved
+    // by taking the leftmost one
+    for (size_t end = 0; end + length <= token.size();)
     {
-        const size_t end = token.find(operatorName, start);
-        if (end == std::string::npos)
+        const auto operatorSymbol = operatorAt(token, end, length);
+        if (operatorSymbol == NO_SYMBOL)
         {
-            if (!newTokens.empty())
-            {
-                auto newTokenValue = token.substr(start);
-                newTokens.emplace_back(tokenTypeByValue(newTokenValue), std::move(newTokenValue));
-            }
-            break;
+            ++end;
+            continue;
         }
 
         if (end != start)
         {
-            auto newTokenValue = token.substr(start, end - start);
-            newTokens.emplace_back(tokenTypeByValue(newTokenValue), std::move(newTokenValue));
+            addTokenOfValue(newTokens, symbols_, token.substr(start, end - start), tokenPosition + start);
         }
 
-        auto newTokenValue = operatorName;
-        newTokens.emplace_back(TokenType::OPERATOR, std::move(newTokenValue));
-        start = end + operatorName.size();
+        newTokens.emplace_back(TokenType::OPERATOR, symbols_[operatorSymbol].name, 0, tokenPosition + end,
+                               operatorSymbol, symbols_[operatorSymbol].priority);
+        end += length;
+        start = end;
     }
 
-    if (!newTokens.empty())
+    if (newTokens.empty())
+    {
+        return;
+    }
+    if (start < token.size())
     {
-        tokenIterator = tokens.erase(tokenIterator);
-        tokens.splice(tokenIterator, newTokens);
-        --tokenIterator;
+        addTokenOfValue(newTokens, symbols_, token.substr(start), tokenPosition + start);
     }
+
+    tokenIterator = tokens.erase(tokenIterator);
+    tokens.splice(tokenIterator, newTokens);
+    --tokenIterator;
 }
 
-s2e2::TokenType s2e2::Tokenizer::tokenTypeByValue(const std::string& value) const
+s2e2::SymbolId s2e2::Tokenizer::operatorAt(std::string_view token, size_t position, size_t length) const
 {
-    if (operators_.count(value))
+    if (operatorsByFirstSymbol_[static_cast<unsigned char>(token[position])].empty())
     {
-        return TokenType::OPERATOR;
+        return NO_SYMBOL;
     }
-    if (functions_.count(value))
-    {
-        return TokenType::FUNCTION;
-    }
-    return TokenType::EXPRESSION;
+
+    const auto symbol = symbols_.find(token.substr(position, length));
+    return (symbol != NO_SYMBOL && symbols_[symbol].type == TokenType::OPERATOR) ? symbol : NO_SYMBOL;
 }
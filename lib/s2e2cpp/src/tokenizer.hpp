@@ -1,13 +1,20 @@
 #pragma once
 
+#include "char_scanner.hpp"
 #include "interface_tokenizer.hpp"
+#include "operator_automaton.hpp"
+#include "symbol_table.hpp"
 #include "token_type.hpp"
 #include "token.hpp"
 
-#include <functional>
+#include <array>
+#include <cstdint>
 #include <list>
 #include <map>
-#include <unordered_set>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 
 namespace s2e2
@@ -15,23 +22,42 @@ namespace s2e2
     /**
      * @class Tokenizer
      * @brief Class splits plain string expressions into list of tokens.
+     * @details Names of functions and operators are interned, their tokens carry ids and priorities of the symbols.
+     *          Operators glued to their operands are split off longer ones first, of overlapping operators
+     *          of the same length the leftmost one is taken, e.g. A<==B is split into A, <= and =B.
+     *          A frozen tokenizer looks names up by a perfect hash and finds operators by an automaton,
+     *          producing the same tokens.
      */
     class Tokenizer final : public ITokenizer
     {
     public:
+        /**
+         * @brief Make a copy knowing the same names under the same ids.
+         * @returns Copy of the tokenizer.
+         */
+        std::unique_ptr<ITokenizer> clone() const override;
+
         /**
          * @brief Add function expected within expression.
          * @param[in] functionName - Function's name.
-         * @throws Error if functions's name is not unique.
+         * @returns Id of the symbol.
+         * @throws Error if functions's name is not unique or the tokenizer is frozen.
          */
-        void addFunction(const std::string& functionName) override;
+        SymbolId addFunction(const std::string& functionName) override;
 
         /**
          * @brief Add operator expected within expression.
          * @param[in] operatorName - Operator's name.
-         * @throws Error if operator's name is not unique.
+         * @param[in] priority - Operator's priority.
+         * @returns Id of the symbol.
+         * @throws Error if operator's name is not unique or the tokenizer is frozen.
          */
-        void addOperator(const std::string& operatorName) override;
+        SymbolId addOperator(const std::string& operatorName, const uint_fast16_t priority) override;
+
+        /**
+         * @brief Build the perfect hash of names and the automaton of operators, no more can be added after that.
+         */
+        void freeze() override;
 
         /**
          * @brief Split expression into tokens.
@@ -41,14 +67,46 @@ namespace s2e2
          */
         std::list<Token> tokenize(const std::string& expression) const override;
 
+        /**
+         * @brief Split expression into tokens without throwing.
+         * @param[in] expression - Input expression.
+         * @param[out] tokens - List of tokens.
+         * @param[out] status - Error if expression contains unknown symbol.
+         * @returns true in case of success.
+         */
+        bool tryTokenize(const std::string& expression, std::list<Token>& tokens, Status& status) const override;
+
+        /**
+         * @brief Check without building any tokens if the expression is just a string literal.
+         * @details The expression is a literal if it has no quotes, commas, brackets and operators,
+         *          and none of its blank separated words is a function or a variable.
+         * @param[in] expression - Input expression.
+         * @param[in] variables - Names of variables.
+         * @param[out] numberOfTokens - Number of words of a literal expression.
+         * @returns true if the expression is a string literal.
+         */
+        bool isLiteral(std::string_view expression,
+                       const std::vector<std::string>& variables,
+                       size_t& numberOfTokens) const override;
+
     private:
         /**
-         * @brief Check is function's or operator's name is unique.
+         * @brief Check is function's or operator's name is unique and can be added.
          * @param[in] entityName - Function's or operator's name.
-         * @throws Error if the name is not unique.
+         * @throws Error if the name is not unique or the tokenizer is frozen.
          */
         void checkUniqueness(const std::string& entityName) const;
 
+        /**
+         * @brief Split one token by the given operators in the order of operatorsByLength_.
+         * @param[in, out] tokens - List of all tokens.
+         * @param[in, out] tokenIterator - Iterator pointing to the current token, then to the last part of it.
+         * @param[in] operators - Flags of operators to split by, by symbol id.
+         */
+        void splitSingleTokenByOperators(std::list<Token>& tokens,
+                                         std::list<Token>::iterator& tokenIterator,
+                                         const std::vector<bool>& operators) const;
+
         /**
          * @brief Split all tokens by all expected operatos.
          * @details This is required since there can be no spaces between operator and its operands.
@@ -58,38 +116,60 @@ namespace s2e2
         std::list<Token> splitTokensByOperators(const std::list<Token>& tokens) const;
 
         /**
-         * @brief Split all tokens by one operator.
+         * @brief Split all tokens by all operators of one length.
          * @param[in, out] tokens - List of tokens.
-         * @param[in] operatorName - Operator to split tokens by.
+         * @param[in] length - Length of operators to split tokens by.
          */
-        void splitTokensBySingleOperator(std::list<Token>& tokens, const std::string& operatorName) const;
+        void splitTokensByOperatorsOfLength(std::list<Token>& tokens, size_t length) const;
 
         /**
-         * @brief Split one token by one operator.
+         * @brief Split one token by all operators of one length, of overlapping operators the leftmost one is taken.
          * @param[in, out] tokens - List of all tokens.
          * @param[in, out] tokenIterator - Iterator pointing to the current token.
-         * @param[in] operatorName  - Operator to split token by.
+         * @param[in] length - Length of operators to split token by.
+         */
+        void splitSingleTokenByOperatorsOfLength(std::list<Token>& tokens,
+                                                 std::list<Token>::iterator& tokenIterator,
+                                                 size_t length) const;
+
+        /**
+         * @brief Find the operator of the given length starting at the position of the token.
+         * @param[in] token - Value of the token.
+         * @param[in] position - Position in the token, at least length symbols before its end.
+         * @param[in] length - Length of the operator.
+         * @returns Id of the operator or NO_SYMBOL if there is none.
          */
-        void splitSingleTokenBySingleOperator(std::list<Token>& tokens,
-                                              std::list<Token>::iterator& tokenIterator,
-                                              const std::string& operatorName) const;
+        SymbolId operatorAt(std::string_view token, size_t position, size_t length) const;
 
         /**
-         * @brief Get token type by its value.
-         * @param[in] value - Token's value.
-         * @returns Token's type.
+         * @brief Check if the word of an expression without special symbols makes a single atom.
+         * @param[in] word - Not empty word.
+         * @param[in] variables - Names of variables.
+         * @returns true if the word contains no operator and is neither a function nor a variable.
          */
-        TokenType tokenTypeByValue(const std::string& value) const;
+        bool isAtom(std::string_view word, const std::vector<std::string>& variables) const;
 
     private:
-        /// @brief Set of expected functions.
-        std::unordered_set<std::string> functions_;
+        /// @brief Interned names of expected functions and operators.
+        SymbolTable symbols_;
+
+        /// @brief Operators sorted by their lengthes (for instance: 1 -> !, +; 2 -> ||, &&), longer ones split first
+        std::map<size_t, std::vector<SymbolId>, std::greater<size_t>> operatorsByLength_;
+
+        /// @brief Operators by their first symbols.
+        std::array<std::vector<std::string>, 256> operatorsByFirstSymbol_;
+
+        /// @brief Flags of symbols functions' names start with.
+        std::array<bool, 256> functionFirstSymbols_{};
+
+        /// @brief Scanner of special symbols.
+        const CharScanner scanner_;
 
-        /// @brief Set of expected operators.
-        std::unordered_set<std::string> operators_;
+        /// @brief Automaton of all operators, built when the tokenizer is frozen.
+        OperatorAutomaton automaton_;
 
-        /// @brief Operators sorted by their lengthes (for instance: 1 -> !, +; 2 -> ||, &&)
-        std::map<size_t, std::unordered_set<std::string>, std::greater<size_t>> operatorsByLength_;
+        /// @brief Are functions and operators frozen.
+        bool frozen_ = false;
     };
 
 } // namespace s2e2
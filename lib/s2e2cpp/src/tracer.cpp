@@ -0,0 +1,26 @@
+#include "tracer_impl.hpp"
+
+#include <s2e2/tracer.hpp>
+
+
+s2e2::Tracer::Tracer(double samplingRate)
+    : impl_{std::make_shared<TracerImpl>(samplingRate)}
+{
+}
+
+s2e2::Tracer::~Tracer() = default;
+
+double s2e2::Tracer::samplingRate() const
+{
+    return impl_->samplingRate();
+}
+
+void s2e2::Tracer::writeChromeTrace(std::ostream& stream) const
+{
+    impl_->writeChromeTrace(stream);
+}
+
+void s2e2::Tracer::clear()
+{
+    impl_->clear();
+}
@@ -0,0 +1,170 @@
+#include "tracer_impl.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+
+namespace // anonymous
+{
+    /// @brief Source of unique tracers' identifiers.
+    std::atomic<uint64_t> lastTracerId{0};
+
+    /**
+     * @brief Write string as a JSON string literal.
+     * @param[out] stream - Output stream.
+     * @param[in] str - String to write.
+     */
+    void writeJsonString(std::ostream& stream, const std::string& str)
+    {
+        stream << '"';
+        for (const char symbol : str)
+        {
+            switch (symbol)
+            {
+            case '"':
+                stream << "\\\"";
+                break;
+
+            case '\\':
+                stream << "\\\\";
+                break;
+
+            default:
+                if (static_cast<unsigned char>(symbol) < 0x20)
+                {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                           << static_cast<int>(symbol) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    stream << symbol;
+                }
+                break;
+            }
+        }
+        stream << '"';
+    }
+
+    /**
+     * @brief Write nanoseconds timestamp as microseconds (Chrome trace time unit).
+     * @param[out] stream - Output stream.
+     * @param[in] ns - Timestamp in nanoseconds.
+     */
+    void writeMicroseconds(std::ostream& stream, uint64_t ns)
+    {
+        stream << (ns / 1000) << '.' << std::setw(3) << std::setfill('0') << (ns % 1000) << std::setfill(' ');
+    }
+
+} // namespace anonymous
+
+
+s2e2::TracerImpl::TracerImpl(double samplingRate)
+    : id_{++lastTracerId}
+    , samplingRate_{samplingRate}
+    , origin_{std::chrono::steady_clock::now()}
+{
+    if (!(samplingRate >= 0.0 && samplingRate <= 1.0))
+    {
+        throw std::invalid_argument("Tracer: sampling rate must be within [0, 1]");
+    }
+}
+
+double s2e2::TracerImpl::samplingRate() const
+{
+    return samplingRate_;
+}
+
+bool s2e2::TracerImpl::sample()
+{
+    if (samplingRate_ <= 0.0)
+    {
+        return false;
+    }
+
+    // the first n evaluations of a thread trace exactly ceil(n * rate) of them, whatever the rate is
+    auto& buffer = threadBuffer();
+    const auto due = static_cast<uint64_t>(std::ceil(static_cast<double>(++buffer.evaluations) * samplingRate_));
+    if (buffer.samples >= due)
+    {
+        return false;
+    }
+    ++buffer.samples;
+    return true;
+}
+
+uint64_t s2e2::TracerImpl::now() const
+{
+    const auto elapsed = std::chrono::steady_clock::now() - origin_;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void s2e2::TracerImpl::addSpan(const std::string& name, uint64_t begin, uint64_t end)
+{
+    threadBuffer().spans.push_back(Span{name, begin, end});
+}
+
+void s2e2::TracerImpl::writeChromeTrace(std::ostream& stream) const
+{
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& buffer : buffers_)
+    {
+        for (const auto& span : buffer->spans)
+        {
+            stream << (first ? "" : ",") << "\n{\"name\":";
+            writeJsonString(stream, span.name);
+            stream << ",\"cat\":\"s2e2\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":";
+            writeMicroseconds(stream, span.begin);
+            stream << ",\"dur\":";
+            writeMicroseconds(stream, span.end - span.begin);
+            stream << '}';
+            first = false;
+        }
+    }
+
+    stream << "\n]}\n";
+}
+
+void s2e2::TracerImpl::clear()
+{
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+
+    for (auto& buffer : buffers_)
+    {
+        buffer->spans.clear();
+        buffer->evaluations = 0;
+        buffer->samples = 0;
+    }
+}
+
+s2e2::TracerImpl::ThreadBuffer& s2e2::TracerImpl::threadBuffer()
+{
+    // A thread caches the buffer of the last tracer it used only, keyed by tracer's id rather than its address,
+    // so a destroyed tracer never aliases a new one and leaves nothing behind in threads.
+    thread_local uint64_t cachedId = 0;
+    thread_local ThreadBuffer* cachedBuffer = nullptr;
+
+    if (cachedId == id_)
+    {
+        return *cachedBuffer;
+    }
+
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+
+    auto& buffer = threadBuffers_[std::this_thread::get_id()];
+    if (!buffer)
+    {
+        const auto threadId = static_cast<uint32_t>(buffers_.size() + 1);
+        buffers_.push_back(std::make_unique<ThreadBuffer>(ThreadBuffer{threadId, 0, 0, {}}));
+        buffer = buffers_.back().get();
+    }
+
+    cachedId = id_;
+    cachedBuffer = buffer;
+    return *buffer;
+}
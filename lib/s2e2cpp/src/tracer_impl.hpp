@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class TracerImpl
+     * @brief Real implementation of Tracer class.
+     */
+    class TracerImpl final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] samplingRate - Share of evaluations to trace, from 0 (none) to 1 (all).
+         * @throws std::invalid_argument if sampling rate is out of range.
+         */
+        explicit TracerImpl(double samplingRate);
+
+        /**
+         * @brief Get share of traced evaluations.
+         * @returns Sampling rate.
+         */
+        double samplingRate() const;
+
+        /**
+         * @brief Decide if the next evaluation in the current thread should be traced.
+         * @returns true if evaluation should be traced, false otherwise.
+         */
+        bool sample();
+
+        /**
+         * @brief Get current timestamp.
+         * @returns Nanoseconds since the tracer was created.
+         */
+        uint64_t now() const;
+
+        /**
+         * @brief Record one finished span in the buffer of the current thread.
+         * @param[in] name - Span's name.
+         * @param[in] begin - Timestamp of span's beginning.
+         * @param[in] end - Timestamp of span's end.
+         */
+        void addSpan(const std::string& name, uint64_t begin, uint64_t end);
+
+        /**
+         * @brief Write all recorded spans as Chrome trace-event JSON.
+         * @param[out] stream - Output stream.
+         */
+        void writeChromeTrace(std::ostream& stream) const;
+
+        /**
+         * @brief Drop all recorded spans.
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief Single recorded span.
+         */
+        struct Span
+        {
+            /// @brief Span's name.
+            std::string name;
+
+            /// @brief Timestamp of span's beginning.
+            uint64_t begin;
+
+            /// @brief Timestamp of span's end.
+            uint64_t end;
+        };
+
+        /**
+         * @brief Spans recorded by one thread. Only the owning thread appends to it.
+         */
+        struct ThreadBuffer
+        {
+            /// @brief Sequential number of the thread within the tracer.
+            uint32_t threadId;
+
+            /// @brief Number of evaluations seen by the thread.
+            uint64_t evaluations;
+
+            /// @brief Number of evaluations traced by the thread.
+            uint64_t samples;
+
+            /// @brief Recorded spans.
+            std::vector<Span> spans;
+        };
+
+        /**
+         * @brief Get buffer of the current thread, create it on the first call.
+         * @returns Buffer of the current thread.
+         */
+        ThreadBuffer& threadBuffer();
+
+    private:
+        /// @brief Unique identifier of the tracer, used as a key of the thread local buffer cache.
+        const uint64_t id_;
+
+        /// @brief Share of traced evaluations.
+        const double samplingRate_;
+
+        /// @brief Time point all timestamps are counted from.
+        const std::chrono::steady_clock::time_point origin_;
+
+        /// @brief Guards list of buffers (taken once per thread, not on recording).
+        mutable std::mutex buffersMutex_;
+
+        /// @brief Buffers of all threads which have ever used the tracer.
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+        /// @brief Buffers by their threads, looked up when a thread switches from another tracer.
+        ///        A thread started after another one has finished may get its identifier and so its buffer.
+        std::unordered_map<std::thread::id, ThreadBuffer*> threadBuffers_;
+    };
+
+    /**
+     * @class TraceSpan
+     * @brief Scoped span: records time between its construction and destruction.
+     */
+    class TraceSpan final
+    {
+    public:
+        /**
+         * @brief Start the span.
+         * @param[in] tracer - Tracer to record the span into, can be null.
+         * @param[in] name - Span's name. Must outlive the span.
+         */
+        TraceSpan(TracerImpl* tracer, const std::string& name)
+            : tracer_{tracer}
+            , name_{name}
+            , begin_{tracer ? tracer->now() : 0}
+        {
+        }
+
+        /**
+         * @brief Finish the span.
+         */
+        ~TraceSpan()
+        {
+            if (tracer_)
+            {
+                tracer_->addSpan(name_, begin_, tracer_->now());
+            }
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        /// @brief Tracer to record the span into.
+        TracerImpl* const tracer_;
+
+        /// @brief Span's name.
+        const std::string& name_;
+
+        /// @brief Timestamp of span's beginning.
+        const uint64_t begin_;
+    };
+
+} // namespace s2e2
@@ -4,6 +4,30 @@
 std::time_t s2e2::utcTs(std::tm* tm)
 {
     const auto localTs = mktime(tm);
-    const auto localToUTcDiff = std::mktime(std::localtime(&localTs)) - std::mktime(std::gmtime(&localTs));
+    auto local = localTm(localTs);
+    auto utc = utcTm(localTs);
+    const auto localToUTcDiff = std::mktime(&local) - std::mktime(&utc);
     return localTs + localToUTcDiff;
 }
+
+std::tm s2e2::utcTm(std::time_t ts)
+{
+    std::tm result{};
+#if defined(_WIN32)
+    gmtime_s(&result, &ts);
+#else
+    gmtime_r(&ts, &result);
+#endif
+    return result;
+}
+
+std::tm s2e2::localTm(std::time_t ts)
+{
+    std::tm result{};
+#if defined(_WIN32)
+    localtime_s(&result, &ts);
+#else
+    localtime_r(&ts, &result);
+#endif
+    return result;
+}
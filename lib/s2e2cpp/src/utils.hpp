@@ -12,4 +12,18 @@ namespace s2e2
      */
     std::time_t utcTs(std::tm* tm);
 
+    /**
+     * @brief Convert number of seconds since epoch into UTC datetime, safe to call from several threads.
+     * @param[in] ts - Seconds since epoch.
+     * @returns UTC datetime.
+     */
+    std::tm utcTm(std::time_t ts);
+
+    /**
+     * @brief Convert number of seconds since epoch into local datetime, safe to call from several threads.
+     * @param[in] ts - Seconds since epoch.
+     * @returns Local datetime.
+     */
+    std::tm localTm(std::time_t ts);
+
 } // namespace s2e2
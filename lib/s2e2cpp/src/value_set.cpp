@@ -0,0 +1,58 @@
+#include "value_set.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+
+s2e2::ValueSet::ValueSet(const std::vector<std::optional<std::string>>& values, bool negated, std::string callee)
+    : negated_(negated)
+    , callee_(std::move(callee))
+{
+    for (const auto& value : values)
+    {
+        if (value)
+        {
+            values_.push_back(*value);
+        }
+        else
+        {
+            containsNull_ = true;
+        }
+    }
+
+    std::sort(values_.begin(), values_.end());
+    values_.erase(std::unique(values_.begin(), values_.end()), values_.end());
+}
+
+bool s2e2::ValueSet::test(std::string_view value) const
+{
+    const auto it = std::lower_bound(values_.begin(), values_.end(), value,
+                                     [](const std::string& a, std::string_view b) { return a < b; });
+    return (it != values_.end() && *it == value) != negated_;
+}
+
+bool s2e2::ValueSet::testNull() const
+{
+    return containsNull_ != negated_;
+}
+
+bool s2e2::ValueSet::testMissing() const
+{
+    return negated_;
+}
+
+const std::vector<std::string>& s2e2::ValueSet::values() const
+{
+    return values_;
+}
+
+const std::string& s2e2::ValueSet::callee() const
+{
+    return callee_;
+}
+
+bool s2e2::ValueSet::operator<(const ValueSet& other) const
+{
+    return std::tie(values_, containsNull_, negated_, callee_) <
+           std::tie(other.values_, other.containsNull_, other.negated_, other.callee_);
+}
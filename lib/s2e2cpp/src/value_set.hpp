@@ -0,0 +1,80 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class ValueSet
+     * @brief Constant set of values for membership tests replacing chains of equality comparisons.
+     * @details Values are kept sorted, so a test is one binary search over string views which neither allocates
+     *          nor copies the tested value.
+     */
+    class ValueSet final
+    {
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] values - Values of the set, NULL is allowed, duplicates are ignored.
+         * @param[in] negated - Is a test true for values outside the set rather than inside it.
+         * @param[in] callee - Operator or function the set replaces, e.g. "operator ==", used in error messages.
+         */
+        ValueSet(const std::vector<std::optional<std::string>>& values, bool negated, std::string callee);
+
+        /**
+         * @brief Test the not NULL value.
+         * @param[in] value - Tested value.
+         * @returns true if the value is in the set, inverted for a negated set.
+         */
+        bool test(std::string_view value) const;
+
+        /**
+         * @brief Test NULL value.
+         * @returns true if NULL is in the set, inverted for a negated set.
+         */
+        bool testNull() const;
+
+        /**
+         * @brief Test a not NULL value which is none of the set's values.
+         * @returns false, inverted for a negated set.
+         */
+        bool testMissing() const;
+
+        /**
+         * @brief Get not NULL values of the set.
+         * @returns Sorted distinct values.
+         */
+        const std::vector<std::string>& values() const;
+
+        /**
+         * @brief Get operator or function the set replaces.
+         * @returns Name of the callee.
+         */
+        const std::string& callee() const;
+
+        /**
+         * @brief Strict weak ordering of sets, lets identical sets be found and shared.
+         * @param[in] other - Other set.
+         * @returns true if this set precedes the other one.
+         */
+        bool operator<(const ValueSet& other) const;
+
+    private:
+        /// @brief Sorted distinct not NULL values.
+        std::vector<std::string> values_;
+
+        /// @brief Is NULL in the set.
+        bool containsNull_ = false;
+
+        /// @brief Is a test true for values outside the set.
+        bool negated_ = false;
+
+        /// @brief Operator or function the set replaces.
+        std::string callee_;
+    };
+
+} // namespace s2e2
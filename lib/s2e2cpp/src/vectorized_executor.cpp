@@ -0,0 +1,1035 @@
+#include "vectorized_executor.hpp"
+
+#include <s2e2/error.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <typeinfo>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace // anonymous
+{
+    using Bitmap = s2e2::VectorizedExecutor::Bitmap;
+
+    constexpr size_t WORD_SIZE = s2e2::VectorizedExecutor::WORD_SIZE;
+
+    /**
+     * @brief Outcome of a comparison for some combination of NULL operands.
+     */
+    enum class NullOutcome : uint8_t
+    {
+        FALSE,  ///< The result is false.
+        TRUE,   ///< The result is true.
+        FAIL    ///< Arguments are invalid.
+    };
+
+    /**
+     * @brief Get index of the lowest set bit.
+     * @param[in] word - Not zero word.
+     * @returns Index of the bit.
+     */
+    inline size_t lowestBit(uint64_t word)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward64(&index, word);
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    /**
+     * @brief Check if the bit is set.
+     * @param[in] bitmap - Bitmap.
+     * @param[in] bit - Index of the bit.
+     * @returns true if the bit is set, false otherwise.
+     */
+    inline bool testBit(const Bitmap& bitmap, size_t bit)
+    {
+        return (bitmap[bit / WORD_SIZE] >> (bit % WORD_SIZE)) & 1;
+    }
+
+    /**
+     * @brief Set the bit.
+     * @param[in, out] bitmap - Bitmap.
+     * @param[in] bit - Index of the bit.
+     */
+    inline void setBit(Bitmap& bitmap, size_t bit)
+    {
+        bitmap[bit / WORD_SIZE] |= uint64_t{1} << (bit % WORD_SIZE);
+    }
+
+    /**
+     * @brief Check if no bit is set.
+     * @param[in] bitmap - Bitmap.
+     * @returns true if all bits are clear, false otherwise.
+     */
+    inline bool isEmpty(const Bitmap& bitmap)
+    {
+        uint64_t any = 0;
+        for (const auto word : bitmap)
+        {
+            any |= word;
+        }
+        return any == 0;
+    }
+
+    /**
+     * @brief Call the function for every set bit in ascending order.
+     * @tparam Function - Type of the function.
+     * @param[in] bitmap - Bitmap.
+     * @param[in] function - Function taking index of the bit.
+     */
+    template <class Function>
+    void forEachBit(const Bitmap& bitmap, Function function)
+    {
+        for (size_t word = 0; word < bitmap.size(); ++word)
+        {
+            for (auto bits = bitmap[word]; bits != 0; bits &= bits - 1)
+            {
+                function(word * WORD_SIZE + lowestBit(bits));
+            }
+        }
+    }
+
+    /**
+     * @brief Compare two columns of strings record by record.
+     * @tparam Compare - Type of comparison functor.
+     * @param[in] active - Records to compare.
+     * @param[in] lhsStrings - Left operands.
+     * @param[in] lhsNulls - NULL flags of left operands.
+     * @param[in] rhsStrings - Right operands.
+     * @param[in] rhsNulls - NULL flags of right operands.
+     * @param[in] bothNull - Outcome if both operands are NULL.
+     * @param[in] oneNull - Outcome if only one operand is NULL.
+     * @param[in] compare - Comparison of not NULL operands.
+     * @param[in, out] failed - Failure flags of records.
+     * @param[out] result - Results of comparison.
+     */
+    template <class Compare>
+    void compareStrings(const Bitmap& active,
+                        const std::string_view* lhsStrings,
+                        const Bitmap& lhsNulls,
+                        const std::string_view* rhsStrings,
+                        const Bitmap& rhsNulls,
+                        NullOutcome bothNull,
+                        NullOutcome oneNull,
+                        Compare compare,
+                        Bitmap& failed,
+                        Bitmap& result)
+    {
+        result = {};
+
+        forEachBit(active, [&](size_t i)
+        {
+            const auto nulls = testBit(lhsNulls, i) + testBit(rhsNulls, i);
+            if (nulls == 0)
+            {
+                if (compare(lhsStrings[i], rhsStrings[i]))
+                {
+                    setBit(result, i);
+                }
+                return;
+            }
+
+            const auto outcome = (nulls == 2) ? bothNull : oneNull;
+            if (outcome == NullOutcome::FAIL)
+            {
+                setBit(failed, i);
+            }
+            else if (outcome == NullOutcome::TRUE)
+            {
+                setBit(result, i);
+            }
+        });
+    }
+
+} // namespace anonymous
+
+
+size_t s2e2::VectorizedExecutor::execute(const Program& program,
+                                         const RecordBatch& records,
+                                         size_t first,
+                                         size_t last,
+                                         Span<std::optional<std::string>> results,
+                                         Span<RecordStatus> statuses)
+{
+    context_ = ExecutionContext::current();
+    resolveEncodedEqualities(program, records);
+
+    size_t failures = 0;
+    for (auto begin = first; begin < last; begin += VECTOR_SIZE)
+    {
+        const auto size = std::min(VECTOR_SIZE, last - begin);
+        failures += executeVector(program, records, begin, size, results.data() + begin, statuses.data() + begin);
+    }
+    return failures;
+}
+
+void s2e2::VectorizedExecutor::setMemoryResource(std::pmr::memory_resource* resource)
+{
+    arena_.setUpstream(resource);
+}
+
+void s2e2::VectorizedExecutor::resolveEncodedEqualities(const Program& program, const RecordBatch& records)
+{
+    const auto& instructions = program.instructions;
+    encodedEqualities_.assign(instructions.size(), std::nullopt);
+
+    for (size_t index = 0; index < instructions.size(); ++index)
+    {
+        if (instructions[index].builtin != Builtin::EQUAL && instructions[index].builtin != Builtin::NOT_EQUAL)
+        {
+            continue;
+        }
+
+        // equality is symmetric, so the variable can be on either side
+        const auto* variable = &instructions[index - 1];
+        const auto* constant = &instructions[variable->subtreeStart - 1];
+        if (variable->type != InstructionType::VARIABLE)
+        {
+            std::swap(variable, constant);
+        }
+        if (variable->type != InstructionType::VARIABLE || constant->type != InstructionType::CONSTANT)
+        {
+            continue;
+        }
+
+        const auto dictionary = records.dictionary(variable->index);
+        const auto& value = program.constants[constant->index];
+        if (dictionary.empty() || (value.has_value() && value.type() != typeid(std::string)))
+        {
+            continue;
+        }
+
+        const auto* literal = std::any_cast<std::string>(&value);
+        const auto position = std::find_if(dictionary.begin(), dictionary.end(), [literal](const VariableValue& entry)
+        {
+            return literal ? (entry && *entry == *literal) : !entry;
+        });
+        const auto code = (position == dictionary.end()) ? NO_CODE
+                                                         : static_cast<uint32_t>(position - dictionary.begin());
+
+        encodedEqualities_[index] = EncodedEquality{variable->index, code};
+    }
+}
+
+void s2e2::VectorizedExecutor::compareCodes(const RecordBatch& records,
+                                            size_t first,
+                                            const EncodedEquality& equality,
+                                            Builtin builtin,
+                                            const Bitmap& active)
+{
+    const auto* codes = records.codes(equality.variable).data() + first;
+    const auto inverse = (builtin == Builtin::NOT_EQUAL) ? ~uint64_t{0} : 0;
+
+    auto& column = pushColumn();
+    column.type = ColumnType::BOOL;
+    column.bools = {};
+
+    for (size_t word = 0; word * WORD_SIZE < size_; ++word)
+    {
+        const auto bits = std::min(WORD_SIZE, size_ - word * WORD_SIZE);
+        const auto* wordCodes = codes + word * WORD_SIZE;
+
+        uint64_t matches = 0;
+        for (size_t bit = 0; bit < bits; ++bit)
+        {
+            matches |= uint64_t{wordCodes[bit] == equality.code} << bit;
+        }
+        column.bools[word] = (matches ^ inverse) & active[word];
+    }
+}
+
+size_t s2e2::VectorizedExecutor::executeVector(const Program& program,
+                                               const RecordBatch& records,
+                                               size_t first,
+                                               size_t size,
+                                               std::optional<std::string>* results,
+                                               RecordStatus* statuses)
+{
+    size_ = size;
+    depth_ = 0;
+    arena_.reset();
+    failed_ = {};
+
+    Bitmap all = {};
+    for (size_t word = 0; word * WORD_SIZE < size_; ++word)
+    {
+        const auto bits = std::min(WORD_SIZE, size_ - word * WORD_SIZE);
+        all[word] = (bits == WORD_SIZE) ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    }
+
+    executeProgram(program, records, first, all);
+
+    // the compiler guarantees exactly one column is left
+    const auto& column = columns_[0];
+    static const auto& stringType = typeid(std::string);
+
+    size_t failures = 0;
+    for (size_t i = 0; i < size_; ++i)
+    {
+        auto failed = testBit(failed_, i);
+        if (!failed)
+        {
+            switch (column.type)
+            {
+                case ColumnType::STRING:
+                    results[i] = testBit(column.nulls, i) ? std::optional<std::string>{}
+                                                          : std::string{column.strings[i]};
+                    break;
+
+                case ColumnType::BOOL:
+                    failed = true;
+                    break;
+
+                case ColumnType::ANY:
+                    if (!column.values[i].has_value())
+                    {
+                        results[i].reset();
+                    }
+                    else if (column.values[i].type() == stringType)
+                    {
+                        results[i] = std::any_cast<const std::string&>(column.values[i]);
+                    }
+                    else
+                    {
+                        failed = true;
+                    }
+                    break;
+            }
+        }
+
+        if (failed)
+        {
+            results[i].reset();
+            statuses[i] = RecordStatus::ERROR;
+            ++failures;
+        }
+        else
+        {
+            statuses[i] = RecordStatus::OK;
+        }
+    }
+    return failures;
+}
+
+void s2e2::VectorizedExecutor::executeProgram(const Program& program,
+                                              const RecordBatch& records,
+                                              size_t first,
+                                              const Bitmap& selection)
+{
+    frames_.clear();
+    selections_.assign(1, selection);
+    pushFrame(program.instructions.size() - 1, 0);
+
+    while (!frames_.empty())
+    {
+        step(program, records, first);
+    }
+}
+
+void s2e2::VectorizedExecutor::step(const Program& program, const RecordBatch& records, size_t first)
+{
+    auto& frame = frames_.back();
+    const auto index = frame.index;
+    const auto selection = frame.selection;
+    const auto& instruction = program.instructions[index];
+    const auto isShortCircuit = (instruction.builtin == Builtin::AND || instruction.builtin == Builtin::OR);
+
+    if (frame.step > 0)
+    {
+        if (isShortCircuit)
+        {
+            stepShortCircuit(program);
+        }
+        else if (instruction.builtin == Builtin::IF)
+        {
+            stepIf(program);
+        }
+        else if (instruction.type == InstructionType::MEMBERSHIP)
+        {
+            testMembership(program.sets[instruction.index], activeRecords(selections_[selection]));
+            frames_.pop_back();
+        }
+        else
+        {
+            executeCall(instruction, activeRecords(selections_[selection]));
+            frames_.pop_back();
+        }
+        return;
+    }
+
+    const auto active = activeRecords(selections_[selection]);
+    if (isEmpty(active))
+    {
+        // nobody is going to read values of the column
+        pushColumn().type = ColumnType::STRING;
+        frames_.pop_back();
+        return;
+    }
+    if (context_)
+    {
+        context_->check();
+    }
+
+    switch (instruction.type)
+    {
+        case InstructionType::CONSTANT:
+            pushConstant(program.constants[instruction.index], active);
+            frames_.pop_back();
+            break;
+
+        case InstructionType::VARIABLE:
+            pushVariable(records, first, instruction.index, active);
+            frames_.pop_back();
+            break;
+
+        case InstructionType::OPERATOR:
+        case InstructionType::FUNCTION:
+            if (isShortCircuit)
+            {
+                stepShortCircuit(program);
+            }
+            else if (instruction.builtin == Builtin::IF)
+            {
+                stepIf(program);
+            }
+            else if (encodedEqualities_[index])
+            {
+                compareCodes(records, first, *encodedEqualities_[index], instruction.builtin, active);
+                frames_.pop_back();
+            }
+            else
+            {
+                // arguments are pushed from the last one, so the first one is executed first
+                frame.step = 1;
+                for (auto end = index; end > instruction.subtreeStart; end = program.instructions[end - 1].subtreeStart)
+                {
+                    pushFrame(end - 1, selection);
+                }
+            }
+            break;
+
+        case InstructionType::MEMBERSHIP:
+            frame.step = 1;
+            pushFrame(index - 1, selection);
+            break;
+    }
+}
+
+void s2e2::VectorizedExecutor::stepShortCircuit(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto rightOperand = frame.index - 1;
+    const auto leftOperand = program.instructions[rightOperand].subtreeStart - 1;
+    const auto isAnd = (program.instructions[frame.index].builtin == Builtin::AND);
+    const auto selection = frame.selection;
+
+    switch (frame.step++)
+    {
+        case 0:
+            pushFrame(leftOperand, selection);
+            break;
+
+        case 1:
+        {
+            auto& lhs = columns_[depth_ - 1];
+            requireBool(lhs, activeRecords(selections_[selection]));
+
+            // the right operand is needed only where the left one is true for && and false for ||
+            const auto active = activeRecords(selections_[selection]);
+            Bitmap undecided;
+            for (size_t word = 0; word < undecided.size(); ++word)
+            {
+                undecided[word] = active[word] & (isAnd ? lhs.bools[word] : ~lhs.bools[word]);
+            }
+
+            frame.operandSelections = static_cast<uint32_t>(selections_.size());
+            selections_.push_back(undecided);
+            pushFrame(rightOperand, selections_.size() - 1);
+            break;
+        }
+
+        default:
+        {
+            const auto undecided = selections_[frame.operandSelections];
+            auto& lhs = columns_[depth_ - 2];
+            auto& rhs = columns_[depth_ - 1];
+            requireBool(rhs, activeRecords(undecided));
+
+            for (size_t word = 0; word < undecided.size(); ++word)
+            {
+                lhs.bools[word] = (lhs.bools[word] & ~undecided[word]) | (rhs.bools[word] & undecided[word]);
+            }
+
+            --depth_;
+            selections_.pop_back();
+            frames_.pop_back();
+            break;
+        }
+    }
+}
+
+void s2e2::VectorizedExecutor::stepIf(const Program& program)
+{
+    auto& frame = frames_.back();
+    const auto whenFalseBranch = frame.index - 1;
+    const auto whenTrueBranch = program.instructions[whenFalseBranch].subtreeStart - 1;
+    const auto condition = program.instructions[whenTrueBranch].subtreeStart - 1;
+    const auto selection = frame.selection;
+    const auto operandSelections = frame.operandSelections;
+
+    switch (frame.step++)
+    {
+        case 0:
+            pushFrame(condition, selection);
+            break;
+
+        case 1:
+        {
+            auto& column = columns_[depth_ - 1];
+            requireBool(column, activeRecords(selections_[selection]));
+
+            const auto active = activeRecords(selections_[selection]);
+            Bitmap whenTrue;
+            Bitmap whenFalse;
+            for (size_t word = 0; word < active.size(); ++word)
+            {
+                whenTrue[word] = active[word] & column.bools[word];
+                whenFalse[word] = active[word] & ~column.bools[word];
+            }
+
+            frame.operandSelections = static_cast<uint32_t>(selections_.size());
+            selections_.push_back(whenTrue);
+            selections_.push_back(whenFalse);
+            pushFrame(whenTrueBranch, selections_.size() - 2);
+            break;
+        }
+
+        case 2:
+            pushFrame(whenFalseBranch, operandSelections + 1);
+            break;
+
+        default:
+        {
+            const auto whenTrue = activeRecords(selections_[operandSelections]);
+            const auto whenFalse = activeRecords(selections_[operandSelections + 1]);
+            merge(whenTrue, whenFalse);
+
+            selections_.resize(operandSelections);
+            frames_.pop_back();
+            break;
+        }
+    }
+}
+
+void s2e2::VectorizedExecutor::pushFrame(size_t index, size_t selection)
+{
+    frames_.push_back(Frame{static_cast<uint32_t>(index), 0, static_cast<uint32_t>(selection), 0});
+}
+
+s2e2::VectorizedExecutor::Bitmap s2e2::VectorizedExecutor::activeRecords(const Bitmap& selection) const
+{
+    Bitmap active;
+    for (size_t word = 0; word < active.size(); ++word)
+    {
+        active[word] = selection[word] & ~failed_[word];
+    }
+    return active;
+}
+
+s2e2::VectorizedExecutor::Column& s2e2::VectorizedExecutor::pushColumn()
+{
+    if (depth_ == columns_.size())
+    {
+        auto& column = columns_.emplace_back();
+        column.strings.resize(VECTOR_SIZE);
+        column.values.resize(VECTOR_SIZE);
+    }
+    return columns_[depth_++];
+}
+
+void s2e2::VectorizedExecutor::pushConstant(const std::any& value, const Bitmap& active)
+{
+    auto& column = pushColumn();
+
+    if (!value.has_value())
+    {
+        column.type = ColumnType::STRING;
+        column.nulls.fill(~uint64_t{0});
+    }
+    else if (value.type() == typeid(std::string))
+    {
+        column.type = ColumnType::STRING;
+        std::fill_n(column.strings.begin(), size_, std::string_view{std::any_cast<const std::string&>(value)});
+        column.nulls.fill(0);
+    }
+    else
+    {
+        column.type = ColumnType::ANY;
+        forEachBit(active, [&](size_t i) { column.values[i] = value; });
+    }
+}
+
+void s2e2::VectorizedExecutor::pushVariable(const RecordBatch& records,
+                                            size_t first,
+                                            uint32_t variable,
+                                            const Bitmap& active)
+{
+    auto& column = pushColumn();
+    column.type = ColumnType::STRING;
+    column.nulls = {};
+
+    forEachBit(active, [&](size_t i)
+    {
+        const auto& value = records.value(first + i, variable);
+        if (value)
+        {
+            column.strings[i] = *value;
+        }
+        else
+        {
+            setBit(column.nulls, i);
+        }
+    });
+}
+
+void s2e2::VectorizedExecutor::executeCall(const Instruction& instruction, const Bitmap& active)
+{
+    const auto typeOf = [this](size_t fromTop) { return columns_[depth_ - fromTop].type; };
+
+    switch (instruction.builtin)
+    {
+        case Builtin::EQUAL:
+        case Builtin::NOT_EQUAL:
+        case Builtin::LESS:
+        case Builtin::LESS_OR_EQUAL:
+        case Builtin::GREATER:
+        case Builtin::GREATER_OR_EQUAL:
+        case Builtin::PLUS:
+            if (typeOf(1) == ColumnType::ANY || typeOf(2) == ColumnType::ANY)
+            {
+                invokeGeneric(instruction, active);
+            }
+            else if (typeOf(1) != ColumnType::STRING || typeOf(2) != ColumnType::STRING)
+            {
+                failCall(2, active);
+            }
+            else if (instruction.builtin == Builtin::PLUS)
+            {
+                concatenate(2, active);
+            }
+            else
+            {
+                compare(instruction.builtin, active);
+            }
+            break;
+
+        case Builtin::NOT:
+            requireBool(columns_[depth_ - 1], active);
+            negate();
+            break;
+
+        case Builtin::CONCAT:
+        {
+            const auto numberOfArguments = instruction.numberOfArguments;
+            const auto first = columns_.begin() + static_cast<std::ptrdiff_t>(depth_ - numberOfArguments);
+            const auto last = columns_.begin() + static_cast<std::ptrdiff_t>(depth_);
+            if (std::any_of(first, last, [](const Column& column) { return column.type == ColumnType::ANY; }))
+            {
+                invokeGeneric(instruction, active);
+            }
+            else if (std::any_of(first, last, [](const Column& column) { return column.type != ColumnType::STRING; }))
+            {
+                failCall(numberOfArguments, active);
+            }
+            else
+            {
+                concatenate(numberOfArguments, active);
+            }
+            break;
+        }
+
+        // && , || and IF are executed lazily by executeSubtree()
+        case Builtin::AND:
+        case Builtin::OR:
+        case Builtin::IF:
+        case Builtin::IN:
+        case Builtin::NONE:
+            invokeGeneric(instruction, active);
+            break;
+    }
+}
+
+void s2e2::VectorizedExecutor::compare(Builtin builtin, const Bitmap& active)
+{
+    auto& lhs = columns_[depth_ - 2];
+    const auto& rhs = columns_[depth_ - 1];
+
+    const auto* lhsStrings = lhs.strings.data();
+    const auto* rhsStrings = rhs.strings.data();
+    Bitmap result;
+
+    switch (builtin)
+    {
+        case Builtin::EQUAL:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::TRUE, NullOutcome::FALSE,
+                           [](std::string_view a, std::string_view b) { return a == b; }, failed_, result);
+            break;
+
+        case Builtin::NOT_EQUAL:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::FALSE, NullOutcome::TRUE,
+                           [](std::string_view a, std::string_view b) { return a != b; }, failed_, result);
+            break;
+
+        case Builtin::LESS:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::FAIL, NullOutcome::FAIL,
+                           [](std::string_view a, std::string_view b) { return a < b; }, failed_, result);
+            break;
+
+        case Builtin::LESS_OR_EQUAL:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::TRUE, NullOutcome::FAIL,
+                           [](std::string_view a, std::string_view b) { return a <= b; }, failed_, result);
+            break;
+
+        case Builtin::GREATER:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::FAIL, NullOutcome::FAIL,
+                           [](std::string_view a, std::string_view b) { return a > b; }, failed_, result);
+            break;
+
+        case Builtin::GREATER_OR_EQUAL:
+            compareStrings(active, lhsStrings, lhs.nulls, rhsStrings, rhs.nulls, NullOutcome::TRUE, NullOutcome::FAIL,
+                           [](std::string_view a, std::string_view b) { return a >= b; }, failed_, result);
+            break;
+
+        default:
+            break;
+    }
+
+    lhs.bools = result;
+    lhs.type = ColumnType::BOOL;
+    --depth_;
+}
+
+void s2e2::VectorizedExecutor::negate()
+{
+    auto& column = columns_[depth_ - 1];
+
+    for (auto& word : column.bools)
+    {
+        word = ~word;
+    }
+}
+
+void s2e2::VectorizedExecutor::concatenate(size_t numberOfArguments, const Bitmap& active)
+{
+    const auto firstArgument = depth_ - numberOfArguments;
+    auto& result = columns_[firstArgument];
+
+    forEachBit(active, [&](size_t i)
+    {
+        // sizes only grow, so the result fits if and only if every partial concatenation of a chain of + fits
+        size_t size = 0;
+        size_t nonNull = 0;
+        auto single = firstArgument;
+        for (auto argument = firstArgument; argument < depth_; ++argument)
+        {
+            if (!testBit(columns_[argument].nulls, i))
+            {
+                size += columns_[argument].strings[i].size();
+                single = argument;
+                ++nonNull;
+            }
+        }
+
+        if (nonNull == 0)
+        {
+            return;
+        }
+        if (nonNull == 1)
+        {
+            result.strings[i] = columns_[single].strings[i];
+            result.nulls[i / WORD_SIZE] &= ~(uint64_t{1} << (i % WORD_SIZE));
+            return;
+        }
+        if (context_ && !context_->fits(size))
+        {
+            setBit(failed_, i);
+            return;
+        }
+
+        auto* data = static_cast<char*>(arena_.allocate(size, 1));
+        size_t offset = 0;
+        for (auto argument = firstArgument; argument < depth_; ++argument)
+        {
+            if (!testBit(columns_[argument].nulls, i))
+            {
+                const auto string = columns_[argument].strings[i];
+                std::memcpy(data + offset, string.data(), string.size());
+                offset += string.size();
+            }
+        }
+        result.strings[i] = std::string_view{data, size};
+        result.nulls[i / WORD_SIZE] &= ~(uint64_t{1} << (i % WORD_SIZE));
+    });
+
+    depth_ = firstArgument + 1;
+}
+
+void s2e2::VectorizedExecutor::merge(const Bitmap& whenTrue, const Bitmap& whenFalse)
+{
+    auto& result = columns_[depth_ - 3];
+    auto& trueBranch = columns_[depth_ - 2];
+    auto& falseBranch = columns_[depth_ - 1];
+    depth_ -= 2;
+
+    if (isEmpty(whenTrue))
+    {
+        std::swap(result, falseBranch);
+    }
+    else if (isEmpty(whenFalse))
+    {
+        std::swap(result, trueBranch);
+    }
+    else if (trueBranch.type == falseBranch.type && trueBranch.type == ColumnType::BOOL)
+    {
+        for (size_t word = 0; word < result.bools.size(); ++word)
+        {
+            result.bools[word] = (trueBranch.bools[word] & whenTrue[word]) | (falseBranch.bools[word] & ~whenTrue[word]);
+        }
+    }
+    else if (trueBranch.type == falseBranch.type && trueBranch.type == ColumnType::STRING)
+    {
+        std::swap(result, trueBranch);
+        forEachBit(whenFalse, [&](size_t i) { result.strings[i] = falseBranch.strings[i]; });
+        for (size_t word = 0; word < result.nulls.size(); ++word)
+        {
+            result.nulls[word] = (result.nulls[word] & ~whenFalse[word]) | (falseBranch.nulls[word] & whenFalse[word]);
+        }
+    }
+    else
+    {
+        forEachBit(whenTrue, [&](size_t i) { result.values[i] = valueOf(trueBranch, i); });
+        forEachBit(whenFalse, [&](size_t i) { result.values[i] = valueOf(falseBranch, i); });
+        result.type = ColumnType::ANY;
+
+        Bitmap active;
+        for (size_t word = 0; word < active.size(); ++word)
+        {
+            active[word] = whenTrue[word] | whenFalse[word];
+        }
+        normalize(result, active);
+    }
+}
+
+void s2e2::VectorizedExecutor::testMembership(const ValueSet& set, const Bitmap& active)
+{
+    auto& column = columns_[depth_ - 1];
+    Bitmap result = {};
+
+    switch (column.type)
+    {
+        case ColumnType::STRING:
+            forEachBit(active, [&](size_t i)
+            {
+                if (testBit(column.nulls, i) ? set.testNull() : set.test(column.strings[i]))
+                {
+                    setBit(result, i);
+                }
+            });
+            break;
+
+        case ColumnType::BOOL:
+            failCall(1, active);
+            return;
+
+        case ColumnType::ANY:
+            forEachBit(active, [&](size_t i)
+            {
+                const auto& value = column.values[i];
+                const auto* string = std::any_cast<std::string>(&value);
+                if (value.has_value() && !string)
+                {
+                    setBit(failed_, i);
+                }
+                else if (string ? set.test(*string) : set.testNull())
+                {
+                    setBit(result, i);
+                }
+            });
+            break;
+    }
+
+    column.bools = result;
+    column.type = ColumnType::BOOL;
+}
+
+void s2e2::VectorizedExecutor::invokeGeneric(const Instruction& instruction, const Bitmap& active)
+{
+    const auto numberOfArguments = instruction.numberOfArguments;
+    const auto firstArgument = depth_ - numberOfArguments;
+
+    results_.resize(VECTOR_SIZE);
+
+    forEachBit(active, [&](size_t i)
+    {
+        for (size_t argument = firstArgument; argument < depth_; ++argument)
+        {
+            stack_.push(valueOf(columns_[argument], i));
+        }
+
+        Status status;
+        try
+        {
+            const auto succeeded = instruction.op ? instruction.op->tryInvoke(stack_, status)
+                                                  : instruction.fn->tryInvoke(stack_, numberOfArguments, status);
+            if (succeeded && (!context_ || context_->tryCheckValue(stack_.top(), status)))
+            {
+                results_[i] = std::move(stack_.top());
+            }
+            else
+            {
+                setBit(failed_, i);
+            }
+        }
+        catch (const AbortedError&)
+        {
+            while (!stack_.empty())
+            {
+                stack_.pop();
+            }
+            throw;
+        }
+        catch (const std::exception&)
+        {
+            setBit(failed_, i);
+        }
+
+        while (!stack_.empty())
+        {
+            stack_.pop();
+        }
+    });
+
+    // functions with no arguments need a new column for their result
+    depth_ = firstArgument;
+    auto& column = pushColumn();
+    column.type = ColumnType::ANY;
+    column.values.swap(results_);
+    normalize(column, activeRecords(active));
+}
+
+void s2e2::VectorizedExecutor::normalize(Column& column, const Bitmap& active)
+{
+    static const auto& stringType = typeid(std::string);
+    static const auto& boolType = typeid(bool);
+
+    bool allStrings = true;
+    bool allBools = true;
+    forEachBit(active, [&](size_t i)
+    {
+        const auto& value = column.values[i];
+        allStrings = allStrings && (!value.has_value() || value.type() == stringType);
+        allBools = allBools && value.has_value() && value.type() == boolType;
+    });
+
+    if (allStrings)
+    {
+        column.nulls = {};
+        forEachBit(active, [&](size_t i)
+        {
+            auto& value = column.values[i];
+            if (value.has_value())
+            {
+                column.strings[i] = arena_.copy(*std::any_cast<std::string>(&value));
+            }
+            else
+            {
+                setBit(column.nulls, i);
+            }
+        });
+        column.type = ColumnType::STRING;
+    }
+    else if (allBools)
+    {
+        column.bools = {};
+        forEachBit(active, [&](size_t i)
+        {
+            if (std::any_cast<bool>(column.values[i]))
+            {
+                setBit(column.bools, i);
+            }
+        });
+        column.type = ColumnType::BOOL;
+    }
+}
+
+void s2e2::VectorizedExecutor::requireBool(Column& column, const Bitmap& active)
+{
+    switch (column.type)
+    {
+        case ColumnType::BOOL:
+            return;
+
+        case ColumnType::STRING:
+            for (size_t word = 0; word < failed_.size(); ++word)
+            {
+                failed_[word] |= active[word];
+            }
+            break;
+
+        case ColumnType::ANY:
+        {
+            Bitmap bools = {};
+            forEachBit(active, [&](size_t i)
+            {
+                const auto* value = std::any_cast<bool>(&column.values[i]);
+                if (!value)
+                {
+                    setBit(failed_, i);
+                }
+                else if (*value)
+                {
+                    setBit(bools, i);
+                }
+            });
+            column.bools = bools;
+            break;
+        }
+    }
+
+    column.type = ColumnType::BOOL;
+}
+
+void s2e2::VectorizedExecutor::failCall(size_t numberOfArguments, const Bitmap& active)
+{
+    depth_ -= numberOfArguments;
+    for (size_t word = 0; word < failed_.size(); ++word)
+    {
+        failed_[word] |= active[word];
+    }
+    pushColumn().type = ColumnType::STRING;
+}
+
+std::any s2e2::VectorizedExecutor::valueOf(const Column& column, size_t record) const
+{
+    switch (column.type)
+    {
+        case ColumnType::STRING:
+            return testBit(column.nulls, record) ? std::any{} : std::any{std::string{column.strings[record]}};
+
+        case ColumnType::BOOL:
+            return std::any{testBit(column.bools, record)};
+
+        case ColumnType::ANY:
+            break;
+    }
+    return column.values[record];
+}
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "arena.hpp"
+#include "execution_context.hpp"
+#include "program.hpp"
+
+#include <s2e2/record_batch.hpp>
+#include <s2e2/span.hpp>
+
+#include <any>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <optional>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class VectorizedExecutor
+     * @brief Executes compiled programs over whole vectors of records at once.
+     * @details Every instruction processes up to VECTOR_SIZE records, so dispatch is paid per vector rather than
+     *          per record. Standard operators, IF and membership tests run as tight loops over columns of string views and booleans,
+     *          all other functions and operators are invoked record by record.
+     *          Booleans, NULL flags and failures are stored as bitmaps, one bit per record. Every subtree is
+     *          executed only for a selection of records: the right operand of && and || only for records the left
+     *          one does not decide, each branch of IF only for records choosing it.
+     *          Results are identical to the ones of record by record execution.
+     *          Limits of the current execution context are checked once per instruction and vector.
+     */
+    class VectorizedExecutor final
+    {
+    public:
+        /// @brief Maximum number of records processed by one instruction.
+        static constexpr size_t VECTOR_SIZE = 1024;
+
+        /// @brief Number of bits in one word of a bitmap.
+        static constexpr size_t WORD_SIZE = 64;
+
+        /// @brief One bit per record of a vector.
+        using Bitmap = std::array<uint64_t, VECTOR_SIZE / WORD_SIZE>;
+
+        /**
+         * @brief Execute the program for a range of records of the batch.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the range.
+         * @param[in] last - Index past the last record of the range.
+         * @param[out] results - Values of expression, one per record of the batch.
+         * @param[out] statuses - Outcomes of evaluation, one per record of the batch.
+         * @returns Number of records of the range which failed to evaluate.
+         */
+        size_t execute(const Program& program,
+                       const RecordBatch& records,
+                       size_t first,
+                       size_t last,
+                       Span<std::optional<std::string>> results,
+                       Span<RecordStatus> statuses);
+
+        /**
+         * @brief Set the resource the arena of intermediate strings takes its memory from.
+         * @param[in] resource - Memory resource, null for the default one.
+         */
+        void setMemoryResource(std::pmr::memory_resource* resource);
+
+    private:
+        /**
+         * @brief Types of column values.
+         */
+        enum class ColumnType : uint8_t
+        {
+            STRING,     ///< String or NULL values.
+            BOOL,       ///< Boolean values.
+            ANY         ///< Values of any type.
+        };
+
+        /**
+         * @brief Intermediate values of one stack slot for all records of the vector.
+         * @details Values are valid only for records selected when the column was pushed.
+         */
+        struct Column
+        {
+            /// @brief Type of values.
+            ColumnType type = ColumnType::STRING;
+
+            /// @brief String values, valid if type is STRING.
+            std::vector<std::string_view> strings;
+
+            /// @brief NULL flags, valid if type is STRING.
+            Bitmap nulls = {};
+
+            /// @brief Boolean values, valid if type is BOOL.
+            Bitmap bools = {};
+
+            /// @brief Values of any type, valid if type is ANY.
+            std::vector<std::any> values;
+        };
+
+        /**
+         * @brief Comparison of a dictionary encoded variable with a constant, resolved once per batch.
+         */
+        struct EncodedEquality
+        {
+            /// @brief Index of the variable.
+            uint32_t variable;
+
+            /// @brief Code of the constant within the variable's dictionary, NO_CODE if it is not there.
+            uint32_t code;
+        };
+
+        /**
+         * @brief Execution of one instruction's subtree in progress.
+         */
+        struct Frame
+        {
+            /// @brief Index of the instruction.
+            uint32_t index = 0;
+
+            /// @brief Number of operands whose execution has already started.
+            uint32_t step = 0;
+
+            /// @brief Index of the selection of records to execute the subtree for.
+            uint32_t selection = 0;
+
+            /// @brief Index of the first selection made by the instruction for its operands.
+            uint32_t operandSelections = 0;
+        };
+
+        /// @brief Code never matching any record.
+        static constexpr uint32_t NO_CODE = UINT32_MAX;
+
+        /**
+         * @brief Find comparisons of dictionary encoded variables with constants and resolve the constants.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         */
+        void resolveEncodedEqualities(const Program& program, const RecordBatch& records);
+
+        /**
+         * @brief Compare codes of the dictionary encoded variable with the code of the constant.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the vector.
+         * @param[in] equality - Resolved comparison.
+         * @param[in] builtin - EQUAL or NOT_EQUAL operator.
+         * @param[in] active - Records to compare values of.
+         */
+        void compareCodes(const RecordBatch& records,
+                          size_t first,
+                          const EncodedEquality& equality,
+                          Builtin builtin,
+                          const Bitmap& active);
+
+        /**
+         * @brief Execute the program for one vector of records.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the vector.
+         * @param[in] size - Number of records of the vector, up to VECTOR_SIZE.
+         * @param[out] results - Values of expression for the vector.
+         * @param[out] statuses - Outcomes of evaluation for the vector.
+         * @returns Number of records which failed to evaluate.
+         */
+        size_t executeVector(const Program& program,
+                             const RecordBatch& records,
+                             size_t first,
+                             size_t size,
+                             std::optional<std::string>* results,
+                             RecordStatus* statuses);
+
+        /**
+         * @brief Execute the whole program and push its values onto the stack.
+         * @details Subtrees are executed with an explicit stack of frames, so the depth of the expression is not
+         *          bounded by the stack of the thread.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the vector.
+         * @param[in] selection - Records to execute the program for.
+         */
+        void executeProgram(const Program& program, const RecordBatch& records, size_t first, const Bitmap& selection);
+
+        /**
+         * @brief Make the next step of the frame on the top: start an operand or finish the instruction.
+         * @param[in] program - Compiled program.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the vector.
+         */
+        void step(const Program& program, const RecordBatch& records, size_t first);
+
+        /**
+         * @brief Make the next step of operator && or ||, the right operand is executed only for records
+         *        the left one does not decide.
+         * @param[in] program - Compiled program.
+         */
+        void stepShortCircuit(const Program& program);
+
+        /**
+         * @brief Make the next step of function IF, each branch is executed only for records choosing it.
+         * @param[in] program - Compiled program.
+         */
+        void stepIf(const Program& program);
+
+        /**
+         * @brief Start execution of the subtree ending with the instruction.
+         * @param[in] index - Index of the last instruction of the subtree.
+         * @param[in] selection - Index of the selection of records to execute the subtree for.
+         */
+        void pushFrame(size_t index, size_t selection);
+
+        /**
+         * @brief Get selected records which have not failed yet.
+         * @param[in] selection - Selected records.
+         * @returns Active records.
+         */
+        Bitmap activeRecords(const Bitmap& selection) const;
+
+        /**
+         * @brief Push new column onto the stack.
+         * @returns Reference to the new column.
+         */
+        Column& pushColumn();
+
+        /**
+         * @brief Push constant value onto the stack.
+         * @param[in] value - Constant value.
+         * @param[in] active - Records to push the value for.
+         */
+        void pushConstant(const std::any& value, const Bitmap& active);
+
+        /**
+         * @brief Push values of the variable onto the stack.
+         * @param[in] records - Values of variables.
+         * @param[in] first - Index of the first record of the vector.
+         * @param[in] variable - Index of the variable.
+         * @param[in] active - Records to push values for.
+         */
+        void pushVariable(const RecordBatch& records, size_t first, uint32_t variable, const Bitmap& active);
+
+        /**
+         * @brief Execute one eager call instruction over the top columns.
+         * @param[in] instruction - Instruction of OPERATOR or FUNCTION type.
+         * @param[in] active - Records to execute the instruction for.
+         */
+        void executeCall(const Instruction& instruction, const Bitmap& active);
+
+        /**
+         * @brief Compare two string columns.
+         * @param[in] builtin - Comparison operator.
+         * @param[in] active - Records to compare values of.
+         */
+        void compare(Builtin builtin, const Bitmap& active);
+
+        /**
+         * @brief Negate the boolean column.
+         */
+        void negate();
+
+        /**
+         * @brief Concatenate string columns on the stack top, failing records whose result exceeds the size limit.
+         * @details NULL values are skipped, the result is NULL only if all values are NULL.
+         * @param[in] numberOfArguments - Number of columns.
+         * @param[in] active - Records to concatenate values of.
+         */
+        void concatenate(size_t numberOfArguments, const Bitmap& active);
+
+        /**
+         * @brief Replace condition and two branches of IF with values of the branches chosen by records.
+         * @param[in] whenTrue - Records executed the first branch.
+         * @param[in] whenFalse - Records executed the second branch.
+         */
+        void merge(const Bitmap& whenTrue, const Bitmap& whenFalse);
+
+        /**
+         * @brief Test values of the top column against the set.
+         * @param[in] set - Constant set.
+         * @param[in] active - Records to test values of.
+         */
+        void testMembership(const ValueSet& set, const Bitmap& active);
+
+        /**
+         * @brief Invoke the operator or function record by record.
+         * @param[in] instruction - Instruction of OPERATOR or FUNCTION type.
+         * @param[in] active - Records to invoke the instruction for.
+         */
+        void invokeGeneric(const Instruction& instruction, const Bitmap& active);
+
+        /**
+         * @brief Turn column of values of any type into a typed one if all values have the same type.
+         * @param[in, out] column - Column.
+         * @param[in] active - Records to check values of.
+         */
+        void normalize(Column& column, const Bitmap& active);
+
+        /**
+         * @brief Turn column into a boolean one, marking records with not boolean values as failed.
+         * @param[in, out] column - Column.
+         * @param[in] active - Records to check values of.
+         */
+        void requireBool(Column& column, const Bitmap& active);
+
+        /**
+         * @brief Pop several columns and mark active records as failed, leaving one column as a result.
+         * @param[in] numberOfArguments - Number of popped arguments.
+         * @param[in] active - Records to mark as failed.
+         */
+        void failCall(size_t numberOfArguments, const Bitmap& active);
+
+        /**
+         * @brief Get value of the column for the record.
+         * @param[in] column - Column.
+         * @param[in] record - Index of the record within the vector.
+         * @returns Value of any type.
+         */
+        std::any valueOf(const Column& column, size_t record) const;
+
+    private:
+        /// @brief Stack of columns, only first depth_ of them are in use. References to them are stable.
+        std::deque<Column> columns_;
+
+        /// @brief Current depth of the stack.
+        size_t depth_ = 0;
+
+        /// @brief Stack of subtrees being executed.
+        std::vector<Frame> frames_;
+
+        /// @brief Selections of records of subtrees being executed, the first one selects the whole vector.
+        std::vector<Bitmap> selections_;
+
+        /// @brief Number of records in the current vector.
+        size_t size_ = 0;
+
+        /// @brief Failure flags of the records of the current vector.
+        Bitmap failed_ = {};
+
+        /// @brief Strings produced while executing the current vector, column views point into it.
+        Arena arena_;
+
+        /// @brief Resolved comparisons of dictionary encoded variables with constants, indexed by instruction.
+        std::vector<std::optional<EncodedEquality>> encodedEqualities_;
+
+        /// @brief Scratch stack for record by record invocations.
+        std::stack<std::any> stack_;
+
+        /// @brief Scratch results of record by record invocations.
+        std::vector<std::any> results_;
+
+        /// @brief Execution context of the current execution, null if it is not limited.
+        ExecutionContext* context_ = nullptr;
+    };
+
+} // namespace s2e2
@@ -0,0 +1,295 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+namespace // anonymous
+{
+    /**
+     * @brief Pin the thread to the CPU.
+     * @details Pinning is a hint: if the CPU is not available to the process the thread is left as it is.
+     * @param[in] thread - Thread.
+     * @param[in] cpu - Index of the CPU.
+     */
+    void pin(std::thread& thread, size_t cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+        static_cast<void>(thread);
+        static_cast<void>(cpu);
+#endif
+    }
+
+    /**
+     * @brief Check if the CPU can be pinned to.
+     * @param[in] cpu - Index of the CPU.
+     * @returns true if the index is supported.
+     */
+    bool isValidCpu(size_t cpu)
+    {
+#if defined(__linux__)
+        return cpu < CPU_SETSIZE;
+#else
+        static_cast<void>(cpu);
+        return true;
+#endif
+    }
+
+} // namespace anonymous
+
+
+thread_local s2e2::WorkStealingPool::Run* s2e2::WorkStealingPool::currentRun_ = nullptr;
+
+
+s2e2::WorkStealingPool::WorkStealingPool(const ThreadPoolOptions& options)
+    : numberOfWorkers_{options.numberOfThreads ? options.numberOfThreads
+                                               : std::max<size_t>(std::thread::hardware_concurrency(), 1)}
+    , grainSize_{options.grainSize}
+{
+    if (grainSize_ == 0)
+    {
+        throw std::invalid_argument("ThreadPool: grain size must be positive");
+    }
+    if (!std::all_of(options.affinity.begin(), options.affinity.end(), isValidCpu))
+    {
+        throw std::invalid_argument("ThreadPool: CPU index is out of range");
+    }
+
+    queues_ = std::make_unique<Queue[]>(numberOfWorkers_);
+    for (size_t worker = 1; worker < numberOfWorkers_; ++worker)
+    {
+        threads_.emplace_back(&WorkStealingPool::loop, this, worker);
+        if (!options.affinity.empty())
+        {
+            pin(threads_.back(), options.affinity[(worker - 1) % options.affinity.size()]);
+        }
+    }
+}
+
+s2e2::WorkStealingPool::~WorkStealingPool()
+{
+    stopping_ = true;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wakeUp_.notify_all();
+
+    for (auto& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+size_t s2e2::WorkStealingPool::numberOfWorkers() const
+{
+    return numberOfWorkers_;
+}
+
+size_t s2e2::WorkStealingPool::grainSize() const
+{
+    return grainSize_;
+}
+
+void s2e2::WorkStealingPool::run(const std::vector<size_t>& tasks, const Body& body)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    Run run;
+    run.body = &body;
+    run.pending = tasks.size();
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        push(Task{&run, tasks[i]}, i % numberOfWorkers_);
+    }
+
+    work(run);
+
+    if (run.error)
+    {
+        std::rethrow_exception(run.error);
+    }
+}
+
+void s2e2::WorkStealingPool::spawn(size_t task, size_t worker)
+{
+    auto* const run = currentRun_;
+    ++run->pending;
+    push(Task{run, task}, worker);
+}
+
+void s2e2::WorkStealingPool::forEachRange(size_t numberOfItems, size_t grain, const RangeBody& body)
+{
+    const auto numberOfRanges = (numberOfItems + grain - 1) / grain;
+    if (numberOfRanges <= 1 || numberOfWorkers_ == 1)
+    {
+        if (numberOfItems != 0)
+        {
+            body(0, numberOfItems, 0);
+        }
+        return;
+    }
+
+    std::vector<size_t> ranges(numberOfRanges);
+    for (size_t range = 0; range < numberOfRanges; ++range)
+    {
+        ranges[range] = range;
+    }
+
+    run(ranges, [numberOfItems, grain, &body](WorkStealingPool&, size_t range, size_t worker)
+    {
+        body(range * grain, std::min(numberOfItems, (range + 1) * grain), worker);
+    });
+}
+
+void s2e2::WorkStealingPool::push(const Task& task, size_t worker)
+{
+    {
+        auto& queue = queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // counted under the same lock it is taken under, so the counters never go below zero
+        ++queued_;
+        ++task.run->queued;
+        queue.tasks.push_back(task);
+    }
+
+    // a worker counts itself as a sleeper before checking the counter, so one of them sees the other
+    if (sleepers_ > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        wakeUp_.notify_one();
+    }
+    if (sleepingCallers_ > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        callerWakeUp_.notify_all();
+    }
+}
+
+bool s2e2::WorkStealingPool::take(size_t worker, const Run* run, Task& task)
+{
+    if ((run ? run->queued : queued_) == 0)
+    {
+        return false;
+    }
+
+    const auto suitable = [run](const Task& queued) { return !run || queued.run == run; };
+    for (size_t i = 0; i < numberOfWorkers_; ++i)
+    {
+        auto& queue = queues_[(worker + i) % numberOfWorkers_];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        // own tasks are taken newest first to stay in cache, stolen ones oldest first
+        if (i == 0)
+        {
+            const auto found = std::find_if(queue.tasks.rbegin(), queue.tasks.rend(), suitable);
+            if (found == queue.tasks.rend())
+            {
+                continue;
+            }
+            task = *found;
+            queue.tasks.erase(std::next(found).base());
+        }
+        else
+        {
+            const auto found = std::find_if(queue.tasks.begin(), queue.tasks.end(), suitable);
+            if (found == queue.tasks.end())
+            {
+                continue;
+            }
+            task = *found;
+            queue.tasks.erase(found);
+        }
+        --queued_;
+        --task.run->queued;
+        return true;
+    }
+    return false;
+}
+
+void s2e2::WorkStealingPool::work(Run& run)
+{
+    // the calling thread takes tasks of its own run only, other runs may keep state of worker 0 of their own
+    Task task{};
+    while (run.pending > 0)
+    {
+        if (take(0, &run, task))
+        {
+            execute(task, 0);
+            continue;
+        }
+
+        ++sleepingCallers_;
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            callerWakeUp_.wait(lock, [&run] { return run.queued > 0 || run.pending == 0; });
+        }
+        --sleepingCallers_;
+    }
+}
+
+void s2e2::WorkStealingPool::execute(const Task& task, size_t worker)
+{
+    auto& run = *task.run;
+    auto* const previousRun = currentRun_;
+    currentRun_ = &run;
+    try
+    {
+        (*run.body)(*this, task.index, worker);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(run.errorMutex);
+        if (!run.error)
+        {
+            run.error = std::current_exception();
+        }
+    }
+    currentRun_ = previousRun;
+
+    // the calling thread may destroy the run as soon as the counter is zero, so it is not touched afterwards
+    if (--run.pending == 0 && sleepingCallers_ > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex_);
+        }
+        callerWakeUp_.notify_all();
+    }
+}
+
+void s2e2::WorkStealingPool::loop(size_t worker)
+{
+    Task task{};
+    while (!stopping_)
+    {
+        if (take(worker, nullptr, task))
+        {
+            execute(task, worker);
+            continue;
+        }
+
+        ++sleepers_;
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            wakeUp_.wait(lock, [this] { return queued_ > 0 || stopping_; });
+        }
+        --sleepers_;
+    }
+}
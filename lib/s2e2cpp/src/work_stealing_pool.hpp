@@ -0,0 +1,209 @@
+#pragma once
+
+#include <s2e2/thread_pool.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace s2e2
+{
+    /**
+     * @class WorkStealingPool
+     * @brief Fixed set of workers running indexed tasks, every worker has its own deque of tasks.
+     * @details A worker takes tasks from the back of its own deque and, when it is empty, steals from the front of
+     *          deques of other workers, so only a worker and its thief ever contend for a deque lock.
+     *          The thread calling run() is worker 0, so a pool of one worker starts no threads at all.
+     *          Runs called from different threads proceed at once: every run keeps its own body, counters and
+     *          exception, and a calling thread only executes tasks of its own run, so state a body keeps per worker
+     *          is never touched by two calling threads.
+     */
+    class WorkStealingPool final
+    {
+    public:
+        /// @brief Body of all tasks of one run: gets the pool, index of the task and index of the worker running it.
+        using Body = std::function<void(WorkStealingPool& pool, size_t task, size_t worker)>;
+
+        /// @brief Body of a range of items: gets the first item, the item past the last one and index of the worker.
+        using RangeBody = std::function<void(size_t first, size_t last, size_t worker)>;
+
+        /**
+         * @brief Constructor, starts the threads.
+         * @param[in] options - Settings of the pool.
+         * @throws std::invalid_argument if grain size is zero or some CPU index is out of range.
+         */
+        explicit WorkStealingPool(const ThreadPoolOptions& options);
+
+        /**
+         * @brief Destructor, stops and joins all threads.
+         */
+        ~WorkStealingPool();
+
+        /**
+         * @brief Get number of workers.
+         * @returns Number of workers including the calling thread.
+         */
+        size_t numberOfWorkers() const;
+
+        /**
+         * @brief Get number of items processed by one task of forEachRange().
+         * @returns Grain size.
+         */
+        size_t grainSize() const;
+
+        /**
+         * @brief Run the tasks and all tasks spawned by them, return when all of them are finished.
+         * @param[in] tasks - Indices of initial tasks, distributed between workers round robin.
+         * @param[in] body - Body of the tasks.
+         * @throws The first exception thrown by the body, after all tasks are finished.
+         */
+        void run(const std::vector<size_t>& tasks, const Body& body);
+
+        /**
+         * @brief Add one more task to the run of the calling task, to be called from the body only.
+         * @param[in] task - Index of the task.
+         * @param[in] worker - Index of the worker calling it, the task is put into its deque.
+         */
+        void spawn(size_t task, size_t worker);
+
+        /**
+         * @brief Split items into ranges of the grain size and process them in parallel.
+         * @details A single range is processed right in the calling thread as worker 0.
+         * @param[in] numberOfItems - Number of items.
+         * @param[in] grain - Number of items of one range, the last one can be shorter.
+         * @param[in] body - Body of a range.
+         * @throws The first exception thrown by the body, after all ranges are processed.
+         */
+        void forEachRange(size_t numberOfItems, size_t grain, const RangeBody& body);
+
+    private:
+        /**
+         * @struct Run
+         * @brief State of one call of run(), owned by the calling thread.
+         */
+        struct Run
+        {
+            /// @brief Body of the tasks.
+            const Body* body = nullptr;
+
+            /// @brief Number of tasks spawned but not finished yet.
+            std::atomic<size_t> pending{0};
+
+            /// @brief Number of tasks in the deques.
+            std::atomic<size_t> queued{0};
+
+            /// @brief The first exception thrown by a task.
+            std::exception_ptr error;
+
+            /// @brief Lock of the exception.
+            std::mutex errorMutex;
+        };
+
+        /**
+         * @struct Task
+         * @brief Task in a deque.
+         */
+        struct Task
+        {
+            /// @brief Run the task belongs to.
+            Run* run;
+
+            /// @brief Index of the task.
+            size_t index;
+        };
+
+        /**
+         * @struct Queue
+         * @brief Deque of tasks of one worker, aligned to keep locks of different workers in different cache lines.
+         */
+        struct alignas(64) Queue
+        {
+            /// @brief Lock of the deque.
+            std::mutex mutex;
+
+            /// @brief Tasks.
+            std::deque<Task> tasks;
+        };
+
+        /**
+         * @brief Push the task into the deque of the worker and wake a sleeping worker if any.
+         * @param[in] task - Task.
+         * @param[in] worker - Index of the worker.
+         */
+        void push(const Task& task, size_t worker);
+
+        /**
+         * @brief Take a task from the worker's own deque or steal one from another worker.
+         * @param[in] worker - Index of the worker.
+         * @param[in] run - Run to take tasks of only, nullptr to take tasks of any run.
+         * @param[out] task - Task.
+         * @returns true if a task is taken, false if there are no suitable tasks.
+         */
+        bool take(size_t worker, const Run* run, Task& task);
+
+        /**
+         * @brief Run tasks of the run in the calling thread until all of them are finished.
+         * @param[in] run - Run.
+         */
+        void work(Run& run);
+
+        /**
+         * @brief Run one task and account its completion.
+         * @param[in] task - Task.
+         * @param[in] worker - Index of the worker.
+         */
+        void execute(const Task& task, size_t worker);
+
+        /**
+         * @brief Main loop of a background worker thread.
+         * @param[in] worker - Index of the worker.
+         */
+        void loop(size_t worker);
+
+    private:
+        /// @brief Deques of tasks, one per worker.
+        std::unique_ptr<Queue[]> queues_;
+
+        /// @brief Number of workers including the calling thread.
+        const size_t numberOfWorkers_;
+
+        /// @brief Number of items processed by one task of forEachRange().
+        const size_t grainSize_;
+
+        /// @brief Background threads, workers from 1 on.
+        std::vector<std::thread> threads_;
+
+        /// @brief Number of tasks in all deques.
+        std::atomic<size_t> queued_{0};
+
+        /// @brief Number of background workers waiting for tasks.
+        std::atomic<size_t> sleepers_{0};
+
+        /// @brief Number of threads calling run() waiting for tasks of their runs.
+        std::atomic<size_t> sleepingCallers_{0};
+
+        /// @brief Are the threads asked to stop.
+        std::atomic<bool> stopping_{false};
+
+        /// @brief Lock of sleeping, it is never taken while there are tasks to run.
+        std::mutex sleepMutex_;
+
+        /// @brief Wakes background workers on new tasks and on stop.
+        std::condition_variable wakeUp_;
+
+        /// @brief Wakes threads calling run() on new tasks and on the end of a run.
+        std::condition_variable callerWakeUp_;
+
+        /// @brief Run of the task the thread is executing, spawned tasks belong to it.
+        static thread_local Run* currentRun_;
+    };
+
+} // namespace s2e2
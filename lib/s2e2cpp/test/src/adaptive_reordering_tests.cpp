@@ -0,0 +1,252 @@
+#include <s2e2/compiled_expression.hpp>
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument and counting its invocations.
+     */
+    class FunctionCount final : public s2e2::Function
+    {
+    public:
+        explicit FunctionCount(size_t& invocations)
+            : s2e2::Function("COUNT", 1)
+            , invocations_{invocations}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            ++invocations_;
+            return arguments_[0];
+        }
+
+    private:
+        size_t& invocations_;
+    };
+
+    /// @brief Number of evaluations enough for several reorderings.
+    const size_t NUMBER_OF_EVALUATIONS = 5000;
+}
+
+class AdaptiveReorderingTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionCount>(invocations));
+        evaluator->setShortCircuit(true);
+        evaluator->setAdaptiveReordering(true);
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+    size_t invocations = 0;
+};
+
+TEST_F(AdaptiveReorderingTests, positiveTest_SelectiveOperand_MovedFirst)
+{
+    const auto expression = evaluator->compile("IF(Flag == yes && Tier == gold, vip, regular)", {"Flag", "Tier"});
+
+    for (size_t i = 0; i < NUMBER_OF_EVALUATIONS; ++i)
+    {
+        const std::string_view tier = (i % 100 == 0) ? "gold" : "silver";
+        evaluator->evaluate(expression, {std::string_view{"yes"}, tier});
+    }
+
+    const auto statistics = expression.chainStatistics();
+    ASSERT_EQ(1, statistics.size());
+    ASSERT_TRUE(statistics[0].conjunction);
+    ASSERT_EQ(NUMBER_OF_EVALUATIONS, statistics[0].evaluations);
+    ASSERT_EQ((std::vector<size_t>{1, 0}), statistics[0].order);
+    ASSERT_LT(0, statistics[0].operands[1].evaluations);
+    ASSERT_GT(statistics[0].operands[1].evaluations / 10, statistics[0].operands[1].passes);
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_Disjunction_LikelyTrueFirst)
+{
+    const auto expression = evaluator->compile("IF(A == a || B == b || C == c, yes, no)", {"A", "B", "C"});
+
+    for (size_t i = 0; i < NUMBER_OF_EVALUATIONS; ++i)
+    {
+        const std::string_view c = (i % 50 == 0) ? "x" : "c";
+        evaluator->evaluate(expression, {std::string_view{"x"}, std::string_view{"x"}, c});
+    }
+
+    const auto statistics = expression.chainStatistics();
+    ASSERT_EQ(1, statistics.size());
+    ASSERT_FALSE(statistics[0].conjunction);
+    ASSERT_EQ(3, statistics[0].operands.size());
+    ASSERT_EQ(2, statistics[0].order[0]);
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_FailingOperand_StaysInPlace)
+{
+    // ordering comparison fails on NULL and custom function may have side effects
+    const auto expression = evaluator->compile("IF(A == a && B < b && C == c && D == d && COUNT(E) == e, yes, no)",
+                                               {"A", "B", "C", "D", "E"});
+
+    for (size_t i = 0; i < NUMBER_OF_EVALUATIONS; ++i)
+    {
+        const std::string_view d = (i % 100 == 0) ? "d" : "x";
+        evaluator->evaluate(expression, {std::string_view{"a"}, std::string_view{"a"}, std::string_view{"c"}, d,
+                                         std::string_view{"e"}});
+    }
+
+    const auto statistics = expression.chainStatistics();
+    ASSERT_EQ(1, statistics.size());
+    const auto& operands = statistics[0].operands;
+    ASSERT_EQ(5, operands.size());
+    ASSERT_TRUE(operands[0].reorderable);
+    ASSERT_FALSE(operands[1].reorderable);
+    ASSERT_TRUE(operands[2].reorderable);
+    ASSERT_TRUE(operands[3].reorderable);
+    ASSERT_FALSE(operands[4].reorderable);
+    ASSERT_EQ((std::vector<size_t>{0, 1, 3, 2, 4}), statistics[0].order);
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_Reset_SourceOrder)
+{
+    const auto expression = evaluator->compile("IF(A == a && B == b, yes, no)", {"A", "B"});
+    for (size_t i = 0; i < NUMBER_OF_EVALUATIONS; ++i)
+    {
+        evaluator->evaluate(expression, {std::string_view{"a"}, std::string_view{"x"}});
+    }
+    ASSERT_EQ((std::vector<size_t>{1, 0}), expression.chainStatistics()[0].order);
+
+    const auto copy = expression;
+    copy.resetStatistics();
+
+    const auto statistics = expression.chainStatistics();
+    ASSERT_EQ(0, statistics[0].evaluations);
+    ASSERT_EQ((std::vector<size_t>{0, 1}), statistics[0].order);
+    ASSERT_EQ(0, statistics[0].operands[0].evaluations);
+    ASSERT_EQ(0, statistics[0].operands[1].passes);
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_NestedChains_Statistics)
+{
+    const auto expression = evaluator->compile("(A == a || A == b || B == b) && IN(C, c, d) && C != e", {"A", "B", "C"});
+
+    const auto statistics = expression.chainStatistics();
+
+    ASSERT_EQ(2, statistics.size());
+    ASSERT_TRUE(statistics[0].conjunction);
+    ASSERT_EQ(3, statistics[0].operands.size());
+    ASSERT_FALSE(statistics[1].conjunction);
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_LongChain_Split)
+{
+    std::string source = "A == a0";
+    for (size_t i = 1; i < 40; ++i)
+    {
+        source += " && A + a" + std::to_string(i) + " != B";
+    }
+    const auto expression = evaluator->compile("IF(" + source + ", yes, no)", {"A", "B"});
+
+    const auto statistics = expression.chainStatistics();
+
+    ASSERT_LT(1, statistics.size());
+    for (const auto& chain : statistics)
+    {
+        ASSERT_GE(16, chain.operands.size());
+    }
+    ASSERT_EQ(std::optional<std::string>{"yes"}, evaluator->evaluate(expression, {std::string_view{"a0"}, std::string_view{"b"}}));
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_Disabled_NoStatistics)
+{
+    evaluator->setAdaptiveReordering(false);
+    const auto expression = evaluator->compile("IF(A == a && B == b, yes, no)", {"A", "B"});
+
+    evaluator->evaluate(expression, {std::string_view{"a"}, std::string_view{"b"}});
+
+    ASSERT_TRUE(expression.chainStatistics().empty());
+    expression.resetStatistics();
+}
+
+TEST_F(AdaptiveReorderingTests, positiveTest_RandomChains_SameAsSourceOrder)
+{
+    const std::vector<std::string> variables = {"A", "B", "C"};
+    const std::vector<std::string> literals = {"a", "b", "ab", "NULL"};
+    const std::vector<std::string> operators = {" == ", " != ", " < "};
+    const std::vector<std::optional<std::string_view>> values = {"a", "b", "ab", "c", std::nullopt};
+
+    std::mt19937 random(17);
+    const auto pick = [&random](const auto& options) { return options[random() % options.size()]; };
+
+    s2e2::Evaluator plain;
+    plain.addStandardFunctions();
+    plain.addStandardOperators();
+    plain.setShortCircuit(true);
+
+    for (size_t i = 0; i < 30; ++i)
+    {
+        std::string source;
+        const auto numberOfOperands = 2 + random() % 6;
+        for (size_t operand = 0; operand < numberOfOperands; ++operand)
+        {
+            if (operand != 0)
+            {
+                source += (random() % 3 == 0) ? " || " : " && ";
+            }
+            source += (random() % 4 == 0) ? "IN(" + pick(variables) + ", " + pick(literals) + ", " + pick(literals) + ")"
+                                          : pick(variables) + pick(operators) + pick(literals);
+        }
+
+        source = "IF(" + source + ", yes, no)";
+        const auto adaptive = evaluator->compile(source, variables);
+        const auto expected = plain.compile(source, variables);
+        for (size_t j = 0; j < 3000; ++j)
+        {
+            const std::vector<s2e2::VariableValue> record = {pick(values), pick(values), pick(values)};
+
+            std::optional<std::string> expectedValue;
+            std::string expectedError;
+            try
+            {
+                expectedValue = plain.evaluate(expected, record);
+            }
+            catch (const s2e2::Error& error)
+            {
+                expectedError = error.what();
+            }
+
+            std::optional<std::string> value;
+            std::string error;
+            try
+            {
+                value = evaluator->evaluate(adaptive, record);
+            }
+            catch (const s2e2::Error& exception)
+            {
+                error = exception.what();
+            }
+
+            ASSERT_EQ(expectedValue, value) << source;
+            ASSERT_EQ(expectedError, error) << source;
+        }
+    }
+}
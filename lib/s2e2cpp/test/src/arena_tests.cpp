@@ -0,0 +1,124 @@
+#include <arena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Resource counting allocations of the default one.
+     */
+    class CountingResource final : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations = 0;
+        size_t deallocations = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override
+        {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override
+        {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+TEST(ArenaTests, positiveTest_Concatenate_Values)
+{
+    s2e2::Arena arena;
+    const auto first = arena.copy("abc");
+    const auto second = arena.concatenate(first, "def");
+
+    ASSERT_EQ("abc", first);
+    ASSERT_EQ("abcdef", second);
+    ASSERT_EQ("", arena.concatenate("", ""));
+}
+
+TEST(ArenaTests, positiveTest_Allocate_Aligned)
+{
+    s2e2::Arena arena;
+    arena.copy("a");
+
+    for (const size_t alignment : {1, 2, 8, 16, 64, 256})
+    {
+        const auto address = reinterpret_cast<uintptr_t>(arena.allocate(3, alignment));
+        ASSERT_EQ(0, address % alignment);
+    }
+}
+
+TEST(ArenaTests, positiveTest_Reset_NoUpstreamAllocations)
+{
+    CountingResource upstream;
+    {
+        s2e2::Arena arena(&upstream);
+        const std::string value(1000, 'x');
+
+        for (int i = 0; i < 100; ++i)
+        {
+            arena.copy(value);
+        }
+        ASSERT_LT(1, upstream.allocations);
+
+        arena.reset();
+        const auto allocations = upstream.allocations;
+        for (int evaluation = 0; evaluation < 10; ++evaluation)
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                arena.copy(value);
+            }
+            arena.reset();
+        }
+        ASSERT_EQ(allocations, upstream.allocations);
+        ASSERT_LE(100 * value.size(), arena.capacity());
+    }
+    ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(ArenaTests, positiveTest_PolymorphicContainer_UsesArena)
+{
+    CountingResource upstream;
+    s2e2::Arena arena(&upstream);
+
+    std::pmr::vector<std::pmr::string> strings(&arena);
+    for (int i = 0; i < 100; ++i)
+    {
+        strings.emplace_back("a string too long for the small string buffer");
+    }
+
+    ASSERT_EQ(100, strings.size());
+    ASSERT_EQ("a string too long for the small string buffer", strings.back());
+    ASSERT_GT(20, upstream.allocations);
+}
+
+TEST(ArenaTests, positiveTest_SetUpstream_ChunksReturned)
+{
+    CountingResource first;
+    CountingResource second;
+    s2e2::Arena arena(&first);
+    arena.copy("abc");
+
+    arena.setUpstream(&second);
+    arena.copy("def");
+
+    ASSERT_EQ(1, first.allocations);
+    ASSERT_EQ(1, first.deallocations);
+    ASSERT_EQ(1, second.allocations);
+    ASSERT_EQ(&second, arena.upstream());
+}
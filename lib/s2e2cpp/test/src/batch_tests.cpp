@@ -0,0 +1,355 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/record_batch.hpp>
+#include <s2e2/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+class BatchTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(BatchTests, positiveTest_CompiledWithoutVariables_EvaluationResult)
+{
+    const auto expression = evaluator->compile("A + B");
+
+    const auto result = evaluator->evaluate(expression);
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("AB", *result);
+}
+
+TEST_F(BatchTests, positiveTest_CompiledLiteral_EvaluationResult)
+{
+    const auto expression = evaluator->compile("A B C");
+
+    const auto result = evaluator->evaluate(expression);
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("A B C", *result);
+}
+
+TEST_F(BatchTests, positiveTest_CompiledSingleVariable_EvaluationResult)
+{
+    const auto expression = evaluator->compile("Country", {"Country"});
+
+    const auto result = evaluator->evaluate(expression, {std::string_view{"NL"}});
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("NL", *result);
+}
+
+TEST_F(BatchTests, positiveTest_CompiledWithVariables_EvaluationResult)
+{
+    const auto expression = evaluator->compile("IF(Tier == gold, Name + \" VIP\", Name)", {"Name", "Tier"});
+
+    const auto gold = evaluator->evaluate(expression, {std::string_view{"Ann"}, std::string_view{"gold"}});
+    const auto silver = evaluator->evaluate(expression, {std::string_view{"Bob"}, std::string_view{"silver"}});
+
+    ASSERT_TRUE(gold);
+    ASSERT_EQ("Ann VIP", *gold);
+    ASSERT_TRUE(silver);
+    ASSERT_EQ("Bob", *silver);
+}
+
+TEST_F(BatchTests, positiveTest_NullVariable_EvaluationResult)
+{
+    const auto expression = evaluator->compile("IF(Name == NULL, Unknown, Name)", {"Name"});
+
+    const auto result = evaluator->evaluate(expression, {std::nullopt});
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("Unknown", *result);
+}
+
+TEST_F(BatchTests, positiveTest_RowMajorBatch_Results)
+{
+    const auto expression = evaluator->compile("A + B", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"1", "2",
+                                                     "3", std::nullopt,
+                                                     std::nullopt, std::nullopt};
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    const auto failures = evaluator->evaluateBatch(expression, s2e2::RecordBatch::rowMajor(values, 3, 2), results, statuses);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"12"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"3"}, results[1]);
+    ASSERT_FALSE(results[2]);
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[2]);
+}
+
+TEST_F(BatchTests, positiveTest_ColumnarBatch_Results)
+{
+    const auto expression = evaluator->compile("IF(A < B, A, B)", {"A", "B"});
+    const std::vector<s2e2::VariableValue> columnA = {"a", "z"};
+    const std::vector<s2e2::VariableValue> columnB = {"b", "c"};
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    const auto failures = evaluator->evaluateBatch(expression, s2e2::RecordBatch::columnar({columnA, columnB}, 2), results, statuses);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"a"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"c"}, results[1]);
+}
+
+TEST_F(BatchTests, positiveTest_DictionaryColumn_Results)
+{
+    const auto expression = evaluator->compile("IF(Tier == gold, Name + \" VIP\", Name)", {"Name", "Tier"});
+    const std::vector<s2e2::VariableValue> names = {"Ann", "Bob", "Eve"};
+    const std::vector<s2e2::VariableValue> tiers = {"silver", "gold", std::nullopt};
+    const std::vector<uint32_t> codes = {1, 2, 1};
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    const auto records = s2e2::RecordBatch::columnar({names, s2e2::BatchColumn::dictionary(tiers, codes)}, 3);
+    const auto failures = evaluator->evaluateBatch(expression, records, results, statuses);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"Ann VIP"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"Bob"}, results[1]);
+    ASSERT_EQ(std::optional<std::string>{"Eve VIP"}, results[2]);
+}
+
+TEST_F(BatchTests, positiveTest_InvalidRecords_Statuses)
+{
+    const auto expression = evaluator->compile("IF(A < B, A, B)", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"a", "b",
+                                                     std::nullopt, "b",
+                                                     "b", "a"};
+    std::vector<std::optional<std::string>> results(3, std::string{"garbage"});
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    const auto failures = evaluator->evaluateBatch(expression, s2e2::RecordBatch::rowMajor(values, 3, 2), results, statuses);
+
+    ASSERT_EQ(1, failures);
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[0]);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[1]);
+    ASSERT_FALSE(results[1]);
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[2]);
+    ASSERT_EQ(std::optional<std::string>{"a"}, results[2]);
+}
+
+TEST_F(BatchTests, positiveTest_ThreadPool_SameAsSequential)
+{
+    const auto expression = evaluator->compile("IF(A < B, REPLACE(A + B, a, b), B + c)", {"A", "B"});
+    const size_t numberOfRecords = 5000;
+    std::vector<std::string> strings;
+    for (size_t number = 0; number < 100; ++number)
+    {
+        strings.push_back(std::to_string(number));
+    }
+    std::vector<s2e2::VariableValue> values;
+    for (size_t record = 0; record < numberOfRecords; ++record)
+    {
+        values.emplace_back(strings[record % 97]);
+        values.emplace_back((record % 13 == 0) ? s2e2::VariableValue{} : s2e2::VariableValue{strings[record % 89]});
+    }
+    const auto records = s2e2::RecordBatch::rowMajor(values, numberOfRecords, 2);
+
+    for (const auto mode : {s2e2::ExecutionMode::SCALAR, s2e2::ExecutionMode::VECTORIZED})
+    {
+        evaluator->setThreadPool(nullptr);
+        std::vector<std::optional<std::string>> expected(numberOfRecords);
+        std::vector<s2e2::RecordStatus> expectedStatuses(numberOfRecords);
+        const auto expectedFailures = evaluator->evaluateBatch(expression, records, expected, expectedStatuses, mode);
+        ASSERT_LT(0, expectedFailures);
+
+        s2e2::ThreadPoolOptions options;
+        options.numberOfThreads = 4;
+        options.grainSize = 100;
+        evaluator->setThreadPool(std::make_shared<s2e2::ThreadPool>(options));
+        for (size_t i = 0; i < 10; ++i)
+        {
+            std::vector<std::optional<std::string>> results(numberOfRecords);
+            std::vector<s2e2::RecordStatus> statuses(numberOfRecords);
+            const auto failures = evaluator->evaluateBatch(expression, records, results, statuses, mode);
+
+            ASSERT_EQ(expectedFailures, failures);
+            ASSERT_EQ(expected, results);
+            ASSERT_EQ(expectedStatuses, statuses);
+        }
+    }
+}
+
+TEST_F(BatchTests, positiveTest_SharedThreadPool_BothEvaluators)
+{
+    s2e2::ThreadPoolOptions options;
+    options.numberOfThreads = 3;
+    options.grainSize = 10;
+    const auto pool = std::make_shared<s2e2::ThreadPool>(options);
+    s2e2::Evaluator other;
+    other.addStandardOperators();
+    evaluator->setThreadPool(pool);
+    other.setThreadPool(pool);
+
+    const auto expression = evaluator->compile("A + b", {"A"});
+    const auto otherExpression = other.compile("A + c", {"A"});
+    const std::vector<s2e2::VariableValue> values(100, std::string_view{"a"});
+    const auto records = s2e2::RecordBatch::rowMajor(values, 100, 1);
+    std::vector<std::optional<std::string>> results(100);
+    std::vector<s2e2::RecordStatus> statuses(100);
+
+    evaluator->evaluateBatch(expression, records, results, statuses);
+    ASSERT_EQ(std::vector<std::optional<std::string>>(100, std::string{"ab"}), results);
+
+    other.evaluateBatch(otherExpression, records, results, statuses);
+    ASSERT_EQ(std::vector<std::optional<std::string>>(100, std::string{"ac"}), results);
+}
+
+TEST_F(BatchTests, negativeTest_CompileFewArguments)
+{
+    ASSERT_THROW({
+        try
+        {
+            evaluator->compile("A + ", {"A"});
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Not enough arguments for operator +", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(BatchTests, negativeTest_VariableDeclaredTwice)
+{
+    ASSERT_THROW({
+        try
+        {
+            evaluator->compile("A + B", {"A", "A"});
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Evaluator: variable A is declared twice", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(BatchTests, negativeTest_WrongNumberOfValues)
+{
+    const auto expression = evaluator->compile("A + B", {"A", "B"});
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate(expression, {std::string_view{"1"}});
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("Evaluator: number of variables does not match the expression", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(BatchTests, negativeTest_WrongOutputSize)
+{
+    const auto expression = evaluator->compile("A + B", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"1", "2"};
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(1);
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluateBatch(expression, s2e2::RecordBatch::rowMajor(values, 1, 2), results, statuses);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("Evaluator: size of outputs does not match number of records", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(BatchTests, negativeTest_RowMajorDimensions)
+{
+    const std::vector<s2e2::VariableValue> values = {"1", "2", "3"};
+
+    ASSERT_THROW({
+        try
+        {
+            s2e2::RecordBatch::rowMajor(values, 2, 2);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("RecordBatch: number of values does not match batch dimensions", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(BatchTests, negativeTest_ColumnarDimensions)
+{
+    const std::vector<s2e2::VariableValue> columnA = {"1", "2"};
+    const std::vector<s2e2::VariableValue> columnB = {"1"};
+
+    ASSERT_THROW({
+        try
+        {
+            s2e2::RecordBatch::columnar({columnA, columnB}, 2);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("RecordBatch: column size does not match number of records", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(BatchTests, negativeTest_DictionaryCodeOutOfRange)
+{
+    const std::vector<s2e2::VariableValue> dictionary = {"a", "b"};
+    const std::vector<uint32_t> codes = {0, 2};
+
+    ASSERT_THROW({
+        try
+        {
+            s2e2::RecordBatch::columnar({s2e2::BatchColumn::dictionary(dictionary, codes)}, 2);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("RecordBatch: dictionary code is out of range", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(BatchTests, negativeTest_DictionaryWithDuplicates)
+{
+    const std::vector<s2e2::VariableValue> dictionary = {"a", "b", "a"};
+    const std::vector<uint32_t> codes = {0, 1};
+
+    ASSERT_THROW({
+        try
+        {
+            s2e2::RecordBatch::columnar({s2e2::BatchColumn::dictionary(dictionary, codes)}, 2);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("RecordBatch: dictionary contains the same value twice", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
@@ -0,0 +1,40 @@
+#include <char_class.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+TEST(CharClassTests, positiveTest_SpecialSymbols_Classes)
+{
+    ASSERT_TRUE(s2e2::hasCharClass(' ', s2e2::CharClass::BLANK));
+    ASSERT_TRUE(s2e2::hasCharClass('\t', s2e2::CharClass::BLANK));
+    ASSERT_TRUE(s2e2::hasCharClass('"', s2e2::CharClass::QUOTE));
+
+    for (const auto symbol : std::string{" \t\",()"})
+    {
+        ASSERT_TRUE(s2e2::hasCharClass(symbol, s2e2::CharClass::SPECIAL));
+        ASSERT_FALSE(s2e2::hasCharClass(symbol, s2e2::CharClass::OPERATOR | s2e2::CharClass::IDENTIFIER));
+    }
+}
+
+TEST(CharClassTests, positiveTest_OrdinarySymbols_Classes)
+{
+    for (const auto symbol : std::string{"azAZ09_"})
+    {
+        ASSERT_TRUE(s2e2::hasCharClass(symbol, s2e2::CharClass::IDENTIFIER));
+    }
+    for (const auto symbol : std::string{"+-*/=!<>&|\\"})
+    {
+        ASSERT_TRUE(s2e2::hasCharClass(symbol, s2e2::CharClass::OPERATOR));
+        ASSERT_FALSE(s2e2::hasCharClass(symbol, s2e2::CharClass::SPECIAL));
+    }
+}
+
+TEST(CharClassTests, negativeTest_NotAscii_NoClass)
+{
+    for (const auto symbol : {'\0', '\n', '\r', '\v', '\f', '\x7f', '\x80', '\xa0', '\xff'})
+    {
+        ASSERT_EQ(0, s2e2::CHAR_CLASSES[static_cast<unsigned char>(symbol)]);
+    }
+}
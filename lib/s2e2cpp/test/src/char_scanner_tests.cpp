@@ -0,0 +1,88 @@
+#include <char_scanner.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Get all instruction sets supported on this machine.
+     */
+    std::vector<s2e2::SimdLevel> supportedLevels()
+    {
+        std::vector<s2e2::SimdLevel> levels = {s2e2::SimdLevel::SCALAR};
+        if (s2e2::CharScanner::bestLevel() != s2e2::SimdLevel::SCALAR)
+        {
+            levels.push_back(s2e2::SimdLevel::SSE2);
+        }
+        if (s2e2::CharScanner::bestLevel() == s2e2::SimdLevel::AVX2)
+        {
+            levels.push_back(s2e2::SimdLevel::AVX2);
+        }
+        return levels;
+    }
+}
+
+TEST(CharScannerTests, positiveTest_EveryPosition_FoundAtOffset)
+{
+    for (const auto level : supportedLevels())
+    {
+        const s2e2::CharScanner scanner(level);
+        for (size_t size = 1; size < 80; ++size)
+        {
+            for (size_t at = 0; at < size; ++at)
+            {
+                for (const auto symbol : {'"', ',', '(', ')', ' ', '\t'})
+                {
+                    auto text = std::string(size, 'a');
+                    text[at] = symbol;
+
+                    ASSERT_EQ(at, scanner.findSpecial(text, 0));
+                    ASSERT_EQ(symbol == '"' ? at : size, scanner.findQuote(text, 0));
+                }
+            }
+        }
+    }
+}
+
+TEST(CharScannerTests, positiveTest_RandomStrings_SameAsScalar)
+{
+    const s2e2::CharScanner scalar(s2e2::SimdLevel::SCALAR);
+    const std::string alphabet = "ab\"\\,() \t+=\x80\xff";
+    std::mt19937 random(7);
+
+    for (const auto level : supportedLevels())
+    {
+        const s2e2::CharScanner scanner(level);
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            std::string text(random() % 200, 'x');
+            for (auto& symbol : text)
+            {
+                // mostly ordinary symbols to get long runs
+                symbol = (random() % 8 == 0) ? alphabet[random() % alphabet.size()] : 'x';
+            }
+            const auto from = text.empty() ? 0 : random() % text.size();
+
+            ASSERT_EQ(scalar.findSpecial(text, from), scanner.findSpecial(text, from)) << text;
+            ASSERT_EQ(scalar.findQuote(text, from), scanner.findQuote(text, from)) << text;
+        }
+    }
+}
+
+TEST(CharScannerTests, positiveTest_NoSpecialSymbols_Size)
+{
+    for (const auto level : supportedLevels())
+    {
+        const s2e2::CharScanner scanner(level);
+        const std::string text(100, 'a');
+
+        ASSERT_EQ(100, scanner.findSpecial(text, 0));
+        ASSERT_EQ(100, scanner.findQuote(text, 37));
+        ASSERT_EQ(100, scanner.findSpecial(text, 100));
+    }
+}
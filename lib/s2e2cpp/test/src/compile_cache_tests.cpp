@@ -0,0 +1,154 @@
+#include <s2e2/compile_cache.hpp>
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument.
+     */
+    class FunctionSame final : public s2e2::Function
+    {
+    public:
+        FunctionSame()
+            : s2e2::Function("SAME", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            return arguments_[0];
+        }
+    };
+}
+
+class CompileCacheTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+
+        s2e2::CompileCacheOptions options;
+        options.capacity = 8;
+        options.failureCapacity = 8;
+        evaluator->setCompileCache(options);
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(CompileCacheTests, positiveTest_SameExpression_Hit)
+{
+    const auto first = evaluator->compile("A + b", {"A"});
+    const auto second = evaluator->compile("A + b", {"A"});
+    evaluator->compile("A + b", {"B"});
+
+    const auto statistics = evaluator->compileCacheStatistics();
+    ASSERT_EQ(1, statistics.hits);
+    ASSERT_EQ(2, statistics.misses);
+    ASSERT_EQ(2, statistics.size);
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate(second, {std::string_view{"a"}}));
+}
+
+TEST_F(CompileCacheTests, negativeTest_RepeatedFailure_SameStatus)
+{
+    const auto first = evaluator->tryCompile("A + (B + C");
+    const auto second = evaluator->tryCompile("A + (B + C");
+
+    ASSERT_EQ(s2e2::ErrorCode::UNPAIRED_BRACKET, second.status().code);
+    ASSERT_EQ(first.status().message, second.status().message);
+    ASSERT_EQ(4, second.status().position);
+    ASSERT_THROW(evaluator->compile("A + (B + C"), s2e2::Error);
+    ASSERT_THROW(evaluator->evaluate("A + (B + C"), s2e2::Error);
+
+    const auto statistics = evaluator->compileCacheStatistics();
+    ASSERT_EQ(1, statistics.misses);
+    ASSERT_EQ(3, statistics.failureHits);
+    ASSERT_EQ(1, statistics.failureSize);
+    ASSERT_EQ(0, statistics.size);
+}
+
+TEST_F(CompileCacheTests, negativeTest_FailureTtl_Expired)
+{
+    s2e2::CompileCacheOptions options;
+    options.failureCapacity = 8;
+    options.failureTtl = std::chrono::milliseconds(1);
+    evaluator->setCompileCache(options);
+
+    evaluator->tryCompile("A + (B");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    evaluator->tryCompile("A + (B");
+
+    const auto statistics = evaluator->compileCacheStatistics();
+    ASSERT_EQ(2, statistics.misses);
+    ASSERT_EQ(0, statistics.failureHits);
+}
+
+TEST_F(CompileCacheTests, negativeTest_FailureCapacity_ProgramsKept)
+{
+    s2e2::CompileCacheOptions options;
+    options.capacity = 1;
+    options.failureCapacity = 2;
+    evaluator->setCompileCache(options);
+
+    evaluator->compile("A + b", {"A"});
+    evaluator->tryCompile("(1");
+    evaluator->tryCompile("(2");
+    evaluator->tryCompile("(3");
+    evaluator->tryCompile("(1");
+    evaluator->compile("A + b", {"A"});
+
+    const auto statistics = evaluator->compileCacheStatistics();
+    ASSERT_EQ(1, statistics.hits);
+    ASSERT_EQ(0, statistics.failureHits);
+    ASSERT_EQ(5, statistics.misses);
+    ASSERT_EQ(2, statistics.failureSize);
+    ASSERT_EQ(1, statistics.size);
+}
+
+TEST_F(CompileCacheTests, positiveTest_AddFunction_FailureDropped)
+{
+    ASSERT_FALSE(evaluator->tryCompile("SAME(A) + b", {"A"}).ok());
+
+    evaluator->addFunction(std::make_unique<FunctionSame>());
+    const auto result = evaluator->tryCompile("SAME(A) + b", {"A"});
+
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate(result.value(), {std::string_view{"a"}}));
+}
+
+TEST_F(CompileCacheTests, positiveTest_Disabled_NothingCached)
+{
+    evaluator->setCompileCache({});
+
+    evaluator->compile("A + b", {"A"});
+    evaluator->compile("A + b", {"A"});
+    evaluator->tryCompile("A + (B");
+
+    const auto statistics = evaluator->compileCacheStatistics();
+    ASSERT_EQ(0, statistics.hits);
+    ASSERT_EQ(0, statistics.misses);
+    ASSERT_EQ(0, statistics.size);
+    ASSERT_EQ(0, statistics.failureSize);
+}
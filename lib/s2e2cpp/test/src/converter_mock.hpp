@@ -7,12 +7,14 @@
 
 #include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 
 class ConverterMock : public s2e2::IConverter
 {
 public:
+    MOCK_CONST_METHOD0(clone, std::unique_ptr<s2e2::IConverter>());
     MOCK_METHOD2(addOperator, void(const std::string&, const uint_fast16_t));
     MOCK_CONST_METHOD1(convert, std::list<s2e2::Token>(const std::list<s2e2::Token>&));
 };
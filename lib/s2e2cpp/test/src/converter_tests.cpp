@@ -1,4 +1,5 @@
 #include <converter.hpp>
+#include <symbol_table.hpp>
 #include <token_type.hpp>
 #include <token.hpp>
 
@@ -6,7 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <iterator>
 #include <memory>
+#include <vector>
 
 
 class ConverterTests : public testing::Test
@@ -65,6 +68,27 @@ TEST_F(ConverterTests, positiveTest_TwoBinaryOperatorsSamePriority_ResultValue)
     ASSERT_EQ(expectedTokens, actualTokens);
 }
 
+TEST_F(ConverterTests, positiveTest_InternedOperators_TokenPriorities)
+{
+    const auto inputTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::ATOM, "A"},
+                                                    s2e2::Token{s2e2::TokenType::OPERATOR, "+", 0, 1, 0, 1},
+                                                    s2e2::Token{s2e2::TokenType::ATOM, "B"},
+                                                    s2e2::Token{s2e2::TokenType::OPERATOR, "*", 0, 3, 1, 2},
+                                                    s2e2::Token{s2e2::TokenType::ATOM, "C"}};
+
+    const auto actualTokens = converter->convert(inputTokens);
+
+    const auto expectedTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::ATOM, "A"},
+                                                       s2e2::Token{s2e2::TokenType::ATOM, "B"},
+                                                       s2e2::Token{s2e2::TokenType::ATOM, "C"},
+                                                       s2e2::Token{s2e2::TokenType::OPERATOR, "*"},
+                                                       s2e2::Token{s2e2::TokenType::OPERATOR, "+"}};
+
+    ASSERT_EQ(expectedTokens, actualTokens);
+    ASSERT_EQ(1, std::next(actualTokens.begin(), 3)->symbol);
+    ASSERT_EQ(0, std::next(actualTokens.begin(), 4)->symbol);
+}
+
 TEST_F(ConverterTests, positiveTest_TwoOperatorsDifferentPriorities_ResultValue)
 {
 	converter->addOperator("+", 1);
@@ -234,6 +258,42 @@ TEST_F(ConverterTests, positiveTest_NestedFunctions_ResultValue)
     ASSERT_EQ(expectedTokens, actualTokens);
 }
 
+TEST_F(ConverterTests, positiveTest_NestedFunctions_NumberOfArguments)
+{
+    converter->addOperator("+", 1);
+
+    const auto inputTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::FUNCTION, "FUN1"},
+                                                    s2e2::Token{s2e2::TokenType::LEFT_BRACKET, "("},
+                                                    s2e2::Token{s2e2::TokenType::FUNCTION, "FUN2"},
+                                                    s2e2::Token{s2e2::TokenType::LEFT_BRACKET, "("},
+                                                    s2e2::Token{s2e2::TokenType::RIGHT_BRACKET, ")"},
+                                                    s2e2::Token{s2e2::TokenType::COMMA, ","},
+                                                    s2e2::Token{s2e2::TokenType::LEFT_BRACKET, "("},
+                                                    s2e2::Token{s2e2::TokenType::ATOM, "Arg1"},
+                                                    s2e2::Token{s2e2::TokenType::OPERATOR, "+"},
+                                                    s2e2::Token{s2e2::TokenType::ATOM, "Arg2"},
+                                                    s2e2::Token{s2e2::TokenType::RIGHT_BRACKET, ")"},
+                                                    s2e2::Token{s2e2::TokenType::COMMA, ","},
+                                                    s2e2::Token{s2e2::TokenType::FUNCTION, "FUN3"},
+                                                    s2e2::Token{s2e2::TokenType::LEFT_BRACKET, "("},
+                                                    s2e2::Token{s2e2::TokenType::ATOM, "Arg3"},
+                                                    s2e2::Token{s2e2::TokenType::RIGHT_BRACKET, ")"},
+                                                    s2e2::Token{s2e2::TokenType::RIGHT_BRACKET, ")"}};
+
+    const auto actualTokens = converter->convert(inputTokens);
+
+    std::vector<size_t> numbersOfArguments;
+    for (const auto& token : actualTokens)
+    {
+        if (token.type == s2e2::TokenType::FUNCTION)
+        {
+            numbersOfArguments.push_back(token.numberOfArguments);
+        }
+    }
+
+    ASSERT_EQ((std::vector<size_t>{0, 1, 3}), numbersOfArguments);
+}
+
 TEST_F(ConverterTests, positiveTest_OperatorsWithoutArguments_ResultValue)
 {
     converter->addOperator("+", 1);
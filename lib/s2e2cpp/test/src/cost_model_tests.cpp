@@ -0,0 +1,202 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/expression_cost.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class CostModelTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+	}
+
+    /**
+     * @brief Get complexity of a single REPLACE with the pattern.
+     */
+    size_t regexComplexity(const std::string& pattern) const
+    {
+        return evaluator->compile("REPLACE(A, \"" + pattern + "\", b)", {"A"}).cost().regexComplexity;
+    }
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(CostModelTests, positiveTest_Calls_Counted)
+{
+    const auto expression = evaluator->compile("IF(A == a && B == b, A + B + c, REPLACE(A, x, y))", {"A", "B"});
+
+    const auto& cost = expression.cost();
+
+    // IF ( A == a && B == b , A + B + c , REPLACE ( A , x , y ) )
+    ASSERT_EQ(25, cost.numberOfTokens);
+    ASSERT_EQ(2, cost.numberOfFunctionCalls);
+    ASSERT_EQ(5, cost.numberOfOperatorCalls);
+    ASSERT_EQ(2, cost.calls.at("=="));
+    ASSERT_EQ(2, cost.calls.at("+"));
+    ASSERT_EQ(1, cost.calls.at("&&"));
+    ASSERT_EQ(1, cost.calls.at("IF"));
+    ASSERT_EQ(1, cost.calls.at("REPLACE"));
+    ASSERT_EQ(1, cost.numberOfRegexes);
+}
+
+TEST_F(CostModelTests, positiveTest_StackDepth)
+{
+    ASSERT_EQ(1, evaluator->compile("A", {"A"}).cost().maxStackDepth);
+    ASSERT_EQ(2, evaluator->compile("A + B + C + D", {"A", "B", "C", "D"}).cost().maxStackDepth);
+    ASSERT_EQ(4, evaluator->compile("A + (B + (C + D))", {"A", "B", "C", "D"}).cost().maxStackDepth);
+}
+
+TEST_F(CostModelTests, positiveTest_NestingDepth)
+{
+    ASSERT_EQ(1, evaluator->compile("A", {"A"}).cost().nestingDepth);
+    ASSERT_EQ(4, evaluator->compile("A + B + C + D", {"A", "B", "C", "D"}).cost().nestingDepth);
+    ASSERT_EQ(4, evaluator->compile("A + (B + (C + D))", {"A", "B", "C", "D"}).cost().nestingDepth);
+    ASSERT_EQ(3, evaluator->compile("IF(A == a, b, A + c)", {"A"}).cost().nestingDepth);
+}
+
+TEST_F(CostModelTests, positiveTest_Literal_Cost)
+{
+    const auto& cost = evaluator->compile("just a literal").cost();
+
+    ASSERT_EQ(3, cost.numberOfTokens);
+    ASSERT_EQ(1, cost.maxStackDepth);
+    ASSERT_EQ(1, cost.nestingDepth);
+    ASSERT_EQ(0, cost.numberOfFunctionCalls + cost.numberOfOperatorCalls);
+}
+
+TEST_F(CostModelTests, positiveTest_RegexComplexity_Ordered)
+{
+    const auto plain = regexComplexity("abc");
+    const auto quantified = regexComplexity("a+bc");
+    const auto nested = regexComplexity("(a+)+bc");
+    const auto backreference = regexComplexity("(a)b\\1");
+
+    ASSERT_EQ(3, plain);
+    ASSERT_LT(plain, quantified);
+    ASSERT_LT(quantified, backreference);
+    ASSERT_LT(backreference, nested);
+    ASSERT_EQ(regexComplexity("a+bc"), regexComplexity("a+?bc") - 1);
+    ASSERT_EQ(regexComplexity("[+*]"), 4);
+}
+
+TEST_F(CostModelTests, positiveTest_DynamicPattern_MostComplex)
+{
+    const auto expression = evaluator->compile("REPLACE(A, B, c)", {"A", "B"});
+
+    ASSERT_EQ(s2e2::ExpressionCost::DYNAMIC_REGEX_COMPLEXITY, expression.cost().regexComplexity);
+}
+
+TEST_F(CostModelTests, positiveTest_WithinLimits_Compiled)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxLength = 100;
+    limits.maxTokens = 10;
+    limits.maxStackDepth = 3;
+    limits.maxNestingDepth = 2;
+    limits.maxCalls = 1;
+    limits.maxRegexes = 1;
+    limits.maxRegexComplexity = 100;
+    evaluator->setLimits(limits);
+
+    ASSERT_EQ(std::optional<std::string>{"xbc"}, evaluator->evaluate("REPLACE(abc, \"a+\", x)"));
+}
+
+TEST_F(CostModelTests, negativeTest_Length)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxLength = 10;
+    evaluator->setLimits(limits);
+
+    try
+    {
+        evaluator->compile("A + B + C + D", {"A", "B", "C", "D"});
+        FAIL() << "Long expression is compiled";
+    }
+    catch (const s2e2::Error& error)
+    {
+        ASSERT_STREQ("Evaluator: expression length 13 exceeds limit 10", error.what());
+    }
+}
+
+TEST_F(CostModelTests, negativeTest_Tokens)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxTokens = 5;
+    evaluator->setLimits(limits);
+
+    ASSERT_THROW(evaluator->evaluate("a + b + c + d"), s2e2::Error);
+    ASSERT_THROW(evaluator->compileRuleSet({"a", "a + b + c + d"}), s2e2::Error);
+}
+
+TEST_F(CostModelTests, negativeTest_StackDepth)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxStackDepth = 3;
+    evaluator->setLimits(limits);
+
+    ASSERT_NO_THROW(evaluator->compile("A + B + C + D", {"A", "B", "C", "D"}));
+    ASSERT_THROW(evaluator->compile("A + (B + (C + D))", {"A", "B", "C", "D"}), s2e2::Error);
+}
+
+TEST_F(CostModelTests, negativeTest_NestingDepth)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxStackDepth = 3;
+    limits.maxNestingDepth = 64;
+    evaluator->setLimits(limits);
+
+    std::string chain = "A == a0";
+    for (size_t i = 1; i < 100000; ++i)
+    {
+        chain += " || A == a" + std::to_string(i);
+    }
+
+    try
+    {
+        evaluator->compile(chain, {"A"});
+        FAIL() << "Deeply nested expression is compiled";
+    }
+    catch (const s2e2::Error& error)
+    {
+        ASSERT_STREQ("Evaluator: nesting depth 100001 exceeds limit 64", error.what());
+    }
+}
+
+TEST_F(CostModelTests, negativeTest_Calls)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxCalls = 2;
+    evaluator->setLimits(limits);
+
+    ASSERT_THROW(evaluator->compile("IF(A == a, b, A + c)", {"A"}), s2e2::Error);
+}
+
+TEST_F(CostModelTests, negativeTest_Regexes)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxRegexes = 1;
+    evaluator->setLimits(limits);
+
+    ASSERT_THROW(evaluator->compile("REPLACE(REPLACE(A, a, b), b, c)", {"A"}), s2e2::Error);
+}
+
+TEST_F(CostModelTests, negativeTest_RegexComplexity)
+{
+    s2e2::ExpressionLimits limits;
+    limits.maxRegexComplexity = 500;
+    evaluator->setLimits(limits);
+
+    ASSERT_NO_THROW(evaluator->compile("REPLACE(A, \"a+b*\", c)", {"A"}));
+    ASSERT_THROW(evaluator->compile("REPLACE(A, \"(a+)+b\", c)", {"A"}), s2e2::Error);
+    ASSERT_THROW(evaluator->compile("REPLACE(A, B, c)", {"A", "B"}), s2e2::Error);
+}
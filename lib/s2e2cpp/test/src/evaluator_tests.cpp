@@ -7,14 +7,21 @@
 
 #include <s2e2/error.hpp>
 #include <s2e2/function.hpp>
+#include <s2e2/functions/function_concat.hpp>
 #include <s2e2/operator.hpp>
+#include <s2e2/record_batch.hpp>
 
 #include <gtest/gtest.h>
 
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <optional>
+#include <stack>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <typeinfo>
 
 
 using namespace ::testing;
@@ -24,6 +31,88 @@ namespace
     const std::string DUMMY_FUNCTION_NAME = "Function";
     const std::string DUMMY_OPERATOR_NAME = "Operator";
     const uint_fast16_t DUMMY_OPERATOR_PRIORITY = 1;
+
+    /**
+     * @brief Custom function wrapping the result of CONCAT, which it invokes from its own result(), in its arguments.
+     */
+    class FunctionWrap final : public s2e2::Function
+    {
+    public:
+        FunctionWrap()
+            : s2e2::Function("WRAP", 2)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return arguments_[0].type() == typeid(std::string) && arguments_[1].type() == typeid(std::string);
+        }
+
+        std::any result() const override
+        {
+            std::stack<std::any> stack;
+            for (const auto* part : {"<", "x", "y", "z", "w", ">"})
+            {
+                stack.push(std::string{part});
+            }
+            s2e2::FunctionConcat().invoke(stack, 6);
+
+            return std::any_cast<const std::string&>(arguments_[0]) + std::any_cast<const std::string&>(stack.top()) +
+                   std::any_cast<const std::string&>(arguments_[1]);
+        }
+    };
+
+    /**
+     * @brief Custom function checking if its argument is not NULL.
+     */
+    class FunctionIsSet final : public s2e2::Function
+    {
+    public:
+        FunctionIsSet()
+            : s2e2::Function("IS_SET", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            return {arguments_[0].has_value()};
+        }
+    };
+
+    /**
+     * @brief Custom function counting its invocations and returning its argument.
+     */
+    class FunctionTick final : public s2e2::Function
+    {
+    public:
+        explicit FunctionTick(size_t& invocations)
+            : s2e2::Function("TICK", 1)
+            , invocations_{invocations}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            ++invocations_;
+            return arguments_[0];
+        }
+
+    private:
+        size_t& invocations_;
+    };
 }
 
 class EvaluatorTests : public testing::Test
@@ -172,9 +261,31 @@ TEST_F(EvaluatorTests, positiveTest_AddOperator_VerifyTokenizer)
 {
 	makeMockedEvaluator();
 
-    EXPECT_CALL(*tokenizerMock, addOperator(DUMMY_OPERATOR_NAME)).Times(1);
+    EXPECT_CALL(*tokenizerMock, addOperator(DUMMY_OPERATOR_NAME, DUMMY_OPERATOR_PRIORITY)).Times(1);
+
+    evaluator->addOperator(dummyOperator());
+}
+
+TEST_F(EvaluatorTests, positiveTest_AddOperatorToSharedRegistry_VerifyClones)
+{
+	makeMockedEvaluator();
+    const auto shared = evaluator->registry();
+
+    auto tokenizerClone = std::make_unique<TokenizerNiceMock>();
+    auto converterClone = std::make_unique<ConverterNiceMock>();
+    EXPECT_CALL(*tokenizerClone, addOperator(DUMMY_OPERATOR_NAME, DUMMY_OPERATOR_PRIORITY)).Times(1);
+    EXPECT_CALL(*converterClone, addOperator(DUMMY_OPERATOR_NAME, DUMMY_OPERATOR_PRIORITY)).Times(1);
+    EXPECT_CALL(*tokenizerMock, addOperator(_, _)).Times(0);
+    EXPECT_CALL(*converterMock, addOperator(_, _)).Times(0);
+    EXPECT_CALL(*tokenizerMock, clone())
+        .WillOnce(Return(ByMove(std::unique_ptr<s2e2::ITokenizer>{std::move(tokenizerClone)})));
+    EXPECT_CALL(*converterMock, clone())
+        .WillOnce(Return(ByMove(std::unique_ptr<s2e2::IConverter>{std::move(converterClone)})));
 
     evaluator->addOperator(dummyOperator());
+
+    ASSERT_EQ(1, evaluator->getOperators().size());
+    ASSERT_EQ(0, shared->getOperators().size());
 }
 
 TEST_F(EvaluatorTests, positiveTest_AddStandardFunctions_SupportedFunctionsSize)
@@ -288,6 +399,32 @@ TEST_F(EvaluatorTests, positiveTest_NestedFunction_EvaluationResult)
     ASSERT_EQ("EBC", *result);
 }
 
+TEST_F(EvaluatorTests, positiveTest_ReentrantFunction_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->addFunction(std::make_unique<FunctionWrap>());
+
+    const auto result = evaluator->evaluate("WRAP(a, b) + WRAP(CONCAT(c, d), WRAP(e, f))");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("a<xyzw>bcd<xyzw>e<xyzw>f", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_Invocation_ReleasesArguments)
+{
+    const auto payload = std::make_shared<int>(0);
+    std::stack<std::any> stack;
+    stack.push(payload);
+
+    FunctionIsSet().invoke(stack);
+
+    ASSERT_EQ(1, payload.use_count());
+    ASSERT_TRUE(std::any_cast<bool>(stack.top()));
+}
+
 TEST_F(EvaluatorTests, positiveTest_TwoFunctionsOneOperator_EvaluationResult)
 {
 	makeRealEvaluator();
@@ -339,6 +476,496 @@ TEST_F(EvaluatorTests, positiveTest_NullAsResult_EvaluationResult)
     ASSERT_FALSE(result);
 }
 
+TEST_F(EvaluatorTests, positiveTest_AndShortCircuit_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->setShortCircuit(true);
+
+    const auto result = evaluator->evaluate("IF(A == B && A < NULL, Wrong, Correct)");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("Correct", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_OrShortCircuit_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->setShortCircuit(true);
+
+    const auto result = evaluator->evaluate("IF(A == A || A < NULL, Correct, Wrong)");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("Correct", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_IfSkipsOtherBranch_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->setShortCircuit(true);
+
+    const auto result = evaluator->evaluate("IF(A == A, Correct, A < NULL)");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("Correct", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_NoShortCircuit_AllArgumentsEvaluated)
+{
+	makeRealEvaluator();
+
+    size_t invocations = 0;
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->addFunction(std::make_unique<FunctionTick>(invocations));
+
+    const auto result = evaluator->evaluate("IF(A == A || TICK(A) == A, TICK(Correct), TICK(Wrong))");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("Correct", *result);
+    ASSERT_EQ(3, invocations);
+
+    evaluator->setShortCircuit(true);
+    evaluator->evaluate("IF(A == A || TICK(A) == A, TICK(Correct), TICK(Wrong))");
+
+    ASSERT_EQ(4, invocations);
+}
+
+TEST_F(EvaluatorTests, positiveTest_LongOrChain_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    std::string expression = "a0 == b0";
+    for (size_t i = 1; i < 100000; ++i)
+    {
+        expression += " || a" + std::to_string(i) + " == b" + std::to_string(i);
+    }
+
+    const auto result = evaluator->evaluate("IF(" + expression + ", t, f)");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("f", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_DeeplyNestedIf_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const size_t depth = 100000;
+    std::string expression;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        expression += "IF(a == b" + std::to_string(i) + ", x, ";
+    }
+    expression += "z" + std::string(depth, ')');
+
+    const auto result = evaluator->evaluate(expression);
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("z", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_EqualityChain_CompiledIntoMembership)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("A == x || A == y || z == A || A == NULL", {"A"});
+
+    ASSERT_EQ(2, program->instructions.size());
+    ASSERT_EQ(s2e2::InstructionType::MEMBERSHIP, program->instructions.back().type);
+    ASSERT_EQ(1, program->sets.size());
+}
+
+TEST_F(EvaluatorTests, positiveTest_EqualityChain_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("IF(A == x || A == y || A == NULL, In, Out)", {"A"});
+    const std::vector<s2e2::VariableValue> values = {"x", "y", std::nullopt, "z", ""};
+    const auto records = s2e2::RecordBatch::rowMajor(values, values.size(), 1);
+
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 0));
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 1));
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 2));
+    ASSERT_EQ(std::optional<std::string>{"Out"}, evaluator->evaluate(*program, records, 3));
+    ASSERT_EQ(std::optional<std::string>{"Out"}, evaluator->evaluate(*program, records, 4));
+}
+
+TEST_F(EvaluatorTests, positiveTest_InequalityChain_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("IF(A != x && A != y && A != z, Out, In)", {"A"});
+    const std::vector<s2e2::VariableValue> values = {"y", std::nullopt};
+    const auto records = s2e2::RecordBatch::rowMajor(values, values.size(), 1);
+
+    ASSERT_EQ(s2e2::InstructionType::MEMBERSHIP, program->instructions[1].type);
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 0));
+    ASSERT_EQ(std::optional<std::string>{"Out"}, evaluator->evaluate(*program, records, 1));
+}
+
+TEST_F(EvaluatorTests, positiveTest_LongEqualityChain_CompiledIntoMembership)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const size_t numberOfOperands = 50000;
+    std::string rewritable = "A == x0";
+    std::string mixed = "A == x0";
+    for (size_t i = 1; i < numberOfOperands; ++i)
+    {
+        rewritable += " || A == x" + std::to_string(i);
+        mixed += ((i % 2 == 0) ? " || A == x" : " || B == x") + std::to_string(i);
+    }
+
+    const auto program = evaluator->compile(rewritable, {"A"});
+    ASSERT_EQ(2, program->instructions.size());
+    ASSERT_EQ(s2e2::InstructionType::MEMBERSHIP, program->instructions.back().type);
+
+    const auto notRewritten = evaluator->compile(mixed, {"A", "B"});
+    ASSERT_EQ(4 * numberOfOperands - 1, notRewritten->instructions.size());
+    ASSERT_TRUE(notRewritten->sets.empty());
+}
+
+TEST_F(EvaluatorTests, positiveTest_MixedChain_NotRewritten)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("A == x || A == y || B == z", {"A", "B"});
+
+    ASSERT_TRUE(program->sets.empty());
+}
+
+TEST_F(EvaluatorTests, positiveTest_PlusChain_CompiledIntoConcat)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("\"Dear \" + Name + \", order \" + Id + NULL", {"Name", "Id"});
+
+    ASSERT_EQ(6, program->instructions.size());
+    ASSERT_EQ(s2e2::Builtin::CONCAT, program->instructions.back().builtin);
+    ASSERT_EQ(5, program->instructions.back().numberOfArguments);
+}
+
+TEST_F(EvaluatorTests, positiveTest_PlusChain_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("A + B + \"-\" + A", {"A", "B"});
+    const auto nulls = evaluator->compile("A + NULL + B + A", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"x", "y", std::nullopt, "y", std::nullopt, std::nullopt};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 3, 2);
+
+    ASSERT_EQ(std::optional<std::string>{"xy-x"}, evaluator->evaluate(*program, records, 0));
+    ASSERT_EQ(std::optional<std::string>{"y-"}, evaluator->evaluate(*program, records, 1));
+    ASSERT_EQ(std::optional<std::string>{"-"}, evaluator->evaluate(*program, records, 2));
+    ASSERT_EQ(std::optional<std::string>{"xyx"}, evaluator->evaluate(*nulls, records, 0));
+    ASSERT_EQ(std::nullopt, evaluator->evaluate(*nulls, records, 2));
+}
+
+TEST_F(EvaluatorTests, positiveTest_PlusChainWithCall_NotRewritten)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("A + B + REPLACE(A, x, z)", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"x", "y"};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 1, 2);
+
+    ASSERT_EQ(s2e2::Builtin::PLUS, program->instructions.back().builtin);
+    ASSERT_EQ(std::optional<std::string>{"xyz"}, evaluator->evaluate(*program, records, 0));
+}
+
+TEST_F(EvaluatorTests, positiveTest_Concat_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto result = evaluator->evaluate("CONCAT(a, NULL, CONCAT(b, c), d + e)");
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ("abcde", *result);
+}
+
+TEST_F(EvaluatorTests, positiveTest_InConstants_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("IF(IN(A + B, ab, ba, NULL), In, Out)", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"b", "a", "a", "a", std::nullopt, std::nullopt};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 3, 2);
+
+    ASSERT_EQ(1, program->sets.size());
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 0));
+    ASSERT_EQ(std::optional<std::string>{"Out"}, evaluator->evaluate(*program, records, 1));
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 2));
+}
+
+TEST_F(EvaluatorTests, positiveTest_InVariables_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const auto program = evaluator->compile("IF(IN(A, x, B, y), In, Out)", {"A", "B"});
+    const std::vector<s2e2::VariableValue> values = {"b", "b", "b", "a"};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 2, 2);
+
+    ASSERT_TRUE(program->sets.empty());
+    ASSERT_EQ(std::optional<std::string>{"In"}, evaluator->evaluate(*program, records, 0));
+    ASSERT_EQ(std::optional<std::string>{"Out"}, evaluator->evaluate(*program, records, 1));
+}
+
+TEST_F(EvaluatorTests, positiveTest_OverlappingOperators_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    // the leftmost one of overlapping operators is taken, so the rest of == is a literal
+    ASSERT_EQ(std::optional<std::string>{"f"}, evaluator->evaluate("IF(A<==B,\"t\",\"f\")"));
+    ASSERT_EQ(std::optional<std::string>{"t"}, evaluator->evaluate("IF(a>==b,\"t\",\"f\")"));
+    ASSERT_EQ(std::optional<std::string>{"t"}, evaluator->evaluate("IF(x!==y,\"t\",\"f\")"));
+
+    evaluator->freeze();
+
+    ASSERT_EQ(std::optional<std::string>{"f"}, evaluator->evaluate("IF(A<==B,\"t\",\"f\")"));
+    ASSERT_EQ(std::optional<std::string>{"t"}, evaluator->evaluate("IF(a>==b,\"t\",\"f\")"));
+    ASSERT_EQ(std::optional<std::string>{"t"}, evaluator->evaluate("IF(x!==y,\"t\",\"f\")"));
+}
+
+TEST_F(EvaluatorTests, positiveTest_Literal_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    const std::string literal = " Plain\ttext  of NULL words ";
+    const auto program = evaluator->compile(literal, {"A"});
+    const std::vector<s2e2::VariableValue> values = {"a"};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 1, 1);
+
+    ASSERT_EQ(std::optional<std::string_view>{literal}, evaluator->asLiteral(literal));
+    ASSERT_EQ(std::optional<std::string>{literal}, evaluator->evaluate(literal));
+    ASSERT_EQ(std::optional<std::string>{literal}, evaluator->evaluate(*program, records, 0));
+}
+
+TEST_F(EvaluatorTests, positiveTest_NotLiteral_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_FALSE(evaluator->asLiteral("a+b"));
+    ASSERT_FALSE(evaluator->asLiteral("IF"));
+    ASSERT_FALSE(evaluator->asLiteral("\"a b\""));
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate("a+b"));
+    ASSERT_EQ(std::optional<std::string>{"yes"}, evaluator->evaluate("IF(A == A, yes, no)"));
+}
+
+TEST_F(EvaluatorTests, positiveTest_Frozen_EvaluationResult)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+    evaluator->freeze();
+    evaluator->freeze();
+
+    ASSERT_TRUE(evaluator->frozen());
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate("a+b"));
+    ASSERT_EQ(std::optional<std::string>{"yes"}, evaluator->evaluate("IF(A == A && !(A != A), yes, no)"));
+    ASSERT_EQ(std::optional<std::string>{"plain text"}, evaluator->evaluate("plain text"));
+}
+
+TEST_F(EvaluatorTests, negativeTest_AddAfterFreeze)
+{
+	makeRealEvaluator();
+
+    evaluator->freeze();
+
+    ASSERT_THROW(evaluator->addStandardFunctions(), s2e2::Error);
+    ASSERT_THROW(evaluator->addOperator(dummyOperator()), s2e2::Error);
+    ASSERT_TRUE(evaluator->getFunctions().empty());
+    ASSERT_TRUE(evaluator->getOperators().empty());
+}
+
+TEST_F(EvaluatorTests, negativeTest_EqualityChainNotStringOperand)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("IF((A == B) == x || (A == B) == y || (A == B) == z, Wrong, Wrong)");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid arguments for operator ==", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_ConcatNotStringArgument)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("CONCAT(a, b, a == b)");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid arguments for function CONCAT", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_InTooFewArguments)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("IN(A)");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid number of arguments for function IN", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_InIsReserved)
+{
+    makeRealEvaluator();
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    // IN used to be a plain literal, now it has to be quoted
+    ASSERT_EQ(std::optional<std::string>{"Code:IN"}, evaluator->evaluate("Code + \":\" + \"IN\""));
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("Code + \":\" + IN");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid number of arguments for function IN", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_ConcatIsReserved)
+{
+    makeRealEvaluator();
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    // CONCAT used to be a plain literal, now it has to be quoted
+    ASSERT_EQ(std::optional<std::string>{"Code:CONCAT"}, evaluator->evaluate("Code + \":\" + \"CONCAT\""));
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("Code + \":\" + CONCAT");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid number of arguments for function CONCAT", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_AndNotBooleanOperand)
+{
+	makeRealEvaluator();
+
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_THROW(evaluator->evaluate("IF(A && A == A, Wrong, Wrong)"), s2e2::Error);
+}
+
+TEST_F(EvaluatorTests, negativeTest_NoShortCircuit_SkippableOperandFails)
+{
+    makeRealEvaluator();
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate("IF(A == B && A < NULL, Wrong, Correct)");
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_STREQ("Invalid arguments for operator <", e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
 TEST_F(EvaluatorTests, negativeTest_AddEmptyFunctionPointer)
 {
     makeRealEvaluator();
@@ -541,3 +1168,26 @@ TEST_F(EvaluatorTests, negativeTest_FewOperators)
         }
     }, s2e2::Error);
 }
+
+TEST_F(EvaluatorTests, negativeTest_ManyArguments)
+{
+    makeRealEvaluator();
+    evaluator->addStandardFunctions();
+    evaluator->addStandardOperators();
+
+    // the call given too many arguments fails on its own arguments rather than the whole expression
+    for (const auto* expression : {"IF(A == A, \"x\", \"y\", \"z\")", "IF(A == A, \"x\", NOW(1))"})
+    {
+        ASSERT_THROW({
+            try
+            {
+                evaluator->evaluate(expression);
+            }
+            catch (const s2e2::Error& e)
+            {
+                ASSERT_STREQ("Invalid arguments for function IF", e.what());
+                throw;
+            }
+        }, s2e2::Error) << expression;
+    }
+}
@@ -0,0 +1,333 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/execution_limits.hpp>
+#include <s2e2/expression_graph.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/record_batch.hpp>
+#include <s2e2/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument and cancelling the token if the argument is "stop".
+     */
+    class FunctionCancel final : public s2e2::Function
+    {
+    public:
+        explicit FunctionCancel(s2e2::CancellationToken& token)
+            : s2e2::Function("CANCEL", 1)
+            , token_{token}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            const auto* value = std::any_cast<std::string>(&arguments_[0]);
+            if (value && *value == "stop")
+            {
+                token_.cancel();
+            }
+            return arguments_[0];
+        }
+
+    private:
+        s2e2::CancellationToken& token_;
+    };
+
+    /**
+     * @brief Custom function returning its argument after a short sleep.
+     */
+    class FunctionSleep final : public s2e2::Function
+    {
+    public:
+        FunctionSleep()
+            : s2e2::Function("SLEEP", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return arguments_[0];
+        }
+    };
+
+    /**
+     * @brief Evaluate the expression and get reason it is aborted with.
+     * @param[in] evaluator - Evaluator.
+     * @param[in] expression - Compiled expression.
+     * @param[in] values - Values of variables.
+     * @returns Reason or empty value if the evaluation is not aborted.
+     */
+    std::optional<s2e2::AbortedError::Reason> abortReason(const s2e2::Evaluator& evaluator,
+                                                          const s2e2::CompiledExpression& expression,
+                                                          const std::vector<s2e2::VariableValue>& values)
+    {
+        try
+        {
+            evaluator.evaluate(expression, values);
+        }
+        catch (const s2e2::AbortedError& error)
+        {
+            return error.reason();
+        }
+        return {};
+    }
+}
+
+class ExecutionLimitsTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        token = std::make_shared<s2e2::CancellationToken>();
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionCancel>(*token));
+        evaluator->addFunction(std::make_unique<FunctionSleep>());
+	}
+
+protected:
+	std::shared_ptr<s2e2::CancellationToken> token;
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(ExecutionLimitsTests, positiveTest_CancelledToken_Aborted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.cancellation = token;
+    evaluator->setExecutionLimits(limits);
+    const auto expression = evaluator->compile("A + B", {"A", "B"});
+
+    token->cancel();
+
+    ASSERT_EQ(s2e2::AbortedError::Reason::CANCELLED,
+              abortReason(*evaluator, expression, {std::string_view{"a"}, std::string_view{"b"}}));
+
+    token->reset();
+
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate(expression, {std::string_view{"a"}, std::string_view{"b"}}));
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_CancelledDuringEvaluation_Aborted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.cancellation = token;
+    evaluator->setExecutionLimits(limits);
+    const auto expression = evaluator->compile("CANCEL(A) + B", {"A", "B"});
+
+    ASSERT_EQ(s2e2::AbortedError::Reason::CANCELLED,
+              abortReason(*evaluator, expression, {std::string_view{"stop"}, std::string_view{"b"}}));
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_CancelledDuringBatch_WholeBatchAborted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.cancellation = token;
+    evaluator->setExecutionLimits(limits);
+
+    s2e2::ThreadPoolOptions options;
+    options.numberOfThreads = 4;
+    options.grainSize = 64;
+    evaluator->setThreadPool(std::make_shared<s2e2::ThreadPool>(options));
+
+    const size_t numberOfRecords = 10000;
+    std::vector<s2e2::VariableValue> values(numberOfRecords, std::string_view{"go"});
+    values[numberOfRecords / 2] = std::string_view{"stop"};
+    const auto records = s2e2::RecordBatch::rowMajor(values, numberOfRecords, 1);
+    const auto expression = evaluator->compile("CANCEL(A) + x", {"A"});
+
+    for (const auto mode : {s2e2::ExecutionMode::SCALAR, s2e2::ExecutionMode::VECTORIZED})
+    {
+        token->reset();
+        std::vector<std::optional<std::string>> results(numberOfRecords);
+        std::vector<s2e2::RecordStatus> statuses(numberOfRecords);
+
+        ASSERT_THROW(evaluator->evaluateBatch(expression, records, results, statuses, mode), s2e2::AbortedError);
+    }
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_CancelledRulesAndGraph_Aborted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.cancellation = token;
+    evaluator->setExecutionLimits(limits);
+
+    const auto rules = evaluator->compileRuleSet({"CANCEL(A) + a", "A + b", "A + c"}, {"A"});
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    ASSERT_THROW(evaluator->evaluateRules(rules, {std::string_view{"stop"}}, results, statuses), s2e2::AbortedError);
+    token->reset();
+    ASSERT_THROW(evaluator->evaluateFirstMatch(rules, {std::string_view{"stop"}}), s2e2::AbortedError);
+    token->reset();
+
+    const auto graph = evaluator->compileGraph({{"X", "CANCEL(A)"}, {"Y", "X + y"}}, {"A"});
+    results.resize(2);
+    statuses.resize(2);
+    ASSERT_THROW(evaluator->evaluateGraph(graph, {std::string_view{"stop"}}, results, statuses), s2e2::AbortedError);
+    token->reset();
+
+    ASSERT_EQ(0, evaluator->evaluateGraph(graph, {std::string_view{"go"}}, results, statuses));
+    ASSERT_EQ(std::optional<std::string>{"goy"}, results[1]);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_PastDeadline_NotStarted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    evaluator->setExecutionLimits(limits);
+
+    const auto expression = evaluator->compile("A", {"A"});
+
+    ASSERT_EQ(s2e2::AbortedError::Reason::DEADLINE_EXCEEDED, abortReason(*evaluator, expression, {std::string_view{"a"}}));
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_TimeoutOfBatch_Aborted)
+{
+    s2e2::ExecutionLimits limits;
+    limits.timeout = std::chrono::milliseconds(20);
+    evaluator->setExecutionLimits(limits);
+
+    // running all records would take at least a second
+    const size_t numberOfRecords = 1000;
+    std::vector<s2e2::VariableValue> values(numberOfRecords, std::string_view{"a"});
+    const auto records = s2e2::RecordBatch::rowMajor(values, numberOfRecords, 1);
+    const auto expression = evaluator->compile("SLEEP(A)", {"A"});
+    std::vector<std::optional<std::string>> results(numberOfRecords);
+    std::vector<s2e2::RecordStatus> statuses(numberOfRecords);
+
+    const auto start = std::chrono::steady_clock::now();
+    try
+    {
+        evaluator->evaluateBatch(expression, records, results, statuses);
+        FAIL() << "Batch is not aborted";
+    }
+    catch (const s2e2::AbortedError& error)
+    {
+        ASSERT_EQ(s2e2::AbortedError::Reason::DEADLINE_EXCEEDED, error.reason());
+    }
+    ASSERT_GT(std::chrono::milliseconds(500), std::chrono::steady_clock::now() - start);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_TimeoutInsideReplace_Aborted)
+{
+    const std::string source(1000000, 'a');
+    const auto expression = evaluator->compile("REPLACE(A, a, b)", {"A"});
+
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(std::optional<std::string>{std::string(source.size(), 'b')}, evaluator->evaluate(expression, {source}));
+    const auto unlimited = std::chrono::steady_clock::now() - start;
+
+    s2e2::ExecutionLimits limits;
+    limits.timeout = unlimited / 20;
+    evaluator->setExecutionLimits(limits);
+
+    const auto limitedStart = std::chrono::steady_clock::now();
+    ASSERT_EQ(s2e2::AbortedError::Reason::DEADLINE_EXCEEDED, abortReason(*evaluator, expression, {source}));
+    ASSERT_GT(unlimited / 2, std::chrono::steady_clock::now() - limitedStart);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_LongConcatenation_SizeLimitError)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 5;
+    evaluator->setExecutionLimits(limits);
+    const auto expression = evaluator->compile("A + A", {"A"});
+
+    ASSERT_EQ(std::optional<std::string>{"abab"}, evaluator->evaluate(expression, {std::string_view{"ab"}}));
+    ASSERT_THROW(evaluator->evaluate(expression, {std::string_view{"abc"}}), s2e2::SizeLimitError);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_LongPlusChain_FirstOverflowReported)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 5;
+    evaluator->setExecutionLimits(limits);
+    const auto expression = evaluator->compile("A + A + A + A", {"A"});
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluate(expression, {std::string_view{"ab"}});
+        }
+        catch (const s2e2::SizeLimitError& e)
+        {
+            ASSERT_STREQ("Evaluator: string size 6 exceeds limit 5", e.what());
+            throw;
+        }
+    }, s2e2::SizeLimitError);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_GrowingReplace_SizeLimitError)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 1000;
+    evaluator->setExecutionLimits(limits);
+    const auto expression = evaluator->compile("REPLACE(A, a, aaaa)", {"A"});
+
+    ASSERT_EQ(std::optional<std::string>{std::string(400, 'a')}, evaluator->evaluate(expression, {std::string(100, 'a')}));
+    ASSERT_THROW(evaluator->evaluate(expression, {std::string(300, 'a')}), s2e2::SizeLimitError);
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_SizeLimitInBatch_RecordFailed)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 6;
+    evaluator->setExecutionLimits(limits);
+
+    const std::vector<s2e2::VariableValue> values = {"ab", "cd", "abcd", "efgh", "x", std::nullopt};
+    const auto records = s2e2::RecordBatch::rowMajor(values, 3, 2);
+    const auto expression = evaluator->compile("A + B + A", {"A", "B"});
+    const std::vector<std::optional<std::string>> expected = {"abcdab", std::nullopt, "xx"};
+    const std::vector<s2e2::RecordStatus> expectedStatuses = {s2e2::RecordStatus::OK, s2e2::RecordStatus::ERROR, s2e2::RecordStatus::OK};
+
+    for (const auto mode : {s2e2::ExecutionMode::SCALAR, s2e2::ExecutionMode::VECTORIZED})
+    {
+        std::vector<std::optional<std::string>> results(3);
+        std::vector<s2e2::RecordStatus> statuses(3);
+
+        ASSERT_EQ(1, evaluator->evaluateBatch(expression, records, results, statuses, mode));
+        ASSERT_EQ(expected, results);
+        ASSERT_EQ(expectedStatuses, statuses);
+    }
+}
+
+TEST_F(ExecutionLimitsTests, positiveTest_SizeLimitInRules_RuleFailed)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 4;
+    evaluator->setExecutionLimits(limits);
+
+    const auto rules = evaluator->compileRuleSet({"A + A + A", "A + A", "REPLACE(A, a, xyzw)"}, {"A"});
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    ASSERT_EQ(2, evaluator->evaluateRules(rules, {std::string_view{"ab"}}, results, statuses));
+    ASSERT_EQ((std::vector<s2e2::RecordStatus>{s2e2::RecordStatus::ERROR, s2e2::RecordStatus::OK, s2e2::RecordStatus::ERROR}), statuses);
+    ASSERT_EQ(std::optional<std::string>{"abab"}, results[1]);
+}
@@ -0,0 +1,104 @@
+#include "../test_utils.hpp"
+
+#include <s2e2/error.hpp>
+#include <s2e2/functions/function_concat.hpp>
+
+#include <gtest/gtest.h>
+
+#include <typeinfo>
+
+
+TEST(FunctionConcatTests, positiveTest_ManyStrings_StackSize)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"B"}, std::string{"C"}, std::string{"D"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_EQ(1, stack.size());
+}
+
+TEST(FunctionConcatTests, positiveTest_ManyStrings_ResultType)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"B"}, std::string{"C"}, std::string{"D"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_TRUE(stack.top().has_value());
+    ASSERT_EQ(typeid(std::string), stack.top().type());
+}
+
+TEST(FunctionConcatTests, positiveTest_ManyStrings_ResultValue)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"Dear "}, std::string{"John"}, std::string{", order "}, std::string{"42"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_EQ("Dear John, order 42", std::any_cast<std::string>(stack.top()));
+}
+
+TEST(FunctionConcatTests, positiveTest_MinimalNumberOfArguments_ResultValue)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"B"});
+
+    function.invoke(stack);
+
+    ASSERT_EQ("AB", std::any_cast<std::string>(stack.top()));
+}
+
+TEST(FunctionConcatTests, positiveTest_SomeNulls_ResultValue)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::any{}, std::string{"A"}, std::any{}, std::string{"B"}, std::any{});
+
+    function.invoke(stack, 5);
+
+    ASSERT_EQ("AB", std::any_cast<std::string>(stack.top()));
+}
+
+TEST(FunctionConcatTests, positiveTest_AllNulls_ResultIsNull)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::any{}, std::any{}, std::any{});
+
+    function.invoke(stack, 3);
+
+    ASSERT_FALSE(stack.top().has_value());
+}
+
+TEST(FunctionConcatTests, positiveTest_NumberOfArguments_IsMinimal)
+{
+	s2e2::FunctionConcat function;
+
+    ASSERT_EQ(2, function.numberOfArguments());
+    ASSERT_TRUE(function.isVariadic());
+}
+
+TEST(FunctionConcatTests, negativeTest_ArgumentWrongType)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"A"}, true, std::string{"B"});
+
+    ASSERT_THROW({
+        try
+        {
+            function.invoke(stack, 3);
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_EQ("Invalid arguments for function " + function.name, e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST(FunctionConcatTests, negativeTest_TooFewArguments)
+{
+	s2e2::FunctionConcat function;
+    auto stack = TestUtils::createStack(std::string{"A"});
+
+    ASSERT_THROW(function.invoke(stack, 1), s2e2::Error);
+}
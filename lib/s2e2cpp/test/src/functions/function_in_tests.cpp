@@ -0,0 +1,140 @@
+#include "../test_utils.hpp"
+
+#include <s2e2/error.hpp>
+#include <s2e2/functions/function_in.hpp>
+
+#include <gtest/gtest.h>
+
+#include <typeinfo>
+
+
+TEST(FunctionInTests, positiveTest_ManyCandidates_StackSize)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"B"}, std::string{"A"}, std::string{"B"}, std::string{"C"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_EQ(1, stack.size());
+}
+
+TEST(FunctionInTests, positiveTest_ManyCandidates_ResultType)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"B"}, std::string{"A"}, std::string{"B"}, std::string{"C"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_TRUE(stack.top().has_value());
+    ASSERT_EQ(typeid(bool), stack.top().type());
+}
+
+TEST(FunctionInTests, positiveTest_ValueIsCandidate_ResultValue)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"B"}, std::string{"A"}, std::string{"B"}, std::string{"C"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_TRUE(std::any_cast<bool>(stack.top()));
+}
+
+TEST(FunctionInTests, positiveTest_ValueIsNotCandidate_ResultValue)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"D"}, std::string{"A"}, std::string{"B"}, std::string{"C"});
+
+    function.invoke(stack, 4);
+
+    ASSERT_FALSE(std::any_cast<bool>(stack.top()));
+}
+
+TEST(FunctionInTests, positiveTest_MinimalNumberOfArguments_ResultValue)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"A"});
+
+    function.invoke(stack);
+
+    ASSERT_TRUE(std::any_cast<bool>(stack.top()));
+}
+
+TEST(FunctionInTests, positiveTest_NullValueNullCandidate_ResultValue)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::any{}, std::string{"A"}, std::any{});
+
+    function.invoke(stack, 3);
+
+    ASSERT_TRUE(std::any_cast<bool>(stack.top()));
+}
+
+TEST(FunctionInTests, positiveTest_NullValueNoNullCandidate_ResultValue)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::any{}, std::string{"A"}, std::string{"B"});
+
+    function.invoke(stack, 3);
+
+    ASSERT_FALSE(std::any_cast<bool>(stack.top()));
+}
+
+TEST(FunctionInTests, positiveTest_NumberOfArguments_IsMinimal)
+{
+	s2e2::FunctionIn function;
+
+    ASSERT_EQ(2, function.numberOfArguments());
+    ASSERT_TRUE(function.isVariadic());
+}
+
+TEST(FunctionInTests, negativeTest_ValueWrongType)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(5, std::string{"A"}, std::string{"B"});
+
+    ASSERT_THROW({
+        try
+        {
+            function.invoke(stack, 3);
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_EQ("Invalid arguments for function " + function.name, e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST(FunctionInTests, negativeTest_CandidateWrongType)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"A"}, true);
+
+    ASSERT_THROW(function.invoke(stack, 3), s2e2::Error);
+}
+
+TEST(FunctionInTests, negativeTest_TooFewArguments)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"A"});
+
+    ASSERT_THROW({
+        try
+        {
+            function.invoke(stack, 1);
+        }
+        catch (const s2e2::Error& e)
+        {
+            ASSERT_EQ("Invalid number of arguments for function " + function.name, e.what());
+            throw;
+        }
+    }, s2e2::Error);
+}
+
+TEST(FunctionInTests, negativeTest_NotEnoughArgumentsOnStack)
+{
+	s2e2::FunctionIn function;
+    auto stack = TestUtils::createStack(std::string{"A"}, std::string{"A"});
+
+    ASSERT_THROW(function.invoke(stack, 3), s2e2::Error);
+}
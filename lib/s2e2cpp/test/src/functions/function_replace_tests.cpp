@@ -62,6 +62,22 @@ TEST(FunctionReplaceTests, positiveTest_SpecialSymbolReplace_ResultValue)
     ASSERT_EQ(std::string{"A + B == C"}, std::any_cast<std::string>(stack.top()));
 }
 
+TEST(FunctionReplaceTests, positiveTest_AlternatingPatterns_ResultValues)
+{
+	s2e2::FunctionReplace function;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto first = TestUtils::createStack(std::string{"ABCABA"}, std::string{"A.*?C"}, std::string{"D"});
+        function.invoke(first);
+        ASSERT_EQ(std::string{"DABA"}, std::any_cast<std::string>(first.top()));
+
+        auto second = TestUtils::createStack(std::string{"ABCABA"}, std::string{"B"}, std::string{"E"});
+        function.invoke(second);
+        ASSERT_EQ(std::string{"AECAEA"}, std::any_cast<std::string>(second.top()));
+    }
+}
+
 TEST(FunctionReplaceTests, positiveTest_FirstArgumentNull_ResultValue)
 {
 	s2e2::FunctionReplace function;
@@ -0,0 +1,215 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/expression_graph.hpp>
+#include <s2e2/function.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument and counting its invocations.
+     */
+    class FunctionCount final : public s2e2::Function
+    {
+    public:
+        explicit FunctionCount(size_t& invocations)
+            : s2e2::Function("COUNT", 1)
+            , invocations_{invocations}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            ++invocations_;
+            return arguments_[0];
+        }
+
+    private:
+        size_t& invocations_;
+    };
+
+    /// @brief Names and expressions of fields.
+    using Fields = std::vector<std::pair<std::string, std::string>>;
+}
+
+class GraphTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionCount>(invocations));
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+    size_t invocations = 0;
+};
+
+TEST_F(GraphTests, positiveTest_Chain_Results)
+{
+    // Total refers to Net before it is defined
+    const auto graph = evaluator->compileGraph({{"Total", "Net + _total"},
+                                                {"Net", "Price + _net"},
+                                                {"Label", "IF(Total == 1_net_total, cheap, expensive)"}},
+                                               {"Price"});
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    const auto failures = evaluator->evaluateGraph(graph, {"1"}, results, statuses);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"1_net_total"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"1_net"}, results[1]);
+    ASSERT_EQ(std::optional<std::string>{"cheap"}, results[2]);
+}
+
+TEST_F(GraphTests, positiveTest_Order_DependenciesFirst)
+{
+    const auto graph = evaluator->compileGraph({{"C", "A + B"}, {"B", "A + b"}, {"A", "X"}, {"D", "d"}}, {"X"});
+
+    const auto order = graph.order();
+    const auto position = [&order](size_t field) { return std::find(order.begin(), order.end(), field) - order.begin(); };
+
+    ASSERT_EQ(4, order.size());
+    ASSERT_LT(position(2), position(1));
+    ASSERT_LT(position(1), position(0));
+    ASSERT_EQ((std::vector<std::string>{"C", "B", "A", "D"}), graph.names());
+    ASSERT_EQ((std::vector<std::string>{"X"}), graph.variables());
+}
+
+TEST_F(GraphTests, positiveTest_SharedField_EvaluatedOnce)
+{
+    const auto graph = evaluator->compileGraph({{"A", "COUNT(X)"}, {"B", "A + b"}, {"C", "A + c"}, {"D", "B + C"}},
+                                               {"X"});
+    std::vector<std::optional<std::string>> results(4);
+    std::vector<s2e2::RecordStatus> statuses(4);
+
+    evaluator->evaluateGraph(graph, {"x"}, results, statuses);
+
+    ASSERT_EQ(1, invocations);
+    ASSERT_EQ(std::optional<std::string>{"xbxc"}, results[3]);
+}
+
+TEST_F(GraphTests, positiveTest_FailedField_DependentsFail)
+{
+    const auto graph = evaluator->compileGraph({{"A", "IF(X < NULL, a, b)"}, {"B", "A + b"}, {"C", "X + c"}}, {"X"});
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    const auto failures = evaluator->evaluateGraph(graph, {"x"}, results, statuses);
+
+    ASSERT_EQ(2, failures);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[0]);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[1]);
+    ASSERT_FALSE(results[1]);
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[2]);
+    ASSERT_EQ(std::optional<std::string>{"xc"}, results[2]);
+}
+
+TEST_F(GraphTests, positiveTest_NullField_BoundAsNull)
+{
+    const auto graph = evaluator->compileGraph({{"A", "IF(X == x, NULL, a)"}, {"B", "IF(A == NULL, none, A)"}}, {"X"});
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateGraph(graph, {"x"}, results, statuses);
+
+    ASSERT_FALSE(results[0]);
+    ASSERT_EQ(std::optional<std::string>{"none"}, results[1]);
+}
+
+TEST_F(GraphTests, positiveTest_Parallel_SameAsSequential)
+{
+    // layered graph: every field refers to up to three fields of earlier layers
+    const size_t numberOfFields = 300;
+    std::mt19937 random(11);
+    Fields fields;
+    for (size_t field = 0; field < numberOfFields; ++field)
+    {
+        std::string expression = "X + f" + std::to_string(field);
+        if (field >= 10)
+        {
+            const auto pick = [&random, field]() { return std::to_string(random() % (field - field % 10)); };
+            expression = "IF(N" + pick() + " < N" + pick() + ", N" + pick() + " + a, REPLACE(N" + pick() + ", a, b))";
+        }
+        fields.emplace_back("N" + std::to_string(field), expression);
+    }
+    const auto graph = evaluator->compileGraph(fields, {"X"});
+
+    std::vector<std::optional<std::string>> expected(numberOfFields);
+    std::vector<s2e2::RecordStatus> expectedStatuses(numberOfFields);
+    evaluator->evaluateGraph(graph, {"x"}, expected, expectedStatuses);
+
+    evaluator->setNumberOfThreads(4);
+    for (size_t i = 0; i < 50; ++i)
+    {
+        std::vector<std::optional<std::string>> results(numberOfFields);
+        std::vector<s2e2::RecordStatus> statuses(numberOfFields);
+        evaluator->evaluateGraph(graph, {"x"}, results, statuses);
+
+        ASSERT_EQ(expected, results);
+        ASSERT_EQ(expectedStatuses, statuses);
+    }
+}
+
+TEST_F(GraphTests, negativeTest_Cycle)
+{
+    try
+    {
+        evaluator->compileGraph({{"A", "B + a"}, {"B", "C + b"}, {"C", "IF(X == x, A, c)"}, {"D", "A"}}, {"X"});
+        FAIL() << "Cycle is not detected";
+    }
+    catch (const s2e2::Error& error)
+    {
+        ASSERT_STREQ("ExpressionGraph: cycle of fields A -> B -> C -> A", error.what());
+    }
+}
+
+TEST_F(GraphTests, negativeTest_SelfReference)
+{
+    ASSERT_THROW(evaluator->compileGraph({{"A", "A + a"}}), s2e2::Error);
+}
+
+TEST_F(GraphTests, negativeTest_NameUsedTwice)
+{
+    ASSERT_THROW(evaluator->compileGraph({{"A", "a"}, {"A", "b"}}), s2e2::Error);
+    ASSERT_THROW(evaluator->compileGraph({{"X", "a"}}, {"X"}), s2e2::Error);
+}
+
+TEST_F(GraphTests, negativeTest_NumberOfValues)
+{
+    const auto graph = evaluator->compileGraph({{"A", "X + Y"}}, {"X", "Y"});
+    std::vector<std::optional<std::string>> results(1);
+    std::vector<s2e2::RecordStatus> statuses(1);
+
+    ASSERT_THROW(evaluator->evaluateGraph(graph, {"x"}, results, statuses), std::invalid_argument);
+}
+
+TEST_F(GraphTests, negativeTest_OutputsSize)
+{
+    const auto graph = evaluator->compileGraph({{"A", "a"}, {"B", "b"}});
+    std::vector<std::optional<std::string>> results(1);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    ASSERT_THROW(evaluator->evaluateGraph(graph, {}, results, statuses), std::invalid_argument);
+}
@@ -0,0 +1,197 @@
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/hot_rule_set.hpp>
+#include <s2e2/registry.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    /// @brief Number of existing FunctionVersion objects.
+    std::atomic<int> liveVersionFunctions{0};
+
+    /**
+     * @brief Custom function returning the version of the registry it is added to.
+     */
+    class FunctionVersion final : public s2e2::Function
+    {
+    public:
+        explicit FunctionVersion(uint64_t version)
+            : s2e2::Function("VERSION", 0)
+            , version_{std::to_string(version)}
+        {
+            ++liveVersionFunctions;
+        }
+
+        ~FunctionVersion() override
+        {
+            --liveVersionFunctions;
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            return version_;
+        }
+
+    private:
+        const std::string version_;
+    };
+
+    const std::vector<s2e2::VariableValue> VALUES = {std::string_view{"x"}};
+}
+
+class HotRuleSetTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        base.addStandardFunctions();
+        base.addStandardOperators();
+	}
+
+    /**
+     * @brief Make the registry with the function of the version and the rule set calling it.
+     */
+    std::pair<s2e2::Registry, s2e2::RuleSet> makeVersion(uint64_t version) const
+    {
+        auto registry = base;
+        registry.addFunction(std::make_unique<FunctionVersion>(version));
+        registry.freeze();
+
+        const s2e2::Evaluator evaluator(registry);
+        auto rules = evaluator.compileRuleSet({"IF(A == y, never, NULL)", "IF(A == x, VERSION(), NULL)", "default"}, {"A"});
+        return {registry, rules};
+    }
+
+protected:
+	s2e2::Registry base;
+};
+
+TEST_F(HotRuleSetTests, positiveTest_Publish_ReaderSeesNewVersion)
+{
+    const auto first = makeVersion(1);
+    s2e2::HotRuleSet hot(first.first, first.second);
+    s2e2::HotRuleSet::Reader reader(hot);
+    const s2e2::Evaluator evaluator(base);
+
+    ASSERT_EQ(1, reader.current().version);
+    ASSERT_EQ("1", evaluator.evaluateFirstMatch(reader.current().rules, VALUES)->value);
+
+    const auto second = makeVersion(2);
+    ASSERT_EQ(2, hot.publish(second.first, second.second));
+    ASSERT_EQ(2, hot.version());
+    ASSERT_EQ(2, reader.current().version);
+    ASSERT_EQ("2", evaluator.evaluateFirstMatch(reader.current().rules, VALUES)->value);
+    ASSERT_EQ(std::optional<std::string>{"2"}, s2e2::Evaluator(reader.current().registry).evaluate("VERSION()"));
+}
+
+TEST_F(HotRuleSetTests, positiveTest_ReplacedSnapshot_FreedAfterLastReference)
+{
+    {
+        auto first = makeVersion(1);
+        s2e2::HotRuleSet hot(first.first, first.second);
+        first = makeVersion(2);
+
+        const auto acquired = hot.acquire();
+        hot.publish(first.first, first.second);
+        first = makeVersion(3);
+        ASSERT_EQ(3, liveVersionFunctions.load());
+
+        hot.publish(first.first, first.second);
+        first = makeVersion(4);
+        ASSERT_EQ(3, liveVersionFunctions.load());
+    }
+    ASSERT_EQ(0, liveVersionFunctions.load());
+}
+
+TEST_F(HotRuleSetTests, positiveTest_ReleasedReader_ReplacedSnapshotFreed)
+{
+    auto first = makeVersion(1);
+    s2e2::HotRuleSet hot(first.first, first.second);
+    first = makeVersion(2);
+    s2e2::HotRuleSet::Reader reader(hot);
+    ASSERT_EQ(1, reader.current().version);
+
+    hot.publish(first.first, first.second);
+    first = makeVersion(3);
+    ASSERT_EQ(3, liveVersionFunctions.load());
+
+    reader.release();
+    ASSERT_EQ(2, liveVersionFunctions.load());
+    ASSERT_EQ(2, reader.current().version);
+}
+
+TEST_F(HotRuleSetTests, stressTest_PublishWhileEvaluating_ConsistentSnapshots)
+{
+    constexpr uint64_t NUMBER_OF_PUBLICATIONS = 300;
+    const auto numberOfReaders = std::max(2u, std::thread::hardware_concurrency());
+
+    const auto first = makeVersion(1);
+    s2e2::HotRuleSet hot(first.first, first.second);
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> evaluations{0};
+    std::atomic<uint64_t> mismatches{0};
+
+    std::vector<std::thread> readers;
+    for (unsigned i = 0; i < numberOfReaders; ++i)
+    {
+        readers.emplace_back([&hot, &stopping, &evaluations, &mismatches, i]()
+        {
+            const s2e2::Evaluator evaluator;
+            s2e2::HotRuleSet::Reader reader(hot);
+            uint64_t lastVersion = 0;
+
+            while (!stopping.load(std::memory_order_relaxed))
+            {
+                const auto& snapshot = reader.current();
+                const auto match = evaluator.evaluateFirstMatch(snapshot.rules, VALUES);
+                if (!match || match->value != std::to_string(snapshot.version) || snapshot.version < lastVersion)
+                {
+                    ++mismatches;
+                }
+                // ad hoc expressions are compiled by evaluators sharing the registry of the snapshot
+                if (i % 2 == 0 && s2e2::Evaluator(snapshot.registry).evaluate("VERSION()") != match->value)
+                {
+                    ++mismatches;
+                }
+                lastVersion = snapshot.version;
+                ++evaluations;
+            }
+        });
+    }
+
+    for (uint64_t version = 2; version <= NUMBER_OF_PUBLICATIONS; ++version)
+    {
+        const auto next = makeVersion(version);
+        ASSERT_EQ(version, hot.publish(next.first, next.second));
+    }
+    stopping = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(0, mismatches.load());
+    ASSERT_LT(0, evaluations.load());
+
+    // all replaced versions are freed once readers are gone, only the current one and the first one are left
+    ASSERT_EQ(2, liveVersionFunctions.load());
+}
@@ -0,0 +1,144 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/registry.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument.
+     */
+    class FunctionSame final : public s2e2::Function
+    {
+    public:
+        FunctionSame()
+            : s2e2::Function("SAME", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            return arguments_[0];
+        }
+    };
+}
+
+class RegistryTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        registry.addStandardFunctions();
+        registry.addStandardOperators();
+	}
+
+protected:
+	s2e2::Registry registry;
+};
+
+TEST_F(RegistryTests, positiveTest_SharedRegistry_SameFunctionsAndOperators)
+{
+    const s2e2::Evaluator first(registry);
+    const s2e2::Evaluator second(registry);
+
+    ASSERT_EQ(7, registry.getFunctions().size());
+    ASSERT_EQ(10, registry.getOperators().size());
+    ASSERT_EQ(registry.getFunctions(), first.getFunctions());
+    ASSERT_EQ(registry.getFunctions(), second.getFunctions());
+    ASSERT_EQ(registry.getOperators(), second.getOperators());
+    ASSERT_EQ(std::optional<std::string>{"ab"}, second.evaluate("IF(1 < 2, a + b, c)"));
+}
+
+TEST_F(RegistryTests, positiveTest_EvaluatorAddsFunction_OtherOwnersUnchanged)
+{
+    s2e2::Evaluator tenant(registry);
+    const s2e2::Evaluator other(registry);
+    tenant.addFunction(std::make_unique<FunctionSame>());
+
+    ASSERT_EQ(std::optional<std::string>{"ab"}, tenant.evaluate("SAME(a + b)"));
+    ASSERT_THROW(other.evaluate("SAME(a + b)"), s2e2::Error);
+    ASSERT_EQ(7, registry.getFunctions().size());
+    ASSERT_EQ(8, tenant.getFunctions().size());
+
+    // functions themselves are not copied
+    for (const auto* fn : registry.getFunctions())
+    {
+        ASSERT_EQ(1, tenant.getFunctions().count(fn));
+    }
+}
+
+TEST_F(RegistryTests, positiveTest_CopyAddsFunction_SourceUnchanged)
+{
+    auto copy = registry;
+    copy.addFunction(std::make_unique<FunctionSame>());
+
+    ASSERT_EQ(7, registry.getFunctions().size());
+    ASSERT_EQ(8, copy.getFunctions().size());
+    ASSERT_EQ(std::optional<std::string>{"a"}, s2e2::Evaluator(copy).evaluate("SAME(a)"));
+}
+
+TEST_F(RegistryTests, positiveTest_EvaluatorRegistry_SharesFunctions)
+{
+    s2e2::Evaluator evaluator;
+    evaluator.addStandardFunctions();
+    evaluator.addStandardOperators();
+    const s2e2::Evaluator other(evaluator.registry());
+
+    ASSERT_EQ(evaluator.getFunctions(), other.getFunctions());
+    ASSERT_EQ(evaluator.getOperators(), other.getOperators());
+
+    evaluator.addFunction(std::make_unique<FunctionSame>());
+    ASSERT_EQ(8, evaluator.getFunctions().size());
+    ASSERT_EQ(7, other.getFunctions().size());
+}
+
+TEST_F(RegistryTests, positiveTest_AddFunctionAfterCompile_CompiledExpressionValid)
+{
+    s2e2::Evaluator evaluator(registry);
+    const auto expression = evaluator.compile("IF(A == a, A + b, c)", {"A"});
+    evaluator.addFunction(std::make_unique<FunctionSame>());
+
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator.evaluate(expression, {std::string_view{"a"}}));
+}
+
+TEST_F(RegistryTests, positiveTest_FreezeEvaluator_SharedRegistryFrozen)
+{
+    s2e2::Evaluator evaluator(registry);
+    evaluator.freeze();
+
+    ASSERT_TRUE(evaluator.frozen());
+    ASSERT_TRUE(registry.frozen());
+    ASSERT_THROW(registry.addFunction(std::make_unique<FunctionSame>()), s2e2::Error);
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator.evaluate("IF(1 < 2, a + b, c)"));
+}
+
+TEST_F(RegistryTests, negativeTest_FrozenRegistry_AddFunctionThrows)
+{
+    registry.freeze();
+    s2e2::Evaluator evaluator(registry);
+    auto copy = registry;
+
+    ASSERT_TRUE(evaluator.frozen());
+    ASSERT_THROW(evaluator.addFunction(std::make_unique<FunctionSame>()), s2e2::Error);
+    ASSERT_THROW(copy.addFunction(std::make_unique<FunctionSame>()), s2e2::Error);
+}
+
+TEST_F(RegistryTests, negativeTest_DuplicateFunction_Throws)
+{
+    ASSERT_THROW(registry.addStandardFunctions(), s2e2::Error);
+    ASSERT_THROW(registry.addFunction(nullptr), std::invalid_argument);
+}
@@ -0,0 +1,438 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/rule_set.hpp>
+#include <s2e2/thread_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument and counting its invocations.
+     */
+    class FunctionCount final : public s2e2::Function
+    {
+    public:
+        explicit FunctionCount(size_t& invocations)
+            : s2e2::Function("COUNT", 1)
+            , invocations_{invocations}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            ++invocations_;
+            return arguments_[0];
+        }
+
+    private:
+        size_t& invocations_;
+    };
+}
+
+class RuleSetTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionCount>(invocations));
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+    size_t invocations = 0;
+};
+
+TEST_F(RuleSetTests, positiveTest_SharedSubexpressions_NumberOfNodes)
+{
+    // A, x, ==, one, NULL, IF, two, IF
+    const auto rules = evaluator->compileRuleSet({"IF(A == x, one, NULL)", "IF(A == x, two, NULL)"}, {"A"});
+
+    ASSERT_EQ(2, rules.size());
+    ASSERT_EQ(8, rules.numberOfNodes());
+}
+
+TEST_F(RuleSetTests, positiveTest_SameMembership_SharedNode)
+{
+    // Country, IN, eu, NULL, IF, west, IF
+    const auto rules = evaluator->compileRuleSet({"IF(IN(Country, DE, FR, IT), eu, NULL)",
+                                                  "IF(IN(Country, IT, DE, FR, DE), west, NULL)"},
+                                                 {"Country"});
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateRules(rules, {"FR"}, results, statuses);
+
+    ASSERT_EQ(7, rules.numberOfNodes());
+    ASSERT_EQ(std::optional<std::string>{"eu"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"west"}, results[1]);
+}
+
+TEST_F(RuleSetTests, positiveTest_AllRules_Results)
+{
+    const std::vector<std::string> expressions = {"IF(Tier == gold, Name + \" VIP\", Name)",
+                                                  "IF(Tier != gold && Name < M, early, NULL)",
+                                                  "Tier == gold",
+                                                  "Name + Tier"};
+    const auto rules = evaluator->compileRuleSet(expressions, {"Name", "Tier"});
+    std::vector<std::optional<std::string>> results(4);
+    std::vector<s2e2::RecordStatus> statuses(4);
+
+    const auto failures = evaluator->evaluateRules(rules, {"Ann", std::nullopt}, results, statuses);
+
+    ASSERT_EQ(1, failures);
+    ASSERT_EQ(std::optional<std::string>{"Ann"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"early"}, results[1]);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[2]);
+    ASSERT_FALSE(results[2]);
+    ASSERT_EQ(std::optional<std::string>{"Ann"}, results[3]);
+}
+
+TEST_F(RuleSetTests, positiveTest_AllRules_SameAsSeparateEvaluation)
+{
+    const std::vector<std::string> expressions = {"IF(A == B || A < C, A + B, C)",
+                                                  "IF(A < C, A + B, NULL)",
+                                                  "IF(!(A == B), A + B + C, C + A)",
+                                                  "IF(A < NULL, A, B)",
+                                                  "REPLACE(A + B, a, c)"};
+    const std::vector<std::vector<s2e2::VariableValue>> records = {{"a", "a", "b"},
+                                                                   {"b", "a", std::nullopt},
+                                                                   {std::nullopt, "c", "c"},
+                                                                   {"ab", "", "abc"}};
+    const auto rules = evaluator->compileRuleSet(expressions, {"A", "B", "C"});
+    std::vector<std::optional<std::string>> results(expressions.size());
+    std::vector<s2e2::RecordStatus> statuses(expressions.size());
+
+    for (const auto& values : records)
+    {
+        evaluator->evaluateRules(rules, values, results, statuses);
+
+        for (size_t rule = 0; rule < expressions.size(); ++rule)
+        {
+            const auto compiled = evaluator->compile(expressions[rule], {"A", "B", "C"});
+            try
+            {
+                ASSERT_EQ(evaluator->evaluate(compiled, values), results[rule]) << expressions[rule];
+                ASSERT_EQ(s2e2::RecordStatus::OK, statuses[rule]) << expressions[rule];
+            }
+            catch (const s2e2::Error&)
+            {
+                ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[rule]) << expressions[rule];
+            }
+        }
+    }
+}
+
+TEST_F(RuleSetTests, positiveTest_SharedNode_EvaluatedOnce)
+{
+    const auto rules = evaluator->compileRuleSet({"COUNT(A) + x", "COUNT(A) + y", "IF(COUNT(A) == a, z, NULL)"}, {"A"});
+    std::vector<std::optional<std::string>> results(3);
+    std::vector<s2e2::RecordStatus> statuses(3);
+
+    evaluator->evaluateRules(rules, {"a"}, results, statuses);
+
+    ASSERT_EQ(1, invocations);
+    ASSERT_EQ(std::optional<std::string>{"ax"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"ay"}, results[1]);
+    ASSERT_EQ(std::optional<std::string>{"z"}, results[2]);
+
+    evaluator->evaluateRules(rules, {"b"}, results, statuses);
+
+    ASSERT_EQ(2, invocations);
+    ASSERT_EQ(std::optional<std::string>{"bx"}, results[0]);
+    ASSERT_FALSE(results[2]);
+}
+
+TEST_F(RuleSetTests, positiveTest_FirstMatch_PriorityOrder)
+{
+    const auto rules = evaluator->compileRuleSet({"IF(Country == DE, eu, NULL)",
+                                                  "IF(Country < NULL, broken, NULL)",
+                                                  "IF(Country == US || Country == CA, na, NULL)",
+                                                  "IF(Country != NULL, other, NULL)"},
+                                                 {"Country"});
+
+    const auto match = evaluator->evaluateFirstMatch(rules, {"CA"});
+
+    ASSERT_TRUE(match);
+    ASSERT_EQ(2, match->rule);
+    ASSERT_EQ("na", match->value);
+}
+
+TEST_F(RuleSetTests, positiveTest_FirstMatch_NoMatch)
+{
+    const auto rules = evaluator->compileRuleSet({"IF(Country == DE, eu, NULL)", "IF(Country == US, na, NULL)"},
+                                                 {"Country"});
+
+    const auto match = evaluator->evaluateFirstMatch(rules, {"JP"});
+
+    ASSERT_FALSE(match);
+}
+
+TEST_F(RuleSetTests, positiveTest_GuardedRules_DecisionNodes)
+{
+    const auto guarded = evaluator->compileRuleSet({"IF(Country == DE, eu, NULL)", "IF(Country == US, na, NULL)"},
+                                                   {"Country"});
+    const auto unguarded = evaluator->compileRuleSet({"IF(Country == DE, eu, other)", "Country + x"}, {"Country"});
+
+    ASSERT_LT(1, guarded.numberOfDecisionNodes());
+    ASSERT_EQ(1, unguarded.numberOfDecisionNodes());
+}
+
+TEST_F(RuleSetTests, positiveTest_OrderingGuard_FailsOnNull)
+{
+    const auto rules = evaluator->compileRuleSet({"IF(Tier == gold && Amount > A5, big, NULL)",
+                                                  "IF(Amount > A5 && Tier == gold, big, NULL)"},
+                                                 {"Tier", "Amount"});
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateRules(rules, {"silver", std::nullopt}, results, statuses);
+
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[0]);
+    ASSERT_FALSE(results[0]);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[1]);
+
+    evaluator->evaluateRules(rules, {"gold", "A7"}, results, statuses);
+
+    ASSERT_EQ(std::optional<std::string>{"big"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"big"}, results[1]);
+}
+
+TEST_F(RuleSetTests, positiveTest_GeneratedGuards_SameAsSeparateEvaluation)
+{
+    const std::vector<std::string> variables = {"A", "B", "C"};
+    const std::vector<std::string> literals = {"a", "b", "ab", "ba", "\"\"", "NULL"};
+    const std::vector<std::string> guards = {"== ", "!= ", "< ", "<= ", "> ", ">= "};
+    const std::vector<std::optional<std::string_view>> values = {"a", "b", "ab", "ba", "", "0", "aa", "abc", "c", std::nullopt};
+
+    std::mt19937 random(13);
+    const auto pick = [&random](const auto& options) { return options[random() % options.size()]; };
+
+    std::vector<std::string> expressions;
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string condition;
+        const auto numberOfConjuncts = 1 + random() % 3;
+        for (size_t j = 0; j < numberOfConjuncts; ++j)
+        {
+            const auto variable = pick(variables);
+            switch (random() % 5)
+            {
+                case 4:
+                    condition += "(" + variable + " != " + pick(literals) + " && " + variable + " != " + pick(literals) +
+                                 " && " + variable + " != " + pick(literals) + ")";
+                    break;
+                case 0:
+                    condition += "IN(" + variable + ", " + pick(literals) + ", " + pick(literals) + ")";
+                    break;
+                case 1:
+                    condition += variable + " == " + pick(literals) + " || " + variable + " == " + pick(literals) +
+                                 " || " + variable + " == " + pick(literals);
+                    break;
+                case 2:
+                    condition += pick(literals) + " " + pick(guards) + variable;
+                    break;
+                default:
+                    condition += variable + " " + pick(guards) + pick(literals);
+                    break;
+            }
+            condition += " && ";
+        }
+        condition += (random() % 2) ? "A + B != x" : "A == A";
+
+        const auto otherwise = (random() % 10 == 0) ? "other" : "NULL";
+        expressions.push_back("IF(" + condition + ", r" + std::to_string(i) + ", " + otherwise + ")");
+    }
+
+    // rule sets always short-circuit
+    evaluator->setShortCircuit(true);
+    const auto rules = evaluator->compileRuleSet(expressions, variables);
+    std::vector<s2e2::CompiledExpression> compiled;
+    for (const auto& expression : expressions)
+    {
+        compiled.push_back(evaluator->compile(expression, variables));
+    }
+
+    std::vector<std::optional<std::string>> results(expressions.size());
+    std::vector<s2e2::RecordStatus> statuses(expressions.size());
+
+    for (int i = 0; i < 300; ++i)
+    {
+        const std::vector<s2e2::VariableValue> record = {pick(values), pick(values), pick(values)};
+        evaluator->evaluateRules(rules, record, results, statuses);
+
+        std::optional<s2e2::RuleMatch> expectedMatch;
+        for (size_t rule = 0; rule < expressions.size(); ++rule)
+        {
+            std::optional<std::string> expected;
+            auto expectedStatus = s2e2::RecordStatus::OK;
+            try
+            {
+                expected = evaluator->evaluate(compiled[rule], record);
+            }
+            catch (const s2e2::Error&)
+            {
+                expectedStatus = s2e2::RecordStatus::ERROR;
+            }
+
+            ASSERT_EQ(expectedStatus, statuses[rule]) << expressions[rule];
+            ASSERT_EQ(expected, results[rule]) << expressions[rule];
+            if (!expectedMatch && expected)
+            {
+                expectedMatch = s2e2::RuleMatch{rule, *expected};
+            }
+        }
+
+        const auto match = evaluator->evaluateFirstMatch(rules, record);
+        ASSERT_EQ(expectedMatch.has_value(), match.has_value());
+        if (match)
+        {
+            ASSERT_EQ(expectedMatch->rule, match->rule);
+            ASSERT_EQ(expectedMatch->value, match->value);
+        }
+    }
+}
+
+TEST_F(RuleSetTests, positiveTest_LongChains_Results)
+{
+    std::string disjunction = "A == a0";
+    std::string conjunction = "A == x";
+    for (size_t i = 1; i < 100000; ++i)
+    {
+        const auto index = std::to_string(i);
+        disjunction += " || " + std::string{i % 2 ? "B" : "A"} + " == a" + index;
+        conjunction += " && B + a" + index + " != c";
+    }
+    const auto rules = evaluator->compileRuleSet({"IF(" + disjunction + ", yes, no)",
+                                                  "IF(" + conjunction + ", yes, NULL)"},
+                                                 {"A", "B"});
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    const auto failures = evaluator->evaluateRules(rules, {"x", "z"}, results, statuses);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"no"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"yes"}, results[1]);
+}
+
+TEST_F(RuleSetTests, positiveTest_ManyGuardedVariables_Results)
+{
+    const size_t numberOfVariables = 1000;
+    std::vector<std::string> variables;
+    std::string condition = "V0 == a";
+    for (size_t i = 0; i < numberOfVariables; ++i)
+    {
+        variables.push_back("V" + std::to_string(i));
+        if (i != 0)
+        {
+            condition += " && V" + std::to_string(i) + " == a";
+        }
+    }
+    const auto rules = evaluator->compileRuleSet({"IF(" + condition + ", all, NULL)", "IF(V999 == a, last, NULL)"},
+                                                 variables);
+    std::vector<s2e2::VariableValue> record(numberOfVariables, "a");
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateRules(rules, record, results, statuses);
+
+    ASSERT_EQ(std::optional<std::string>{"all"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"last"}, results[1]);
+
+    record[500] = "b";
+    evaluator->evaluateRules(rules, record, results, statuses);
+
+    ASSERT_EQ(s2e2::RecordStatus::OK, statuses[0]);
+    ASSERT_FALSE(results[0]);
+    ASSERT_EQ(std::optional<std::string>{"last"}, results[1]);
+}
+
+TEST_F(RuleSetTests, positiveTest_ThreadPool_SameAsSequential)
+{
+    std::vector<std::string> expressions;
+    for (int i = 0; i < 500; ++i)
+    {
+        const auto literal = std::to_string(i % 7);
+        expressions.push_back("IF(A == " + literal + " || B < " + literal + ", A + r" + std::to_string(i) +
+                              ", IF(A > B, NULL, B + " + literal + "))");
+    }
+    const auto rules = evaluator->compileRuleSet(expressions, {"A", "B"});
+    const std::vector<std::optional<std::string_view>> values = {"0", "3", "5", "x", std::nullopt};
+
+    s2e2::ThreadPoolOptions options;
+    options.numberOfThreads = 4;
+    options.grainSize = 16;
+    const auto pool = std::make_shared<s2e2::ThreadPool>(options);
+
+    for (const auto a : values)
+    {
+        for (const auto b : values)
+        {
+            const std::vector<s2e2::VariableValue> record = {a, b};
+            std::vector<std::optional<std::string>> expected(expressions.size());
+            std::vector<s2e2::RecordStatus> expectedStatuses(expressions.size());
+            evaluator->setThreadPool(nullptr);
+            const auto expectedFailures = evaluator->evaluateRules(rules, record, expected, expectedStatuses);
+
+            std::vector<std::optional<std::string>> results(expressions.size());
+            std::vector<s2e2::RecordStatus> statuses(expressions.size());
+            evaluator->setThreadPool(pool);
+            const auto failures = evaluator->evaluateRules(rules, record, results, statuses);
+
+            ASSERT_EQ(expectedFailures, failures);
+            ASSERT_EQ(expected, results);
+            ASSERT_EQ(expectedStatuses, statuses);
+        }
+    }
+}
+
+TEST_F(RuleSetTests, negativeTest_InvalidExpression)
+{
+    ASSERT_THROW(evaluator->compileRuleSet({"A + B", "A +"}, {"A", "B"}), s2e2::Error);
+}
+
+TEST_F(RuleSetTests, negativeTest_OutputsSize)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B", "A"}, {"A", "B"});
+    std::vector<std::optional<std::string>> results(1);
+    std::vector<s2e2::RecordStatus> statuses(1);
+
+    ASSERT_THROW({
+        try
+        {
+            evaluator->evaluateRules(rules, {"a", "b"}, results, statuses);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("Evaluator: size of outputs does not match number of rules", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
+
+TEST_F(RuleSetTests, negativeTest_NumberOfValues)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B"}, {"A", "B"});
+
+    ASSERT_THROW(evaluator->evaluateFirstMatch(rules, {"a"}), std::invalid_argument);
+}
@@ -0,0 +1,228 @@
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/session.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function returning its argument and counting its invocations.
+     */
+    class FunctionCount final : public s2e2::Function
+    {
+    public:
+        explicit FunctionCount(size_t& invocations)
+            : s2e2::Function("COUNT", 1)
+            , invocations_{invocations}
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            ++invocations_;
+            return arguments_[0];
+        }
+
+    private:
+        size_t& invocations_;
+    };
+}
+
+class SessionTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionCount>(invocations));
+	}
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+    size_t invocations = 0;
+};
+
+TEST_F(SessionTests, positiveTest_Start_AllRulesEvaluated)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B", "IF(A == a, x, NULL)", "B + c"}, {"A", "B"});
+    const auto session = evaluator->startSession(rules, {"a", "b"});
+
+    ASSERT_EQ(3, session.size());
+    ASSERT_EQ(std::optional<std::string>{"ab"}, session.result(0));
+    ASSERT_EQ(std::optional<std::string>{"x"}, session.result(1));
+    ASSERT_EQ(std::optional<std::string>{"bc"}, session.result(2));
+    ASSERT_TRUE(session.changedRules().empty());
+}
+
+TEST_F(SessionTests, positiveTest_Update_OnlyDependentRulesChanged)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B", "IF(A == a, x, NULL)", "B + c", "IF(B == b, y, NULL)"},
+                                                 {"A", "B"});
+    auto session = evaluator->startSession(rules, {"a", "b"});
+
+    session.update(0, "z");
+
+    ASSERT_EQ((std::vector<size_t>{0, 1}), session.changedRules());
+    ASSERT_EQ(std::optional<std::string>{"zb"}, session.result(0));
+    ASSERT_FALSE(session.result(1));
+    ASSERT_EQ(std::optional<std::string>{"bc"}, session.result(2));
+    ASSERT_EQ(std::optional<std::string>{"y"}, session.result(3));
+}
+
+TEST_F(SessionTests, positiveTest_Update_UnchangedResultNotReported)
+{
+    const auto rules = evaluator->compileRuleSet({"IF(A == a, x, NULL)", "A + B"}, {"A", "B"});
+    auto session = evaluator->startSession(rules, {"b", "b"});
+
+    session.update("A", "c");
+
+    ASSERT_EQ((std::vector<size_t>{1}), session.changedRules());
+    ASSERT_EQ(std::optional<std::string>{"cb"}, session.result(1));
+}
+
+TEST_F(SessionTests, positiveTest_Update_OnlyDirtyNodesRecomputed)
+{
+    const auto rules = evaluator->compileRuleSet({"COUNT(A) + x", "COUNT(A) + B", "B + y"}, {"A", "B"});
+    auto session = evaluator->startSession(rules, {"a", "b"});
+    ASSERT_EQ(1, invocations);
+
+    session.update("B", "c");
+
+    // B, COUNT(A) + B, B + y
+    ASSERT_EQ(1, invocations);
+    ASSERT_EQ(3, session.numberOfRecomputedNodes());
+    ASSERT_EQ((std::vector<size_t>{1, 2}), session.changedRules());
+    ASSERT_EQ(std::optional<std::string>{"ac"}, session.result(1));
+
+    session.update("A", "d");
+
+    ASSERT_EQ(2, invocations);
+    ASSERT_EQ((std::vector<size_t>{0, 1}), session.changedRules());
+    ASSERT_EQ(std::optional<std::string>{"dx"}, session.result(0));
+    ASSERT_EQ(std::optional<std::string>{"dc"}, session.result(1));
+}
+
+TEST_F(SessionTests, positiveTest_Update_SameValue_NothingRecomputed)
+{
+    const auto rules = evaluator->compileRuleSet({"COUNT(A)"}, {"A"});
+    auto session = evaluator->startSession(rules, {"a"});
+
+    session.update(0, "a");
+
+    ASSERT_EQ(1, invocations);
+    ASSERT_EQ(0, session.numberOfRecomputedNodes());
+    ASSERT_TRUE(session.changedRules().empty());
+}
+
+TEST_F(SessionTests, positiveTest_Update_StatusTransitions)
+{
+    const auto rules = evaluator->compileRuleSet({"IF(A < B, x, y)"}, {"A", "B"});
+    auto session = evaluator->startSession(rules, {"a", "b"});
+    ASSERT_EQ(s2e2::RecordStatus::OK, session.status());
+    ASSERT_EQ(std::optional<std::string>{"x"}, session.result());
+
+    session.update("B", std::nullopt);
+
+    ASSERT_EQ((std::vector<size_t>{0}), session.changedRules());
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, session.status());
+    ASSERT_FALSE(session.result());
+
+    session.update("B", "0");
+
+    ASSERT_EQ((std::vector<size_t>{0}), session.changedRules());
+    ASSERT_EQ(s2e2::RecordStatus::OK, session.status());
+    ASSERT_EQ(std::optional<std::string>{"y"}, session.result());
+}
+
+TEST_F(SessionTests, positiveTest_CompiledExpression_OneRule)
+{
+    const auto compiled = evaluator->compile("IF(A == B, A + C, C)", {"A", "B", "C"});
+    auto session = evaluator->startSession(compiled, {"a", "a", "c"});
+
+    ASSERT_EQ(1, session.size());
+    ASSERT_EQ(std::optional<std::string>{"ac"}, session.result());
+
+    session.update("B", "b");
+
+    ASSERT_EQ((std::vector<size_t>{0}), session.changedRules());
+    ASSERT_EQ(std::optional<std::string>{"c"}, session.result());
+}
+
+TEST_F(SessionTests, positiveTest_RandomUpdates_SameAsFullEvaluation)
+{
+    const std::vector<std::string> variables = {"A", "B", "C"};
+    const std::vector<std::string> expressions = {"IF(A == B || A < C, A + B, C)",
+                                                  "IF(A == a && B != b, x, NULL)",
+                                                  "IF(IN(C, a, b, c), C + C, NULL)",
+                                                  "IF(!(A == B), A + B + C, C + A)",
+                                                  "IF(A < NULL, A, B)",
+                                                  "IF(C > b, REPLACE(A + B, a, c), NULL)"};
+    const std::vector<s2e2::VariableValue> candidates = {"a", "b", "c", "ab", "", std::nullopt};
+    const auto rules = evaluator->compileRuleSet(expressions, variables);
+
+    std::mt19937 random(7);
+    const auto pick = [&random](size_t n) { return std::uniform_int_distribution<size_t>(0, n - 1)(random); };
+
+    std::vector<s2e2::VariableValue> values = {"a", "b", "c"};
+    auto session = evaluator->startSession(rules, values);
+    std::vector<std::optional<std::string>> results(expressions.size());
+    std::vector<s2e2::RecordStatus> statuses(expressions.size());
+    evaluator->evaluateRules(rules, values, results, statuses);
+
+    for (size_t i = 0; i < 500; ++i)
+    {
+        const auto previousResults = results;
+        const auto previousStatuses = statuses;
+        const auto variable = pick(variables.size());
+        values[variable] = candidates[pick(candidates.size())];
+        session.update(variable, values[variable]);
+
+        evaluator->evaluateRules(rules, values, results, statuses);
+        std::vector<size_t> changed;
+        for (size_t rule = 0; rule < expressions.size(); ++rule)
+        {
+            ASSERT_EQ(results[rule], session.result(rule)) << expressions[rule];
+            ASSERT_EQ(statuses[rule], session.status(rule)) << expressions[rule];
+            if (results[rule] != previousResults[rule] || statuses[rule] != previousStatuses[rule])
+            {
+                changed.push_back(rule);
+            }
+        }
+        ASSERT_EQ(changed, session.changedRules());
+    }
+}
+
+TEST_F(SessionTests, negativeTest_NumberOfValues)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B"}, {"A", "B"});
+
+    ASSERT_THROW(evaluator->startSession(rules, {"a"}), std::invalid_argument);
+}
+
+TEST_F(SessionTests, negativeTest_UnknownVariable)
+{
+    const auto rules = evaluator->compileRuleSet({"A + B"}, {"A", "B"});
+    auto session = evaluator->startSession(rules, {"a", "b"});
+
+    ASSERT_THROW(session.update("C", "c"), std::invalid_argument);
+    ASSERT_THROW(session.update(2, "c"), std::invalid_argument);
+    ASSERT_THROW(session.result(1), std::invalid_argument);
+    ASSERT_THROW(session.status(1), std::invalid_argument);
+}
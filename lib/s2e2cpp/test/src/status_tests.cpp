@@ -0,0 +1,227 @@
+#include <s2e2/error.hpp>
+#include <s2e2/evaluator.hpp>
+#include <s2e2/execution_limits.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/status.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Custom function always throwing.
+     */
+    class FunctionThrow final : public s2e2::Function
+    {
+    public:
+        FunctionThrow()
+            : s2e2::Function("THROW", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return true;
+        }
+
+        std::any result() const override
+        {
+            throw std::runtime_error("THROW: failed");
+        }
+    };
+}
+
+class StatusTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionThrow>());
+	}
+
+    /**
+     * @brief Get message of the exception thrown by compile.
+     */
+    std::string compileError(const std::string& expression, const std::vector<std::string>& variables = {})
+    {
+        try
+        {
+            evaluator->compile(expression, variables);
+        }
+        catch (const s2e2::Error& error)
+        {
+            return error.what();
+        }
+        return {};
+    }
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(StatusTests, positiveTest_TryCompile_ResultValue)
+{
+    const auto result = evaluator->tryCompile("A + b", {"A"});
+
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(s2e2::ErrorCode::OK, result.status().code);
+    ASSERT_EQ(std::optional<std::string>{"ab"}, evaluator->evaluate(result.value(), {std::string_view{"a"}}));
+}
+
+TEST_F(StatusTests, positiveTest_TryEvaluate_ResultValue)
+{
+    const auto value = evaluator->tryEvaluate("A + B");
+    ASSERT_TRUE(value.ok());
+    ASSERT_EQ(std::optional<std::string>{"AB"}, value.value());
+
+    const auto null = evaluator->tryEvaluate("IF(A == A, NULL, B)");
+    ASSERT_TRUE(null.ok());
+    ASSERT_EQ(std::nullopt, null.value());
+}
+
+TEST_F(StatusTests, negativeTest_UnpairedBracket_Position)
+{
+    const auto unclosed = evaluator->tryCompile("A + (B + C");
+    ASSERT_EQ(s2e2::ErrorCode::UNPAIRED_BRACKET, unclosed.status().code);
+    ASSERT_EQ(4, unclosed.status().position);
+    ASSERT_EQ(compileError("A + (B + C"), unclosed.status().message);
+
+    const auto unopened = evaluator->tryCompile("A + B) + C");
+    ASSERT_EQ(s2e2::ErrorCode::UNPAIRED_BRACKET, unopened.status().code);
+    ASSERT_EQ(5, unopened.status().position);
+}
+
+TEST_F(StatusTests, negativeTest_NotEnoughArguments_Position)
+{
+    const auto result = evaluator->tryCompile("A == B + ");
+
+    ASSERT_FALSE(result.ok());
+    ASSERT_EQ(s2e2::ErrorCode::NOT_ENOUGH_ARGUMENTS, result.status().code);
+    ASSERT_EQ("Not enough arguments for operator ==", result.status().message);
+    ASSERT_EQ(2, result.status().position);
+}
+
+TEST_F(StatusTests, negativeTest_InvalidNumberOfArguments_Position)
+{
+    const auto result = evaluator->tryCompile("B + IN(A)", {"A", "B"});
+
+    ASSERT_EQ(s2e2::ErrorCode::INVALID_NUMBER_OF_ARGUMENTS, result.status().code);
+    ASSERT_EQ("Invalid number of arguments for function IN", result.status().message);
+    ASSERT_EQ(4, result.status().position);
+}
+
+TEST_F(StatusTests, negativeTest_CompileErrors_Codes)
+{
+    const auto invalid = evaluator->tryCompile("FOO(A) + B");
+    ASSERT_EQ(s2e2::ErrorCode::INVALID_EXPRESSION, invalid.status().code);
+    ASSERT_EQ(s2e2::Status::NO_POSITION, invalid.status().position);
+    ASSERT_EQ(compileError("FOO(A) + B"), invalid.status().message);
+
+    const auto duplicate = evaluator->tryCompile("A + B", {"A", "A"});
+    ASSERT_EQ(s2e2::ErrorCode::DUPLICATE_VARIABLE, duplicate.status().code);
+
+    s2e2::ExpressionLimits limits;
+    limits.maxLength = 4;
+    evaluator->setLimits(limits);
+    const auto tooLong = evaluator->tryCompile("A + B");
+    ASSERT_EQ(s2e2::ErrorCode::LIMIT_EXCEEDED, tooLong.status().code);
+    ASSERT_EQ(compileError("A + B"), tooLong.status().message);
+}
+
+TEST_F(StatusTests, negativeTest_InvalidArgumentsOnEvaluation_Position)
+{
+    const auto expression = evaluator->compile("IF(A == a, b, c) + IF(B < C, d, e)", {"A", "B", "C"});
+
+    const auto result = evaluator->tryEvaluate(expression, {std::string_view{"a"}, std::nullopt, std::string_view{"c"}});
+
+    ASSERT_FALSE(result.ok());
+    ASSERT_EQ(s2e2::ErrorCode::INVALID_ARGUMENTS, result.status().code);
+    ASSERT_EQ("Invalid arguments for operator <", result.status().message);
+    ASSERT_EQ(24, result.status().position);
+
+    const auto condition = evaluator->compile("x + IF(A, b, c)", {"A"});
+    const auto ifResult = evaluator->tryEvaluate(condition, {std::string_view{"a"}});
+    ASSERT_EQ(s2e2::ErrorCode::INVALID_ARGUMENTS, ifResult.status().code);
+    ASSERT_EQ(4, ifResult.status().position);
+}
+
+TEST_F(StatusTests, negativeTest_NotString_Code)
+{
+    const auto result = evaluator->tryEvaluate("A == B");
+
+    ASSERT_EQ(s2e2::ErrorCode::NOT_A_STRING, result.status().code);
+    ASSERT_EQ("Evaluator: expression value is not a string", result.status().message);
+}
+
+TEST_F(StatusTests, negativeTest_WrongNumberOfValues_InvalidVariables)
+{
+    const auto expression = evaluator->compile("A + B", {"A", "B"});
+
+    const auto result = evaluator->tryEvaluate(expression, {std::string_view{"a"}});
+
+    ASSERT_EQ(s2e2::ErrorCode::INVALID_VARIABLES, result.status().code);
+    ASSERT_THROW(evaluator->evaluate(expression, {std::string_view{"a"}}), std::invalid_argument);
+}
+
+TEST_F(StatusTests, negativeTest_CustomFunctionThrows_CallFailed)
+{
+    const auto expression = evaluator->compile("x + THROW(A)", {"A"});
+
+    const auto result = evaluator->tryEvaluate(expression, {std::string_view{"a"}});
+
+    ASSERT_EQ(s2e2::ErrorCode::CALL_FAILED, result.status().code);
+    ASSERT_EQ("THROW: failed", result.status().message);
+    ASSERT_THROW(evaluator->evaluate(expression, {std::string_view{"a"}}), std::runtime_error);
+}
+
+TEST_F(StatusTests, negativeTest_Cancelled_Code)
+{
+    auto token = std::make_shared<s2e2::CancellationToken>();
+    token->cancel();
+    s2e2::ExecutionLimits limits;
+    limits.cancellation = token;
+    evaluator->setExecutionLimits(limits);
+
+    const auto result = evaluator->tryEvaluate("A + B");
+
+    ASSERT_EQ(s2e2::ErrorCode::CANCELLED, result.status().code);
+    ASSERT_THROW(evaluator->evaluate("A + B"), s2e2::AbortedError);
+}
+
+TEST_F(StatusTests, negativeTest_StringTooLong_Code)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 4;
+    evaluator->setExecutionLimits(limits);
+
+    const auto result = evaluator->tryEvaluate("abc + def");
+
+    ASSERT_EQ(s2e2::ErrorCode::STRING_TOO_LONG, result.status().code);
+    ASSERT_THROW(evaluator->evaluate("abc + def"), s2e2::SizeLimitError);
+}
+
+TEST_F(StatusTests, negativeTest_StringTooLongInFunction_Position)
+{
+    s2e2::ExecutionLimits limits;
+    limits.maxStringSize = 4;
+    evaluator->setExecutionLimits(limits);
+
+    const auto result = evaluator->tryEvaluate("x + CONCAT(abc, def)");
+
+    ASSERT_EQ(s2e2::ErrorCode::STRING_TOO_LONG, result.status().code);
+    ASSERT_EQ("Evaluator: string size 6 exceeds limit 4", result.status().message);
+    ASSERT_EQ(4u, result.status().position);
+    ASSERT_THROW(evaluator->evaluate("x + CONCAT(abc, def)"), s2e2::SizeLimitError);
+}
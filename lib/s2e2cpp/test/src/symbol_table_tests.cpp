@@ -0,0 +1,61 @@
+#include <symbol_table.hpp>
+#include <token_type.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+TEST(SymbolTableTests, positiveTest_AddedNames_Ids)
+{
+    s2e2::SymbolTable symbols;
+    const auto function = symbols.add("FUN", s2e2::TokenType::FUNCTION, 0);
+    const auto op = symbols.add("+", s2e2::TokenType::OPERATOR, 3);
+
+    ASSERT_EQ(0, function);
+    ASSERT_EQ(1, op);
+    ASSERT_EQ(op, symbols.find("+"));
+    ASSERT_EQ(3, symbols[op].priority);
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find("FU"));
+    ASSERT_FALSE(symbols.frozen());
+}
+
+TEST(SymbolTableTests, positiveTest_Frozen_SameIds)
+{
+    s2e2::SymbolTable symbols;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        symbols.add("NAME" + std::to_string(i), s2e2::TokenType::FUNCTION, 0);
+    }
+    symbols.add("&&", s2e2::TokenType::OPERATOR, 1);
+
+    symbols.freeze();
+
+    ASSERT_TRUE(symbols.frozen());
+    for (s2e2::SymbolId id = 0; id < symbols.size(); ++id)
+    {
+        ASSERT_EQ(id, symbols.find(symbols[id].name));
+    }
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find("NAME500"));
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find("&"));
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find(""));
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find("A NAME LONGER THAN ANY OTHER"));
+}
+
+TEST(SymbolTableTests, positiveTest_ManyNames_SlotsNearNames)
+{
+    s2e2::SymbolTable symbols;
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        symbols.add("NAME" + std::to_string(i), s2e2::TokenType::FUNCTION, 0);
+    }
+
+    symbols.freeze();
+
+    ASSERT_LE(symbols.numberOfSlots(), symbols.size() + symbols.size() / 2);
+    for (s2e2::SymbolId id = 0; id < symbols.size(); ++id)
+    {
+        ASSERT_EQ(id, symbols.find(symbols[id].name));
+    }
+    ASSERT_EQ(s2e2::NO_SYMBOL, symbols.find("NAME20000"));
+}
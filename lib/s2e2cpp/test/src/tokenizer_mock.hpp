@@ -1,19 +1,29 @@
 #pragma once
 
 #include <interface_tokenizer.hpp>
+#include <symbol_table.hpp>
 #include <token.hpp>
 
 #include <gmock/gmock.h>
 
+#include <cstdint>
 #include <list>
+#include <memory>
 #include <string>
 
 
 class TokenizerMock : public s2e2::ITokenizer
 {
 public:
-    MOCK_METHOD1(addFunction, void(const std::string&));
-    MOCK_METHOD1(addOperator, void(const std::string&));
+    TokenizerMock()
+    {
+        ON_CALL(*this, addFunction(testing::_)).WillByDefault(testing::Return(s2e2::NO_SYMBOL));
+        ON_CALL(*this, addOperator(testing::_, testing::_)).WillByDefault(testing::Return(s2e2::NO_SYMBOL));
+    }
+
+    MOCK_CONST_METHOD0(clone, std::unique_ptr<s2e2::ITokenizer>());
+    MOCK_METHOD1(addFunction, s2e2::SymbolId(const std::string&));
+    MOCK_METHOD2(addOperator, s2e2::SymbolId(const std::string&, const uint_fast16_t));
     MOCK_CONST_METHOD1(tokenize, std::list<s2e2::Token>(const std::string&));
 };
 
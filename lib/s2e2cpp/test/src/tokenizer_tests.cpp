@@ -1,3 +1,4 @@
+#include <symbol_table.hpp>
 #include <token_type.hpp>
 #include <token.hpp>
 #include <tokenizer.hpp>
@@ -6,7 +7,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+#include <list>
 #include <memory>
+#include <string>
+#include <vector>
 
 
 
@@ -29,7 +35,7 @@ protected:
 
 TEST_F(TokenizerTests, positiveTest_OneOperatorWithSpaces_ResultValue)
 {
-	tokenizer->addOperator("+");
+	tokenizer->addOperator("+", 1);
 
     const auto actualTokens = tokenizer->tokenize("A + B");
 
@@ -42,7 +48,7 @@ TEST_F(TokenizerTests, positiveTest_OneOperatorWithSpaces_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_OneOperatorWithoutSpaces_ResultValue)
 {
-    tokenizer->addOperator("+");
+    tokenizer->addOperator("+", 1);
 
     const auto actualTokens = tokenizer->tokenize("A+B");
 
@@ -55,8 +61,8 @@ TEST_F(TokenizerTests, positiveTest_OneOperatorWithoutSpaces_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_TwoOperatorWithSpaces_ResultValue)
 {
-    tokenizer->addOperator("+");
-    tokenizer->addOperator("&&");
+    tokenizer->addOperator("+", 1);
+    tokenizer->addOperator("&&", 1);
 
     const auto actualTokens = tokenizer->tokenize("A + B && C");
 
@@ -71,8 +77,8 @@ TEST_F(TokenizerTests, positiveTest_TwoOperatorWithSpaces_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_TwoOperatorWithoutSpaces_ResultValue)
 {
-    tokenizer->addOperator("+");
-    tokenizer->addOperator("&&");
+    tokenizer->addOperator("+", 1);
+    tokenizer->addOperator("&&", 1);
 
     const auto actualTokens = tokenizer->tokenize("A+B&&C");
 
@@ -87,8 +93,8 @@ TEST_F(TokenizerTests, positiveTest_TwoOperatorWithoutSpaces_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_OneOperatorIsSubstringOfAnother_ResultValue)
 {
-    tokenizer->addOperator("!");
-    tokenizer->addOperator("!=");
+    tokenizer->addOperator("!", 1);
+    tokenizer->addOperator("!=", 1);
 
     const auto actualTokens = tokenizer->tokenize("A != !B");
 
@@ -100,6 +106,28 @@ TEST_F(TokenizerTests, positiveTest_OneOperatorIsSubstringOfAnother_ResultValue)
     ASSERT_EQ(expectedTokens, actualTokens);
 }
 
+TEST_F(TokenizerTests, positiveTest_InternedSymbols_TokenSymbols)
+{
+    const auto functionSymbol = tokenizer->addFunction("FUN1");
+    const auto operatorSymbol = tokenizer->addOperator("+", 7);
+
+    const auto actualTokens = tokenizer->tokenize("FUN1(A+B)");
+
+    ASSERT_NE(functionSymbol, operatorSymbol);
+    ASSERT_EQ(6, actualTokens.size());
+
+    const auto& functionToken = actualTokens.front();
+    ASSERT_EQ(s2e2::TokenType::FUNCTION, functionToken.type);
+    ASSERT_EQ(functionSymbol, functionToken.symbol);
+
+    const auto& operatorToken = *std::next(actualTokens.begin(), 3);
+    ASSERT_EQ(s2e2::TokenType::OPERATOR, operatorToken.type);
+    ASSERT_EQ(operatorSymbol, operatorToken.symbol);
+    ASSERT_EQ(7, operatorToken.priority);
+
+    ASSERT_EQ(s2e2::NO_SYMBOL, std::next(actualTokens.begin(), 2)->symbol);
+}
+
 TEST_F(TokenizerTests, positiveTest_OneFunctionWithoutArguments_ResultValue)
 {
     tokenizer->addFunction("FUN1");
@@ -149,7 +177,7 @@ TEST_F(TokenizerTests, positiveTest_TwoFunctionsOneOperator_ResultValue)
 {
     tokenizer->addFunction("FUN1");
     tokenizer->addFunction("FUN2");
-    tokenizer->addOperator("+");
+    tokenizer->addOperator("+", 1);
 
     const auto actualTokens = tokenizer->tokenize("FUN1(Arg1) + FUN2(Arg2)");
 
@@ -190,7 +218,7 @@ TEST_F(TokenizerTests, positiveTest_NestedFunctions_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_NestedBrackets_ResultValue)
 {
-    tokenizer->addOperator("+");
+    tokenizer->addOperator("+", 1);
 
     const auto actualTokens = tokenizer->tokenize("(((A + B)))");
 
@@ -209,7 +237,7 @@ TEST_F(TokenizerTests, positiveTest_NestedBrackets_ResultValue)
 
 TEST_F(TokenizerTests, positiveTest_OperatorsWithoutArguments_ResultValue)
 {
-    tokenizer->addOperator("+");
+    tokenizer->addOperator("+", 1);
 
     const auto actualTokens = tokenizer->tokenize("+ + +");
 
@@ -232,14 +260,173 @@ TEST_F(TokenizerTests, positiveTest_UnpairedBrackets_ResultValue)
     ASSERT_EQ(expectedTokens, actualTokens);
 }
 
+TEST_F(TokenizerTests, positiveTest_Positions_OffsetsOfTokens)
+{
+    tokenizer->addOperator("+", 1);
+    tokenizer->addFunction("FUN");
+
+    const auto actualTokens = tokenizer->tokenize("FUN(A,  \"b c\")+ BC+D");
+
+    std::vector<size_t> actualPositions;
+    for (const auto& token : actualTokens)
+    {
+        actualPositions.push_back(token.position);
+    }
+
+    const auto expectedPositions = std::vector<size_t>{0, 3, 4, 5, 8, 13, 14, 16, 18, 19};
+    ASSERT_EQ(expectedPositions, actualPositions);
+}
+
+TEST_F(TokenizerTests, positiveTest_LongQuotedLiteral_ResultValue)
+{
+    tokenizer->addOperator("+", 1);
+
+    // escaped quotes, commas and blanks inside quotes fall on both sides of chunk boundaries
+    std::string literal;
+    std::string expectedLiteral;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        literal += std::string(i % 37, 'a') + ((i % 3 == 0) ? "\\\"" : ", (x)\t");
+        expectedLiteral += std::string(i % 37, 'a') + ((i % 3 == 0) ? "\"" : ", (x)\t");
+    }
+
+    const auto actualTokens = tokenizer->tokenize("A + \"" + literal + "\"+B");
+
+    const auto expectedTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::ATOM, "A"},
+                                                       s2e2::Token{s2e2::TokenType::OPERATOR, "+"},
+                                                       s2e2::Token{s2e2::TokenType::ATOM, expectedLiteral},
+                                                       s2e2::Token{s2e2::TokenType::OPERATOR, "+"},
+                                                       s2e2::Token{s2e2::TokenType::ATOM, "B"}};
+
+    ASSERT_EQ(expectedTokens, actualTokens);
+}
+
+TEST_F(TokenizerTests, positiveTest_LongExpression_ResultValue)
+{
+    tokenizer->addOperator("+", 1);
+    tokenizer->addFunction("FUN");
+
+    std::string expression = "FUN(";
+    auto expectedTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::FUNCTION, "FUN"},
+                                                 s2e2::Token{s2e2::TokenType::LEFT_BRACKET, "("}};
+    for (size_t i = 0; i < 300; ++i)
+    {
+        const auto atom = "Atom" + std::string(i % 40, 'x') + std::to_string(i);
+        expression += atom + ((i % 2 == 0) ? " +\t" : ",");
+        expectedTokens.emplace_back(s2e2::TokenType::ATOM, atom);
+        expectedTokens.emplace_back((i % 2 == 0) ? s2e2::TokenType::OPERATOR : s2e2::TokenType::COMMA,
+                                    (i % 2 == 0) ? "+" : ",");
+    }
+    expression += "Z)";
+    expectedTokens.emplace_back(s2e2::TokenType::ATOM, "Z");
+    expectedTokens.emplace_back(s2e2::TokenType::RIGHT_BRACKET, ")");
+
+    const auto actualTokens = tokenizer->tokenize(expression);
+
+    ASSERT_EQ(expectedTokens, actualTokens);
+}
+
+TEST_F(TokenizerTests, positiveTest_Literal_IsLiteral)
+{
+    tokenizer->addOperator("==", 1);
+    tokenizer->addFunction("FUN");
+
+    size_t numberOfTokens = 0;
+    const auto isLiteral = tokenizer->isLiteral("  Just =\ta FUNNY\tliteral ", {"B"}, numberOfTokens);
+
+    ASSERT_TRUE(isLiteral);
+    ASSERT_EQ(5, numberOfTokens);
+}
+
+TEST_F(TokenizerTests, negativeTest_NotLiteral_IsLiteral)
+{
+    tokenizer->addOperator("==", 1);
+    tokenizer->addFunction("FUN");
+
+    size_t numberOfTokens = 0;
+    ASSERT_FALSE(tokenizer->isLiteral("A==B", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("call FUN", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("value of B", {"B"}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("one, two", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("(one)", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("\"quoted\"", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral(" \t ", {}, numberOfTokens));
+}
+
+TEST_F(TokenizerTests, positiveTest_Frozen_SameTokens)
+{
+    for (const auto& name : {"!", "!=", "==", "=", "&&", "||", "+", "<", "<=", "<<", "<<="})
+    {
+        tokenizer->addOperator(name, 1);
+    }
+    tokenizer->addFunction("FUN");
+    tokenizer->addFunction("IF");
+
+    const std::vector<std::string> expressions = {
+        "A!==B", "a<<=<b", "!!x||y&&z", "FUN(A+B, \"x+y\", IF(!A,B,C))", "x=y==z!=w", "IF+FUN", "plain words", "<<<<="};
+
+    std::vector<std::list<s2e2::Token>> expectedTokens;
+    for (const auto& expression : expressions)
+    {
+        expectedTokens.push_back(tokenizer->tokenize(expression));
+    }
+
+    tokenizer->freeze();
+
+    for (size_t i = 0; i < expressions.size(); ++i)
+    {
+        const auto actualTokens = tokenizer->tokenize(expressions[i]);
+        ASSERT_EQ(expectedTokens[i], actualTokens) << expressions[i];
+        ASSERT_TRUE(std::equal(actualTokens.begin(), actualTokens.end(), expectedTokens[i].begin(),
+            [](const auto& left, const auto& right) { return left.position == right.position && left.symbol == right.symbol; }));
+    }
+
+    size_t numberOfTokens = 0;
+    ASSERT_TRUE(tokenizer->isLiteral("plain words", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("a<b", {}, numberOfTokens));
+    ASSERT_FALSE(tokenizer->isLiteral("call FUN", {}, numberOfTokens));
+}
+
+TEST_F(TokenizerTests, positiveTest_OverlappingOperatorsOfTheSameLength_LeftmostTaken)
+{
+    // the order of registration does not matter
+    for (const auto& name : {"==", "!=", "<=", ">=", "<", ">", "!"})
+    {
+        tokenizer->addOperator(name, 1);
+    }
+
+    const auto expectedTokens = std::list<s2e2::Token>{s2e2::Token{s2e2::TokenType::ATOM, "A"},
+                                                       s2e2::Token{s2e2::TokenType::OPERATOR, "<="},
+                                                       s2e2::Token{s2e2::TokenType::ATOM, "=B"}};
+
+    ASSERT_EQ(expectedTokens, tokenizer->tokenize("A<==B"));
+    ASSERT_EQ("!=", std::next(tokenizer->tokenize("x!==y").begin())->value);
+    ASSERT_EQ(">=", std::next(tokenizer->tokenize("a>==b").begin())->value);
+
+    tokenizer->freeze();
+
+    ASSERT_EQ(expectedTokens, tokenizer->tokenize("A<==B"));
+    ASSERT_EQ("!=", std::next(tokenizer->tokenize("x!==y").begin())->value);
+    ASSERT_EQ(">=", std::next(tokenizer->tokenize("a>==b").begin())->value);
+}
+
+TEST_F(TokenizerTests, negativeTest_AddAfterFreeze)
+{
+    tokenizer->addOperator("+", 1);
+    tokenizer->freeze();
+
+    ASSERT_THROW(tokenizer->addOperator("-", 1), s2e2::Error);
+    ASSERT_THROW(tokenizer->addFunction("FUN"), s2e2::Error);
+}
+
 TEST_F(TokenizerTests, negativeTest_TwoOperatorsWithTheSameName)
 {
-    tokenizer->addOperator("+");
+    tokenizer->addOperator("+", 1);
 
     ASSERT_THROW({
         try
         {
-            tokenizer->addOperator("+");
+            tokenizer->addOperator("+", 1);
         }
         catch (const s2e2::Error& e)
         {
@@ -273,7 +460,7 @@ TEST_F(TokenizerTests, negativeTest_FunctionAndOperatorWithTheSameName)
     ASSERT_THROW({
         try
         {
-            tokenizer->addOperator("FF");
+            tokenizer->addOperator("FF", 1);
         }
         catch (const s2e2::Error& e)
         {
@@ -285,7 +472,7 @@ TEST_F(TokenizerTests, negativeTest_FunctionAndOperatorWithTheSameName)
 
 TEST_F(TokenizerTests, negativeTest_OperatorAndFunctionWithTheSameName)
 {
-    tokenizer->addOperator("FF");
+    tokenizer->addOperator("FF", 1);
 
     ASSERT_THROW({
         try
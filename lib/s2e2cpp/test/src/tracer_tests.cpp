@@ -0,0 +1,195 @@
+#include <s2e2/evaluator.hpp>
+#include <s2e2/tracer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    size_t countOccurrences(const std::string& str, const std::string& substr)
+    {
+        size_t result = 0;
+        for (auto pos = str.find(substr); pos != std::string::npos; pos = str.find(substr, pos + substr.size()))
+        {
+            ++result;
+        }
+        return result;
+    }
+}
+
+class TracerTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+	}
+
+    std::string dump(const s2e2::Tracer& tracer) const
+    {
+        std::ostringstream stream;
+        tracer.writeChromeTrace(stream);
+        return stream.str();
+    }
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(TracerTests, positiveTest_NoEvaluations_EmptyTrace)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>();
+
+    const auto trace = dump(*tracer);
+
+    ASSERT_NE(std::string::npos, trace.find("\"traceEvents\":["));
+    ASSERT_EQ(0, countOccurrences(trace, "\"ph\":\"X\""));
+}
+
+TEST_F(TracerTests, positiveTest_OneEvaluation_SpansNames)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>();
+    evaluator->setTracer(tracer);
+
+    evaluator->evaluate("IF(A < B, REPLACE(ABC, A, E), C)");
+
+    const auto trace = dump(*tracer);
+
+    ASSERT_EQ(1, countOccurrences(trace, "\"name\":\"evaluate\""));
+    ASSERT_EQ(1, countOccurrences(trace, "\"name\":\"compile\""));
+    ASSERT_EQ(1, countOccurrences(trace, "\"name\":\"IF\""));
+    ASSERT_EQ(1, countOccurrences(trace, "\"name\":\"REPLACE\""));
+}
+
+TEST_F(TracerTests, positiveTest_ZeroSamplingRate_NoSpans)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>(0.0);
+    evaluator->setTracer(tracer);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        evaluator->evaluate("A + B");
+    }
+
+    ASSERT_EQ(0, countOccurrences(dump(*tracer), "\"ph\":\"X\""));
+}
+
+TEST_F(TracerTests, positiveTest_PartialSamplingRate_NumberOfSpans)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>(0.25);
+    evaluator->setTracer(tracer);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        evaluator->evaluate("A + B");
+    }
+
+    ASSERT_EQ(25, countOccurrences(dump(*tracer), "\"name\":\"evaluate\""));
+}
+
+TEST_F(TracerTests, positiveTest_UnevenSamplingRate_NumberOfSpans)
+{
+    // rates which are not one over a whole number are not rounded to the nearest period
+    for (const auto& [rate, expected] : {std::pair{0.3, 30}, std::pair{0.6, 60}, std::pair{0.99, 99}})
+    {
+        const auto tracer = std::make_shared<s2e2::Tracer>(rate);
+        evaluator->setTracer(tracer);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            evaluator->evaluate("A + B");
+        }
+
+        ASSERT_EQ(expected, countOccurrences(dump(*tracer), "\"name\":\"evaluate\"")) << rate;
+    }
+}
+
+TEST_F(TracerTests, positiveTest_AlternatingTracers_OwnSpans)
+{
+    s2e2::Evaluator other;
+    other.addStandardOperators();
+
+    for (int round = 0; round < 3; ++round)
+    {
+        const auto first = std::make_shared<s2e2::Tracer>();
+        const auto second = std::make_shared<s2e2::Tracer>(0.5);
+        evaluator->setTracer(first);
+        other.setTracer(second);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            evaluator->evaluate("A + B");
+            other.evaluate("A + B");
+        }
+
+        ASSERT_EQ(10, countOccurrences(dump(*first), "\"name\":\"evaluate\""));
+        ASSERT_EQ(5, countOccurrences(dump(*second), "\"name\":\"evaluate\""));
+        ASSERT_EQ(0, countOccurrences(dump(*first), "\"tid\":2,"));
+    }
+}
+
+TEST_F(TracerTests, positiveTest_TracerReset_NoSpans)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>();
+    evaluator->setTracer(tracer);
+    evaluator->evaluate("A + B");
+
+    evaluator->setTracer(nullptr);
+    tracer->clear();
+    evaluator->evaluate("A + B");
+
+    ASSERT_EQ(0, countOccurrences(dump(*tracer), "\"ph\":\"X\""));
+}
+
+TEST_F(TracerTests, positiveTest_SeveralThreads_ThreadIds)
+{
+    const auto tracer = std::make_shared<s2e2::Tracer>();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i)
+    {
+        threads.emplace_back([tracer]()
+        {
+            s2e2::Evaluator threadEvaluator;
+            threadEvaluator.addStandardOperators();
+            threadEvaluator.setTracer(tracer);
+            threadEvaluator.evaluate("A + B");
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto trace = dump(*tracer);
+
+    ASSERT_EQ(3, countOccurrences(trace, "\"name\":\"evaluate\""));
+    ASSERT_EQ(2, countOccurrences(trace, "\"tid\":1,"));
+    ASSERT_EQ(2, countOccurrences(trace, "\"tid\":2,"));
+    ASSERT_EQ(2, countOccurrences(trace, "\"tid\":3,"));
+}
+
+TEST_F(TracerTests, negativeTest_SamplingRateOutOfRange)
+{
+    ASSERT_THROW({
+        try
+        {
+            s2e2::Tracer tracer(1.5);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            ASSERT_STREQ("Tracer: sampling rate must be within [0, 1]", e.what());
+            throw;
+        }
+    }, std::invalid_argument);
+}
@@ -0,0 +1,341 @@
+#include <s2e2/evaluator.hpp>
+#include <s2e2/function.hpp>
+#include <s2e2/record_batch.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    const std::vector<std::string> VARIABLES = {"V0", "V1", "V2", "V3"};
+    const std::vector<std::string> LITERALS = {"a", "b", "ab", "\"\"", "NULL"};
+    const std::vector<std::string> COMPARISONS = {"==", "!=", "<", "<=", ">", ">="};
+    const std::vector<std::string> VALUES = {"a", "b", "ab", "", "ba"};
+
+    /**
+     * @brief Generator of random expressions over standard operators, IF and REPLACE.
+     */
+    class ExpressionGenerator
+    {
+    public:
+        explicit ExpressionGenerator(uint32_t seed)
+            : random_(seed)
+        {
+        }
+
+        std::string stringExpression(int depth)
+        {
+            switch (depth <= 0 ? pick(2) : pick(6))
+            {
+            case 0:
+                return VARIABLES[pick(VARIABLES.size())];
+            case 1:
+                return LITERALS[pick(LITERALS.size())];
+            case 2:
+                return "(" + stringExpression(depth - 1) + " + " + stringExpression(depth - 1) + ")";
+            case 3:
+                return "IF(" + booleanExpression(depth - 1) + ", " + stringExpression(depth - 1) + ", " + stringExpression(depth - 1) + ")";
+            case 4:
+                return "REPLACE(" + stringExpression(depth - 1) + ", a, c)";
+            default:
+                // occasionally a type error which must fail in both modes
+                return pick(4) == 0 ? booleanExpression(depth - 1) : stringExpression(depth - 1);
+            }
+        }
+
+        std::string booleanExpression(int depth)
+        {
+            switch (depth <= 0 ? 0 : pick(5))
+            {
+            case 0:
+            case 1:
+                return "(" + stringExpression(depth - 1) + " " + COMPARISONS[pick(COMPARISONS.size())] + " " + stringExpression(depth - 1) + ")";
+            case 2:
+                return "(" + booleanExpression(depth - 1) + " && " + booleanExpression(depth - 1) + ")";
+            case 3:
+                return "(" + booleanExpression(depth - 1) + " || " + booleanExpression(depth - 1) + ")";
+            default:
+                return "!(" + booleanExpression(depth - 1) + ")";
+            }
+        }
+
+        std::vector<s2e2::VariableValue> records(size_t numberOfRecords)
+        {
+            std::vector<s2e2::VariableValue> values;
+            for (size_t i = 0; i < numberOfRecords * VARIABLES.size(); ++i)
+            {
+                const auto index = pick(VALUES.size() + 1);
+                values.push_back(index < VALUES.size() ? s2e2::VariableValue{VALUES[index]} : std::nullopt);
+            }
+            return values;
+        }
+
+    private:
+        size_t pick(size_t n)
+        {
+            return std::uniform_int_distribution<size_t>(0, n - 1)(random_);
+        }
+
+    private:
+        std::mt19937 random_;
+    };
+
+    /**
+     * @brief Custom function returning a boolean, it is always invoked record by record.
+     */
+    class FunctionIsEmpty final : public s2e2::Function
+    {
+    public:
+        FunctionIsEmpty()
+            : s2e2::Function("IS_EMPTY", 1)
+        {
+        }
+
+    private:
+        bool checkArguments() const override
+        {
+            return !arguments_[0].has_value() || arguments_[0].type() == typeid(std::string);
+        }
+
+        std::any result() const override
+        {
+            return {!arguments_[0].has_value() || std::any_cast<std::string>(arguments_[0]).empty()};
+        }
+    };
+}
+
+class VectorizedTests : public testing::Test
+{
+protected:
+	void SetUp()
+	{
+        evaluator = std::make_unique<s2e2::Evaluator>();
+        evaluator->addStandardFunctions();
+        evaluator->addStandardOperators();
+        evaluator->addFunction(std::make_unique<FunctionIsEmpty>());
+        // vectorized batches always short-circuit
+        evaluator->setShortCircuit(true);
+	}
+
+    void expectIdenticalModes(const std::string& expression, const std::vector<s2e2::VariableValue>& values)
+    {
+        const auto compiled = evaluator->compile(expression, VARIABLES);
+        const auto numberOfRecords = values.size() / VARIABLES.size();
+        const auto records = s2e2::RecordBatch::rowMajor(values, numberOfRecords, VARIABLES.size());
+
+        std::vector<std::optional<std::string>> scalarResults(numberOfRecords);
+        std::vector<s2e2::RecordStatus> scalarStatuses(numberOfRecords);
+        std::vector<std::optional<std::string>> vectorizedResults(numberOfRecords);
+        std::vector<s2e2::RecordStatus> vectorizedStatuses(numberOfRecords);
+
+        const auto scalarFailures = evaluator->evaluateBatch(compiled, records, scalarResults, scalarStatuses, s2e2::ExecutionMode::SCALAR);
+        const auto vectorizedFailures = evaluator->evaluateBatch(compiled, records, vectorizedResults, vectorizedStatuses, s2e2::ExecutionMode::VECTORIZED);
+
+        ASSERT_EQ(scalarFailures, vectorizedFailures) << expression;
+        ASSERT_EQ(scalarStatuses, vectorizedStatuses) << expression;
+        ASSERT_EQ(scalarResults, vectorizedResults) << expression;
+    }
+
+protected:
+	std::unique_ptr<s2e2::Evaluator> evaluator;
+};
+
+TEST_F(VectorizedTests, positiveTest_Comparison_Results)
+{
+    const std::vector<s2e2::VariableValue> values = {"a", "b", "c", "d",
+                                                     "b", "b", std::nullopt, "d"};
+    const auto compiled = evaluator->compile("IF(V0 == V1, same, different)", VARIABLES);
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateBatch(compiled, s2e2::RecordBatch::rowMajor(values, 2, 4), results, statuses, s2e2::ExecutionMode::VECTORIZED);
+
+    ASSERT_EQ(std::optional<std::string>{"different"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"same"}, results[1]);
+}
+
+TEST_F(VectorizedTests, positiveTest_Concatenation_Results)
+{
+    const std::vector<s2e2::VariableValue> values = {"a", "b", "c", std::nullopt,
+                                                     std::nullopt, std::nullopt, "c", "d"};
+    const auto compiled = evaluator->compile("V0 + V1 + V3", VARIABLES);
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    evaluator->evaluateBatch(compiled, s2e2::RecordBatch::rowMajor(values, 2, 4), results, statuses, s2e2::ExecutionMode::VECTORIZED);
+
+    ASSERT_EQ(std::optional<std::string>{"ab"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"d"}, results[1]);
+}
+
+TEST_F(VectorizedTests, positiveTest_PlusChain_IdenticalResults)
+{
+    ExpressionGenerator generator(5);
+    const auto values = generator.records(3000);
+
+    const std::vector<std::string> expressions = {"V0 + V1 + V2 + V3",
+                                                  "V0 + a + NULL + V1 + \"\" + V0",
+                                                  "NULL + V0 + NULL + V1",
+                                                  "V3 + (V0 + V1) + b + V0",
+                                                  "IF(V0 == a, V1, V2) + V3 + b + V0",
+                                                  "CONCAT(V0, V1, IF(IS_EMPTY(V2), V3, V2), NULL)",
+                                                  "CONCAT(V0, V1 == V2, V3)"};
+
+    for (const auto& expression : expressions)
+    {
+        expectIdenticalModes(expression, values);
+    }
+}
+
+TEST_F(VectorizedTests, positiveTest_MemoryResource_Results)
+{
+    std::pmr::unsynchronized_pool_resource resource;
+    evaluator->setMemoryResource(&resource);
+
+    ExpressionGenerator generator(5);
+    const auto values = generator.records(3000);
+
+    expectIdenticalModes("V0 + _long_enough_not_to_fit_into_a_small_string_ + V1 + REPLACE(V2 + V3, a, c)", values);
+    expectIdenticalModes("IF(IS_EMPTY(V0), V1 + V2 + V3, V3 + V2 + V1)", values);
+}
+
+TEST_F(VectorizedTests, positiveTest_BooleanResult_Statuses)
+{
+    const std::vector<s2e2::VariableValue> values = {"a", "b", "c", "d"};
+    const auto compiled = evaluator->compile("V0 == V1", VARIABLES);
+    std::vector<std::optional<std::string>> results(1);
+    std::vector<s2e2::RecordStatus> statuses(1);
+
+    const auto failures = evaluator->evaluateBatch(compiled, s2e2::RecordBatch::rowMajor(values, 1, 4), results, statuses, s2e2::ExecutionMode::VECTORIZED);
+
+    ASSERT_EQ(1, failures);
+    ASSERT_EQ(s2e2::RecordStatus::ERROR, statuses[0]);
+}
+
+TEST_F(VectorizedTests, positiveTest_ShortCircuit_Statuses)
+{
+    const std::vector<s2e2::VariableValue> values = {std::nullopt, "b", "c", "d",
+                                                     "a", "b", "c", "d"};
+    const auto compiled = evaluator->compile("IF(V0 != NULL && V0 < V1, less, IF(V0 == NULL, none, V2 < NULL))", VARIABLES);
+    std::vector<std::optional<std::string>> results(2);
+    std::vector<s2e2::RecordStatus> statuses(2);
+
+    const auto failures = evaluator->evaluateBatch(compiled, s2e2::RecordBatch::rowMajor(values, 2, 4), results, statuses, s2e2::ExecutionMode::VECTORIZED);
+
+    ASSERT_EQ(0, failures);
+    ASSERT_EQ(std::optional<std::string>{"none"}, results[0]);
+    ASSERT_EQ(std::optional<std::string>{"less"}, results[1]);
+}
+
+TEST_F(VectorizedTests, positiveTest_CustomFunction_IdenticalResults)
+{
+    ExpressionGenerator generator(1);
+    const auto values = generator.records(3000);
+
+    expectIdenticalModes("IF(IS_EMPTY(V0) || IS_EMPTY(V1 + V2), empty, V0 + V1 + V2)", values);
+}
+
+TEST_F(VectorizedTests, positiveTest_GeneratedCorpus_IdenticalResults)
+{
+    ExpressionGenerator generator(42);
+    const auto values = generator.records(2500);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        const auto expression = generator.stringExpression(1 + i % 5);
+        expectIdenticalModes(expression, values);
+        if (HasFatalFailure())
+        {
+            return;
+        }
+    }
+}
+
+TEST_F(VectorizedTests, positiveTest_Membership_IdenticalResults)
+{
+    ExpressionGenerator generator(3);
+    const auto values = generator.records(3000);
+
+    const std::vector<std::string> expressions = {"IF(V0 == a || V0 == b || V0 == NULL, yes, no)",
+                                                  "IF(V0 + V1 != a && V0 + V1 != ab && V0 + V1 != \"\", V0, V1)",
+                                                  "IF(IN(V2, ab, ba, NULL, a), V2, V3)",
+                                                  "IF(IN(V0, V1, V2, a), yes, no)",
+                                                  "IF(V0 == V1 || IN(V0 == V1, a, b), yes, no)",
+                                                  "IF(IN(IF(V0 == a, V1, V0 == V2), a, b), yes, no)"};
+
+    for (const auto& expression : expressions)
+    {
+        expectIdenticalModes(expression, values);
+    }
+}
+
+TEST_F(VectorizedTests, positiveTest_LongShortCircuitChain_IdenticalResults)
+{
+    ExpressionGenerator generator(11);
+    const auto values = generator.records(16);
+
+    std::string expression = "V0 == V1";
+    for (size_t i = 0; i < 100000; ++i)
+    {
+        expression += " || V1 + a" + std::to_string(i) + " == V2";
+    }
+
+    expectIdenticalModes("IF(" + expression + ", V3, V0)", values);
+}
+
+TEST_F(VectorizedTests, positiveTest_DictionaryColumn_IdenticalResults)
+{
+    ExpressionGenerator generator(7);
+    const auto values = generator.records(3000);
+    const auto numberOfRecords = values.size() / VARIABLES.size();
+
+    std::vector<s2e2::VariableValue> dictionary(VALUES.begin(), VALUES.end());
+    dictionary.push_back(std::nullopt);
+
+    std::vector<std::vector<s2e2::VariableValue>> plainColumns(VARIABLES.size());
+    std::vector<uint32_t> codes;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        plainColumns[i % VARIABLES.size()].push_back(values[i]);
+        if (i % VARIABLES.size() == 0)
+        {
+            const auto position = std::find(dictionary.begin(), dictionary.end(), values[i]);
+            codes.push_back(static_cast<uint32_t>(position - dictionary.begin()));
+        }
+    }
+
+    const auto plain = s2e2::RecordBatch::rowMajor(values, numberOfRecords, VARIABLES.size());
+    const auto encoded = s2e2::RecordBatch::columnar({s2e2::BatchColumn::dictionary(dictionary, codes),
+                                                      plainColumns[1], plainColumns[2], plainColumns[3]},
+                                                     numberOfRecords);
+
+    const std::vector<std::string> expressions = {"IF(V0 == a, yes, no)",
+                                                  "IF(ab != V0, yes, no)",
+                                                  "IF(V0 == NULL, yes, no)",
+                                                  "IF(V0 != missing, yes, no)",
+                                                  "IF(V0 == \"\" || V0 == V1, V0, V2)"};
+
+    for (const auto& expression : expressions)
+    {
+        const auto compiled = evaluator->compile(expression, VARIABLES);
+
+        std::vector<std::optional<std::string>> expectedResults(numberOfRecords);
+        std::vector<s2e2::RecordStatus> expectedStatuses(numberOfRecords);
+        std::vector<std::optional<std::string>> results(numberOfRecords);
+        std::vector<s2e2::RecordStatus> statuses(numberOfRecords);
+
+        evaluator->evaluateBatch(compiled, plain, expectedResults, expectedStatuses, s2e2::ExecutionMode::SCALAR);
+        evaluator->evaluateBatch(compiled, encoded, results, statuses, s2e2::ExecutionMode::VECTORIZED);
+
+        ASSERT_EQ(expectedStatuses, statuses) << expression;
+        ASSERT_EQ(expectedResults, results) << expression;
+    }
+}
@@ -0,0 +1,246 @@
+#include <work_stealing_pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    /**
+     * @brief Make options of a pool.
+     */
+    s2e2::ThreadPoolOptions withThreads(size_t numberOfThreads)
+    {
+        s2e2::ThreadPoolOptions options;
+        options.numberOfThreads = numberOfThreads;
+        return options;
+    }
+}
+
+
+TEST(WorkStealingPoolTests, positiveTest_OneWorker_NoThreads)
+{
+    s2e2::WorkStealingPool pool(withThreads(1));
+    std::vector<size_t> order;
+
+    pool.run({0, 1, 2}, [&order](s2e2::WorkStealingPool&, size_t task, size_t worker)
+    {
+        ASSERT_EQ(0, worker);
+        order.push_back(task);
+    });
+
+    ASSERT_EQ(1, pool.numberOfWorkers());
+    ASSERT_EQ(3, order.size());
+}
+
+TEST(WorkStealingPoolTests, positiveTest_SpawnedTasks_AllRun)
+{
+    // every task below 1000 spawns two children, so every index from 1 to 1999 runs once
+    const size_t numberOfTasks = 2000;
+    s2e2::WorkStealingPool pool(withThreads(4));
+
+    for (size_t run = 0; run < 20; ++run)
+    {
+        const auto runs = std::make_unique<std::atomic<size_t>[]>(numberOfTasks);
+        std::atomic<bool> invalidWorker{false};
+
+        pool.run({1}, [&](s2e2::WorkStealingPool& current, size_t task, size_t worker)
+        {
+            ++runs[task];
+            if (worker >= current.numberOfWorkers())
+            {
+                invalidWorker = true;
+            }
+            if (task < 1000)
+            {
+                current.spawn(2 * task, worker);
+                current.spawn(2 * task + 1, worker);
+            }
+        });
+
+        ASSERT_FALSE(invalidWorker.load());
+        ASSERT_EQ(0, runs[0].load());
+        for (size_t task = 1; task < numberOfTasks; ++task)
+        {
+            ASSERT_EQ(1, runs[task].load()) << task;
+        }
+    }
+}
+
+TEST(WorkStealingPoolTests, positiveTest_NoTasks_Returns)
+{
+    s2e2::WorkStealingPool pool(withThreads(2));
+
+    pool.run({}, [](s2e2::WorkStealingPool&, size_t, size_t) { FAIL(); });
+}
+
+TEST(WorkStealingPoolTests, negativeTest_TaskThrows_RethrownAfterAllTasks)
+{
+    s2e2::WorkStealingPool pool(withThreads(3));
+    std::atomic<size_t> finished{0};
+
+    ASSERT_THROW(pool.run({0, 1, 2, 3, 4, 5}, [&finished](s2e2::WorkStealingPool&, size_t task, size_t)
+    {
+        if (task == 2)
+        {
+            throw std::runtime_error("task failed");
+        }
+        ++finished;
+    }), std::runtime_error);
+
+    ASSERT_EQ(5, finished.load());
+
+    // the pool is usable after a failed run
+    pool.run({0}, [&finished](s2e2::WorkStealingPool&, size_t, size_t) { ++finished; });
+    ASSERT_EQ(6, finished.load());
+}
+
+TEST(WorkStealingPoolTests, positiveTest_RunsFromTwoThreads_Overlap)
+{
+    s2e2::WorkStealingPool pool(withThreads(2));
+    std::promise<void> started;
+    std::promise<void> released;
+    auto release = released.get_future();
+    bool overlapped = false;
+
+    // the first run waits for a task of the second one, so it only finishes if runs are not serialized
+    std::thread first([&]
+    {
+        pool.run({0}, [&](s2e2::WorkStealingPool&, size_t, size_t)
+        {
+            started.set_value();
+            overlapped = release.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+        });
+    });
+    started.get_future().wait();
+    pool.run({0}, [&released](s2e2::WorkStealingPool&, size_t, size_t) { released.set_value(); });
+    first.join();
+
+    ASSERT_TRUE(overlapped);
+}
+
+TEST(WorkStealingPoolTests, positiveTest_ConcurrentRuns_OwnTasksAndWorkers)
+{
+    const size_t numberOfTasks = 2000;
+    const size_t numberOfCallers = 3;
+    s2e2::WorkStealingPool pool(withThreads(3));
+    std::atomic<bool> failed{false};
+
+    const auto call = [&]
+    {
+        for (size_t run = 0; run < 10; ++run)
+        {
+            const auto runs = std::make_unique<std::atomic<size_t>[]>(numberOfTasks);
+            const auto busy = std::make_unique<std::atomic<bool>[]>(pool.numberOfWorkers());
+
+            pool.run({1}, [&](s2e2::WorkStealingPool& current, size_t task, size_t worker)
+            {
+                // state kept per worker by one run is never used by two threads at once
+                if (busy[worker].exchange(true))
+                {
+                    failed = true;
+                }
+                ++runs[task];
+                if (task < numberOfTasks / 2)
+                {
+                    current.spawn(2 * task, worker);
+                    current.spawn(2 * task + 1, worker);
+                }
+                busy[worker] = false;
+            });
+
+            for (size_t task = 1; task < numberOfTasks; ++task)
+            {
+                if (runs[task] != 1)
+                {
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> callers;
+    for (size_t caller = 0; caller < numberOfCallers; ++caller)
+    {
+        callers.emplace_back(call);
+    }
+    for (auto& caller : callers)
+    {
+        caller.join();
+    }
+
+    ASSERT_FALSE(failed.load());
+}
+
+TEST(WorkStealingPoolTests, positiveTest_Ranges_CoverAllItemsOnce)
+{
+    s2e2::WorkStealingPool pool(withThreads(4));
+    const size_t numberOfItems = 10007;
+    const auto visits = std::make_unique<std::atomic<size_t>[]>(numberOfItems);
+
+    pool.forEachRange(numberOfItems, 100, [&visits](size_t first, size_t last, size_t)
+    {
+        ASSERT_LE(last - first, 100);
+        for (auto item = first; item < last; ++item)
+        {
+            ++visits[item];
+        }
+    });
+
+    for (size_t item = 0; item < numberOfItems; ++item)
+    {
+        ASSERT_EQ(1, visits[item].load()) << item;
+    }
+}
+
+TEST(WorkStealingPoolTests, positiveTest_OneRange_CallingThread)
+{
+    s2e2::WorkStealingPool pool(withThreads(4));
+    size_t calls = 0;
+
+    pool.forEachRange(50, 100, [&calls](size_t first, size_t last, size_t worker)
+    {
+        ASSERT_EQ(0, first);
+        ASSERT_EQ(50, last);
+        ASSERT_EQ(0, worker);
+        ++calls;
+    });
+    pool.forEachRange(0, 100, [&calls](size_t, size_t, size_t) { ++calls; });
+
+    ASSERT_EQ(1, calls);
+}
+
+TEST(WorkStealingPoolTests, positiveTest_Affinity_Started)
+{
+    auto options = withThreads(3);
+    options.affinity = {0};
+    s2e2::WorkStealingPool pool(options);
+    std::atomic<size_t> finished{0};
+
+    pool.run({0, 1, 2, 3}, [&finished](s2e2::WorkStealingPool&, size_t, size_t) { ++finished; });
+
+    ASSERT_EQ(4, finished.load());
+}
+
+TEST(WorkStealingPoolTests, negativeTest_ZeroGrainSize)
+{
+    auto options = withThreads(2);
+    options.grainSize = 0;
+
+    ASSERT_THROW(s2e2::WorkStealingPool pool(options), std::invalid_argument);
+}
+
+TEST(WorkStealingPoolTests, negativeTest_CpuOutOfRange)
+{
+    auto options = withThreads(2);
+    options.affinity = {1000000};
+
+    ASSERT_THROW(s2e2::WorkStealingPool pool(options), std::invalid_argument);
+}